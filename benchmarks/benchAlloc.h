@@ -0,0 +1,40 @@
+#ifndef BENCH_ALLOC_H
+#define BENCH_ALLOC_H
+
+#include <cstdint>
+#include <benchmark/benchmark.h>
+
+namespace bench_util
+{
+    // 进程内累计的 operator new 调用次数（由 bench_alloc.cpp 替换全局 operator new 统计）
+    uint64_t allocation_count();
+
+    // 在基准循环前构造、循环后析构，报告每次迭代的平均分配次数 allocs_per_op
+    class AllocationCounter
+    {
+    public:
+        explicit AllocationCounter(benchmark::State &state) : state_(state), start_(allocation_count()) {}
+
+        ~AllocationCounter()
+        {
+            state_.counters["allocs_per_op"] =
+                benchmark::Counter(static_cast<double>(allocation_count() - start_), benchmark::Counter::kAvgIterations);
+        }
+
+        AllocationCounter(const AllocationCounter &) = delete;
+        AllocationCounter &operator=(const AllocationCounter &) = delete;
+
+    private:
+        benchmark::State &state_;
+        uint64_t start_;
+    };
+
+    // 同时报告 bytes/s 与 items/s
+    inline void set_throughput(benchmark::State &state, std::size_t bytes_per_op, std::size_t items_per_op = 1)
+    {
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(bytes_per_op));
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(items_per_op));
+    }
+} // namespace bench_util
+
+#endif // BENCH_ALLOC_H
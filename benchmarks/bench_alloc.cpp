@@ -0,0 +1,47 @@
+// 替换全局 operator new/delete 以统计分配次数，供 AllocationCounter 使用
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "benchAlloc.h"
+
+namespace
+{
+    std::atomic<uint64_t> g_allocations{0};
+
+    void *counted_alloc(std::size_t size)
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        if (void *p = std::malloc(size == 0 ? 1 : size))
+        {
+            return p;
+        }
+        throw std::bad_alloc();
+    }
+} // namespace
+
+namespace bench_util
+{
+    uint64_t allocation_count()
+    {
+        return g_allocations.load(std::memory_order_relaxed);
+    }
+} // namespace bench_util
+
+void *operator new(std::size_t size) { return counted_alloc(size); }
+void *operator new[](std::size_t size) { return counted_alloc(size); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { std::free(p); }
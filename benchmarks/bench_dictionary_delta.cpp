@@ -0,0 +1,98 @@
+// 订阅推送：200 个 key 的状态字典每次只有一个 key 变化时，增量编码 vs 推送完整 Dictionary
+#include <string>
+#include <benchmark/benchmark.h>
+#include "benchAlloc.h"
+#include "common/variant.pb.h"
+#include "dictionaryDelta.h"
+
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::utils::PB;
+
+namespace
+{
+    Dictionary make_state()
+    {
+        Dictionary dict;
+        auto &map = *dict.mutable_keyvaluelist();
+        for (int i = 0; i < 200; ++i)
+        {
+            map["joint_" + std::to_string(i)].set_doublevalue(i * 0.1);
+        }
+        return dict;
+    }
+} // namespace
+
+// 服务端：差分 + 序列化增量
+static void BM_DeltaEncode(benchmark::State &state)
+{
+    Dictionary snapshot = make_state();
+    DeltaEncoder encoder;
+    DictionaryDelta delta;
+    std::string wire;
+    encoder.encode(snapshot, &delta);
+    auto &changing = (*snapshot.mutable_keyvaluelist())["joint_7"];
+    double value = 0;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        changing.set_doublevalue(value += 1.0);
+        encoder.encode(snapshot, &delta);
+        delta.SerializeToString(&wire);
+    }
+    state.counters["wire_bytes"] = static_cast<double>(wire.size());
+    bench_util::set_throughput(state, wire.size());
+}
+BENCHMARK(BM_DeltaEncode);
+
+// 对比：每次序列化完整字典
+static void BM_FullSnapshotSerialize(benchmark::State &state)
+{
+    Dictionary snapshot = make_state();
+    auto &changing = (*snapshot.mutable_keyvaluelist())["joint_7"];
+    std::string wire;
+    double value = 0;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        changing.set_doublevalue(value += 1.0);
+        snapshot.SerializeToString(&wire);
+    }
+    state.counters["wire_bytes"] = static_cast<double>(wire.size());
+    bench_util::set_throughput(state, wire.size());
+}
+BENCHMARK(BM_FullSnapshotSerialize);
+
+// 客户端：解析 + 应用增量 vs 解析完整字典
+static void BM_DeltaApply(benchmark::State &state)
+{
+    Dictionary snapshot = make_state();
+    Dictionary materialized = snapshot;
+    DeltaEncoder encoder;
+    DictionaryDelta delta;
+    encoder.encode(snapshot, &delta);
+    (*snapshot.mutable_keyvaluelist())["joint_7"].set_doublevalue(1.0);
+    encoder.encode(snapshot, &delta);
+    std::string wire = delta.SerializeAsString();
+    DictionaryDelta parsed;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        parsed.ParseFromString(wire);
+        apply_delta(parsed, &materialized);
+    }
+    bench_util::set_throughput(state, wire.size());
+}
+BENCHMARK(BM_DeltaApply);
+
+static void BM_FullSnapshotParse(benchmark::State &state)
+{
+    const std::string wire = make_state().SerializeAsString();
+    Dictionary parsed;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        parsed.ParseFromString(wire);
+    }
+    bench_util::set_throughput(state, wire.size());
+}
+BENCHMARK(BM_FullSnapshotParse);
@@ -0,0 +1,115 @@
+// 黑匣子记录：发布者侧记录开销（传感器大小的负载）与 mmap 顺序读取吞吐
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <benchmark/benchmark.h>
+#include "benchAlloc.h"
+#include "flightRecorder.h"
+
+using namespace humanoid_robot::PB::communication;
+using namespace humanoid_robot::utils::PB;
+
+namespace
+{
+    std::string make_temp_dir()
+    {
+        char pattern[] = "/tmp/flight_recorder_bench_XXXXXX";
+        const char *dir = mkdtemp(pattern);
+        return dir != nullptr ? dir : "/tmp";
+    }
+
+    TopicMessage make_message(std::size_t size)
+    {
+        TopicMessage message;
+        message.set_topic_name("camera/front/image");
+        message.set_publisher_id("camera_node");
+        message.set_payload(std::string(size, 'x'));
+        return message;
+    }
+} // namespace
+
+// 发布者调用 record() 的开销；磁盘跟不上时记录被丢弃，dropped 计数反映写盘能力
+static void BM_FlightRecorderRecord(benchmark::State &state)
+{
+    const std::string dir = make_temp_dir();
+    RecorderOptions options;
+    options.directory = dir;
+    auto recorder = FlightRecorder::open(options);
+    TopicMessage message = make_message(static_cast<std::size_t>(state.range(0)));
+    uint64_t sequence = 0;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        message.set_sequence(++sequence);
+        message.set_timestamp(sequence);
+        benchmark::DoNotOptimize(recorder->record(message));
+    }
+    recorder->close();
+    state.counters["dropped"] = static_cast<double>(recorder->dropped());
+    std::filesystem::remove_all(dir);
+    bench_util::set_throughput(state, message.payload().size());
+}
+BENCHMARK(BM_FlightRecorderRecord)->Arg(4 << 10)->Arg(64 << 10)->Arg(1 << 20);
+
+// 端到端写盘吞吐：记录后 flush，计入后台线程写文件的时间
+static void BM_FlightRecorderSustained(benchmark::State &state)
+{
+    const std::string dir = make_temp_dir();
+    RecorderOptions options;
+    options.directory = dir;
+    auto recorder = FlightRecorder::open(options);
+    TopicMessage message = make_message(static_cast<std::size_t>(state.range(0)));
+    constexpr int kBurst = 64;
+    for (auto _ : state)
+    {
+        for (int i = 0; i < kBurst; ++i)
+        {
+            recorder->record(message);
+        }
+        recorder->flush();
+    }
+    recorder->close();
+    state.counters["dropped"] = static_cast<double>(recorder->dropped());
+    std::filesystem::remove_all(dir);
+    bench_util::set_throughput(state, kBurst * message.payload().size(), kBurst);
+}
+BENCHMARK(BM_FlightRecorderSustained)->Arg(64 << 10)->Arg(1 << 20)->UseRealTime();
+
+// 读取端：零拷贝遍历全部记录
+static void BM_FlightReaderScan(benchmark::State &state)
+{
+    const std::string dir = make_temp_dir();
+    RecorderOptions options;
+    options.directory = dir;
+    auto recorder = FlightRecorder::open(options);
+    TopicMessage message = make_message(static_cast<std::size_t>(state.range(0)));
+    constexpr uint64_t kRecords = 1024;
+    for (uint64_t i = 0; i < kRecords; ++i)
+    {
+        message.set_timestamp(i);
+        recorder->record(message);
+        if (i % 64 == 63)
+        {
+            recorder->flush();
+        }
+    }
+    recorder->close();
+
+    auto reader = FlightReader::open(dir);
+    RecordView record;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        reader->rewind();
+        std::size_t bytes = 0;
+        while (reader->next(&record))
+        {
+            bytes += record.payload.size();
+        }
+        benchmark::DoNotOptimize(bytes);
+    }
+    std::filesystem::remove_all(dir);
+    bench_util::set_throughput(state, reader->record_count() * message.payload().size(), reader->record_count());
+}
+BENCHMARK(BM_FlightReaderScan)->Arg(4 << 10)->Arg(64 << 10);
@@ -0,0 +1,149 @@
+// 图像传输路径对比：生成代码（bytes 字段拷贝） vs ImageFrame（外部缓冲区零拷贝）
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <grpcpp/grpcpp.h>
+#include "common/variant.pb.h"
+#include "imageTransport.h"
+
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::utils::PB;
+
+namespace
+{
+    constexpr std::size_t kFrameBytes = 1920 * 1080 * 3; // 1080p RGB
+
+    const std::shared_ptr<std::string> &camera_frame()
+    {
+        static const std::shared_ptr<std::string> frame = []
+        {
+            auto buf = std::make_shared<std::string>(kFrameBytes, '\0');
+            for (std::size_t i = 0; i < buf->size(); ++i)
+            {
+                (*buf)[i] = static_cast<char>(i * 31);
+            }
+            return buf;
+        }();
+        return frame;
+    }
+
+    // gRPC 接收到的大消息通常被切分成多个 slice，这里按 64KB 模拟
+    ::grpc::ByteBuffer split_buffer(const std::string &flat)
+    {
+        constexpr std::size_t kSliceBytes = 64 * 1024;
+        std::vector<::grpc::Slice> slices;
+        for (std::size_t off = 0; off < flat.size(); off += kSliceBytes)
+        {
+            slices.emplace_back(flat.data() + off, std::min(kSliceBytes, flat.size() - off));
+        }
+        return ::grpc::ByteBuffer(slices.data(), slices.size());
+    }
+
+    std::string serialized_frame()
+    {
+        Image image;
+        image.set_timestamp("1705123456789");
+        image.set_img(*camera_frame());
+        return image.SerializeAsString();
+    }
+} // namespace
+
+// 生成代码发送路径：帧拷贝进 bytes 字段，再序列化为连续缓冲区
+static void BM_ImageProtobufSerialize(benchmark::State &state)
+{
+    const auto &frame = camera_frame();
+    std::string out;
+    for (auto _ : state)
+    {
+        Image image;
+        image.set_timestamp("1705123456789");
+        image.set_img(*frame);
+        image.SerializeToString(&out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * kFrameBytes);
+}
+BENCHMARK(BM_ImageProtobufSerialize);
+
+// ImageFrame 发送路径：帧以外部 slice 挂到 ByteBuffer 上
+static void BM_ImageFrameSerialize(benchmark::State &state)
+{
+    const auto &frame = camera_frame();
+    for (auto _ : state)
+    {
+        ImageFrame image;
+        image.set_time_stamp("1705123456789");
+        image.attach_image(frame->data(), frame->size(), frame);
+        ::grpc::ByteBuffer buffer;
+        image.serialize(&buffer);
+        benchmark::DoNotOptimize(buffer.Length());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * kFrameBytes);
+}
+BENCHMARK(BM_ImageFrameSerialize);
+
+// 生成代码接收路径：slice 合并为连续内存后解析，img 再拷贝进 std::string
+static void BM_ImageProtobufParse(benchmark::State &state)
+{
+    const std::string flat = serialized_frame();
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        ::grpc::ByteBuffer buffer = split_buffer(flat);
+        state.ResumeTiming();
+
+        std::vector<::grpc::Slice> slices;
+        buffer.Dump(&slices);
+        std::string joined;
+        joined.reserve(flat.size());
+        for (const auto &slice : slices)
+        {
+            joined.append(reinterpret_cast<const char *>(slice.begin()), slice.size());
+        }
+        Image image;
+        image.ParseFromString(joined);
+        benchmark::DoNotOptimize(image.img().data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * kFrameBytes);
+}
+BENCHMARK(BM_ImageProtobufParse);
+
+// ImageFrame 接收路径：图像保持为 slice 分段视图
+static void BM_ImageFrameParse(benchmark::State &state)
+{
+    const std::string flat = serialized_frame();
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        ::grpc::ByteBuffer buffer = split_buffer(flat);
+        state.ResumeTiming();
+
+        ImageFrame image;
+        image.parse(&buffer);
+        benchmark::DoNotOptimize(image.image_segments().data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * kFrameBytes);
+}
+BENCHMARK(BM_ImageFrameParse);
+
+// ImageFrame 接收后仍需要连续内存时（例如送入推理）：只拷贝一次
+static void BM_ImageFrameParseContiguous(benchmark::State &state)
+{
+    const std::string flat = serialized_frame();
+    std::string pixels(kFrameBytes, '\0');
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        ::grpc::ByteBuffer buffer = split_buffer(flat);
+        state.ResumeTiming();
+
+        ImageFrame image;
+        image.parse(&buffer);
+        image.copy_image_to(&pixels[0]);
+        benchmark::DoNotOptimize(pixels.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * kFrameBytes);
+}
+BENCHMARK(BM_ImageFrameParseContiguous);
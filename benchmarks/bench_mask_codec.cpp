@@ -0,0 +1,85 @@
+// 掩码编码对比：repeated Mask 逐点消息 vs MaskRle（约 3 万像素的分割块）
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "common/variant.pb.h"
+#include "maskCodec.h"
+
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::utils::PB;
+
+namespace
+{
+    constexpr int kBlobWidth = 200;
+    constexpr int kBlobHeight = 240;
+
+    // 椭圆形分割块的逐像素点列表
+    PerceptionRow make_legacy_row()
+    {
+        PerceptionRow row;
+        const float cx = kBlobWidth / 2.0f;
+        const float cy = kBlobHeight / 2.0f;
+        for (int y = 0; y < kBlobHeight; ++y)
+        {
+            for (int x = 0; x < kBlobWidth; ++x)
+            {
+                const float dx = (x - cx) / cx;
+                const float dy = (y - cy) / cy;
+                if (dx * dx + dy * dy <= 1.0f)
+                {
+                    Mask *point = row.add_masks();
+                    point->set_x(640 + x);
+                    point->set_y(200 + y);
+                }
+            }
+        }
+        return row;
+    }
+} // namespace
+
+static void BM_MaskPointsParse(benchmark::State &state)
+{
+    const std::string wire = make_legacy_row().SerializeAsString();
+    for (auto _ : state)
+    {
+        PerceptionRow row;
+        row.ParseFromString(wire);
+        benchmark::DoNotOptimize(row.masks_size());
+    }
+    state.counters["wire_bytes"] = static_cast<double>(wire.size());
+}
+BENCHMARK(BM_MaskPointsParse);
+
+static void BM_MaskRleParseDecode(benchmark::State &state)
+{
+    PerceptionRow row = make_legacy_row();
+    points_to_rle(row.masks(), row.mutable_maskrle());
+    row.clear_masks();
+    const std::string wire = row.SerializeAsString();
+    std::vector<uint8_t> bitmap(static_cast<std::size_t>(kBlobWidth) * kBlobHeight);
+    for (auto _ : state)
+    {
+        PerceptionRow parsed;
+        parsed.ParseFromString(wire);
+        decode_rle(parsed.maskrle(), bitmap.data());
+        benchmark::DoNotOptimize(bitmap.data());
+    }
+    state.counters["wire_bytes"] = static_cast<double>(wire.size());
+}
+BENCHMARK(BM_MaskRleParseDecode);
+
+static void BM_MaskRleEncode(benchmark::State &state)
+{
+    PerceptionRow row = make_legacy_row();
+    MaskRle rle;
+    points_to_rle(row.masks(), &rle);
+    std::vector<uint8_t> bitmap(static_cast<std::size_t>(kBlobWidth) * kBlobHeight);
+    decode_rle(rle, bitmap.data());
+    for (auto _ : state)
+    {
+        encode_rle(bitmap.data(), kBlobWidth, kBlobHeight, kBlobWidth, &rle);
+        benchmark::DoNotOptimize(rle.counts_size());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * kBlobWidth * kBlobHeight);
+}
+BENCHMARK(BM_MaskRleEncode);
@@ -0,0 +1,182 @@
+// 业务消息基准：N 行 x M 掩码点的感知结果，以及不同负载大小的 UniversalRequest 信封
+#include <string>
+#include <benchmark/benchmark.h>
+#include "benchAlloc.h"
+#include "communication/communication_service.pb.h"
+#include "perception/perception_request_response.pb.h"
+
+using namespace humanoid_robot::PB::common;
+using humanoid_robot::PB::communication::UniversalRequest;
+using humanoid_robot::PB::perception::PerceptionResponse;
+
+namespace
+{
+    // rows 行，每行 mask_points 个掩码点
+    PerceptionResponse make_perception(int rows, int mask_points)
+    {
+        const char *classes[] = {"person", "car", "bicycle", "dog"};
+        PerceptionResponse response;
+        response.set_ret(0);
+        auto *perception = response.mutable_perception();
+        perception->set_timestamp("1705123456789");
+        for (int i = 0; i < rows; ++i)
+        {
+            PerceptionRow *row = perception->add_rows();
+            row->mutable_bbox()->set_x1(static_cast<float>(i % 40) * 48.0f);
+            row->mutable_bbox()->set_y1(static_cast<float>(i / 40) * 200.0f);
+            row->mutable_bbox()->set_x2(static_cast<float>(i % 40) * 48.0f + 40.0f);
+            row->mutable_bbox()->set_y2(static_cast<float>(i / 40) * 200.0f + 120.0f);
+            row->set_conf(static_cast<float>(i % 100) / 100.0f);
+            row->set_cls(classes[i % 4]);
+            row->set_trackid("track_" + std::to_string(i));
+            row->set_ismove(i % 3 == 0);
+            for (int p = 0; p < mask_points; ++p)
+            {
+                Mask *point = row->add_masks();
+                point->set_x(i * 48 + p % 40);
+                point->set_y(p / 40);
+            }
+        }
+        return response;
+    }
+
+    UniversalRequest make_request(int payload_size)
+    {
+        UniversalRequest request;
+        request.set_command(20001);
+        request.set_version(1);
+        request.set_requestid(123456);
+        request.set_sendrequesttimestamp(1705123456789LL);
+        request.set_checksum(0x5a5a5a5a);
+        request.set_payload(std::string(static_cast<std::size_t>(payload_size), 'p'));
+        request.set_payloadtype(3);
+        request.set_payloadsize(payload_size);
+        return request;
+    }
+
+    void perception_args(benchmark::internal::Benchmark *b)
+    {
+        for (int rows : {10, 50, 200})
+        {
+            for (int points : {0, 100, 1000})
+            {
+                b->Args({rows, points});
+            }
+        }
+        b->ArgNames({"rows", "mask_points"});
+    }
+
+    void request_args(benchmark::internal::Benchmark *b)
+    {
+        b->Arg(32)->Arg(256)->Arg(4096)->Arg(64 * 1024)->ArgName("payload");
+    }
+} // namespace
+
+static void BM_PerceptionSerialize(benchmark::State &state)
+{
+    const PerceptionResponse response = make_perception(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    std::string out;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        response.SerializeToString(&out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    bench_util::set_throughput(state, out.size(), static_cast<std::size_t>(state.range(0)));
+}
+BENCHMARK(BM_PerceptionSerialize)->Apply(perception_args);
+
+static void BM_PerceptionParse(benchmark::State &state)
+{
+    const std::string wire =
+        make_perception(static_cast<int>(state.range(0)), static_cast<int>(state.range(1))).SerializeAsString();
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        PerceptionResponse parsed;
+        parsed.ParseFromString(wire);
+        benchmark::DoNotOptimize(&parsed);
+    }
+    bench_util::set_throughput(state, wire.size(), static_cast<std::size_t>(state.range(0)));
+}
+BENCHMARK(BM_PerceptionParse)->Apply(perception_args);
+
+static void BM_PerceptionByteSize(benchmark::State &state)
+{
+    const PerceptionResponse response = make_perception(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    const std::size_t size = response.ByteSizeLong();
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(response.ByteSizeLong());
+    }
+    bench_util::set_throughput(state, size, static_cast<std::size_t>(state.range(0)));
+}
+BENCHMARK(BM_PerceptionByteSize)->Apply(perception_args);
+
+static void BM_PerceptionCopy(benchmark::State &state)
+{
+    const PerceptionResponse response = make_perception(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        PerceptionResponse copy(response);
+        benchmark::DoNotOptimize(&copy);
+    }
+    bench_util::set_throughput(state, response.ByteSizeLong(), static_cast<std::size_t>(state.range(0)));
+}
+BENCHMARK(BM_PerceptionCopy)->Apply(perception_args);
+
+static void BM_UniversalRequestSerialize(benchmark::State &state)
+{
+    const UniversalRequest request = make_request(static_cast<int>(state.range(0)));
+    std::string out;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        request.SerializeToString(&out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    bench_util::set_throughput(state, out.size());
+}
+BENCHMARK(BM_UniversalRequestSerialize)->Apply(request_args);
+
+static void BM_UniversalRequestParse(benchmark::State &state)
+{
+    const std::string wire = make_request(static_cast<int>(state.range(0))).SerializeAsString();
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        UniversalRequest parsed;
+        parsed.ParseFromString(wire);
+        benchmark::DoNotOptimize(&parsed);
+    }
+    bench_util::set_throughput(state, wire.size());
+}
+BENCHMARK(BM_UniversalRequestParse)->Apply(request_args);
+
+static void BM_UniversalRequestByteSize(benchmark::State &state)
+{
+    const UniversalRequest request = make_request(static_cast<int>(state.range(0)));
+    const std::size_t size = request.ByteSizeLong();
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(request.ByteSizeLong());
+    }
+    bench_util::set_throughput(state, size);
+}
+BENCHMARK(BM_UniversalRequestByteSize)->Apply(request_args);
+
+static void BM_UniversalRequestCopy(benchmark::State &state)
+{
+    const UniversalRequest request = make_request(static_cast<int>(state.range(0)));
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        UniversalRequest copy(request);
+        benchmark::DoNotOptimize(&copy);
+    }
+    bench_util::set_throughput(state, request.ByteSizeLong());
+}
+BENCHMARK(BM_UniversalRequestCopy)->Apply(request_args);
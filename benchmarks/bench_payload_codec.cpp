@@ -0,0 +1,170 @@
+// payload 压缩：压缩率与每条消息耗时。默认使用合成的机器人状态 Dictionary（每条同一组 key），
+// 设置 PB_FLIGHT_DIR=<flightRecorder 目录> 时改用录制的 TopicMessage / UniversalRequest 负载。
+// 前 512 条用于训练 Zstd 字典，其余参与测量
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "benchAlloc.h"
+#include "flightRecorder.h"
+#include "payloadCodec.h"
+#include "common/variant.pb.h"
+
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::PB::communication;
+using namespace humanoid_robot::utils::PB;
+
+namespace
+{
+    constexpr std::size_t kTrainMessages = 512;
+    constexpr std::size_t kMaxMessages = 4096;
+
+    struct CodecVariant
+    {
+        const char *name;
+        PayloadCodec codec;
+        int level;
+        bool dictionary;
+    };
+
+    const CodecVariant kVariants[] = {
+        {"lz4", PAYLOAD_CODEC_LZ4, 0, false},
+        {"zstd-1", PAYLOAD_CODEC_ZSTD, 1, false},
+        {"zstd-3", PAYLOAD_CODEC_ZSTD, 3, false},
+        {"zstd-3+dict", PAYLOAD_CODEC_ZSTD, 3, true},
+    };
+
+    std::string robot_state(int sequence)
+    {
+        static const char *joints[] = {"left_hip_pitch", "left_hip_roll", "left_knee", "left_ankle_pitch",
+                                       "right_hip_pitch", "right_hip_roll", "right_knee", "right_ankle_pitch",
+                                       "left_shoulder_pitch", "left_elbow", "right_shoulder_pitch", "right_elbow"};
+        Dictionary dict;
+        auto &map = *dict.mutable_keyvaluelist();
+        for (int i = 0; i < 12; ++i)
+        {
+            const std::string joint = joints[i];
+            map[joint + ".position"].set_doublevalue(std::sin(sequence * 0.01 + i));
+            map[joint + ".velocity"].set_floatvalue(static_cast<float>(std::cos(sequence * 0.01 + i)));
+            map[joint + ".temperature"].set_int32value(40 + (sequence + i) % 3);
+        }
+        map["locomotion.mode"].set_stringvalue(sequence % 500 < 400 ? "walking" : "standing");
+        map["battery.percent"].set_floatvalue(87.5f - static_cast<float>(sequence) * 0.001f);
+        return dict.SerializeAsString();
+    }
+
+    const std::vector<std::string> &traffic()
+    {
+        static const std::vector<std::string> messages = []()
+        {
+            std::vector<std::string> out;
+            if (const char *dir = std::getenv("PB_FLIGHT_DIR"))
+            {
+                if (auto reader = FlightReader::open(dir))
+                {
+                    RecordView record;
+                    TopicMessage message;
+                    while (out.size() < kMaxMessages && reader->next(&record))
+                    {
+                        // 已压缩的负载不参与比较
+                        if (to_topic_message(record, &message) && message.payload_codec() == PAYLOAD_CODEC_NONE)
+                        {
+                            out.push_back(message.payload());
+                        }
+                    }
+                }
+            }
+            for (int i = 0; out.size() < kMaxMessages; ++i)
+            {
+                out.push_back(robot_state(i));
+            }
+            return out;
+        }();
+        return messages;
+    }
+
+    std::unique_ptr<PayloadCompressor> make_compressor(const CodecVariant &variant)
+    {
+        CodecOptions options;
+        options.codec = variant.codec;
+        options.zstd_level = variant.level;
+        auto compressor = std::make_unique<PayloadCompressor>(options);
+        if (variant.dictionary)
+        {
+            const std::vector<std::string> &messages = traffic();
+            std::vector<std::string> samples(messages.begin(), messages.begin() + kTrainMessages);
+            compressor->set_dictionary(ZstdDictionary::train(samples, 16 * 1024, variant.level));
+        }
+        return compressor;
+    }
+} // namespace
+
+static void BM_PayloadCompress(benchmark::State &state)
+{
+    const CodecVariant &variant = kVariants[state.range(0)];
+    state.SetLabel(variant.name);
+    if (!codec_available(variant.codec))
+    {
+        state.SkipWithError("codec not compiled in");
+        return;
+    }
+    const std::vector<std::string> &messages = traffic();
+    auto compressor = make_compressor(variant);
+    std::string wire;
+    std::size_t index = kTrainMessages;
+    std::size_t raw_bytes = 0;
+    std::size_t wire_bytes = 0;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        const std::string &raw = messages[index];
+        compressor->compress(raw, &wire);
+        raw_bytes += raw.size();
+        wire_bytes += wire.size();
+        index = index + 1 < messages.size() ? index + 1 : kTrainMessages;
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(raw_bytes));
+    state.SetItemsProcessed(state.iterations());
+    state.counters["ratio"] = raw_bytes == 0 ? 0.0 : static_cast<double>(wire_bytes) / static_cast<double>(raw_bytes);
+    state.counters["raw_bytes"] = static_cast<double>(raw_bytes) / static_cast<double>(state.iterations());
+    state.counters["wire_bytes"] = static_cast<double>(wire_bytes) / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_PayloadCompress)->DenseRange(0, 3)->Unit(benchmark::kMicrosecond);
+
+static void BM_PayloadDecompress(benchmark::State &state)
+{
+    const CodecVariant &variant = kVariants[state.range(0)];
+    state.SetLabel(variant.name);
+    if (!codec_available(variant.codec))
+    {
+        state.SkipWithError("codec not compiled in");
+        return;
+    }
+    const std::vector<std::string> &messages = traffic();
+    auto compressor = make_compressor(variant);
+    PayloadDecompressor decompressor;
+    decompressor.add_dictionary(compressor->dictionary());
+    std::vector<std::pair<PayloadCodec, std::string>> wires;
+    std::size_t raw_bytes = 0;
+    for (std::size_t i = kTrainMessages; i < messages.size(); ++i)
+    {
+        std::string wire;
+        const PayloadCodec codec = compressor->compress(messages[i], &wire);
+        wires.emplace_back(codec, std::move(wire));
+    }
+
+    std::string out;
+    std::size_t index = 0;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        decompressor.decompress(wires[index].first, wires[index].second, &out);
+        raw_bytes += out.size();
+        index = index + 1 < wires.size() ? index + 1 : 0;
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(raw_bytes));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PayloadDecompress)->DenseRange(0, 3)->Unit(benchmark::kMicrosecond);
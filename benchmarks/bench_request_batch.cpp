@@ -0,0 +1,82 @@
+// sendRequest 批量复用：64 条 48 字节遥测请求逐条发送 vs 合并为一个批量信封
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "benchAlloc.h"
+#include "requestBatch.h"
+
+using namespace humanoid_robot::PB::communication;
+using namespace humanoid_robot::utils::PB;
+
+namespace
+{
+    constexpr int kRequests = 64;
+
+    std::vector<UniversalRequest> make_requests()
+    {
+        std::vector<UniversalRequest> requests(kRequests);
+        for (int i = 0; i < kRequests; ++i)
+        {
+            UniversalRequest &request = requests[static_cast<std::size_t>(i)];
+            request.set_command(30001 + i % 4);
+            request.set_version(1);
+            request.set_requestid(100000 + i);
+            request.set_sendrequesttimestamp(1705123456789LL + i);
+            request.set_checksum(0x1234 + i);
+            request.set_payload(std::string(48, static_cast<char>('a' + i % 26)));
+            request.set_payloadtype(3);
+            request.set_payloadsize(48);
+        }
+        return requests;
+    }
+} // namespace
+
+// 逐条发送：每条请求单独序列化成一帧，服务端逐条解析（不含 gRPC 每帧开销）
+static void BM_RequestsSingleFrames(benchmark::State &state)
+{
+    const std::vector<UniversalRequest> requests = make_requests();
+    std::string out;
+    std::size_t wire = 0;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        wire = 0;
+        for (const auto &request : requests)
+        {
+            request.SerializeToString(&out);
+            wire += out.size();
+            UniversalRequest received;
+            received.ParseFromString(out);
+            benchmark::DoNotOptimize(&received);
+        }
+    }
+    bench_util::set_throughput(state, wire, kRequests);
+    state.counters["frames"] = kRequests;
+    state.counters["wire_bytes"] = static_cast<double>(wire);
+}
+BENCHMARK(BM_RequestsSingleFrames);
+
+// 合并发送：打包为信封后序列化，服务端拆包
+static void BM_RequestsBatchRoundtrip(benchmark::State &state)
+{
+    const std::vector<UniversalRequest> requests = make_requests();
+    std::string out;
+    std::vector<UniversalRequest> unpacked;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        UniversalRequest envelope;
+        pack_batch(requests, &envelope);
+        envelope.SerializeToString(&out);
+
+        UniversalRequest received;
+        received.ParseFromString(out);
+        unpacked.clear();
+        unpack_batch(received, &unpacked);
+        benchmark::DoNotOptimize(unpacked.data());
+    }
+    bench_util::set_throughput(state, out.size(), kRequests);
+    state.counters["frames"] = 1;
+    state.counters["wire_bytes"] = static_cast<double>(out.size());
+}
+BENCHMARK(BM_RequestsBatchRoundtrip);
@@ -0,0 +1,117 @@
+// 感知结果编码对比：repeated PerceptionRow vs RowColumns 列式编码（200 个检测结果）
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "common/variant.pb.h"
+#include "perception/perception_request_response.pb.h"
+#include "rowColumns.h"
+
+using namespace humanoid_robot::PB::common;
+using humanoid_robot::PB::perception::Perception;
+using namespace humanoid_robot::utils::PB;
+
+namespace
+{
+    constexpr int kRows = 200;
+
+    google::protobuf::RepeatedPtrField<PerceptionRow> make_rows()
+    {
+        const char *classes[] = {"person", "car", "bicycle", "dog"};
+        google::protobuf::RepeatedPtrField<PerceptionRow> rows;
+        for (int i = 0; i < kRows; ++i)
+        {
+            PerceptionRow *row = rows.Add();
+            row->mutable_bbox()->set_x1(static_cast<float>(i % 40) * 48.0f);
+            row->mutable_bbox()->set_y1(static_cast<float>(i / 40) * 200.0f);
+            row->mutable_bbox()->set_x2(static_cast<float>(i % 40) * 48.0f + 40.0f);
+            row->mutable_bbox()->set_y2(static_cast<float>(i / 40) * 200.0f + 120.0f);
+            row->set_conf(static_cast<float>(i % 100) / 100.0f);
+            row->set_cls(classes[i % 4]);
+            row->set_trackid("track_" + std::to_string(i));
+            row->set_ismove(i % 3 == 0);
+        }
+        return rows;
+    }
+} // namespace
+
+// 行式：每行一个 PerceptionRow + BBox 子消息 + 两个 string
+static void BM_RowsParse(benchmark::State &state)
+{
+    Perception perception;
+    *perception.mutable_rows() = make_rows();
+    const std::string wire = perception.SerializeAsString();
+    for (auto _ : state)
+    {
+        Perception parsed;
+        parsed.ParseFromString(wire);
+        benchmark::DoNotOptimize(parsed.rows_size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * kRows);
+    state.counters["wire_bytes"] = static_cast<double>(wire.size());
+}
+BENCHMARK(BM_RowsParse);
+
+// 列式：固定数量的连续数组 + 字典
+static void BM_ColumnsParse(benchmark::State &state)
+{
+    Perception perception;
+    to_columns(make_rows(), perception.mutable_columns());
+    const std::string wire = perception.SerializeAsString();
+    for (auto _ : state)
+    {
+        Perception parsed;
+        parsed.ParseFromString(wire);
+        benchmark::DoNotOptimize(parsed.columns().count());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * kRows);
+    state.counters["wire_bytes"] = static_cast<double>(wire.size());
+}
+BENCHMARK(BM_ColumnsParse);
+
+static void BM_RowsConfidenceFilter(benchmark::State &state)
+{
+    const google::protobuf::RepeatedPtrField<PerceptionRow> rows = make_rows();
+    std::vector<uint32_t> kept;
+    for (auto _ : state)
+    {
+        kept.clear();
+        for (int i = 0; i < rows.size(); ++i)
+        {
+            if (rows.Get(i).conf() >= 0.5f)
+            {
+                kept.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        benchmark::DoNotOptimize(kept.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * kRows);
+}
+BENCHMARK(BM_RowsConfidenceFilter);
+
+static void BM_ColumnsConfidenceFilter(benchmark::State &state)
+{
+    RowColumns columns;
+    to_columns(make_rows(), &columns);
+    std::vector<uint32_t> kept;
+    for (auto _ : state)
+    {
+        select_by_confidence(columns, 0.5f, &kept);
+        benchmark::DoNotOptimize(kept.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * kRows);
+}
+BENCHMARK(BM_ColumnsConfidenceFilter);
+
+static void BM_ColumnsIoU(benchmark::State &state)
+{
+    RowColumns columns;
+    to_columns(make_rows(), &columns);
+    std::vector<float> iou(columns.count());
+    for (auto _ : state)
+    {
+        iou_with_box(columns, 100.0f, 0.0f, 140.0f, 120.0f, iou.data());
+        benchmark::DoNotOptimize(iou.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * kRows);
+}
+BENCHMARK(BM_ColumnsIoU);
@@ -0,0 +1,108 @@
+// 消息跟踪的生产者开销：TraceSink 异步入队 vs 在调用线程同步格式化并写文件
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <benchmark/benchmark.h>
+#include "benchAlloc.h"
+#include "common/variant.pb.h"
+#include "traceSink.h"
+
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::utils::PB;
+
+namespace
+{
+    constexpr std::size_t kRingCapacity = 4096;
+
+    // 典型的 InterfaceService 请求参数
+    std::shared_ptr<const Dictionary> make_params()
+    {
+        auto dict = std::make_shared<Dictionary>();
+        auto *map = dict->mutable_keyvaluelist();
+        (*map)["timeout"].set_int32value(500);
+        (*map)["resource_name"].set_stringvalue("left_arm_controller");
+        (*map)["speed"].set_doublevalue(0.35);
+        auto *joints = (*map)["joints"].mutable_doublearrayvalue();
+        for (int i = 0; i < 7; ++i)
+        {
+            joints->add_values(i * 0.1);
+        }
+        return dict;
+    }
+} // namespace
+
+// 已持有快照引用时的入队开销
+static void BM_TraceSinkEnqueue(benchmark::State &state)
+{
+    TraceOptions options;
+    options.path = "/dev/null";
+    options.ring_capacity = kRingCapacity;
+    TraceSink sink(options);
+    sink.start();
+    const auto params = make_params();
+    bench_util::AllocationCounter allocs(state);
+    std::size_t queued = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(sink.trace("SendRequest", params));
+        if (++queued == kRingCapacity)
+        {
+            // 只测入队路径：队列满前暂停计时，等后台线程排空
+            state.PauseTiming();
+            sink.flush();
+            queued = 0;
+            state.ResumeTiming();
+        }
+    }
+    state.counters["dropped"] = static_cast<double>(sink.dropped());
+    bench_util::set_throughput(state, 0);
+}
+BENCHMARK(BM_TraceSinkEnqueue);
+
+// 只拿得到 const 引用时：拷贝快照 + 入队
+static void BM_TraceSinkCopyEnqueue(benchmark::State &state)
+{
+    TraceOptions options;
+    options.path = "/dev/null";
+    options.ring_capacity = kRingCapacity;
+    TraceSink sink(options);
+    sink.start();
+    const auto params = make_params();
+    bench_util::AllocationCounter allocs(state);
+    std::size_t queued = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(sink.trace_copy("SendRequest", *params));
+        if (++queued == kRingCapacity)
+        {
+            // 只测入队路径：队列满前暂停计时，等后台线程排空
+            state.PauseTiming();
+            sink.flush();
+            queued = 0;
+            state.ResumeTiming();
+        }
+    }
+    state.counters["dropped"] = static_cast<double>(sink.dropped());
+    bench_util::set_throughput(state, 0);
+}
+BENCHMARK(BM_TraceSinkCopyEnqueue);
+
+// 对比：在调用线程格式化并逐条写文件
+static void BM_TraceSynchronous(benchmark::State &state)
+{
+    std::FILE *file = std::fopen("/dev/null", "a");
+    const auto params = make_params();
+    std::string line;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        line.assign("SendRequest ");
+        format_message(*params, &line);
+        line.push_back('\n');
+        std::fwrite(line.data(), 1, line.size(), file);
+        std::fflush(file);
+    }
+    std::fclose(file);
+    bench_util::set_throughput(state, line.size());
+}
+BENCHMARK(BM_TraceSynchronous);
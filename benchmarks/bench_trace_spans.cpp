@@ -0,0 +1,137 @@
+// 端到端延迟追踪的开销：每个阶段记录 span / 追加 TraceHop 的耗时，以及 TraceContext 带来的额外字节
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "benchAlloc.h"
+#include "spanTracer.h"
+#include "communication/topic_service.pb.h"
+
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::PB::communication;
+using namespace humanoid_robot::utils::PB;
+
+namespace
+{
+    // 每 1024 条排空一次，模拟导出方定期取走 span
+    constexpr int kDrainEvery = 1024;
+} // namespace
+
+// 单条 span 写入本线程队列（不含排空）
+static void BM_SpanRecord(benchmark::State &state)
+{
+    SpanTracer tracer(kDrainEvery);
+    std::vector<SpanRecord> spans;
+    spans.reserve(kDrainEvery);
+    int pending = 0;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        const uint64_t now = trace_clock_ns();
+        benchmark::DoNotOptimize(tracer.record("perception", 42, now, now + 1000));
+        if (++pending == kDrainEvery)
+        {
+            state.PauseTiming();
+            spans.clear();
+            tracer.drain(&spans);
+            pending = 0;
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SpanRecord);
+
+// 一帧经过 采集 → 传输 → 感知 → 规划：HopScope 追加 4 个 TraceHop 并记录 span
+static void BM_HopScopePipeline(benchmark::State &state)
+{
+    SpanTracer tracer(kDrainEvery * 4);
+    std::vector<SpanRecord> spans;
+    TraceContext context;
+    int pending = 0;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        context.Clear();
+        start_trace(&context);
+        {
+            HopScope hop(&context, TRACE_STAGE_CAPTURE, &tracer);
+        }
+        {
+            HopScope hop(&context, TRACE_STAGE_TRANSPORT, &tracer);
+        }
+        {
+            HopScope hop(&context, TRACE_STAGE_PERCEPTION, &tracer);
+        }
+        {
+            HopScope hop(&context, TRACE_STAGE_PLANNER, &tracer);
+        }
+        benchmark::DoNotOptimize(end_to_end_ns(context));
+        if (++pending == kDrainEvery)
+        {
+            state.PauseTiming();
+            spans.clear();
+            tracer.drain(&spans);
+            pending = 0;
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HopScopePipeline);
+
+// TopicMessage 带 / 不带 4 个阶段的 TraceContext 的序列化与解析
+static void BM_TopicMessageTraced(benchmark::State &state)
+{
+    const bool traced = state.range(0) != 0;
+    TopicMessage message;
+    message.set_name_id(3);
+    message.set_sequence(1000);
+    message.set_timestamp(1705123456789ULL);
+    message.set_payload(std::string(256, 'm'));
+    if (traced)
+    {
+        TraceContext *context = message.mutable_trace();
+        start_trace(context);
+        uint64_t now = trace_clock_ns();
+        for (TraceStage stage : {TRACE_STAGE_CAPTURE, TRACE_STAGE_TRANSPORT, TRACE_STAGE_PERCEPTION, TRACE_STAGE_PLANNER})
+        {
+            add_hop(context, stage, now, now + 250000);
+            now += 300000;
+        }
+    }
+    std::string wire;
+    TopicMessage received;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        message.SerializeToString(&wire);
+        received.ParseFromString(wire);
+        benchmark::DoNotOptimize(received.trace().hops_size());
+    }
+    bench_util::set_throughput(state, wire.size(), 1);
+    state.counters["wire_bytes"] = static_cast<double>(wire.size());
+    state.counters["trace_bytes"] = static_cast<double>(message.trace().ByteSizeLong());
+}
+BENCHMARK(BM_TopicMessageTraced)->Arg(0)->Arg(1);
+
+// 4096 条 span 导出为 Chrome trace JSON
+static void BM_ChromeTraceExport(benchmark::State &state)
+{
+    std::vector<SpanRecord> spans(4096);
+    uint64_t now = trace_clock_ns();
+    for (std::size_t i = 0; i < spans.size(); ++i)
+    {
+        spans[i] = {"perception", i + 1, now, 123456, static_cast<uint32_t>(i % 4 + 1)};
+        now += 200000;
+    }
+    std::string json;
+    for (auto _ : state)
+    {
+        json.clear();
+        format_chrome_trace(spans, &json);
+        benchmark::DoNotOptimize(json.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * json.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * spans.size()));
+}
+BENCHMARK(BM_ChromeTraceExport)->Unit(benchmark::kMicrosecond);
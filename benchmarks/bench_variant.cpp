@@ -0,0 +1,292 @@
+// Variant / Dictionary 序列化基准：Variant 的每个 oneof 分支分别测试 Serialize/Parse/ByteSizeLong/Copy，
+// 分支通过反射枚举，variant.proto 新增类型后自动纳入
+#include <memory>
+#include <string>
+#include <benchmark/benchmark.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/reflection.h>
+#include "benchAlloc.h"
+#include "common/variant.pb.h"
+
+using namespace humanoid_robot::PB::common;
+using google::protobuf::FieldDescriptor;
+using google::protobuf::Message;
+using google::protobuf::Reflection;
+
+namespace
+{
+    constexpr int kRepeatedElements = 16; // 数组类字段的元素个数
+    constexpr int kMaxFillDepth = 3;      // 嵌套消息填充深度
+
+    void fill_message(Message *message, int depth);
+
+    // 为单个字段（或 repeated 字段的一个元素）写入样本值
+    void fill_field(Message *message, const FieldDescriptor *field, int index, int depth)
+    {
+        const Reflection *reflection = message->GetReflection();
+        const bool repeated = field->is_repeated();
+        const int seed = 1000 + index * 37;
+
+        switch (field->cpp_type())
+        {
+        case FieldDescriptor::CPPTYPE_BOOL:
+            repeated ? reflection->AddBool(message, field, index % 2 == 0) : reflection->SetBool(message, field, true);
+            break;
+        case FieldDescriptor::CPPTYPE_INT32:
+            repeated ? reflection->AddInt32(message, field, seed) : reflection->SetInt32(message, field, 120);
+            break;
+        case FieldDescriptor::CPPTYPE_UINT32:
+            repeated ? reflection->AddUInt32(message, field, seed) : reflection->SetUInt32(message, field, 200);
+            break;
+        case FieldDescriptor::CPPTYPE_INT64:
+            repeated ? reflection->AddInt64(message, field, 1705123456789LL + seed)
+                     : reflection->SetInt64(message, field, 1705123456789LL);
+            break;
+        case FieldDescriptor::CPPTYPE_UINT64:
+            repeated ? reflection->AddUInt64(message, field, 1705123456789ULL + seed)
+                     : reflection->SetUInt64(message, field, 1705123456789ULL);
+            break;
+        case FieldDescriptor::CPPTYPE_FLOAT:
+            repeated ? reflection->AddFloat(message, field, 0.5f * seed) : reflection->SetFloat(message, field, 3.14f);
+            break;
+        case FieldDescriptor::CPPTYPE_DOUBLE:
+            repeated ? reflection->AddDouble(message, field, 0.25 * seed) : reflection->SetDouble(message, field, 2.718281828);
+            break;
+        case FieldDescriptor::CPPTYPE_ENUM:
+            repeated ? reflection->AddEnumValue(message, field, 0) : reflection->SetEnumValue(message, field, 0);
+            break;
+        case FieldDescriptor::CPPTYPE_STRING:
+        {
+            // bytes 字段给 64 字节，string 字段给 16 字节
+            std::string value(field->type() == FieldDescriptor::TYPE_BYTES ? 64 : 16, static_cast<char>('a' + index % 26));
+            repeated ? reflection->AddString(message, field, value) : reflection->SetString(message, field, value);
+            break;
+        }
+        case FieldDescriptor::CPPTYPE_MESSAGE:
+        {
+            if (field->is_map())
+            {
+                Message *entry = reflection->AddMessage(message, field);
+                const FieldDescriptor *key = entry->GetDescriptor()->map_key();
+                entry->GetReflection()->SetString(entry, key, "key_" + std::to_string(index));
+                fill_message(entry->GetReflection()->MutableMessage(entry, entry->GetDescriptor()->map_value()), depth + 1);
+                break;
+            }
+            Message *child = repeated ? reflection->AddMessage(message, field) : reflection->MutableMessage(message, field);
+            fill_message(child, depth + 1);
+            break;
+        }
+        }
+    }
+
+    // 递归填充全部字段；oneof 只填第一个分支，避免 Dictionary ↔ Variant 无限展开
+    void fill_message(Message *message, int depth)
+    {
+        if (depth > kMaxFillDepth)
+        {
+            return;
+        }
+        const auto *descriptor = message->GetDescriptor();
+        for (int i = 0; i < descriptor->field_count(); ++i)
+        {
+            const FieldDescriptor *field = descriptor->field(i);
+            if (field->containing_oneof() != nullptr && field->index_in_oneof() != 0)
+            {
+                continue;
+            }
+            if (field->is_map())
+            {
+                // map 的值可能继续嵌套 Dictionary，深度越大条目越少
+                for (int k = 0; k < 4 - depth; ++k)
+                {
+                    fill_field(message, field, k, depth);
+                }
+            }
+            else if (field->is_repeated())
+            {
+                for (int k = 0; k < kRepeatedElements; ++k)
+                {
+                    fill_field(message, field, k, depth);
+                }
+            }
+            else
+            {
+                fill_field(message, field, 0, depth);
+            }
+        }
+    }
+
+    std::shared_ptr<const Variant> make_variant(const FieldDescriptor *field)
+    {
+        auto variant = std::make_shared<Variant>();
+        if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE)
+        {
+            fill_message(variant->GetReflection()->MutableMessage(variant.get(), field), 1);
+        }
+        else
+        {
+            fill_field(variant.get(), field, 0, 1);
+        }
+        return variant;
+    }
+
+    void variant_serialize(benchmark::State &state, std::shared_ptr<const Variant> variant)
+    {
+        std::string out;
+        bench_util::AllocationCounter allocs(state);
+        for (auto _ : state)
+        {
+            variant->SerializeToString(&out);
+            benchmark::DoNotOptimize(out.data());
+        }
+        bench_util::set_throughput(state, out.size());
+    }
+
+    void variant_parse(benchmark::State &state, std::shared_ptr<const Variant> variant)
+    {
+        const std::string wire = variant->SerializeAsString();
+        Variant parsed;
+        bench_util::AllocationCounter allocs(state);
+        for (auto _ : state)
+        {
+            parsed.ParseFromString(wire);
+            benchmark::DoNotOptimize(&parsed);
+        }
+        bench_util::set_throughput(state, wire.size());
+    }
+
+    void variant_byte_size(benchmark::State &state, std::shared_ptr<const Variant> variant)
+    {
+        const std::size_t size = variant->ByteSizeLong();
+        bench_util::AllocationCounter allocs(state);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(variant->ByteSizeLong());
+        }
+        bench_util::set_throughput(state, size);
+    }
+
+    void variant_copy(benchmark::State &state, std::shared_ptr<const Variant> variant)
+    {
+        bench_util::AllocationCounter allocs(state);
+        for (auto _ : state)
+        {
+            Variant copy(*variant);
+            benchmark::DoNotOptimize(&copy);
+        }
+        bench_util::set_throughput(state, variant->ByteSizeLong());
+    }
+
+    int register_variant_benchmarks()
+    {
+        const auto *oneof = Variant::descriptor()->FindOneofByName("value");
+        for (int i = 0; i < oneof->field_count(); ++i)
+        {
+            const FieldDescriptor *field = oneof->field(i);
+            auto variant = make_variant(field);
+            benchmark::RegisterBenchmark(("BM_VariantSerialize/" + field->name()).c_str(), variant_serialize, variant);
+            benchmark::RegisterBenchmark(("BM_VariantParse/" + field->name()).c_str(), variant_parse, variant);
+            benchmark::RegisterBenchmark(("BM_VariantByteSize/" + field->name()).c_str(), variant_byte_size, variant);
+            benchmark::RegisterBenchmark(("BM_VariantCopy/" + field->name()).c_str(), variant_copy, variant);
+        }
+        return oneof->field_count();
+    }
+
+    const int kRegisteredVariantCases = register_variant_benchmarks();
+
+    // 深度为 depth 的嵌套字典：每层 8 个标量条目 + 2 个子字典
+    void build_dictionary(Dictionary *dict, int depth)
+    {
+        auto *map = dict->mutable_keyvaluelist();
+        for (int i = 0; i < 8; ++i)
+        {
+            Variant &value = (*map)["field_" + std::to_string(i)];
+            switch (i % 4)
+            {
+            case 0:
+                value.set_int32value(i * 1000);
+                break;
+            case 1:
+                value.set_doublevalue(i * 0.125);
+                break;
+            case 2:
+                value.set_stringvalue("value_" + std::to_string(i));
+                break;
+            default:
+                value.set_boolvalue(true);
+                break;
+            }
+        }
+        if (depth > 1)
+        {
+            for (int i = 0; i < 2; ++i)
+            {
+                build_dictionary((*map)["child_" + std::to_string(i)].mutable_dictvalue(), depth - 1);
+            }
+        }
+    }
+
+    std::size_t dictionary_entries(int depth)
+    {
+        return depth <= 1 ? 8 : 10 + 2 * dictionary_entries(depth - 1);
+    }
+} // namespace
+
+static void BM_DictionarySerialize(benchmark::State &state)
+{
+    Dictionary dict;
+    build_dictionary(&dict, static_cast<int>(state.range(0)));
+    std::string out;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        dict.SerializeToString(&out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    bench_util::set_throughput(state, out.size(), dictionary_entries(static_cast<int>(state.range(0))));
+}
+BENCHMARK(BM_DictionarySerialize)->DenseRange(1, 4);
+
+static void BM_DictionaryParse(benchmark::State &state)
+{
+    Dictionary dict;
+    build_dictionary(&dict, static_cast<int>(state.range(0)));
+    const std::string wire = dict.SerializeAsString();
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        Dictionary parsed;
+        parsed.ParseFromString(wire);
+        benchmark::DoNotOptimize(&parsed);
+    }
+    bench_util::set_throughput(state, wire.size(), dictionary_entries(static_cast<int>(state.range(0))));
+}
+BENCHMARK(BM_DictionaryParse)->DenseRange(1, 4);
+
+static void BM_DictionaryByteSize(benchmark::State &state)
+{
+    Dictionary dict;
+    build_dictionary(&dict, static_cast<int>(state.range(0)));
+    const std::size_t size = dict.ByteSizeLong();
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(dict.ByteSizeLong());
+    }
+    bench_util::set_throughput(state, size, dictionary_entries(static_cast<int>(state.range(0))));
+}
+BENCHMARK(BM_DictionaryByteSize)->DenseRange(1, 4);
+
+static void BM_DictionaryCopy(benchmark::State &state)
+{
+    Dictionary dict;
+    build_dictionary(&dict, static_cast<int>(state.range(0)));
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        Dictionary copy(dict);
+        benchmark::DoNotOptimize(&copy);
+    }
+    bench_util::set_throughput(state, dict.ByteSizeLong(), dictionary_entries(static_cast<int>(state.range(0))));
+}
+BENCHMARK(BM_DictionaryCopy)->DenseRange(1, 4);
@@ -0,0 +1,112 @@
+// 日志格式化：variantFormatter 追加到复用缓冲区 vs protobuf 自带的 ShortDebugString / JSON 转换
+#include <string>
+#include <benchmark/benchmark.h>
+#include <google/protobuf/util/json_util.h>
+#include "benchAlloc.h"
+#include "common/variant.pb.h"
+#include "variantFormatter.h"
+
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::utils::PB;
+
+namespace
+{
+    // 典型的 interfaces 参数字典：标量 + 一个 200 元素的关节数组，depth 层嵌套
+    Dictionary make_dictionary(int depth)
+    {
+        Dictionary dict;
+        auto *map = dict.mutable_keyvaluelist();
+        (*map)["timeout"].set_int32value(500);
+        (*map)["resource_name"].set_stringvalue("left_arm_controller");
+        (*map)["speed"].set_doublevalue(0.35);
+        (*map)["enabled"].set_boolvalue(true);
+        auto *joints = (*map)["joints"].mutable_doublearrayvalue();
+        for (int i = 0; i < 200; ++i)
+        {
+            joints->add_values(i * 0.01);
+        }
+        if (depth > 1)
+        {
+            *(*map)["child"].mutable_dictvalue() = make_dictionary(depth - 1);
+        }
+        return dict;
+    }
+} // namespace
+
+static void BM_FormatDictionaryText(benchmark::State &state)
+{
+    const Dictionary dict = make_dictionary(static_cast<int>(state.range(0)));
+    std::string out;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        out.clear();
+        format_dictionary(dict, &out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    bench_util::set_throughput(state, out.size());
+}
+BENCHMARK(BM_FormatDictionaryText)->DenseRange(1, 4)->ArgName("depth");
+
+static void BM_FormatDictionaryJson(benchmark::State &state)
+{
+    const Dictionary dict = make_dictionary(static_cast<int>(state.range(0)));
+    FormatOptions options;
+    options.style = FormatStyle::kJson;
+    std::string out;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        out.clear();
+        format_dictionary(dict, &out, options);
+        benchmark::DoNotOptimize(out.data());
+    }
+    bench_util::set_throughput(state, out.size());
+}
+BENCHMARK(BM_FormatDictionaryJson)->DenseRange(1, 4)->ArgName("depth");
+
+// 定长日志缓冲区，超长部分截断
+static void BM_FormatDictionaryFixedBuffer(benchmark::State &state)
+{
+    Variant variant;
+    *variant.mutable_dictvalue() = make_dictionary(static_cast<int>(state.range(0)));
+    char buffer[512];
+    std::size_t written = 0;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        written = format_variant(variant, buffer, sizeof(buffer));
+        benchmark::DoNotOptimize(buffer);
+    }
+    bench_util::set_throughput(state, written);
+}
+BENCHMARK(BM_FormatDictionaryFixedBuffer)->DenseRange(1, 4)->ArgName("depth");
+
+static void BM_ShortDebugString(benchmark::State &state)
+{
+    const Dictionary dict = make_dictionary(static_cast<int>(state.range(0)));
+    std::string out;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        out = dict.ShortDebugString();
+        benchmark::DoNotOptimize(out.data());
+    }
+    bench_util::set_throughput(state, out.size());
+}
+BENCHMARK(BM_ShortDebugString)->DenseRange(1, 4)->ArgName("depth");
+
+static void BM_MessageToJsonString(benchmark::State &state)
+{
+    const Dictionary dict = make_dictionary(static_cast<int>(state.range(0)));
+    std::string out;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        out.clear();
+        google::protobuf::util::MessageToJsonString(dict, &out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    bench_util::set_throughput(state, out.size());
+}
+BENCHMARK(BM_MessageToJsonString)->DenseRange(1, 4)->ArgName("depth");
@@ -0,0 +1,118 @@
+// 变化检测：结构哈希 / 深度比较 vs 确定性序列化后比较
+#include <string>
+#include <benchmark/benchmark.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include "benchAlloc.h"
+#include "common/variant.pb.h"
+#include "variantHash.h"
+
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::utils::PB;
+
+namespace
+{
+    // 200 个关节值 + 一段 4096 点的浮点数组 + 嵌套字典
+    Dictionary make_state()
+    {
+        Dictionary dict;
+        auto &map = *dict.mutable_keyvaluelist();
+        for (int i = 0; i < 200; ++i)
+        {
+            map["joint_" + std::to_string(i)].set_doublevalue(i * 0.1);
+        }
+        auto *scan = map["scan"].mutable_floatarrayvalue();
+        for (int i = 0; i < 4096; ++i)
+        {
+            scan->add_values(i * 0.01f);
+        }
+        auto &nested = *map["arm"].mutable_dictvalue()->mutable_keyvaluelist();
+        nested["temperature"].set_floatvalue(40.0f);
+        nested["mode"].set_stringvalue("idle");
+        return dict;
+    }
+
+    void serialize_deterministic(const Dictionary &dict, std::string *out)
+    {
+        out->clear();
+        google::protobuf::io::StringOutputStream stream(out);
+        google::protobuf::io::CodedOutputStream coded(&stream);
+        coded.SetSerializationDeterministic(true);
+        dict.SerializePartialToCodedStream(&coded);
+    }
+} // namespace
+
+static void BM_HashDictionary(benchmark::State &state)
+{
+    const Dictionary dict = make_state();
+    const std::size_t bytes = dict.ByteSizeLong();
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(hash_dictionary(dict));
+    }
+    bench_util::set_throughput(state, bytes);
+}
+BENCHMARK(BM_HashDictionary);
+
+static void BM_DictionaryEqual(benchmark::State &state)
+{
+    const Dictionary a = make_state();
+    const Dictionary b = make_state();
+    const std::size_t bytes = a.ByteSizeLong();
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(dictionary_equal(a, b));
+    }
+    bench_util::set_throughput(state, bytes);
+}
+BENCHMARK(BM_DictionaryEqual);
+
+// 对比：两侧确定性序列化后比较字节
+static void BM_SerializeCompare(benchmark::State &state)
+{
+    const Dictionary a = make_state();
+    const Dictionary b = make_state();
+    const std::size_t bytes = a.ByteSizeLong();
+    std::string wire_a, wire_b;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        serialize_deterministic(a, &wire_a);
+        serialize_deterministic(b, &wire_b);
+        benchmark::DoNotOptimize(wire_a == wire_b);
+    }
+    bench_util::set_throughput(state, bytes);
+}
+BENCHMARK(BM_SerializeCompare);
+
+// 单个 key 变化后的增量哈希
+static void BM_IncrementalHash(benchmark::State &state)
+{
+    const Dictionary dict = make_state();
+    DictionaryHash cache;
+    cache.reset(dict);
+    Variant value;
+    double x = 0;
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        value.set_doublevalue(x += 1.0);
+        cache.set("joint_7", value);
+        benchmark::DoNotOptimize(cache.value());
+    }
+}
+BENCHMARK(BM_IncrementalHash);
+
+// 原始字节吞吐
+static void BM_HashBytes(benchmark::State &state)
+{
+    const std::string data(static_cast<std::size_t>(state.range(0)), 'x');
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(hash_bytes(data));
+    }
+    bench_util::set_throughput(state, data.size());
+}
+BENCHMARK(BM_HashBytes)->Arg(64)->Arg(4096)->Arg(1 << 20);
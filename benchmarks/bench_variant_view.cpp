@@ -0,0 +1,97 @@
+// 路由节点只读取 1~2 个 key：VariantView 直接在线格式上查找 vs 完整 ParseFromString 后查 map
+#include <string>
+#include <benchmark/benchmark.h>
+#include "benchAlloc.h"
+#include "common/variant.pb.h"
+#include "variantView.h"
+
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::utils::PB;
+
+namespace
+{
+    // 约 200 个 key 的机器人状态字典，含若干数组和嵌套字典
+    std::string make_state_bytes()
+    {
+        Dictionary dict;
+        auto &map = *dict.mutable_keyvaluelist();
+        for (int i = 0; i < 200; ++i)
+        {
+            const std::string key = "joint_" + std::to_string(i);
+            switch (i % 4)
+            {
+            case 0:
+                map[key].set_doublevalue(i * 0.01);
+                break;
+            case 1:
+                map[key].set_stringvalue("state_" + std::to_string(i));
+                break;
+            case 2:
+            {
+                auto *values = map[key].mutable_floatarrayvalue();
+                for (int j = 0; j < 16; ++j)
+                {
+                    values->add_values(static_cast<float>(j));
+                }
+                break;
+            }
+            default:
+            {
+                auto &nested = *map[key].mutable_dictvalue()->mutable_keyvaluelist();
+                nested["temperature"].set_floatvalue(40.0f);
+                nested["current"].set_floatvalue(1.2f);
+                break;
+            }
+            }
+        }
+        map["mode"].set_int32value(3);
+        return dict.SerializeAsString();
+    }
+} // namespace
+
+static void BM_DictionaryViewFind(benchmark::State &state)
+{
+    const std::string bytes = make_state_bytes();
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        VariantView value;
+        int64_t mode = 0;
+        DictionaryView(bytes).find("mode", &value) && value.as_int64(&mode);
+        benchmark::DoNotOptimize(mode);
+    }
+    bench_util::set_throughput(state, bytes.size());
+}
+BENCHMARK(BM_DictionaryViewFind);
+
+static void BM_DictionaryParseFind(benchmark::State &state)
+{
+    const std::string bytes = make_state_bytes();
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        Dictionary dict;
+        dict.ParseFromString(bytes);
+        auto it = dict.keyvaluelist().find("mode");
+        int32_t mode = it != dict.keyvaluelist().end() ? it->second.int32value() : 0;
+        benchmark::DoNotOptimize(mode);
+    }
+    bench_util::set_throughput(state, bytes.size());
+}
+BENCHMARK(BM_DictionaryParseFind);
+
+// 完整遍历：所有 key 的类型统计
+static void BM_DictionaryViewIterate(benchmark::State &state)
+{
+    const std::string bytes = make_state_bytes();
+    bench_util::AllocationCounter allocs(state);
+    for (auto _ : state)
+    {
+        std::size_t dictionaries = 0;
+        DictionaryView(bytes).for_each([&](std::string_view, const VariantView &value)
+                                       { dictionaries += value.value_case() == Variant::kDictValue; return true; });
+        benchmark::DoNotOptimize(dictionaries);
+    }
+    bench_util::set_throughput(state, bytes.size());
+}
+BENCHMARK(BM_DictionaryViewIterate);
@@ -0,0 +1,47 @@
+#!/bin/bash
+
+# 完整版与 PB_LITE 版对比：二进制体积（可执行文件 + 实际加载的 PB / protobuf / gRPC 动态库）与启动耗时
+# 用法: ./compare_lite.sh <probe 所在目录> [运行次数]
+# 需先以 -DPB_LITE=ON -DBUILD_PB_BENCHMARKS=ON 构建 PB_startup_full 与 PB_startup_lite
+
+set -e
+
+BIN_DIR="${1:-.}"
+RUNS="${2:-50}"
+
+if [ ! -x "$BIN_DIR/PB_startup_full" ] || [ ! -x "$BIN_DIR/PB_startup_lite" ]; then
+    echo "错误: $BIN_DIR 中缺少 PB_startup_full / PB_startup_lite"
+    echo "用法: $0 <probe 所在目录> [运行次数]"
+    exit 1
+fi
+
+# 可执行文件与其依赖的 PB、protobuf、gRPC、abseil 动态库的总字节数
+binary_size() {
+    local exe="$1"
+    local total
+    total=$(stat -L -c %s "$exe")
+    for lib in $(ldd "$exe" | awk '/=> \// {print $3}' | grep -E 'PB|protobuf|grpc|gpr|absl|upb|address_sorting|re2|cares|ssl|crypto'); do
+        total=$((total + $(stat -L -c %s "$lib")))
+    done
+    echo "$total"
+}
+
+# 进程从 exec 到退出的平均耗时（微秒），含动态加载与描述符注册等静态初始化
+startup_us() {
+    local exe="$1"
+    "$exe" > /dev/null # 预热页缓存
+    local begin end
+    begin=$(date +%s%N)
+    for ((i = 0; i < RUNS; i++)); do
+        "$exe" > /dev/null
+    done
+    end=$(date +%s%N)
+    echo $(((end - begin) / RUNS / 1000))
+}
+
+printf "%-6s %14s %14s %12s  %s\n" "build" "exe_bytes" "with_libs" "startup_us" "probe"
+for variant in full lite; do
+    exe="$BIN_DIR/PB_startup_$variant"
+    printf "%-6s %14s %14s %12s  %s\n" "$variant" "$(stat -L -c %s "$exe")" "$(binary_size "$exe")" \
+        "$(startup_us "$exe")" "$("$exe")"
+done
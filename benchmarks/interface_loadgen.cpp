@@ -0,0 +1,358 @@
+// InterfaceService 回环压测：启动 AsyncInterfaceServer（回显处理器），异步客户端持续打满
+// 固定数量的并发请求，统计吞吐与 p50 / p99 / p999 延迟
+//
+//   PB_interface_loadgen --mode=query --threads=4 --concurrency=32 --seconds=5 --payload=256
+//   PB_interface_loadgen --mode=send --server-threads=2 --target=10.0.0.2:50051
+//
+// mode=query 每个客户端线程保持 concurrency 个未完成的一元 Query；
+// mode=send 每个客户端线程打开 concurrency 条 Send 流，每条流上逐条写入、等待回显（ping-pong）
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <grpcpp/grpcpp.h>
+#include "interfaces/interfaces_grpc.grpc.pb.h"
+#include "interfaces/interfaces_request_response.pb.h"
+#include "asyncInterfaceServer.h"
+
+using namespace humanoid_robot::PB::interfaces;
+using namespace humanoid_robot::utils::PB;
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+    struct LoadOptions
+    {
+        std::string mode = "query";
+        std::string target; // 为空时在本进程启动服务端
+        int threads = 2;
+        int server_threads = 0;
+        int concurrency = 16;
+        int seconds = 5;
+        std::size_t payload = 64;
+    };
+
+    bool parse_args(int argc, char **argv, LoadOptions *options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            const std::size_t eq = arg.find('=');
+            if (arg.compare(0, 2, "--") != 0 || eq == std::string::npos)
+            {
+                return false;
+            }
+            const std::string key = arg.substr(2, eq - 2);
+            const std::string value = arg.substr(eq + 1);
+            if (key == "mode")
+                options->mode = value;
+            else if (key == "target")
+                options->target = value;
+            else if (key == "threads")
+                options->threads = std::atoi(value.c_str());
+            else if (key == "server-threads")
+                options->server_threads = std::atoi(value.c_str());
+            else if (key == "concurrency")
+                options->concurrency = std::atoi(value.c_str());
+            else if (key == "seconds")
+                options->seconds = std::atoi(value.c_str());
+            else if (key == "payload")
+                options->payload = static_cast<std::size_t>(std::atoll(value.c_str()));
+            else
+                return false;
+        }
+        return (options->mode == "query" || options->mode == "send") && options->threads > 0 && options->concurrency > 0 &&
+               options->seconds > 0;
+    }
+
+    class EchoHandler : public InterfaceHandler
+    {
+    public:
+        grpc::Status query(const QueryRequest &request, QueryResponse *response) override
+        {
+            *response->mutable_output() = request.input();
+            return grpc::Status::OK;
+        }
+
+        void send(const SendRequest &request, const std::shared_ptr<ResponseStream<SendResponse>> &stream) override
+        {
+            SendResponse response;
+            *response.mutable_output() = request.input();
+            stream->write(response);
+        }
+    };
+
+    // 单个客户端线程：一个完成队列，所有调用对象直接作为 tag（每个对象同一时刻只有一个未完成操作）
+    class ClientWorker
+    {
+    public:
+        ClientWorker(InterfaceService::Stub *stub, const LoadOptions &options, Clock::time_point deadline)
+            : stub_(stub), options_(options), deadline_(deadline)
+        {
+            (*query_.mutable_input()->mutable_keyvaluelist())["payload"].set_stringvalue(std::string(options.payload, 'x'));
+            (*send_.mutable_input()->mutable_keyvaluelist())["payload"].set_stringvalue(std::string(options.payload, 'x'));
+            latencies_.reserve(1 << 16);
+        }
+
+        void run()
+        {
+            if (options_.mode == "query")
+            {
+                run_query();
+            }
+            else
+            {
+                run_send();
+            }
+        }
+
+        const std::vector<uint32_t> &latencies() const { return latencies_; }
+        uint64_t errors() const { return errors_; }
+
+    private:
+        struct UnaryCall
+        {
+            std::unique_ptr<grpc::ClientContext> context;
+            std::unique_ptr<grpc::ClientAsyncResponseReader<QueryResponse>> reader;
+            QueryResponse response;
+            grpc::Status status;
+            Clock::time_point start;
+        };
+
+        enum class Phase
+        {
+            kConnecting,
+            kWriting,
+            kReading,
+            kClosing,
+            kFinishing
+        };
+
+        struct StreamCall
+        {
+            grpc::ClientContext context;
+            std::unique_ptr<grpc::ClientAsyncReaderWriter<SendRequest, SendResponse>> stream;
+            SendResponse response;
+            grpc::Status status;
+            Phase phase = Phase::kConnecting;
+            Clock::time_point start;
+        };
+
+        void record(Clock::time_point start)
+        {
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+            latencies_.push_back(static_cast<uint32_t>(std::min<int64_t>(ns, UINT32_MAX)));
+        }
+
+        void issue(UnaryCall *call)
+        {
+            call->context = std::make_unique<grpc::ClientContext>();
+            call->start = Clock::now();
+            call->reader = stub_->PrepareAsyncQuery(call->context.get(), query_, &cq_);
+            call->reader->StartCall();
+            call->reader->Finish(&call->response, &call->status, call);
+        }
+
+        void run_query()
+        {
+            std::vector<UnaryCall> calls(static_cast<std::size_t>(options_.concurrency));
+            for (auto &call : calls)
+            {
+                issue(&call);
+            }
+            std::size_t outstanding = calls.size();
+            void *tag = nullptr;
+            bool ok = false;
+            while (outstanding > 0 && cq_.Next(&tag, &ok))
+            {
+                auto *call = static_cast<UnaryCall *>(tag);
+                if (ok && call->status.ok())
+                {
+                    record(call->start);
+                }
+                else
+                {
+                    ++errors_;
+                }
+                if (Clock::now() < deadline_)
+                {
+                    issue(call);
+                }
+                else
+                {
+                    --outstanding;
+                }
+            }
+            cq_.Shutdown();
+            while (cq_.Next(&tag, &ok))
+            {
+            }
+        }
+
+        void run_send()
+        {
+            std::vector<std::unique_ptr<StreamCall>> calls;
+            for (int i = 0; i < options_.concurrency; ++i)
+            {
+                calls.push_back(std::make_unique<StreamCall>());
+                StreamCall *call = calls.back().get();
+                call->stream = stub_->AsyncSend(&call->context, &cq_, call);
+            }
+            std::size_t outstanding = calls.size();
+            void *tag = nullptr;
+            bool ok = false;
+            while (outstanding > 0 && cq_.Next(&tag, &ok))
+            {
+                auto *call = static_cast<StreamCall *>(tag);
+                if (!ok && call->phase != Phase::kFinishing)
+                {
+                    // 流已断开，取状态后结束
+                    ++errors_;
+                    call->phase = Phase::kFinishing;
+                    call->stream->Finish(&call->status, call);
+                    continue;
+                }
+                switch (call->phase)
+                {
+                case Phase::kReading:
+                    record(call->start);
+                    if (Clock::now() >= deadline_)
+                    {
+                        call->phase = Phase::kClosing;
+                        call->stream->WritesDone(call);
+                        break;
+                    }
+                    // fall through
+                case Phase::kConnecting:
+                    call->phase = Phase::kWriting;
+                    call->start = Clock::now();
+                    call->stream->Write(send_, call);
+                    break;
+                case Phase::kWriting:
+                    call->phase = Phase::kReading;
+                    call->stream->Read(&call->response, call);
+                    break;
+                case Phase::kClosing:
+                    call->phase = Phase::kFinishing;
+                    call->stream->Finish(&call->status, call);
+                    break;
+                case Phase::kFinishing:
+                    --outstanding;
+                    break;
+                }
+            }
+            cq_.Shutdown();
+            while (cq_.Next(&tag, &ok))
+            {
+            }
+        }
+
+        InterfaceService::Stub *stub_;
+        const LoadOptions &options_;
+        Clock::time_point deadline_;
+        grpc::CompletionQueue cq_;
+        QueryRequest query_;
+        SendRequest send_;
+        std::vector<uint32_t> latencies_; // 纳秒
+        uint64_t errors_ = 0;
+    };
+
+    double percentile_us(const std::vector<uint32_t> &sorted, double p)
+    {
+        if (sorted.empty())
+        {
+            return 0.0;
+        }
+        const std::size_t index = std::min(sorted.size() - 1, static_cast<std::size_t>(p * static_cast<double>(sorted.size())));
+        return static_cast<double>(sorted[index]) / 1000.0;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    LoadOptions options;
+    if (!parse_args(argc, argv, &options))
+    {
+        std::cerr << "usage: " << argv[0]
+                  << " [--mode=query|send] [--threads=N] [--concurrency=N] [--seconds=N] [--payload=BYTES]"
+                     " [--server-threads=N] [--target=host:port]"
+                  << std::endl;
+        return 1;
+    }
+
+    EchoHandler handler;
+    std::unique_ptr<AsyncInterfaceServer> server;
+    std::string target = options.target;
+    if (target.empty())
+    {
+        AsyncServerOptions server_options;
+        server_options.address = "127.0.0.1:0";
+        server_options.threads = options.server_threads;
+        server = std::make_unique<AsyncInterfaceServer>(&handler, server_options);
+        if (!server->start())
+        {
+            std::cerr << "failed to start server" << std::endl;
+            return 1;
+        }
+        target = "127.0.0.1:" + std::to_string(server->port());
+    }
+
+    // 每个客户端线程独立的 channel，避免所有流挤在一条 HTTP/2 连接上
+    std::vector<std::unique_ptr<InterfaceService::Stub>> stubs;
+    std::vector<std::unique_ptr<ClientWorker>> workers;
+    const Clock::time_point begin = Clock::now();
+    const Clock::time_point deadline = begin + std::chrono::seconds(options.seconds);
+    for (int i = 0; i < options.threads; ++i)
+    {
+        grpc::ChannelArguments args;
+        args.SetInt("grpc.channel_id", i); // 不同参数阻止 channel 复用同一个子通道
+        stubs.push_back(InterfaceService::NewStub(
+            grpc::CreateCustomChannel(target, grpc::InsecureChannelCredentials(), args)));
+        workers.push_back(std::make_unique<ClientWorker>(stubs.back().get(), options, deadline));
+    }
+
+    std::vector<std::thread> threads;
+    for (auto &worker : workers)
+    {
+        threads.emplace_back(&ClientWorker::run, worker.get());
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    const double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    std::vector<uint32_t> latencies;
+    uint64_t errors = 0;
+    for (const auto &worker : workers)
+    {
+        latencies.insert(latencies.end(), worker->latencies().begin(), worker->latencies().end());
+        errors += worker->errors();
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "mode=" << options.mode << " threads=" << options.threads << " concurrency=" << options.concurrency
+              << " payload=" << options.payload << "B" << std::endl;
+    std::cout << "requests: " << latencies.size() << "  errors: " << errors << "  throughput: "
+              << static_cast<double>(latencies.size()) / elapsed << " req/s" << std::endl;
+    std::cout << "latency us  p50: " << percentile_us(latencies, 0.50) << "  p99: " << percentile_us(latencies, 0.99)
+              << "  p999: " << percentile_us(latencies, 0.999) << "  max: "
+              << (latencies.empty() ? 0.0 : latencies.back() / 1000.0) << std::endl;
+
+    if (server)
+    {
+        server->shutdown();
+        AsyncServerStats stats = server->stats();
+        std::cout << "server calls: " << stats.calls << "  rejected_writes: " << stats.rejected_writes
+                  << "  paused_reads: " << stats.paused_reads << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+// 启动开销探针：同一份源码分别链接完整版（libCHRIC_commonPB + libprotobuf + gRPC++）与
+// PB_LITE 版（libCHRIC_commonPBLite + libprotobuf-lite），只做嵌入式节点需要的 Variant / Dictionary 编解码。
+// 进程整体耗时（动态加载 + 静态初始化 + main）由 compare_lite.sh 在外部多次测量；
+// 这里输出 main 内编解码耗时与结束时的 RSS，只使用 MessageLite 接口，两种运行时都能编译
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "common/variant.pb.h"
+
+using namespace humanoid_robot::PB::common;
+
+namespace
+{
+    long resident_kb()
+    {
+        std::FILE *status = std::fopen("/proc/self/status", "r");
+        if (status == nullptr)
+        {
+            return -1;
+        }
+        char line[256];
+        long kb = -1;
+        while (std::fgets(line, sizeof(line), status) != nullptr)
+        {
+            if (std::strncmp(line, "VmRSS:", 6) == 0)
+            {
+                kb = std::strtol(line + 6, nullptr, 10);
+                break;
+            }
+        }
+        std::fclose(status);
+        return kb;
+    }
+} // namespace
+
+int main()
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    Dictionary state;
+    auto &map = *state.mutable_keyvaluelist();
+    for (int i = 0; i < 12; ++i)
+    {
+        const std::string joint = "joint_" + std::to_string(i);
+        map[joint + ".position"].set_doublevalue(0.1 * i);
+        map[joint + ".temperature"].set_int32value(40 + i);
+    }
+    map["locomotion.mode"].set_stringvalue("walking");
+
+    std::string wire;
+    state.SerializeToString(&wire);
+    Dictionary decoded;
+    const bool ok = decoded.ParseFromString(wire) && decoded.keyvaluelist().size() == state.keyvaluelist().size() &&
+                    decoded.keyvaluelist().at("joint_3.temperature").int32value() == 43;
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    std::printf("runtime=%s ok=%d wire_bytes=%zu main_us=%lld rss_kb=%ld\n",
+#ifdef PB_LITE
+                "lite",
+#else
+                "full",
+#endif
+                ok ? 1 : 0, wire.size(), static_cast<long long>(elapsed.count()), resident_kb());
+    return ok ? 0 : 1;
+}
@@ -1,8 +1,10 @@
 #!/bin/bash
 
 # 通用 Protobuf 代码生成脚本
-# 用法: ./generate_proto.sh <proto_directory_path> <export_symbol> [protoc_path] [grpc_plugin_path]
+# 用法: ./generate_proto.sh [--lite] <proto_directory_path> <export_symbol> [protoc_path] [grpc_plugin_path]
 # 参数:
+#   --lite (可选): 生成 optimize_for = LITE_RUNTIME 的纯消息代码（不生成 gRPC），输出到 lite/include 与 lite/source，
+#                  供 PB_LITE 构建的嵌入式节点使用。proto 文件本身不改动，在临时目录中统一注入该选项
 #   proto_directory_path: proto文件所在目录路径
 #   export_symbol: 导入导出符号名称（如 IMAGEPROCESSING_PB_API）
 #   protoc_path (可选): protoc工具的路径
@@ -17,12 +19,20 @@ VCPKG_ROOT="/home/ubuntu/vcpkg"
 echo "=== 通用 Protobuf 代码生成脚本 ==="
 echo "PB 根目录: $PB_ROOT"
 
+# 解析 --lite 选项
+LITE_MODE=0
+if [ "${1:-}" = "--lite" ]; then
+    LITE_MODE=1
+    shift
+fi
+
 # 检查参数数量
 if [ $# -lt 2 ] || [ $# -gt 4 ]; then
     echo "错误: 参数数量不正确"
-    echo "用法: $0 <proto_directory_path> <export_symbol> [protoc_path] [grpc_plugin_path]"
+    echo "用法: $0 [--lite] <proto_directory_path> <export_symbol> [protoc_path] [grpc_plugin_path]"
     echo ""
     echo "参数说明:"
+    echo "  --lite                  生成 LITE_RUNTIME 纯消息代码到 lite/ (可选)"
     echo "  proto_directory_path    proto文件所在目录路径 (必需)"
     echo "  export_symbol           导入导出符号名称 (必需)"
     echo "  protoc_path             protoc工具的路径 (可选)"
@@ -32,6 +42,7 @@ if [ $# -lt 2 ] || [ $# -gt 4 ]; then
     echo "  $0 proto/perception IMAGEPROCESSING_PB_API"
     echo "  $0 proto/detection DETECTION_PB_API"
     echo "  $0 proto/perception IMAGEPROCESSING_PB_API /custom/path/protoc /custom/path/grpc_cpp_plugin"
+    echo "  $0 --lite proto/common COMMON_API"
     exit 1
 fi
 
@@ -43,6 +54,9 @@ CUSTOM_GRPC_PLUGIN_PATH="${4:-}"
 
 echo "Proto目录参数: $PROTO_DIR_ARG"
 echo "导出符号: $EXPORT_SYMBOL"
+if [ $LITE_MODE -eq 1 ]; then
+    echo "模式: LITE_RUNTIME（仅消息，不生成 gRPC）"
+fi
 
 # 处理proto目录路径
 if [[ "$PROTO_DIR_ARG" = /* ]]; then
@@ -99,7 +113,7 @@ if [ ! -f "$PROTOC_PATH" ]; then
     exit 1
 fi
 
-if [ ! -f "$GRPC_PLUGIN_PATH" ]; then
+if [ $LITE_MODE -eq 0 ] && [ ! -f "$GRPC_PLUGIN_PATH" ]; then
     echo "错误: grpc_cpp_plugin工具不存在: $GRPC_PLUGIN_PATH"
     echo "请先在Humanoid-Robot根目录运行cmake配置以安装vcpkg依赖，或提供正确的grpc_cpp_plugin路径"
     exit 1
@@ -122,6 +136,31 @@ for proto_file in "${PROTO_FILES[@]}"; do
     echo "  - $(basename "$proto_file")"
 done
 
+# 所有生成库都需要支持 Arena 分配（DictionaryBuilder/MessageArena 依赖此选项）
+for proto_file in "${PROTO_FILES[@]}"; do
+    if ! grep -q '^option cc_enable_arenas = true;' "$proto_file"; then
+        echo "警告: $(basename "$proto_file") 未声明 'option cc_enable_arenas = true;'，请补充以启用 Arena 分配"
+    fi
+done
+
+# 输出根目录：完整版为 include / source，lite 版为 lite/include / lite/source
+if [ $LITE_MODE -eq 1 ]; then
+    INCLUDE_ROOT="$PB_ROOT/lite/include"
+    SOURCE_ROOT="$PB_ROOT/lite/source"
+    mkdir -p "$INCLUDE_ROOT"
+    cp "$PB_ROOT/include/pb_export.h" "$INCLUDE_ROOT/"
+
+    # lite 消息只能 import lite 消息：复制整个 proto 树，在每个文件的 package 之后注入 optimize_for
+    PROTO_ROOT="$PB_ROOT/temp_proto_lite"
+    rm -rf "$PROTO_ROOT"
+    cp -r "$PB_ROOT/proto" "$PROTO_ROOT"
+    find "$PROTO_ROOT" -name "*.proto" -type f -exec sed -i '/^package /a\\noption optimize_for = LITE_RUNTIME;' {} +
+else
+    INCLUDE_ROOT="$PB_ROOT/include"
+    SOURCE_ROOT="$PB_ROOT/source"
+    PROTO_ROOT="$PB_ROOT/proto"
+fi
+
 # 为每个proto文件生成代码
 for PROTO_FILE in "${PROTO_FILES[@]}"; do
     echo ""
@@ -137,8 +176,8 @@ for PROTO_FILE in "${PROTO_FILES[@]}"; do
     echo "  文件名: $PROTO_NAME"
     
     # 创建输出目录
-    mkdir -p "$PB_ROOT/include/$PROTO_DIR"
-    mkdir -p "$PB_ROOT/source/$PROTO_DIR"
+    mkdir -p "$INCLUDE_ROOT/$PROTO_DIR"
+    mkdir -p "$SOURCE_ROOT/$PROTO_DIR"
     
     # 生成临时输出目录
     TEMP_OUTPUT="$PB_ROOT/temp_proto_output"
@@ -148,12 +187,19 @@ for PROTO_FILE in "${PROTO_FILES[@]}"; do
     
     # 生成protobuf代码到临时目录
     cd "$PB_ROOT"
-    "$PROTOC_PATH" \
-        --proto_path=proto \
-        --cpp_out="$TEMP_OUTPUT" \
-        --grpc_out="$TEMP_OUTPUT" \
-        --plugin=protoc-gen-grpc="$GRPC_PLUGIN_PATH" \
-        "$REL_PROTO_PATH"
+    if [ $LITE_MODE -eq 1 ]; then
+        "$PROTOC_PATH" \
+            --proto_path="$PROTO_ROOT" \
+            --cpp_out="$TEMP_OUTPUT" \
+            "$REL_PROTO_PATH"
+    else
+        "$PROTOC_PATH" \
+            --proto_path=proto \
+            --cpp_out="$TEMP_OUTPUT" \
+            --grpc_out="$TEMP_OUTPUT" \
+            --plugin=protoc-gen-grpc="$GRPC_PLUGIN_PATH" \
+            "$REL_PROTO_PATH"
+    fi
     
     if [ $? -ne 0 ]; then
         echo "  错误: protobuf代码生成失败"
@@ -169,30 +215,30 @@ for PROTO_FILE in "${PROTO_FILES[@]}"; do
     
     # 移动头文件
     if [ -f "$TEMP_PROTO_H" ]; then
-        mv "$TEMP_PROTO_H" "$PB_ROOT/include/$PROTO_DIR/"
+        mv "$TEMP_PROTO_H" "$INCLUDE_ROOT/$PROTO_DIR/"
         echo "  ✓ 已移动: include/$PROTO_DIR/$PROTO_NAME.pb.h"
     fi
     
     if [ -f "$TEMP_GRPC_H" ]; then
-        mv "$TEMP_GRPC_H" "$PB_ROOT/include/$PROTO_DIR/"
+        mv "$TEMP_GRPC_H" "$INCLUDE_ROOT/$PROTO_DIR/"
         echo "  ✓ 已移动: include/$PROTO_DIR/$PROTO_NAME.grpc.pb.h"
     fi
     
     # 移动源文件
     if [ -f "$TEMP_PROTO_CC" ]; then
-        mv "$TEMP_PROTO_CC" "$PB_ROOT/source/$PROTO_DIR/"
+        mv "$TEMP_PROTO_CC" "$SOURCE_ROOT/$PROTO_DIR/"
         echo "  ✓ 已移动: source/$PROTO_DIR/$PROTO_NAME.pb.cc"
     fi
     
     if [ -f "$TEMP_GRPC_CC" ]; then
-        mv "$TEMP_GRPC_CC" "$PB_ROOT/source/$PROTO_DIR/"
+        mv "$TEMP_GRPC_CC" "$SOURCE_ROOT/$PROTO_DIR/"
         echo "  ✓ 已移动: source/$PROTO_DIR/$PROTO_NAME.grpc.pb.cc"
     fi
     
     echo "  2. 添加导出符号到头文件..."
     
     # 处理protobuf头文件
-    PROTO_HEADER="$PB_ROOT/include/$PROTO_DIR/$PROTO_NAME.pb.h"
+    PROTO_HEADER="$INCLUDE_ROOT/$PROTO_DIR/$PROTO_NAME.pb.h"
     if [ -f "$PROTO_HEADER" ]; then
         echo "    处理: include/$PROTO_DIR/$PROTO_NAME.pb.h"
         
@@ -216,7 +262,7 @@ for PROTO_FILE in "${PROTO_FILES[@]}"; do
     fi
     
     # 处理gRPC头文件
-    GRPC_HEADER="$PB_ROOT/include/$PROTO_DIR/$PROTO_NAME.grpc.pb.h"
+    GRPC_HEADER="$INCLUDE_ROOT/$PROTO_DIR/$PROTO_NAME.grpc.pb.h"
     if [ -f "$GRPC_HEADER" ]; then
         echo "    处理: include/$PROTO_DIR/$PROTO_NAME.grpc.pb.h"
         
@@ -239,12 +285,15 @@ done
 
 # 清理临时目录
 rm -rf "$TEMP_OUTPUT"
+if [ $LITE_MODE -eq 1 ]; then
+    rm -rf "$PROTO_ROOT"
+fi
 
 echo ""
 echo "=== 生成完成! ==="
 echo "生成的文件位于:"
-echo "  头文件: $PB_ROOT/include/"
-echo "  源文件: $PB_ROOT/source/"
+echo "  头文件: $INCLUDE_ROOT/"
+echo "  源文件: $SOURCE_ROOT/"
 echo ""
 echo "目录结构:"
-find "$PB_ROOT/include" "$PB_ROOT/source" -type f -name "*.h" -o -name "*.cc" | sort
+find "$INCLUDE_ROOT" "$SOURCE_ROOT" -type f -name "*.h" -o -name "*.cc" | sort
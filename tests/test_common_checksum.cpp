@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "payloadChecksum.h"
+#include "requestBatch.h"
+using namespace humanoid_robot::PB::communication;
+using namespace humanoid_robot::utils::PB;
+
+// 简单的测试函数
+template <typename T>
+void print_test_result(const std::string &test_name, const T &expected, const T &actual)
+{
+    bool passed = (expected == actual);
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << test_name
+              << " - Expected: " << expected << ", Actual: " << actual << std::endl;
+}
+
+void print_section(const std::string &section_name)
+{
+    std::cout << "\n=== " << section_name << " ===" << std::endl;
+}
+
+// 测试 CRC32C 标准向量
+void test_crc32c_vectors()
+{
+    print_section("CRC32C Vectors");
+    std::cout << "Implementation: " << crc32c_implementation() << std::endl;
+
+    print_test_result("CRC32C empty", 0u, crc32c("", 0));
+    print_test_result("CRC32C \"123456789\"", 0xE3069283u, crc32c("123456789"));
+    print_test_result("CRC32C 32 zero bytes", 0x8A9136AAu, crc32c(std::string(32, '\0')));
+    print_test_result("CRC32C 32 0xFF bytes", 0x62A8AB43u, crc32c(std::string(32, '\xFF')));
+    print_test_result("Portable \"123456789\"", 0xE3069283u, crc32c_extend_portable(0, "123456789", 9));
+}
+
+// 测试硬件实现与查表实现一致（覆盖三路交错的长/短分块、未对齐起始地址与尾部）
+void test_crc32c_consistency()
+{
+    print_section("CRC32C Consistency");
+
+    std::vector<uint8_t> data(3 * 8192 * 2 + 3 * 256 + 77);
+    uint32_t seed = 12345;
+    for (uint8_t &byte : data)
+    {
+        seed = seed * 1103515245u + 12345u;
+        byte = static_cast<uint8_t>(seed >> 16);
+    }
+
+    bool equal = true;
+    for (std::size_t offset : {0, 1, 3, 7})
+    {
+        for (std::size_t size : std::vector<std::size_t>{0, 1, 7, 8, 255, 768, 1000, 24576, 25000, data.size() - 7})
+        {
+            equal = equal && crc32c(data.data() + offset, size) ==
+                                 crc32c_extend_portable(0, data.data() + offset, size);
+        }
+    }
+    print_test_result("Hardware matches portable", true, equal);
+
+    // 增量计算与一次计算结果相同
+    Crc32c hasher;
+    std::vector<std::string_view> segments;
+    const char *base = reinterpret_cast<const char *>(data.data());
+    for (std::size_t pos = 0, step = 1; pos < data.size(); pos += step, step = step * 3 + 1)
+    {
+        segments.emplace_back(base + pos, std::min(step, data.size() - pos));
+    }
+    hasher.update(segments);
+    print_test_result("Incremental segments", crc32c(data.data(), data.size()), hasher.value());
+    hasher.reset();
+    print_test_result("Reset", 0u, hasher.value());
+}
+
+// 测试 UniversalRequest / UniversalResponse 的 checksum 字段
+void test_envelope_checksum()
+{
+    print_section("Envelope Checksum");
+
+    UniversalRequest request;
+    request.set_payload(std::string(4096, 'x'));
+    seal_checksum(&request);
+    print_test_result("Request verify", true, verify_checksum(request));
+    print_test_result("Request checksum bits", crc32c(request.payload()), static_cast<uint32_t>(request.checksum()));
+    (*request.mutable_payload())[100] = 'y';
+    print_test_result("Request corrupted", false, verify_checksum(request));
+
+    UniversalResponse response;
+    response.set_payload("response payload");
+    seal_checksum(&response);
+    print_test_result("Response verify", true, verify_checksum(response));
+
+    Crc32c stream;
+    stream.update(response.payload().substr(0, 5));
+    stream.update(response.payload().substr(5));
+    print_test_result("Streamed matches", true, stream.matches(response.checksum()));
+
+    // 批量信封由 pack_batch 封装校验和，拆包时校验
+    std::vector<UniversalRequest> requests(3, request);
+    UniversalRequest envelope;
+    pack_batch(requests, &envelope);
+    print_test_result("Batch envelope verify", true, verify_checksum(envelope));
+    std::vector<UniversalRequest> out;
+    print_test_result("Batch unpack", true, unpack_batch(envelope, &out));
+    envelope.mutable_payload()->back() ^= 1;
+    out.clear();
+    print_test_result("Corrupted batch rejected", false, unpack_batch(envelope, &out));
+    print_test_result("Corrupted batch appends nothing", static_cast<std::size_t>(0), out.size());
+}
+
+int main()
+{
+    std::cout << "Testing Payload Checksum Functionality" << std::endl;
+    std::cout << "======================================" << std::endl;
+
+    try
+    {
+        test_crc32c_vectors();
+        test_crc32c_consistency();
+        test_envelope_checksum();
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "All tests completed successfully!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include <iostream>
+#include <string>
+#include <google/protobuf/util/message_differencer.h>
+#include "common/variant.pb.h"
+#include "dictionaryDelta.h"
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::utils::PB;
+using google::protobuf::util::MessageDifferencer;
+
+// 简单的测试函数
+template <typename T>
+void print_test_result(const std::string &test_name, const T &expected, const T &actual)
+{
+    bool passed = (expected == actual);
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << test_name
+              << " - Expected: " << expected << ", Actual: " << actual << std::endl;
+}
+
+void print_section(const std::string &section_name)
+{
+    std::cout << "\n=== " << section_name << " ===" << std::endl;
+}
+
+Dictionary make_state(int keys)
+{
+    Dictionary dict;
+    auto &map = *dict.mutable_keyvaluelist();
+    for (int i = 0; i < keys; ++i)
+    {
+        map["joint_" + std::to_string(i)].set_doublevalue(i * 0.1);
+    }
+    auto &nested = *map["arm"].mutable_dictvalue()->mutable_keyvaluelist();
+    nested["temperature"].set_floatvalue(40.0f);
+    nested["mode"].set_int32value(1);
+    return dict;
+}
+
+int decoder_result(DeltaDecoder::Result result)
+{
+    return static_cast<int>(result);
+}
+
+// 测试增量生成与客户端应用
+void test_encode_and_apply()
+{
+    print_section("Encode And Apply");
+
+    DeltaEncoder encoder;
+    DeltaDecoder decoder;
+    DictionaryDelta delta;
+    Dictionary state = make_state(200);
+
+    print_test_result("First update", true, encoder.encode(state, &delta));
+    print_test_result("First is keyframe", true, delta.keyframe());
+    print_test_result("Keyframe applied", decoder_result(DeltaDecoder::Result::kKeyframe), decoder_result(decoder.apply(delta)));
+
+    print_test_result("Unchanged snapshot", false, encoder.encode(state, &delta));
+
+    (*state.mutable_keyvaluelist())["joint_7"].set_doublevalue(99.0);
+    print_test_result("Single change", true, encoder.encode(state, &delta));
+    print_test_result("Delta not keyframe", false, delta.keyframe());
+    print_test_result("Delta set size", 1, static_cast<int>(delta.set().size()));
+    print_test_result("Delta base version", encoder.version() - 1, delta.baseversion());
+    print_test_result("Delta applied", decoder_result(DeltaDecoder::Result::kApplied), decoder_result(decoder.apply(delta)));
+
+    // 嵌套字典内的修改与删除
+    (*(*state.mutable_keyvaluelist())["arm"].mutable_dictvalue()->mutable_keyvaluelist())["mode"].set_int32value(2);
+    state.mutable_keyvaluelist()->erase("joint_3");
+    encoder.encode(state, &delta);
+    print_test_result("Nested change set", 1, static_cast<int>(delta.set().size()));
+    print_test_result("Removed key", std::string("joint_3"), delta.remove_size() == 1 ? delta.remove(0) : std::string());
+    decoder.apply(delta);
+    print_test_result("Materialized state", true, MessageDifferencer::Equals(state, decoder.state()));
+    print_test_result("Encoder state", true, MessageDifferencer::Equals(state, encoder.state()));
+    print_test_result("Delta much smaller", true, delta.ByteSizeLong() * 20 < state.ByteSizeLong());
+}
+
+// 测试乱序、丢失与关键帧恢复
+void test_versions()
+{
+    print_section("Versions");
+
+    DeltaOptions options;
+    options.keyframe_interval = 4;
+    DeltaEncoder encoder(options);
+    DeltaDecoder decoder;
+    Dictionary state = make_state(20);
+    DictionaryDelta delta;
+
+    encoder.encode(state, &delta);
+    decoder.apply(delta);
+    const DictionaryDelta first = delta;
+    print_test_result("Duplicate is stale", decoder_result(DeltaDecoder::Result::kStale), decoder_result(decoder.apply(first)));
+
+    // 丢失一个增量
+    (*state.mutable_keyvaluelist())["joint_1"].set_doublevalue(1.5);
+    encoder.encode(state, &delta);
+    (*state.mutable_keyvaluelist())["joint_2"].set_doublevalue(2.5);
+    encoder.encode(state, &delta);
+    print_test_result("Gap detected", decoder_result(DeltaDecoder::Result::kGap), decoder_result(decoder.apply(delta)));
+    print_test_result("Not synced", false, decoder.synced());
+
+    // 关键帧之后的第 4 次更新强制关键帧
+    (*state.mutable_keyvaluelist())["joint_3"].set_doublevalue(3.5);
+    encoder.encode(state, &delta);
+    print_test_result("Still gap", decoder_result(DeltaDecoder::Result::kGap), decoder_result(decoder.apply(delta)));
+    (*state.mutable_keyvaluelist())["joint_4"].set_doublevalue(4.5);
+    encoder.encode(state, &delta);
+    print_test_result("Periodic keyframe", true, delta.keyframe());
+    print_test_result("Resynced", decoder_result(DeltaDecoder::Result::kKeyframe), decoder_result(decoder.apply(delta)));
+    print_test_result("State after resync", true, MessageDifferencer::Equals(state, decoder.state()));
+
+    // 新订阅者：直接拿当前关键帧
+    DeltaDecoder late;
+    DictionaryDelta keyframe;
+    encoder.keyframe(&keyframe);
+    late.apply(keyframe);
+    print_test_result("Late subscriber", true, MessageDifferencer::Equals(state, late.state()));
+}
+
+// 测试订阅参数协商
+void test_negotiation()
+{
+    print_section("Negotiation");
+
+    Dictionary params;
+    print_test_result("Default full", false, accepts_delta(params));
+    (*params.mutable_keyvaluelist())[kAcceptDeltaKey].set_boolvalue(true);
+    print_test_result("Accepts delta", true, accepts_delta(params));
+}
+
+int main()
+{
+    std::cout << "Testing Dictionary Delta Functionality" << std::endl;
+    std::cout << "======================================" << std::endl;
+
+    try
+    {
+        test_encode_and_apply();
+        test_versions();
+        test_negotiation();
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "All tests completed successfully!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,358 @@
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include "flightRecorder.h"
+using namespace humanoid_robot::PB::communication;
+using namespace humanoid_robot::utils::PB;
+
+// 简单的测试函数
+template <typename T>
+void print_test_result(const std::string &test_name, const T &expected, const T &actual)
+{
+    bool passed = (expected == actual);
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << test_name
+              << " - Expected: " << expected << ", Actual: " << actual << std::endl;
+}
+
+void print_section(const std::string &section_name)
+{
+    std::cout << "\n=== " << section_name << " ===" << std::endl;
+}
+
+std::string make_temp_dir()
+{
+    char pattern[] = "/tmp/flight_recorder_test_XXXXXX";
+    const char *dir = mkdtemp(pattern);
+    return dir != nullptr ? dir : "";
+}
+
+TopicMessage make_message(const std::string &topic, uint64_t timestamp, uint64_t sequence, std::size_t size)
+{
+    TopicMessage message;
+    message.set_topic_name(topic);
+    message.set_publisher_id("camera_node");
+    message.set_timestamp(timestamp);
+    message.set_sequence(sequence);
+    message.set_payload(std::string(size, static_cast<char>('a' + sequence % 26)));
+    return message;
+}
+
+// 测试记录与顺序读取
+void test_record_and_read(const std::string &dir)
+{
+    print_section("Record And Read");
+
+    RecorderOptions options;
+    options.directory = dir;
+    options.block_bytes = 4096;
+    auto recorder = FlightRecorder::open(options);
+    print_test_result("Recorder opened", true, recorder != nullptr);
+
+    for (uint64_t i = 0; i < 100; ++i)
+    {
+        recorder->record(make_message(i % 2 == 0 ? "image" : "imu", 1000 + i * 10, i, 100 + i));
+    }
+    TopicMessage handshake = make_message("image", 0, 0, 0);
+    handshake.set_shm_segment("/chric_topic_image");
+    print_test_result("Handshake ignored", false, recorder->record(handshake));
+
+    UniversalRequest request;
+    request.set_command(7);
+    request.set_requestid(42);
+    request.set_sendrequesttimestamp(1500);
+    request.set_payload("request-body");
+    print_test_result("Request recorded", true, recorder->record("sendRequest", request));
+    recorder->close();
+    print_test_result("Recorded", static_cast<uint64_t>(101), recorder->recorded());
+    print_test_result("Record after close", false, recorder->record(make_message("imu", 1, 1, 1)));
+
+    auto reader = FlightReader::open(dir, "flight", ReaderOptions{true});
+    print_test_result("Reader opened", true, reader != nullptr);
+    print_test_result("Record count", static_cast<uint64_t>(101), reader->record_count());
+
+    RecordView record;
+    uint64_t messages = 0;
+    bool payloads_match = true;
+    bool found_request = false;
+    while (reader->next(&record))
+    {
+        if (record.kind == RecordKind::kUniversalRequest)
+        {
+            UniversalRequest restored;
+            found_request = to_universal_request(record, &restored) && restored.requestid() == 42 &&
+                            restored.payload() == "request-body" && record.topic_name == "sendRequest";
+            continue;
+        }
+        TopicMessage restored;
+        to_topic_message(record, &restored);
+        const TopicMessage expected = make_message(restored.sequence() % 2 == 0 ? "image" : "imu",
+                                                   1000 + restored.sequence() * 10, restored.sequence(), 100 + restored.sequence());
+        payloads_match = payloads_match && restored.SerializeAsString() == expected.SerializeAsString();
+        ++messages;
+    }
+    print_test_result("Messages read", static_cast<uint64_t>(100), messages);
+    print_test_result("Payloads match", true, payloads_match);
+    print_test_result("Request restored", true, found_request);
+    print_test_result("Checksum failures", static_cast<uint64_t>(0), reader->checksum_failures());
+}
+
+// 测试分段、时间范围定位和 topic 过滤
+void test_segments_and_seek(const std::string &dir)
+{
+    print_section("Segments And Seek");
+
+    RecorderOptions options;
+    options.directory = dir;
+    options.prefix = "seg";
+    options.block_bytes = 8192;
+    options.segment_bytes = 64 * 1024;
+    auto recorder = FlightRecorder::open(options);
+    for (uint64_t i = 0; i < 1000; ++i)
+    {
+        recorder->record(make_message(i % 4 == 0 ? "lidar" : "imu", i, i, 256));
+    }
+    recorder->close();
+    print_test_result("Multiple segments", true, recorder->segments() > 1);
+
+    auto reader = FlightReader::open(dir, "seg");
+    print_test_result("Segment count", static_cast<std::size_t>(recorder->segments()), reader->segment_count());
+    print_test_result("First timestamp", static_cast<uint64_t>(0), reader->first_timestamp());
+    print_test_result("Last timestamp", static_cast<uint64_t>(999), reader->last_timestamp());
+
+    RecordView record;
+    reader->set_time_range(500, 600);
+    reader->seek(500);
+    uint64_t count = 0;
+    uint64_t first = 0;
+    while (reader->next(&record))
+    {
+        first = count == 0 ? record.timestamp : first;
+        ++count;
+    }
+    print_test_result("Range count", static_cast<uint64_t>(100), count);
+    print_test_result("Range first", static_cast<uint64_t>(500), first);
+
+    reader->set_topic("lidar");
+    reader->seek(500);
+    count = 0;
+    while (reader->next(&record))
+    {
+        ++count;
+    }
+    print_test_result("Topic filter count", static_cast<uint64_t>(25), count);
+
+    // 回放：最快速度，handler 返回 false 时提前结束
+    ReplayOptions replay_options;
+    replay_options.speed = 0;
+    replay_options.topic_name = "imu";
+    uint64_t seen = 0;
+    const uint64_t replayed = replay(reader.get(), replay_options, [&](const RecordView &)
+                                     { return ++seen < 10; });
+    print_test_result("Replay stops early", static_cast<uint64_t>(10), replayed);
+
+    // 实时回放：30 毫秒的录制时间跨度
+    replay_options.speed = 1.0;
+    replay_options.begin = 100;
+    replay_options.end = 131;
+    replay_options.topic_name.clear();
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t n = replay(reader.get(), replay_options, [](const RecordView &)
+                              { return true; });
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    print_test_result("Real-time replay count", static_cast<uint64_t>(31), n);
+    print_test_result("Real-time pacing", true, elapsed.count() >= 29);
+}
+
+// 测试未正常关闭（缺少索引、尾部截断）时的恢复
+void test_crash_recovery(const std::string &dir)
+{
+    print_section("Crash Recovery");
+
+    RecorderOptions options;
+    options.directory = dir;
+    options.prefix = "crash";
+    auto recorder = FlightRecorder::open(options);
+    for (uint64_t i = 0; i < 50; ++i)
+    {
+        recorder->record(make_message("imu", i, i, 64));
+    }
+    recorder->close();
+
+    const std::string rec = dir + "/crash-000001.rec";
+    std::filesystem::remove(dir + "/crash-000001.idx");
+    std::filesystem::resize_file(rec, std::filesystem::file_size(rec) - 20);
+
+    auto reader = FlightReader::open(dir, "crash");
+    print_test_result("Recovered records", static_cast<uint64_t>(49), reader->record_count());
+
+    // 重新打开录制器时从下一个段号开始，不覆盖旧数据
+    auto next = FlightRecorder::open(options);
+    next->record(make_message("imu", 100, 100, 64));
+    next->close();
+    print_test_result("New segment file", true, std::filesystem::exists(dir + "/crash-000002.rec"));
+    reader = FlightReader::open(dir, "crash");
+    print_test_result("Records after reopen", static_cast<uint64_t>(50), reader->record_count());
+}
+
+// 测试 name_id、压缩编码、字典、trace 与负数 requestId 的保存与还原（含无索引扫描）
+void test_message_fields(const std::string &dir)
+{
+    print_section("Message Fields");
+
+    RecorderOptions options;
+    options.directory = dir;
+    options.prefix = "fields";
+    auto recorder = FlightRecorder::open(options);
+
+    TopicMessage sent;
+    sent.set_name_id(9);
+    sent.set_publisher_id("camera_node");
+    sent.set_timestamp(2000);
+    sent.set_sequence(5);
+    sent.set_payload("compressed-bytes");
+    sent.set_payload_codec(PAYLOAD_CODEC_ZSTD);
+    sent.set_codec_dictionary("dict-v1");
+    sent.mutable_trace()->set_trace_id(0x1234);
+    print_test_result("Envelope recorded", true, recorder->record(sent));
+    print_test_result("Plain recorded", true, recorder->record(make_message("imu", 2001, 6, 8)));
+
+    UniversalRequest request;
+    request.set_requestid(-7);
+    request.set_sendrequesttimestamp(2002);
+    print_test_result("Negative id recorded", true, recorder->record("sendRequest", request));
+    recorder->close();
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        if (pass == 1)
+        {
+            std::filesystem::remove(dir + "/fields-000001.idx");
+        }
+        auto reader = FlightReader::open(dir, "fields", ReaderOptions{true});
+        const std::string label = pass == 0 ? "Indexed " : "Scanned ";
+        print_test_result(label + "record count", static_cast<uint64_t>(3), reader->record_count());
+
+        RecordView record;
+        TopicMessage restored;
+        reader->next(&record);
+        print_test_result(label + "envelope kind", true, record.kind == RecordKind::kTopicEnvelope);
+        print_test_result(label + "envelope restored", true, to_topic_message(record, &restored) &&
+                                                                 restored.SerializeAsString() == sent.SerializeAsString());
+
+        reader->next(&record);
+        print_test_result(label + "plain restored", true, to_topic_message(record, &restored) &&
+                                                              restored.name_id() == 0 && !restored.has_trace() &&
+                                                              restored.payload() == std::string(8, 'g'));
+
+        reader->next(&record);
+        print_test_result(label + "request not a topic message", false, to_topic_message(record, &restored));
+        print_test_result(label + "request id widened", static_cast<int64_t>(-7), static_cast<int64_t>(record.sequence));
+    }
+}
+
+// 测试写盘失败（文件大小超限后又恢复）：失败段之后的记录不得指向错误的字节
+void test_write_failure(const std::string &dir)
+{
+    print_section("Write Failure");
+
+    rlimit original{};
+    getrlimit(RLIMIT_FSIZE, &original);
+    std::signal(SIGXFSZ, SIG_IGN);
+
+    RecorderOptions options;
+    options.directory = dir;
+    options.prefix = "fail";
+    options.block_bytes = 4096;
+    auto recorder = FlightRecorder::open(options);
+
+    rlimit limited = original;
+    limited.rlim_cur = 6000;
+    setrlimit(RLIMIT_FSIZE, &limited);
+    uint64_t sequence = 0;
+    for (int batch = 0; batch < 2; ++batch)
+    {
+        for (int i = 0; i < 10; ++i, ++sequence)
+        {
+            recorder->record(make_message("imu", sequence, sequence, 400));
+        }
+        recorder->flush();
+    }
+    // 空间恢复后继续记录
+    setrlimit(RLIMIT_FSIZE, &original);
+    for (int batch = 0; batch < 3; ++batch)
+    {
+        for (int i = 0; i < 10; ++i, ++sequence)
+        {
+            recorder->record(make_message("imu", sequence, sequence, 400));
+        }
+        recorder->flush();
+    }
+    recorder->close();
+    std::signal(SIGXFSZ, SIG_DFL);
+
+    print_test_result("Records dropped", true, recorder->dropped() > 0);
+    print_test_result("Rolled to new segment", true, recorder->segments() > 1);
+
+    ReaderOptions reader_options;
+    reader_options.verify_checksums = true;
+    auto reader = FlightReader::open(dir, "fail", reader_options);
+    print_test_result("Reader opened", true, reader != nullptr);
+    if (reader == nullptr)
+    {
+        return;
+    }
+    print_test_result("Readable records", recorder->recorded(), reader->record_count());
+    RecordView record;
+    uint64_t count = 0;
+    bool intact = true;
+    while (reader->next(&record))
+    {
+        ++count;
+        intact = intact && record.payload == std::string(400, static_cast<char>('a' + record.sequence % 26)) &&
+                 record.timestamp == record.sequence;
+    }
+    print_test_result("Replayed records", recorder->recorded(), count);
+    print_test_result("Records intact", true, intact);
+    print_test_result("Checksum failures", static_cast<uint64_t>(0), reader->checksum_failures());
+    print_test_result("Later records kept", true, record.sequence == sequence - 1);
+}
+
+int main()
+{
+    std::cout << "Testing Flight Recorder Functionality" << std::endl;
+    std::cout << "=====================================" << std::endl;
+
+    const std::string dir = make_temp_dir();
+    if (dir.empty())
+    {
+        std::cerr << "Cannot create temp directory" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        test_record_and_read(dir);
+        test_segments_and_seek(dir);
+        test_crash_recovery(dir);
+        test_message_fields(dir);
+        test_write_failure(dir);
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "All tests completed successfully!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        std::filesystem::remove_all(dir);
+        return 1;
+    }
+
+    std::filesystem::remove_all(dir);
+    return 0;
+}
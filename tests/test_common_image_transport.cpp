@@ -0,0 +1,145 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "imageTransport.h"
+#include "printUtil.h"
+#include "spanTracer.h"
+#include "common/variant.pb.h"
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::utils::PB;
+
+// 把 ImageFrame 序列化出的多个 slice 拼成连续字节
+std::string frame_bytes(const ImageFrame &frame)
+{
+    ::grpc::ByteBuffer buffer;
+    frame.serialize(&buffer);
+    std::vector<::grpc::Slice> slices;
+    buffer.Dump(&slices);
+    std::string bytes;
+    for (const auto &slice : slices)
+    {
+        bytes.append(reinterpret_cast<const char *>(slice.begin()), slice.size());
+    }
+    return bytes;
+}
+
+Image sample_image()
+{
+    Image image;
+    image.set_timestamp("1705123456.789");
+    image.set_requiresmasks(true);
+    std::string pixels(64 * 48 * 3, '\0');
+    for (std::size_t i = 0; i < pixels.size(); ++i)
+    {
+        pixels[i] = static_cast<char>(i * 7);
+    }
+    image.set_img(pixels);
+    start_trace(image.mutable_trace());
+    add_hop(image.mutable_trace(), TRACE_STAGE_CAPTURE, 1000, 3000);
+    return image;
+}
+
+// 测试与生成代码 Image 的双向互通
+void test_roundtrip()
+{
+    print_section("Round Trip");
+
+    const Image image = sample_image();
+    const std::string wire = image.SerializeAsString();
+
+    ImageFrame frame;
+    print_test_result("Parse generated wire", true, frame.parse(wire.data(), wire.size()));
+    print_test_result("Time stamp", image.timestamp(), frame.time_stamp());
+    print_test_result("Requires masks", true, frame.requires_masks());
+    print_test_result("Image size", image.img().size(), frame.image_size());
+    std::string_view view;
+    print_test_result("Image zero copy", true, frame.image_contiguous(&view) && view.data() >= wire.data() && view.data() < wire.data() + wire.size());
+    print_test_result("Image bytes", image.img(), std::string(view));
+    print_test_result("Trace parsed", true, frame.has_trace());
+    print_test_result("Trace id", image.trace().trace_id(), frame.trace().trace_id());
+    print_test_result("Trace hops", 1, frame.trace().hops_size());
+
+    // 接收端追加阶段后转发，生成代码解析结果应与原消息一致（除新增的 hop）
+    add_hop(frame.mutable_trace(), TRACE_STAGE_TRANSPORT, 3500, 4000);
+    Image decoded;
+    print_test_result("Generated parses frame", true, decoded.ParseFromString(frame_bytes(frame)));
+    print_test_result("Decoded time stamp", image.timestamp(), decoded.timestamp());
+    print_test_result("Decoded requires masks", true, decoded.requiresmasks());
+    print_test_result("Decoded image", image.img(), decoded.img());
+    print_test_result("Decoded trace id", image.trace().trace_id(), decoded.trace().trace_id());
+    print_test_result("Decoded trace hops", 2, decoded.trace().hops_size());
+
+    // 不带 trace 的帧不输出字段 4
+    ImageFrame plain;
+    plain.from_message(image);
+    plain.clear_trace();
+    Image untraced;
+    untraced.ParseFromString(frame_bytes(plain));
+    print_test_result("No trace emitted", false, untraced.has_trace());
+
+    Image converted;
+    frame.to_message(&converted);
+    print_test_result("to_message trace", 2, converted.trace().hops_size());
+    print_test_result("to_message image", image.img(), converted.img());
+
+    // 未知字段跳过
+    Image with_unknown = image;
+    std::string extended = with_unknown.SerializeAsString();
+    extended.append("\x78\x2a", 2); // field 15 varint
+    print_test_result("Unknown field skipped", true, frame.parse(extended.data(), extended.size()) && frame.image_size() == image.img().size());
+}
+
+// 测试截断与畸形输入
+void test_truncated()
+{
+    print_section("Truncated Input");
+
+    const std::string wire = sample_image().SerializeAsString();
+    ImageFrame frame;
+    bool all_rejected = true;
+    for (std::size_t cut = 1; cut < wire.size(); ++cut)
+    {
+        Image reference;
+        const bool reference_ok = reference.ParseFromArray(wire.data(), static_cast<int>(cut));
+        const bool ok = frame.parse(wire.data(), cut);
+        if (ok != reference_ok)
+        {
+            all_rejected = false;
+        }
+    }
+    print_test_result("Matches generated parser on every prefix", true, all_rejected);
+    print_test_result("Cleared after failure", static_cast<std::size_t>(0), frame.image_size());
+
+    // 长度前缀远大于剩余字节：不得按线上长度预分配
+    const std::string huge_time_stamp("\x0a\xff\xff\xff\xff\x0f", 6);
+    print_test_result("Huge string length", false, frame.parse(huge_time_stamp.data(), huge_time_stamp.size()));
+    const std::string huge_image("\x12\xff\xff\xff\xff\xff\xff\xff\xff\x01", 10);
+    print_test_result("Huge image length", false, frame.parse(huge_image.data(), huge_image.size()));
+    const std::string huge_unknown("\x7a\xff\xff\xff\xff\x0f", 6);
+    print_test_result("Huge unknown length", false, frame.parse(huge_unknown.data(), huge_unknown.size()));
+    const std::string bad_trace("\x22\x02\xff\xff", 4);
+    print_test_result("Malformed trace", false, frame.parse(bad_trace.data(), bad_trace.size()));
+}
+
+int main()
+{
+    std::cout << "Testing Image Transport Functionality" << std::endl;
+    std::cout << "=====================================" << std::endl;
+
+    try
+    {
+        test_roundtrip();
+        test_truncated();
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "All tests completed successfully!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
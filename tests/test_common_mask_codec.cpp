@@ -0,0 +1,200 @@
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include "common/variant.pb.h"
+#include "maskCodec.h"
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::utils::PB;
+
+// 简单的测试函数
+template <typename T>
+void print_test_result(const std::string &test_name, const T &expected, const T &actual)
+{
+    bool passed = (expected == actual);
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << test_name
+              << " - Expected: " << expected << ", Actual: " << actual << std::endl;
+}
+
+void print_section(const std::string &section_name)
+{
+    std::cout << "\n=== " << section_name << " ===" << std::endl;
+}
+
+// 测试位图游程编码
+void test_rle_bitmap()
+{
+    print_section("RLE Bitmap");
+
+    // 37 列：覆盖 SSE2 的 16 字节块和尾部标量路径
+    const uint32_t width = 37;
+    const uint32_t height = 5;
+    std::vector<uint8_t> bitmap(width * height, 0);
+    for (uint32_t y = 1; y < 4; ++y)
+    {
+        for (uint32_t x = 10; x < 30; ++x)
+        {
+            bitmap[y * width + x] = 255;
+        }
+    }
+
+    MaskRle rle;
+    encode_rle(bitmap.data(), width, height, width, &rle);
+    print_test_result("RLE run count", 7, rle.counts_size());
+    print_test_result("RLE first background run", static_cast<uint32_t>(width + 10), rle.counts(0));
+    print_test_result("RLE area", static_cast<uint64_t>(60), rle_area(rle));
+
+    std::vector<uint8_t> decoded(width * height, 7);
+    print_test_result("RLE decode ok", true, decode_rle(rle, decoded.data()));
+    bool equal = true;
+    for (std::size_t i = 0; i < bitmap.size(); ++i)
+    {
+        equal = equal && decoded[i] == (bitmap[i] != 0 ? 1 : 0);
+    }
+    print_test_result("RLE decode equal", true, equal);
+
+    // 全前景：第一个游程为 0 长度背景
+    std::vector<uint8_t> full(64, 1);
+    encode_rle(full.data(), 8, 8, 8, &rle);
+    print_test_result("Full mask runs", 2, rle.counts_size());
+    print_test_result("Full mask leading zero run", static_cast<uint32_t>(0), rle.counts(0));
+
+    // 游程总长与区域不符
+    rle.add_counts(1);
+    print_test_result("Corrupt RLE rejected", false, decode_rle(rle, decoded.data()));
+}
+
+// 测试旧版点列表与 RLE 互转
+void test_rle_points()
+{
+    print_section("RLE Points");
+
+    google::protobuf::RepeatedPtrField<Mask> points;
+    for (int y = 100; y < 140; ++y)
+    {
+        for (int x = -20; x < 20 + (y % 3); ++x)
+        {
+            Mask *point = points.Add();
+            point->set_x(x);
+            point->set_y(y);
+        }
+    }
+
+    PerceptionRow row;
+    points_to_rle(points, row.mutable_maskrle());
+    print_test_result("Points RLE origin x", -20, row.maskrle().originx());
+    print_test_result("Points RLE origin y", 100, row.maskrle().originy());
+    print_test_result("Points RLE area", static_cast<uint64_t>(points.size()), rle_area(row.maskrle()));
+
+    PerceptionRow legacy;
+    *legacy.mutable_masks() = points;
+    print_test_result("RLE smaller on wire", true, row.ByteSizeLong() * 20 < legacy.ByteSizeLong());
+
+    google::protobuf::RepeatedPtrField<Mask> decoded;
+    print_test_result("RLE to points ok", true, rle_to_points(row.maskrle(), &decoded));
+    bool equal = decoded.size() == points.size();
+    for (int i = 0; equal && i < points.size(); ++i)
+    {
+        equal = decoded.Get(i).x() == points.Get(i).x() && decoded.Get(i).y() == points.Get(i).y();
+    }
+    print_test_result("RLE to points equal", true, equal);
+
+    // 稀疏点集不经过位图，结果与稠密路径的格式一致
+    const int32_t sparse[] = {5, 7, 1000000, 3000, 6, 7, 5, 7, 999999, 3000};
+    MaskRle sparse_rle;
+    print_test_result("Sparse points ok", true, points_to_rle(sparse, 5, &sparse_rle));
+    print_test_result("Sparse width", static_cast<uint32_t>(999996), sparse_rle.width());
+    print_test_result("Sparse area deduplicated", static_cast<uint64_t>(4), rle_area(sparse_rle));
+    print_test_result("Sparse ends with foreground", static_cast<uint32_t>(2), sparse_rle.counts(sparse_rle.counts_size() - 1));
+    std::vector<int32_t> sparse_xy;
+    print_test_result("Sparse to points", true, rle_to_points(sparse_rle, &sparse_xy));
+    print_test_result("Sparse last point", 1000000, sparse_xy.empty() ? 0 : sparse_xy[sparse_xy.size() - 2]);
+
+    const int32_t corners[] = {10, 20, 209, 20, 10, 119, 11, 119, 10, 20};
+    MaskRle corners_rle;
+    points_to_rle(corners, 5, &corners_rle);
+    std::vector<uint8_t> corners_bitmap(200 * 100, 0);
+    corners_bitmap[0] = corners_bitmap[199] = corners_bitmap[99 * 200] = corners_bitmap[99 * 200 + 1] = 1;
+    MaskRle corners_dense;
+    encode_rle(corners_bitmap.data(), 200, 100, 200, &corners_dense);
+    corners_dense.set_originx(10);
+    corners_dense.set_originy(20);
+    print_test_result("Sparse path matches bitmap encoding", corners_dense.SerializeAsString() == corners_rle.SerializeAsString(), true);
+
+    // 外接矩形超出 uint32 游程范围：宽度会回绕为 0 或面积过大
+    const int32_t wide[] = {std::numeric_limits<int32_t>::min(), 0, std::numeric_limits<int32_t>::max(), 0};
+    MaskRle rejected;
+    print_test_result("Full int32 span rejected", false, points_to_rle(wide, 2, &rejected));
+    print_test_result("Rejected RLE cleared", static_cast<uint32_t>(0), rejected.width());
+    const int32_t square[] = {0, 0, 70000, 70000};
+    print_test_result("Huge area rejected", false, points_to_rle(square, 2, &rejected));
+    const int32_t line[] = {0, 0, 0, 65535};
+    print_test_result("Tall sparse column ok", true, points_to_rle(line, 2, &rejected) && rle_area(rejected) == 2);
+
+    // 十几字节的线上 RLE 声明了约 43 亿个前景像素：不得按声明预留
+    MaskRle hostile;
+    hostile.set_width(65535);
+    hostile.set_height(65535);
+    hostile.add_counts(0);
+    hostile.add_counts(4294836225u);
+    std::vector<int32_t> hostile_xy;
+    print_test_result("Hostile RLE rejected", false, rle_to_points(hostile, &hostile_xy));
+    print_test_result("Hostile RLE output empty", true, hostile_xy.empty());
+    hostile.add_counts(7);
+    print_test_result("Overlong runs rejected", false, rle_to_points(hostile, &hostile_xy));
+    print_test_result("Max points respected", false, rle_to_points(row.maskrle(), &hostile_xy, points.size() - 1));
+    print_test_result("Max points exact", true, rle_to_points(row.maskrle(), &hostile_xy, points.size()));
+}
+
+// 测试差分轮廓编码
+void test_contour()
+{
+    print_section("Contour");
+
+    std::vector<int32_t> xy;
+    for (int i = 0; i < 11; ++i)
+    {
+        xy.push_back(500 + i * 3);
+        xy.push_back(300 - i * i);
+    }
+    xy.push_back(2147483647);
+    xy.push_back(-2147483647 - 1);
+
+    MaskContour contour;
+    encode_contour(xy.data(), xy.size() / 2, &contour);
+    print_test_result("Contour point count", xy.size() / 2, contour_point_count(contour));
+
+    MaskContour parsed;
+    parsed.ParseFromString(contour.SerializeAsString());
+    std::vector<int32_t> decoded(xy.size());
+    decode_contour(parsed, decoded.data());
+    print_test_result("Contour roundtrip equal", true, decoded == xy);
+
+    google::protobuf::RepeatedPtrField<Mask> points;
+    decode_contour(parsed, &points);
+    print_test_result("Contour points size", static_cast<int>(xy.size() / 2), points.size());
+    print_test_result("Contour last point x", 2147483647, points.Get(points.size() - 1).x());
+}
+
+int main()
+{
+    std::cout << "Testing Mask Codec Functionality" << std::endl;
+    std::cout << "================================" << std::endl;
+
+    try
+    {
+        test_rle_bitmap();
+        test_rle_points();
+        test_contour();
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "All tests completed successfully!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,225 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/variant.pb.h"
+#include "traceSink.h"
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::utils::PB;
+
+// 简单的测试函数
+template <typename T>
+void print_test_result(const std::string &test_name, const T &expected, const T &actual)
+{
+    bool passed = (expected == actual);
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << test_name
+              << " - Expected: " << expected << ", Actual: " << actual << std::endl;
+}
+
+void print_section(const std::string &section_name)
+{
+    std::cout << "\n=== " << section_name << " ===" << std::endl;
+}
+
+// 收集后台线程的输出
+struct CapturedOutput
+{
+    std::mutex mutex;
+    std::string text;
+
+    std::size_t lines_containing(const std::string &needle)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::size_t count = 0;
+        for (std::size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1))
+        {
+            ++count;
+        }
+        return count;
+    }
+};
+
+TraceOptions capture_options(CapturedOutput *output, std::size_t capacity)
+{
+    TraceOptions options;
+    options.ring_capacity = capacity;
+    options.writer = [output](std::string_view data)
+    {
+        std::lock_guard<std::mutex> lock(output->mutex);
+        output->text.append(data.data(), data.size());
+    };
+    return options;
+}
+
+// 测试单线程记录的格式
+void test_trace_format()
+{
+    print_section("Trace Format");
+
+    CapturedOutput output;
+    TraceSink sink(capture_options(&output, 16));
+    print_test_result("Start", true, sink.start());
+
+    auto dict = std::make_shared<Dictionary>();
+    (*dict->mutable_keyvaluelist())["timeout"].set_int32value(500);
+    print_test_result("Trace accepted", true, sink.trace("SendRequest", dict));
+
+    Variant variant;
+    variant.set_stringvalue("arm");
+    print_test_result("Trace copy accepted", true, sink.trace_copy("Query", variant));
+    variant.set_stringvalue("changed");
+    sink.flush();
+
+    print_test_result("Written", static_cast<uint64_t>(2), sink.written());
+    print_test_result("Dictionary line", static_cast<std::size_t>(1), output.lines_containing(" SendRequest {timeout: 500}\n"));
+    print_test_result("Snapshot line", static_cast<std::size_t>(1), output.lines_containing(" Query \"arm\"\n"));
+    print_test_result("Snapshot refcount released", 1L, dict.use_count());
+    sink.stop();
+}
+
+// 测试队列满时的丢弃策略
+void test_drop_policy()
+{
+    print_section("Drop Policy");
+
+    CapturedOutput output;
+    TraceSink sink(capture_options(&output, 8));
+    auto variant = std::make_shared<Variant>();
+    variant->set_int32value(1);
+
+    // 后台线程未启动：队列写满后丢弃新记录
+    int accepted = 0;
+    for (int i = 0; i < 20; ++i)
+    {
+        accepted += sink.trace("Tick", variant) ? 1 : 0;
+    }
+    print_test_result("Accepted up to capacity", 8, accepted);
+    print_test_result("Enqueued", static_cast<uint64_t>(8), sink.enqueued());
+    print_test_result("Dropped", static_cast<uint64_t>(12), sink.dropped());
+
+    sink.start();
+    sink.flush();
+    print_test_result("Written after start", static_cast<uint64_t>(8), sink.written());
+    print_test_result("Drop notice", static_cast<std::size_t>(1), output.lines_containing("trace dropped 12 records"));
+    print_test_result("Accepted after drain", true, sink.trace("Tick", variant));
+    sink.stop();
+    print_test_result("Written after stop", static_cast<uint64_t>(9), sink.written());
+}
+
+// 测试多个生产者线程，含已退出线程队列的回收
+void test_multiple_producers()
+{
+    print_section("Multiple Producers");
+
+    CapturedOutput output;
+    TraceSink sink(capture_options(&output, 64));
+    sink.start();
+
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 2000;
+    auto variant = std::make_shared<Variant>();
+    variant->set_int32value(7);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        threads.emplace_back([&]
+                             {
+            for (int i = 0; i < kPerThread; ++i)
+            {
+                if (!sink.trace("Worker", variant))
+                {
+                    std::this_thread::yield();
+                }
+            } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    sink.flush();
+    sink.flush(); // 第二轮排空后回收已退出线程的队列
+
+    const uint64_t total = static_cast<uint64_t>(kThreads * kPerThread);
+    print_test_result("Enqueued + dropped", total, sink.enqueued() + sink.dropped());
+    print_test_result("Written == enqueued", sink.enqueued(), sink.written());
+    print_test_result("Lines written", static_cast<std::size_t>(sink.written()), output.lines_containing(" Worker 7\n"));
+    sink.stop();
+}
+
+// 测试其他线程持续写入时 flush() 仍按调用时的写位置完成
+void test_flush_under_load()
+{
+    print_section("Flush Under Load");
+
+    CapturedOutput output;
+    TraceOptions options = capture_options(&output, 256);
+    // 每轮都写出且输出较慢：生产者在此期间写满队列，后台线程每轮都能排空到新数据
+    options.flush_interval = std::chrono::milliseconds(0);
+    options.writer = [&output](std::string_view data)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        std::lock_guard<std::mutex> lock(output.mutex);
+        output.text.append(data.data(), data.size());
+    };
+    TraceSink sink(options);
+    sink.start();
+
+    auto variant = std::make_shared<Variant>();
+    variant->set_int32value(1);
+    std::atomic<bool> stop{false};
+    std::thread producer([&]
+                         {
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            sink.trace("Busy", variant);
+        } });
+
+    // 等待后台线程进入持续有数据可排空的状态
+    while (sink.written() < 1000)
+    {
+        std::this_thread::yield();
+    }
+    bool all_flushed = true;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 20; ++i)
+    {
+        sink.trace("Marker", variant);
+        sink.flush();
+        all_flushed = all_flushed && output.lines_containing(" Marker 1\n") == static_cast<std::size_t>(i + 1);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    stop = true;
+    producer.join();
+
+    print_test_result("Flushed records visible", true, all_flushed);
+    print_test_result("Flush does not wait for idle", true, elapsed < std::chrono::seconds(5));
+    sink.stop();
+}
+
+int main()
+{
+    std::cout << "Testing Trace Sink Functionality" << std::endl;
+    std::cout << "================================" << std::endl;
+
+    try
+    {
+        test_trace_format();
+        test_drop_policy();
+        test_multiple_producers();
+        test_flush_under_load();
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "All tests completed successfully!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -4,7 +4,10 @@
 #include <map>
 #include <cmath>
 #include "common/variant.pb.h"
+#include "packedArrayUtil.h"
+#include "rowColumns.h"
 using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::utils::PB;
 
 // 简单的测试函数
 template <typename T>
@@ -245,6 +248,169 @@ void test_array_types()
     }
 }
 
+// 测试定宽 packed 数组类型
+void test_packed_arrays()
+{
+    print_section("Packed Array Types");
+
+    // 测试 PackedInt16Array 零拷贝视图
+    {
+        Variant variant;
+        const int16_t depth[] = {-32768, -1, 0, 1, 1234, 32767};
+        set_packed_values(variant.mutable_packedint16arrayvalue(), depth, 6);
+
+        print_test_result("Variant PackedInt16Array type", static_cast<int>(Variant::KPackedInt16ArrayValue),
+                          static_cast<int>(variant.value_case()));
+        print_test_result("PackedInt16Array byte size", static_cast<size_t>(12),
+                          variant.packedint16arrayvalue().values().size());
+
+        ArraySpan<const int16_t> span;
+        bool has_span = packed_span(variant.packedint16arrayvalue(), &span);
+        print_test_result("PackedInt16Array span available", true, has_span);
+        print_test_result("PackedInt16Array span size", static_cast<size_t>(6), span.size());
+        if (has_span)
+        {
+            print_test_result("PackedInt16Array first value", static_cast<int>(-32768), static_cast<int>(span[0]));
+            print_test_result("PackedInt16Array last value", static_cast<int>(32767), static_cast<int>(span[5]));
+        }
+    }
+
+    // 测试序列化后的体积与旧版 repeated 数组对比
+    {
+        UInt8Array legacy;
+        for (int i = 0; i < 640; ++i)
+        {
+            legacy.add_values(static_cast<uint32_t>(200 + i % 50));
+        }
+
+        PackedUInt8Array packed;
+        print_test_result("UInt8Array to packed", true, to_packed(legacy, &packed));
+        print_test_result("PackedUInt8Array size", static_cast<size_t>(640), packed_size(packed));
+        print_test_result("PackedUInt8Array smaller on wire", true, packed.ByteSizeLong() < legacy.ByteSizeLong());
+
+        UInt8Array roundtrip;
+        to_legacy(packed, &roundtrip);
+        print_test_result("PackedUInt8Array roundtrip size", legacy.values_size(), roundtrip.values_size());
+        print_test_result("PackedUInt8Array roundtrip equal", true,
+                          legacy.SerializeAsString() == roundtrip.SerializeAsString());
+    }
+
+    // 测试超出位宽的旧版数据
+    {
+        Int8Array legacy;
+        legacy.add_values(127);
+        legacy.add_values(128);
+
+        PackedInt8Array packed;
+        print_test_result("Int8Array out of range rejected", false, to_packed(legacy, &packed));
+        print_test_result("PackedInt8Array untouched", static_cast<size_t>(0), packed_size(packed));
+    }
+
+    // 测试序列化往返
+    {
+        Variant original;
+        const uint16_t mask[] = {0, 1, 65535, 4096};
+        set_packed_values(original.mutable_packeduint16arrayvalue(), mask, 4);
+
+        Variant parsed;
+        parsed.ParseFromString(original.SerializeAsString());
+
+        std::vector<uint16_t> copy;
+        packed_copy(parsed.packeduint16arrayvalue(), &copy);
+        print_test_result("PackedUInt16Array parsed size", static_cast<size_t>(4), copy.size());
+        print_test_result("PackedUInt16Array parsed value", static_cast<int>(65535), static_cast<int>(copy[2]));
+    }
+}
+
+// 测试列式感知结果编码
+void test_row_columns()
+{
+    print_section("Row Columns");
+
+    google::protobuf::RepeatedPtrField<PerceptionRow> rows;
+    const char *classes[] = {"person", "car", "person"};
+    for (int i = 0; i < 3; ++i)
+    {
+        PerceptionRow *row = rows.Add();
+        row->mutable_bbox()->set_x1(10.0f * i);
+        row->mutable_bbox()->set_y1(10.0f * i);
+        row->mutable_bbox()->set_x2(10.0f * i + 20.0f);
+        row->mutable_bbox()->set_y2(10.0f * i + 20.0f);
+        row->set_conf(0.3f + 0.3f * i);
+        row->set_cls(classes[i]);
+        row->set_trackid("track_" + std::to_string(i));
+        row->set_ismove(i == 1);
+        for (int p = 0; p < i; ++p)
+        {
+            Mask *point = row->add_masks();
+            point->set_x(i * 100 + p);
+            point->set_y(-p);
+        }
+    }
+
+    RowColumns columns;
+    to_columns(rows, &columns);
+    print_test_result("RowColumns count", static_cast<uint32_t>(3), columns.count());
+    print_test_result("RowColumns class dictionary", 2, columns.clsdict_size());
+    print_test_result("RowColumns valid", true, columns_valid(columns, true));
+    print_test_result("RowColumns row 2 class", std::string("person"), row_cls(columns, 2));
+    print_test_result("RowColumns row 1 isMove", true, row_is_move(columns, 1));
+    print_test_result("RowColumns row 2 isMove", false, row_is_move(columns, 2));
+    print_test_result("RowColumns row 2 mask size", static_cast<size_t>(4), row_mask(columns, 2).size());
+
+    std::vector<uint32_t> kept;
+    print_test_result("Confidence filter count", static_cast<size_t>(2), select_by_confidence(columns, 0.5f, &kept));
+    print_test_result("Confidence filter first", static_cast<uint32_t>(1), kept[0]);
+
+    std::vector<float> iou(columns.count());
+    iou_with_box(columns, 0.0f, 0.0f, 20.0f, 20.0f, iou.data());
+    print_test_result("IoU with itself", 1.0f, iou[0]);
+    print_test_result("IoU partial overlap", true, std::fabs(row_iou(columns, 0, 1) - 100.0f / 700.0f) < 1e-6f);
+
+    RowColumns filtered;
+    print_test_result("Gather rows", true, gather_rows(columns, kept, &filtered));
+    print_test_result("Gathered rows valid", true, columns_valid(filtered, true));
+    print_test_result("Gathered row 0 track", std::string("track_1"), row_track_id(filtered, 0));
+    RowColumns rejected;
+    print_test_result("Gather index out of range", false, gather_rows(columns, {0, 3}, &rejected));
+
+    RowColumns parsed;
+    parsed.ParseFromString(columns.SerializeAsString());
+    google::protobuf::RepeatedPtrField<PerceptionRow> roundtrip;
+    print_test_result("RowColumns to rows", true, to_rows(parsed, &roundtrip));
+    bool equal = roundtrip.size() == rows.size();
+    for (int i = 0; equal && i < rows.size(); ++i)
+    {
+        equal = roundtrip.Get(i).SerializeAsString() == rows.Get(i).SerializeAsString();
+    }
+    print_test_result("RowColumns roundtrip equal", true, equal);
+
+    // 紧凑掩码按行保存，未设置的行保持未设置
+    rows.Mutable(0)->mutable_maskrle()->set_width(4);
+    rows.Mutable(0)->mutable_maskrle()->add_counts(3);
+    rows.Mutable(2)->mutable_maskcontour()->add_deltas(5);
+    to_columns(rows, &columns);
+    print_test_result("Mask RLE column", 3, columns.maskrle_size());
+    print_test_result("Mask contour column", 3, columns.maskcontour_size());
+    print_test_result("Compact mask columns valid", true, columns_valid(columns, true));
+    print_test_result("Compact mask to rows", true, to_rows(columns, &roundtrip));
+    print_test_result("Row 0 RLE kept", true, roundtrip.Get(0).has_maskrle() && roundtrip.Get(0).maskrle().counts(0) == 3);
+    print_test_result("Row 1 RLE unset", false, roundtrip.Get(1).has_maskrle());
+    print_test_result("Row 2 contour kept", 5, roundtrip.Get(2).maskcontour().deltas(0));
+    gather_rows(columns, {2, 0}, &filtered);
+    print_test_result("Gathered contour", 5, filtered.maskcontour(0).deltas(0));
+    print_test_result("Gathered RLE", static_cast<uint32_t>(4), filtered.maskrle(1).width());
+    columns.mutable_maskrle()->RemoveLast();
+    print_test_result("Short RLE column rejected", false, columns_valid(columns, true));
+
+    // DivisionRow 没有检测框，作为 Perception 行解码时应被拒绝
+    google::protobuf::RepeatedPtrField<DivisionRow> division;
+    division.Add()->set_cls("road");
+    to_columns(division, &columns);
+    print_test_result("Division columns without bbox", 0, columns.x1_size());
+    print_test_result("Division columns as perception rejected", false, to_rows(columns, &roundtrip));
+}
+
 // 测试字典类型
 void test_dictionary()
 {
@@ -383,6 +549,8 @@ int main()
         test_basic_types();
         test_date_timestamp();
         test_array_types();
+        test_packed_arrays();
+        test_row_columns();
         test_dictionary();
         test_serialization();
         test_type_enums();
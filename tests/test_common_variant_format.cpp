@@ -0,0 +1,177 @@
+#include <iostream>
+#include <limits>
+#include <string>
+#include "common/variant.pb.h"
+#include "variantFormatter.h"
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::utils::PB;
+
+// 简单的测试函数
+template <typename T>
+void print_test_result(const std::string &test_name, const T &expected, const T &actual)
+{
+    bool passed = (expected == actual);
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << test_name
+              << " - Expected: " << expected << ", Actual: " << actual << std::endl;
+}
+
+void print_section(const std::string &section_name)
+{
+    std::cout << "\n=== " << section_name << " ===" << std::endl;
+}
+
+std::string text(const Variant &variant, const FormatOptions &options = FormatOptions())
+{
+    std::string out;
+    format_variant(variant, &out, options);
+    return out;
+}
+
+std::string json(const Variant &variant, FormatOptions options = FormatOptions())
+{
+    options.style = FormatStyle::kJson;
+    return text(variant, options);
+}
+
+// 测试标量类型
+void test_scalars()
+{
+    print_section("Scalars");
+
+    Variant v;
+    v.set_int32value(-42);
+    print_test_result("Int32", std::string("-42"), text(v));
+    v.set_uint64value(18446744073709551615ull);
+    print_test_result("Uint64", std::string("18446744073709551615"), text(v));
+    v.set_doublevalue(0.1);
+    print_test_result("Double shortest", std::string("0.1"), text(v));
+    v.set_floatvalue(1.5f);
+    print_test_result("Float", std::string("1.5"), text(v));
+    v.set_boolvalue(true);
+    print_test_result("Bool", std::string("true"), text(v));
+    v.set_stringvalue("a\"b\\c\n");
+    print_test_result("String escaped", std::string("\"a\\\"b\\\\c\\n\""), text(v));
+    v.set_charvalue('x');
+    print_test_result("Char", std::string("\"x\""), text(v));
+    v.mutable_datevalue()->set_year(2025);
+    v.mutable_datevalue()->set_month(3);
+    v.mutable_datevalue()->set_day(7);
+    print_test_result("Date text", std::string("2025-03-07"), text(v));
+    print_test_result("Date json", std::string("\"2025-03-07\""), json(v));
+    v.mutable_timestampvalue()->set_seconds(1705123456);
+    v.mutable_timestampvalue()->set_nanos(5000);
+    print_test_result("Timestamp", std::string("1705123456.000005000"), text(v));
+    v.set_bytevalue(std::string("\x0a\xff", 2));
+    print_test_result("Bytes hex", std::string("\"0aff\""), text(v));
+    v.set_doublevalue(std::numeric_limits<double>::quiet_NaN());
+    print_test_result("NaN json", std::string("\"NaN\""), json(v));
+    v.Clear();
+    print_test_result("Unset", std::string("null"), text(v));
+}
+
+// 测试数组与截断
+void test_arrays_and_limits()
+{
+    print_section("Arrays And Limits");
+
+    Variant v;
+    for (int i = 0; i < 100; ++i)
+    {
+        v.mutable_int32arrayvalue()->add_values(i);
+    }
+    FormatOptions options;
+    options.max_elements = 3;
+    print_test_result("Array truncated text", std::string("[0, 1, 2, ...(+97)]"), text(v, options));
+    print_test_result("Array truncated json", std::string("[0,1,2,\"...(+97)\"]"), json(v, options));
+
+    v.mutable_packeduint16arrayvalue()->set_values(std::string("\x01\x00\x02\x01", 4));
+    print_test_result("Packed array", std::string("[1, 258]"), text(v));
+
+    options.max_string = 4;
+    v.set_stringvalue("abcdefgh");
+    print_test_result("String truncated", std::string("\"abcd...(+4)\""), text(v, options));
+
+    // 多字节字符不被截断在中间
+    v.set_stringvalue("ab\xe4\xb8\xad");
+    options.max_string = 3;
+    print_test_result("UTF-8 boundary", std::string("\"ab...(+3)\""), text(v, options));
+}
+
+// 测试字典与深度限制
+void test_dictionary()
+{
+    print_section("Dictionary");
+
+    Variant v;
+    (*v.mutable_dictvalue()->mutable_keyvaluelist())["timeout"].set_int32value(500);
+    print_test_result("Dict text", std::string("{timeout: 500}"), text(v));
+    print_test_result("Dict json", std::string("{\"timeout\":500}"), json(v));
+
+    Variant nested;
+    Dictionary *level = nested.mutable_dictvalue();
+    for (int depth = 0; depth < 4; ++depth)
+    {
+        level = (*level->mutable_keyvaluelist())["child"].mutable_dictvalue();
+    }
+    (*level->mutable_keyvaluelist())["leaf"].set_boolvalue(true);
+    FormatOptions options;
+    options.max_depth = 2;
+    print_test_result("Depth limited", std::string("{child: {child: {...(+1)}}}"), text(nested, options));
+    print_test_result("Depth limited json", std::string("{\"child\":{\"child\":{\"...\":1}}}"), json(nested, options));
+    print_test_result("Full depth", std::string("{child: {child: {child: {child: {leaf: true}}}}}"), text(nested));
+}
+
+// 测试反射格式化与定长缓冲区
+void test_message_and_fixed_buffer()
+{
+    print_section("Message And Fixed Buffer");
+
+    PerceptionRow row;
+    row.mutable_bbox()->set_x1(1.0f);
+    row.mutable_bbox()->set_x2(2.5f);
+    row.set_cls("person");
+    row.set_conf(0.75f);
+    std::string out;
+    format_message(row, &out);
+    print_test_result("Message text", std::string("{bbox: {x1: 1, x2: 2.5}, conf: 0.75, cls: \"person\"}"), out);
+
+    Variant v;
+    *v.mutable_perceptionrowvalue() = row;
+    FormatOptions options;
+    options.style = FormatStyle::kJson;
+    out.clear();
+    format_variant(v, &out, options);
+    print_test_result("Row json", std::string("{\"bbox\":{\"x1\":1,\"x2\":2.5},\"conf\":0.75,\"cls\":\"person\"}"), out);
+
+    char buffer[16];
+    const std::size_t written = format_message(row, buffer, sizeof(buffer));
+    print_test_result("Fixed buffer size", sizeof(buffer), written);
+    print_test_result("Fixed buffer truncated", std::string("{bbox: {x1: 1..."), std::string(buffer, written));
+
+    const std::size_t small = format_variant(v, buffer, sizeof(buffer));
+    print_test_result("Fixed buffer variant", std::string("{bbox: {x1: 1..."), std::string(buffer, small));
+}
+
+int main()
+{
+    std::cout << "Testing Variant Formatter Functionality" << std::endl;
+    std::cout << "=======================================" << std::endl;
+
+    try
+    {
+        test_scalars();
+        test_arrays_and_limits();
+        test_dictionary();
+        test_message_and_fixed_buffer();
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "All tests completed successfully!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
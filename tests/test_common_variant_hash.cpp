@@ -0,0 +1,237 @@
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "common/variant.pb.h"
+#include "variantHash.h"
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::utils::PB;
+
+// 简单的测试函数
+template <typename T>
+void print_test_result(const std::string &test_name, const T &expected, const T &actual)
+{
+    bool passed = (expected == actual);
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << test_name
+              << " - Expected: " << expected << ", Actual: " << actual << std::endl;
+}
+
+void print_section(const std::string &section_name)
+{
+    std::cout << "\n=== " << section_name << " ===" << std::endl;
+}
+
+// 按给定顺序插入同一组 key，使 map 内部布局不同
+Dictionary make_dict(const std::vector<int> &order)
+{
+    Dictionary dict;
+    auto &map = *dict.mutable_keyvaluelist();
+    for (int i : order)
+    {
+        map["key_" + std::to_string(i)].set_int32value(i);
+    }
+    auto &nested = *map["nested"].mutable_dictvalue()->mutable_keyvaluelist();
+    for (auto it = order.rbegin(); it != order.rend(); ++it)
+    {
+        nested["n_" + std::to_string(*it)].set_doublevalue(*it * 0.5);
+    }
+    return dict;
+}
+
+// 测试字节哈希
+void test_hash_bytes()
+{
+    print_section("Hash Bytes");
+
+    std::string data(1000, 'a');
+    const uint64_t base = hash_bytes(data);
+    print_test_result("Deterministic", base, hash_bytes(data.data(), data.size()));
+    print_test_result("Seed changes hash", true, base != hash_bytes(data, 1));
+
+    // 每个位置、各个尾部长度的修改都应被察觉
+    bool all_differ = true;
+    for (std::size_t i = 0; i < 40; ++i)
+    {
+        std::string changed = data;
+        changed[i] = 'b';
+        all_differ = all_differ && hash_bytes(changed) != base;
+    }
+    print_test_result("Single byte change", true, all_differ);
+
+    bool lengths_differ = true;
+    for (std::size_t n = 1; n < 70; ++n)
+    {
+        lengths_differ = lengths_differ && hash_bytes(data.data(), n) != hash_bytes(data.data(), n - 1);
+    }
+    print_test_result("Length change", true, lengths_differ);
+}
+
+// 测试标量与数组
+void test_variant_hash()
+{
+    print_section("Variant Hash");
+
+    Variant a, b;
+    a.set_int32value(7);
+    b.set_uint32value(7);
+    print_test_result("Type participates", true, hash_variant(a) != hash_variant(b));
+    print_test_result("Type mismatch unequal", false, variant_equal(a, b));
+
+    b.set_int32value(7);
+    print_test_result("Same value same hash", hash_variant(a), hash_variant(b));
+    print_test_result("Same value equal", true, variant_equal(a, b));
+
+    Variant pos, neg;
+    pos.set_doublevalue(0.0);
+    neg.set_doublevalue(-0.0);
+    print_test_result("Signed zero unequal", false, variant_equal(pos, neg));
+    pos.set_doublevalue(std::nan(""));
+    neg.set_doublevalue(std::nan(""));
+    print_test_result("Same NaN bits equal", true, variant_equal(pos, neg));
+
+    Variant arr_a, arr_b;
+    for (int i = 0; i < 1000; ++i)
+    {
+        arr_a.mutable_floatarrayvalue()->add_values(i * 0.25f);
+        arr_b.mutable_floatarrayvalue()->add_values(i * 0.25f);
+    }
+    print_test_result("Array same hash", hash_variant(arr_a), hash_variant(arr_b));
+    print_test_result("Array equal", true, variant_equal(arr_a, arr_b));
+    arr_b.mutable_floatarrayvalue()->set_values(999, 0.0f);
+    print_test_result("Array last element", true, hash_variant(arr_a) != hash_variant(arr_b));
+    print_test_result("Array unequal", false, variant_equal(arr_a, arr_b));
+
+    Variant strs_a, strs_b;
+    strs_a.mutable_stringarrayvalue()->add_values("ab");
+    strs_a.mutable_stringarrayvalue()->add_values("c");
+    strs_b.mutable_stringarrayvalue()->add_values("a");
+    strs_b.mutable_stringarrayvalue()->add_values("bc");
+    print_test_result("String array boundaries", true, hash_variant(strs_a) != hash_variant(strs_b));
+
+    Variant row_a, row_b;
+    row_a.mutable_perceptionrowvalue()->set_trackid("7");
+    row_b.mutable_perceptionrowvalue()->set_trackid("7");
+    row_b.mutable_perceptionrowvalue()->mutable_bbox();
+    print_test_result("Submessage presence", false, variant_equal(row_a, row_b));
+    row_a.mutable_perceptionrowvalue()->mutable_bbox();
+    print_test_result("Row equal", true, variant_equal(row_a, row_b));
+    print_test_result("Row same hash", hash_variant(row_a), hash_variant(row_b));
+
+    // Image.trace 参与比较：只有 trace 不同的两帧序列化结果也不同
+    Variant image_a, image_b;
+    image_a.mutable_imagevalue()->set_timestamp("1");
+    image_a.mutable_imagevalue()->set_img("pixels");
+    image_b = image_a;
+    image_b.mutable_imagevalue()->mutable_trace();
+    print_test_result("Trace presence", false, variant_equal(image_a, image_b));
+    print_test_result("Trace presence hash", true, hash_variant(image_a) != hash_variant(image_b));
+    image_a.mutable_imagevalue()->mutable_trace()->set_trace_id(9);
+    image_b.mutable_imagevalue()->mutable_trace()->set_trace_id(9);
+    image_a.mutable_imagevalue()->mutable_trace()->add_hops()->set_start_ns(100);
+    image_b.mutable_imagevalue()->mutable_trace()->add_hops()->set_start_ns(100);
+    print_test_result("Image trace equal", true, variant_equal(image_a, image_b));
+    print_test_result("Image trace same hash", hash_variant(image_a), hash_variant(image_b));
+    print_test_result("Equal matches bytes", image_a.SerializeAsString() == image_b.SerializeAsString(), variant_equal(image_a, image_b));
+    image_b.mutable_imagevalue()->mutable_trace()->mutable_hops(0)->set_duration_ns(5);
+    print_test_result("Hop differs", false, variant_equal(image_a, image_b));
+    print_test_result("Hop differs hash", true, hash_variant(image_a) != hash_variant(image_b));
+}
+
+// 测试字典顺序无关与深度比较
+void test_dictionary_hash()
+{
+    print_section("Dictionary Hash");
+
+    std::vector<int> forward, backward;
+    for (int i = 0; i < 100; ++i)
+    {
+        forward.push_back(i);
+        backward.push_back(99 - i);
+    }
+    Dictionary a = make_dict(forward);
+    Dictionary b = make_dict(backward);
+    print_test_result("Order independent", hash_dictionary(a), hash_dictionary(b));
+    print_test_result("Dictionaries equal", true, dictionary_equal(a, b));
+
+    Dictionary c = b;
+    (*(*c.mutable_keyvaluelist())["nested"].mutable_dictvalue()->mutable_keyvaluelist())["n_5"].set_doublevalue(9.0);
+    print_test_result("Nested change", true, hash_dictionary(a) != hash_dictionary(c));
+    print_test_result("Nested unequal", false, dictionary_equal(a, c));
+
+    // 交换两个 key 的值：条目求和时 key 与值必须绑定
+    Dictionary d = a;
+    (*d.mutable_keyvaluelist())["key_1"].set_int32value(2);
+    (*d.mutable_keyvaluelist())["key_2"].set_int32value(1);
+    print_test_result("Swapped values", true, hash_dictionary(a) != hash_dictionary(d));
+
+    Dictionary e = a;
+    e.mutable_keyvaluelist()->erase("key_0");
+    print_test_result("Size mismatch unequal", false, dictionary_equal(a, e));
+    print_test_result("Removed key", true, hash_dictionary(a) != hash_dictionary(e));
+
+    Dictionary empty;
+    print_test_result("Empty hash stable", hash_dictionary(empty), hash_dictionary(Dictionary()));
+}
+
+// 测试增量哈希
+void test_incremental()
+{
+    print_section("Incremental");
+
+    std::vector<int> order;
+    for (int i = 0; i < 50; ++i)
+    {
+        order.push_back(i);
+    }
+    Dictionary dict = make_dict(order);
+    DictionaryHash cache;
+    cache.reset(dict);
+    print_test_result("Reset matches", hash_dictionary(dict), cache.value());
+
+    Variant value;
+    value.set_int32value(3);
+    print_test_result("Unchanged set", false, cache.set("key_3", value));
+    value.set_int32value(42);
+    print_test_result("Changed set", true, cache.set("key_3", value));
+    (*dict.mutable_keyvaluelist())["key_3"] = value;
+    print_test_result("After update", hash_dictionary(dict), cache.value());
+
+    value.set_stringvalue("new");
+    print_test_result("New key", true, cache.set("extra", value));
+    (*dict.mutable_keyvaluelist())["extra"] = value;
+    print_test_result("After insert", hash_dictionary(dict), cache.value());
+
+    print_test_result("Remove key", true, cache.remove("key_10"));
+    print_test_result("Remove missing", false, cache.remove("key_10"));
+    dict.mutable_keyvaluelist()->erase("key_10");
+    print_test_result("After remove", hash_dictionary(dict), cache.value());
+    print_test_result("Size tracked", static_cast<std::size_t>(dict.keyvaluelist().size()), cache.size());
+
+    uint64_t value_hash = 0;
+    print_test_result("Find value hash", true, cache.find("extra", &value_hash));
+    print_test_result("Value hash matches", hash_variant(value), value_hash);
+}
+
+int main()
+{
+    std::cout << "Testing Variant Hash Functionality" << std::endl;
+    std::cout << "==================================" << std::endl;
+
+    try
+    {
+        test_hash_bytes();
+        test_variant_hash();
+        test_dictionary_hash();
+        test_incremental();
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "All tests completed successfully!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
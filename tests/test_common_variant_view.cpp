@@ -0,0 +1,230 @@
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include <google/protobuf/util/message_differencer.h>
+#include "common/variant.pb.h"
+#include "variantView.h"
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::utils::PB;
+
+// 简单的测试函数
+template <typename T>
+void print_test_result(const std::string &test_name, const T &expected, const T &actual)
+{
+    bool passed = (expected == actual);
+    std::cout << "[" << (passed ? "PASS" : "FAIL") << "] " << test_name
+              << " - Expected: " << expected << ", Actual: " << actual << std::endl;
+}
+
+void print_section(const std::string &section_name)
+{
+    std::cout << "\n=== " << section_name << " ===" << std::endl;
+}
+
+// 机器人状态字典：标量、数组、嵌套字典混合
+Dictionary make_state()
+{
+    Dictionary dict;
+    auto &map = *dict.mutable_keyvaluelist();
+    map["enabled"].set_boolvalue(true);
+    map["mode"].set_int32value(-3);
+    map["counter"].set_uint64value(std::numeric_limits<uint64_t>::max());
+    map["ticks"].set_int64value(-1234567890123LL);
+    map["speed"].set_doublevalue(0.35);
+    map["gain"].set_floatvalue(1.5f);
+    map["name"].set_stringvalue("left_arm");
+    map["flag"].set_charvalue('x');
+    auto *joints = map["joints"].mutable_doublearrayvalue();
+    for (int i = 0; i < 7; ++i)
+    {
+        joints->add_values(i * 0.5);
+    }
+    auto *ids = map["ids"].mutable_int32arrayvalue();
+    ids->add_values(-1);
+    ids->add_values(0);
+    ids->add_values(300);
+    auto *labels = map["labels"].mutable_stringarrayvalue();
+    labels->add_values("person");
+    labels->add_values("chair");
+    map["depth"].mutable_packedint16arrayvalue()->set_values(std::string("\x01\x00\xff\xff", 4));
+    map["stamp"].mutable_timestampvalue()->set_seconds(1700000000);
+    auto &nested = *map["arm"].mutable_dictvalue()->mutable_keyvaluelist();
+    nested["temperature"].set_floatvalue(41.5f);
+    nested["joint"].set_uint32value(6);
+    return dict;
+}
+
+// 测试标量读取与生成代码一致
+void test_scalars()
+{
+    print_section("Scalars");
+
+    const Dictionary state = make_state();
+    const std::string bytes = state.SerializeAsString();
+    DictionaryView view(bytes);
+    print_test_result("Size", state.keyvaluelist().size(), view.size());
+
+    VariantView value;
+    bool flag = false;
+    print_test_result("Find bool", true, view.find("enabled", &value) && value.as_bool(&flag) && flag);
+
+    int64_t i64 = 0;
+    print_test_result("Int32 sign", true, view.find("mode", &value) && value.as_int64(&i64) && i64 == -3);
+    print_test_result("Int64", true, view.find("ticks", &value) && value.as_int64(&i64) && i64 == -1234567890123LL);
+
+    uint64_t u64 = 0;
+    print_test_result("Uint64 max", true, view.find("counter", &value) && value.as_uint64(&u64) && u64 == std::numeric_limits<uint64_t>::max());
+    print_test_result("Uint64 max not int64", false, value.as_int64(&i64));
+    print_test_result("Negative not uint64", false, view.find("mode", &value) && value.as_uint64(&u64));
+
+    double d = 0;
+    print_test_result("Double", true, view.find("speed", &value) && value.as_double(&d) && d == 0.35);
+    print_test_result("Float", true, view.find("gain", &value) && value.as_double(&d) && d == 1.5);
+
+    std::string_view text;
+    print_test_result("String", true, view.find("name", &value) && value.as_string(&text) && text == "left_arm");
+    print_test_result("Type mismatch", false, value.as_bool(&flag));
+    print_test_result("Char", true, view.find("flag", &value) && value.as_int64(&i64) && i64 == 'x');
+    print_test_result("Missing key", false, view.contains("missing"));
+
+    std::string_view message;
+    Timestamp stamp;
+    print_test_result("Message bytes", true, view.find("stamp", &value) && value.as_message(&message) &&
+                                                 stamp.ParseFromArray(message.data(), static_cast<int>(message.size())) &&
+                                                 stamp.seconds() == 1700000000);
+}
+
+// 测试数组与嵌套字典
+void test_arrays_and_nesting()
+{
+    print_section("Arrays And Nesting");
+
+    const std::string bytes = make_state().SerializeAsString();
+    DictionaryView view(bytes);
+    VariantView value;
+    ArrayView array;
+
+    print_test_result("Double array", true, view.find("joints", &value) && value.as_array(&array));
+    print_test_result("Double array size", static_cast<std::size_t>(7), array.size());
+    double sum = 0;
+    for (double d; array.next(&d);)
+    {
+        sum += d;
+    }
+    print_test_result("Double array sum", 10.5, sum);
+    print_test_result("Double array bytes", static_cast<std::size_t>(56), array.bytes().size());
+
+    view.find("ids", &value);
+    value.as_array(&array);
+    std::vector<int64_t> ids;
+    for (int64_t v; array.next(&v);)
+    {
+        ids.push_back(v);
+    }
+    print_test_result("Int32 array", true, ids == std::vector<int64_t>{-1, 0, 300});
+
+    view.find("labels", &value);
+    value.as_array(&array);
+    std::string joined;
+    for (std::string_view s; array.next(&s);)
+    {
+        joined.append(s.data(), s.size()).push_back(',');
+    }
+    print_test_result("String array", std::string("person,chair,"), joined);
+
+    view.find("depth", &value);
+    value.as_array(&array);
+    std::vector<int64_t> depth;
+    for (int64_t v; array.next(&v);)
+    {
+        depth.push_back(v);
+    }
+    print_test_result("Packed int16", true, depth == std::vector<int64_t>{1, -1});
+
+    DictionaryView nested;
+    print_test_result("Nested dictionary", true, view.find("arm", &value) && value.as_dictionary(&nested));
+    double d = 0;
+    print_test_result("Nested value", true, nested.find("temperature", &value) && value.as_double(&d) && d == 41.5);
+    print_test_result("Validate", true, view.validate());
+
+    // 从外层消息取出字典：Dictionary 的 keyValueList 也是字段 1，这里用 Variant.dictValue = 18
+    Variant wrapper;
+    *wrapper.mutable_dictvalue() = make_state();
+    const std::string wrapped = wrapper.SerializeAsString();
+    std::string_view inner;
+    print_test_result("Find message field", true, find_message_field(wrapped, Variant::kDictValue, &inner) && DictionaryView(inner).contains("arm"));
+}
+
+// 测试遍历结果与生成代码解析结果一致
+void test_matches_generated_parser()
+{
+    print_section("Matches Generated Parser");
+
+    const Dictionary state = make_state();
+    const std::string bytes = state.SerializeAsString();
+    std::size_t matched = 0;
+    DictionaryView(bytes).for_each([&](std::string_view key, const VariantView &value)
+                                   {
+        Variant parsed;
+        value.materialize(&parsed);
+        auto it = state.keyvaluelist().find(std::string(key));
+        if (it != state.keyvaluelist().end() && google::protobuf::util::MessageDifferencer::Equals(it->second, parsed) &&
+            it->second.value_case() == value.value_case())
+        {
+            ++matched;
+        }
+        return true; });
+    print_test_result("Entries match", state.keyvaluelist().size(), matched);
+
+    // 重复 key：后出现的覆盖前面的
+    Dictionary first;
+    (*first.mutable_keyvaluelist())["k"].set_int32value(1);
+    Dictionary second;
+    (*second.mutable_keyvaluelist())["k"].set_int32value(2);
+    const std::string duplicated = first.SerializeAsString() + second.SerializeAsString();
+    Dictionary parsed;
+    parsed.ParseFromString(duplicated);
+    VariantView value;
+    int64_t v = 0;
+    DictionaryView(duplicated).find("k", &value);
+    value.as_int64(&v);
+    print_test_result("Duplicate key last wins", static_cast<int64_t>(parsed.keyvaluelist().at("k").int32value()), v);
+
+    // 截断输入：逐个前缀比较校验结果
+    std::size_t agree = 0;
+    for (std::size_t n = 0; n <= bytes.size(); ++n)
+    {
+        const std::string prefix = bytes.substr(0, n);
+        Dictionary dict;
+        if (dict.ParseFromString(prefix) == DictionaryView(prefix).validate())
+        {
+            ++agree;
+        }
+    }
+    print_test_result("Truncated prefixes agree", bytes.size() + 1, agree);
+}
+
+int main()
+{
+    std::cout << "Testing Variant View Functionality" << std::endl;
+    std::cout << "==================================" << std::endl;
+
+    try
+    {
+        test_scalars();
+        test_arrays_and_nesting();
+        test_matches_generated_parser();
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "All tests completed successfully!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
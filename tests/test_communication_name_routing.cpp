@@ -0,0 +1,277 @@
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <grpcpp/grpcpp.h>
+#include "nameRouting.h"
+#include "printUtil.h"
+using namespace humanoid_robot::PB::communication;
+using namespace humanoid_robot::utils::PB;
+
+// 回显处理函数：payload 前加上服务名与调用方
+grpc::Status echo_handler(const RpcRoute &route, const ServiceRequest &request, ServiceResponse *response)
+{
+    response->set_success(true);
+    response->set_payload(route.service_name + "|" + route.client_id + "@" + route.node_name + "|" + request.payload());
+    return grpc::Status::OK;
+}
+
+ServiceRequest named_request(const std::string &service, const std::string &payload)
+{
+    ServiceRequest request;
+    request.set_service_name(service);
+    request.set_client_id("client-1");
+    request.set_node_name("arm_node");
+    request.set_payload(payload);
+    return request;
+}
+
+// 测试驻留表
+void test_intern_table()
+{
+    print_section("Intern Table");
+
+    InternTable<std::string> table(300);
+    const uint32_t a = table.intern("alpha", []() { return std::string("A"); });
+    const uint32_t b = table.intern("beta", []() { return std::string("B"); });
+    print_test_result("Ids start at 1", static_cast<uint32_t>(1), a);
+    print_test_result("Ids dense", static_cast<uint32_t>(2), b);
+    print_test_result("Existing key keeps id", a, table.intern("alpha", []() { return std::string("X"); }));
+    print_test_result("Entry by id", std::string("A"), *table.get(a));
+    print_test_result("Find missing", static_cast<uint32_t>(0), table.find("gamma"));
+    print_test_result("Id 0 invalid", true, table.get(0) == nullptr);
+    print_test_result("Unassigned id invalid", true, table.get(3) == nullptr);
+
+    // 容量向上取整到整块（256）：跨块后地址不变，超过容量返回 0
+    const std::string *first = table.get(a);
+    uint32_t last = 0;
+    for (int i = 0; i < 600; ++i)
+    {
+        last = table.intern("k" + std::to_string(i), [i]() { return std::to_string(i); });
+        if (last == 0)
+        {
+            break;
+        }
+    }
+    print_test_result("Full table returns 0", static_cast<uint32_t>(0), last);
+    print_test_result("Capacity rounded to chunks", static_cast<uint32_t>(512), table.size());
+    print_test_result("Entries stable across chunks", true, first == table.get(a) && *table.get(300) == "297");
+
+    InternTable<int> shared;
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&]()
+                             {
+            for (int i = 0; i < 1000; ++i)
+            {
+                const uint32_t id = shared.intern("n" + std::to_string(i), [i]() { return i; });
+                mismatches += *shared.get(id) == i ? 0 : 1;
+            } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    print_test_result("Concurrent intern consistent", 0, mismatches.load());
+    print_test_result("Concurrent intern dedups", static_cast<uint32_t>(1000), shared.size());
+}
+
+// 测试 RpcRouter 握手、按 id 分发与回退
+void test_rpc_router()
+{
+    print_section("Rpc Router");
+
+    RpcRouter router;
+    router.add_service("/arm/move", echo_handler);
+    router.add_service("/arm/stop", echo_handler);
+    RpcRouteHandle handle("/arm/move", "client-1", "arm_node");
+
+    ServiceRequest request;
+    ServiceResponse response;
+    handle.prepare(&request);
+    request.set_payload("p1");
+    router.dispatch(request, &response);
+    print_test_result("Handshake carries names", std::string("/arm/move"), request.service_name());
+    print_test_result("Handshake dispatched", std::string("/arm/move|client-1@arm_node|p1"), response.payload());
+    print_test_result("Route id assigned", true, response.route_id() != 0);
+    print_test_result("No retry", false, handle.on_response(response));
+
+    ServiceRequest compact;
+    handle.prepare(&compact);
+    compact.set_payload("p2");
+    response.Clear();
+    router.dispatch(compact, &response);
+    print_test_result("Compact request has no names", true,
+                      compact.service_name().empty() && compact.client_id().empty() && compact.node_name().empty());
+    print_test_result("Compact request smaller", true, compact.ByteSizeLong() + 20 < request.ByteSizeLong());
+    print_test_result("Id dispatch restores caller", std::string("/arm/move|client-1@arm_node|p2"), response.payload());
+
+    // 同一服务不同调用方分配不同路由；重复握手复用已有路由
+    ServiceResponse other;
+    ServiceRequest other_request = named_request("/arm/move", "x");
+    other_request.set_client_id("client-2");
+    router.dispatch(other_request, &other);
+    ServiceResponse again;
+    router.dispatch(named_request("/arm/move", "y"), &again);
+    print_test_result("Distinct caller distinct route", true, other.route_id() != handle.route_id());
+    print_test_result("Repeated handshake reuses route", handle.route_id(), again.route_id());
+
+    ServiceResponse unknown;
+    router.dispatch(named_request("/arm/missing", ""), &unknown);
+    print_test_result("Unknown service fails", false, unknown.success());
+    print_test_result("Unknown service not routed", static_cast<uint64_t>(0), unknown.route_id());
+
+    RpcRouterStats stats = router.stats();
+    print_test_result("Stats by id", static_cast<uint64_t>(1), stats.by_id);
+    print_test_result("Stats routes", static_cast<uint32_t>(2), stats.routes);
+}
+
+// 测试服务端重启后的 unknown_route 与旧版 Client
+void test_restart_and_legacy()
+{
+    print_section("Restart And Legacy");
+
+    RpcRouter first;
+    first.add_service("/arm/move", echo_handler);
+    RpcRouteHandle handle("/arm/move", "client-1", "arm_node");
+    ServiceRequest request;
+    ServiceResponse response;
+    handle.prepare(&request);
+    first.dispatch(request, &response);
+    handle.on_response(response);
+
+    // 新实例注册了不同的服务，旧 id 的低位恰好有效，也不能被解析
+    RpcRouter restarted;
+    restarted.add_service("/arm/stop", echo_handler);
+    restarted.add_service("/arm/move", echo_handler);
+    restarted.dispatch(named_request("/arm/stop", ""), &response);
+    handle.prepare(&request);
+    response.Clear();
+    restarted.dispatch(request, &response);
+    print_test_result("Stale id rejected", true, response.unknown_route() && !response.success());
+    print_test_result("Retry requested", true, handle.on_response(response));
+
+    handle.prepare(&request);
+    request.set_payload("retry");
+    response.Clear();
+    restarted.dispatch(request, &response);
+    print_test_result("Retry with names", std::string("/arm/move|client-1@arm_node|retry"), response.payload());
+    handle.on_response(response);
+    print_test_result("New route id learned", response.route_id(), handle.route_id());
+
+    // 旧版 Client 只发名称，旧版服务端不返回 route_id
+    response.Clear();
+    restarted.dispatch(named_request("/arm/move", "legacy"), &response);
+    print_test_result("Legacy client served", true, response.success());
+    RpcRouteHandle legacy_server("/arm/move", "client-1", "arm_node");
+    ServiceResponse old_response;
+    old_response.set_success(true);
+    legacy_server.on_response(old_response);
+    legacy_server.prepare(&request);
+    print_test_result("Legacy server keeps names", std::string("/arm/move"), request.service_name());
+}
+
+// 测试 RoutedRpcService 的 gRPC 往返
+void test_grpc_service()
+{
+    print_section("Routed RpcService");
+
+    RpcRouter router;
+    router.add_service("/arm/move", echo_handler);
+    RoutedRpcService service(&router);
+    int port = 0;
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(), &port);
+    builder.RegisterService(&service);
+    auto server = builder.BuildAndStart();
+    auto stub = RpcService::NewStub(grpc::CreateChannel("127.0.0.1:" + std::to_string(port), grpc::InsecureChannelCredentials()));
+
+    RpcRouteHandle handle("/arm/move", "client-1", "arm_node");
+    int ok = 0;
+    for (int i = 0; i < 5; ++i)
+    {
+        grpc::ClientContext context;
+        ServiceRequest request;
+        ServiceResponse response;
+        handle.prepare(&request);
+        request.set_request_id(static_cast<uint64_t>(i));
+        request.set_payload(std::to_string(i));
+        ok += stub->Call(&context, request, &response).ok() && response.request_id() == static_cast<uint64_t>(i) &&
+                      response.payload() == "/arm/move|client-1@arm_node|" + std::to_string(i)
+                  ? 1
+                  : 0;
+        handle.on_response(response);
+    }
+    print_test_result("All calls served", 5, ok);
+    RpcRouterStats stats = router.stats();
+    print_test_result("One handshake", static_cast<uint64_t>(1), stats.by_name);
+    print_test_result("Rest by id", static_cast<uint64_t>(4), stats.by_id);
+    server->Shutdown();
+}
+
+// 测试 TopicMessage 名称编码
+void test_topic_names()
+{
+    print_section("Topic Names");
+
+    SubscribeRequest subscribe;
+    prepare_name_ids(&subscribe);
+    TopicNameEncoder encoder(subscribe);
+    TopicNameDecoder decoder;
+
+    std::vector<TopicMessage> wire(3);
+    encoder.stamp("/camera/front", "pub-1", &wire[0]);
+    encoder.stamp("/camera/front", "pub-1", &wire[1]);
+    encoder.stamp("/camera/rear", "pub-1", &wire[2]);
+    print_test_result("First message carries names", std::string("/camera/front"), wire[0].topic_name());
+    print_test_result("Later message id only", true, wire[1].topic_name().empty() && wire[1].publisher_id().empty());
+    print_test_result("Same id", wire[0].name_id(), wire[1].name_id());
+    print_test_result("New names new id", static_cast<uint32_t>(2), wire[2].name_id());
+
+    print_test_result("Decoder id", static_cast<uint32_t>(1), decoder.observe(&wire[0]));
+    const uint32_t id = decoder.observe(&wire[1], true);
+    print_test_result("Names restored", std::string("/camera/front"), wire[1].topic_name());
+    print_test_result("Names by id", std::string("pub-1"), decoder.names(id)->publisher_id);
+    print_test_result("Unseen id", true, decoder.names(2) == nullptr);
+
+    TopicMessage skipped;
+    skipped.set_name_id(9);
+    skipped.set_topic_name("/bogus");
+    decoder.observe(&skipped);
+    print_test_result("Out-of-order id not registered", true, decoder.names(9) == nullptr);
+
+    TopicNameEncoder legacy{SubscribeRequest()};
+    TopicMessage message;
+    legacy.stamp("/camera/front", "pub-1", &message);
+    legacy.stamp("/camera/front", "pub-1", &message);
+    print_test_result("Legacy subscriber gets names", std::string("/camera/front"), message.topic_name());
+    print_test_result("Legacy subscriber no id", static_cast<uint32_t>(0), message.name_id());
+}
+
+int main()
+{
+    std::cout << "Testing Name Routing Functionality" << std::endl;
+    std::cout << "==================================" << std::endl;
+
+    try
+    {
+        test_intern_table();
+        test_rpc_router();
+        test_restart_and_legacy();
+        test_grpc_service();
+        test_topic_names();
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "All tests completed successfully!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,198 @@
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "payloadCodec.h"
+#include "printUtil.h"
+#include "common/variant.pb.h"
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::PB::communication;
+using namespace humanoid_robot::utils::PB;
+
+// 每条都带同一组 key 的机器人状态 Dictionary，数值随序号变化
+std::string robot_state(int sequence)
+{
+    static const char *joints[] = {"left_hip_pitch", "left_hip_roll", "left_knee", "left_ankle_pitch",
+                                   "right_hip_pitch", "right_hip_roll", "right_knee", "right_ankle_pitch",
+                                   "left_shoulder_pitch", "left_elbow", "right_shoulder_pitch", "right_elbow"};
+    Dictionary dict;
+    auto &map = *dict.mutable_keyvaluelist();
+    for (int i = 0; i < 12; ++i)
+    {
+        const std::string joint = joints[i];
+        map[joint + ".position"].set_doublevalue(std::sin(sequence * 0.01 + i));
+        map[joint + ".velocity"].set_floatvalue(static_cast<float>(std::cos(sequence * 0.01 + i)));
+        map[joint + ".temperature"].set_int32value(40 + (sequence + i) % 3);
+    }
+    map["locomotion.mode"].set_stringvalue("walking");
+    map["battery.percent"].set_floatvalue(87.5f);
+    return dict.SerializeAsString();
+}
+
+std::string random_bytes(std::size_t size)
+{
+    std::mt19937 rng(7);
+    std::string out(size, '\0');
+    for (auto &c : out)
+    {
+        c = static_cast<char>(rng());
+    }
+    return out;
+}
+
+// 测试编码协商
+void test_negotiation()
+{
+    print_section("Negotiation");
+
+    google::protobuf::RepeatedField<int> none;
+    print_test_result("Legacy peer gets NONE", static_cast<int>(PAYLOAD_CODEC_NONE), static_cast<int>(negotiate_codec(PAYLOAD_CODEC_LZ4, none)));
+
+    google::protobuf::RepeatedField<int> mine;
+    advertise_codecs(&mine);
+    print_test_result("Advertised matches available", static_cast<int>(available_codecs().size()), mine.size());
+
+    google::protobuf::RepeatedField<int> zstd_only;
+    zstd_only.Add(PAYLOAD_CODEC_ZSTD);
+    const PayloadCodec expected = codec_available(PAYLOAD_CODEC_ZSTD) ? PAYLOAD_CODEC_ZSTD : PAYLOAD_CODEC_NONE;
+    print_test_result("Falls back to common codec", static_cast<int>(expected), static_cast<int>(negotiate_codec(PAYLOAD_CODEC_LZ4, zstd_only)));
+    print_test_result("NONE stays NONE", static_cast<int>(PAYLOAD_CODEC_NONE), static_cast<int>(negotiate_codec(PAYLOAD_CODEC_NONE, mine)));
+}
+
+// 测试各编码的往返与阈值
+void test_roundtrip(PayloadCodec codec, const std::string &name)
+{
+    print_section("Roundtrip " + name);
+    if (!codec_available(codec))
+    {
+        std::cout << name << " not compiled in, skipped" << std::endl;
+        return;
+    }
+
+    CodecOptions options;
+    options.codec = codec;
+    PayloadCompressor compressor(options);
+    PayloadDecompressor decompressor;
+
+    const std::string state = robot_state(1);
+    std::string wire;
+    print_test_result("Compressed", static_cast<int>(codec), static_cast<int>(compressor.compress(state, &wire)));
+    print_test_result("Repeated keys shrink", true, wire.size() * 4 < state.size() * 3);
+    std::string back;
+    print_test_result("Decompress ok", true, decompressor.decompress(codec, wire, &back));
+    print_test_result("Roundtrip equal", state, back);
+
+    print_test_result("Small payload raw", static_cast<int>(PAYLOAD_CODEC_NONE),
+                      static_cast<int>(compressor.compress(std::string(32, 'a'), &wire)));
+    print_test_result("Small payload copied", std::string(32, 'a'), wire);
+    print_test_result("Random payload raw", static_cast<int>(PAYLOAD_CODEC_NONE),
+                      static_cast<int>(compressor.compress(random_bytes(4096), &wire)));
+
+    const CodecStats &stats = compressor.stats();
+    print_test_result("Below threshold counted", static_cast<uint64_t>(1), stats.below_threshold);
+    print_test_result("No gain counted", static_cast<uint64_t>(1), stats.no_gain);
+
+    // 消息就地压缩
+    UniversalRequest request;
+    request.set_payload(state);
+    request.set_payloadsize(static_cast<int32_t>(state.size()));
+    compressor.compress(&request);
+    print_test_result("Request codec set", static_cast<int>(codec), static_cast<int>(request.payloadcodec()));
+    print_test_result("Request decompress", true, decompressor.decompress(&request) && request.payload() == state);
+    print_test_result("Request codec reset", static_cast<int>(PAYLOAD_CODEC_NONE), static_cast<int>(request.payloadcodec()));
+
+    ServiceResponse response;
+    response.set_payload(state);
+    compressor.compress(&response);
+    print_test_result("Service response roundtrip", true, decompressor.decompress(&response) && response.payload() == state);
+
+    // 损坏与超限
+    compressor.compress(state, &wire);
+    std::string corrupt = wire.substr(0, wire.size() / 2);
+    print_test_result("Truncated rejected", false, decompressor.decompress(codec, corrupt, &back));
+    PayloadDecompressor limited(state.size() - 1);
+    print_test_result("Over limit rejected", false, limited.decompress(codec, wire, &back));
+}
+
+// 测试按 Topic 训练字典与带内下发
+void test_dictionary()
+{
+    print_section("Zstd Dictionary");
+    if (!codec_available(PAYLOAD_CODEC_ZSTD))
+    {
+        std::cout << "zstd not compiled in, skipped" << std::endl;
+        return;
+    }
+
+    CodecOptions options;
+    options.codec = PAYLOAD_CODEC_ZSTD;
+    options.train_samples = 64;
+    PayloadCompressor trained(options);
+    options.train_samples = 0;
+    PayloadCompressor plain(options);
+    PayloadDecompressor decompressor;
+
+    int announced = 0;
+    int mismatches = 0;
+    std::size_t trained_bytes = 0;
+    std::size_t plain_bytes = 0;
+    for (int i = 0; i < 200; ++i)
+    {
+        // map 的序列化顺序不保证稳定，保留原始字节用于比较
+        const std::string state = robot_state(i);
+        TopicMessage message;
+        message.set_payload(state);
+        trained.compress(&message);
+        announced += message.codec_dictionary().empty() ? 0 : 1;
+        if (i >= 100)
+        {
+            trained_bytes += message.payload().size();
+            std::string wire;
+            plain.compress(state, &wire);
+            plain_bytes += wire.size();
+        }
+        mismatches += decompressor.decompress(&message) && message.payload() == state ? 0 : 1;
+    }
+    print_test_result("Dictionary trained", true, trained.dictionary() != nullptr);
+    print_test_result("Dictionary sent once", 1, announced);
+    print_test_result("All messages roundtrip", 0, mismatches);
+    print_test_result("Dictionary beats plain zstd", true, trained_bytes * 3 < plain_bytes * 2);
+
+    // 未收到字典的接收端无法解压
+    const std::string state = robot_state(500);
+    TopicMessage message;
+    message.set_payload(state);
+    trained.compress(&message);
+    PayloadDecompressor fresh;
+    print_test_result("Missing dictionary rejected", false, fresh.decompress(&message));
+    fresh.add_dictionary(ZstdDictionary::load(trained.dictionary()->content()));
+    print_test_result("Dictionary added out of band", true, fresh.decompress(&message) && message.payload() == state);
+
+    print_test_result("Too few samples", true, ZstdDictionary::train({"a", "b"}) == nullptr);
+    print_test_result("Raw content rejected", true, ZstdDictionary::load("not a dictionary") == nullptr);
+}
+
+int main()
+{
+    std::cout << "Testing Payload Codec Functionality" << std::endl;
+    std::cout << "===================================" << std::endl;
+
+    try
+    {
+        test_negotiation();
+        test_roundtrip(PAYLOAD_CODEC_LZ4, "LZ4");
+        test_roundtrip(PAYLOAD_CODEC_ZSTD, "Zstd");
+        test_dictionary();
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "All tests completed successfully!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,397 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "payloadChecksum.h"
+#include "payloadCodec.h"
+#include "printUtil.h"
+#include "requestBatch.h"
+#include "spanTracer.h"
+#include "communication/communication_service.pb.h"
+using namespace humanoid_robot::PB::communication;
+using namespace humanoid_robot::utils::PB;
+
+namespace
+{
+    UniversalRequest make_request(int32_t id, int64_t timestamp, const std::string &payload)
+    {
+        UniversalRequest request;
+        request.set_command(100 + id % 3);
+        request.set_version(2);
+        request.set_requestid(id);
+        request.set_sendrequesttimestamp(timestamp);
+        request.set_payloadtype(7);
+        request.set_payload(payload);
+        request.set_payloadsize(static_cast<int32_t>(payload.size()));
+        seal_checksum(&request);
+        return request;
+    }
+
+    std::vector<UniversalRequest> make_requests(int count)
+    {
+        std::vector<UniversalRequest> requests;
+        for (int i = 0; i < count; ++i)
+        {
+            requests.push_back(make_request(1000 + i, 1705123456789LL + 3 * i, "payload_" + std::to_string(i)));
+        }
+        return requests;
+    }
+
+    bool same_requests(const std::vector<UniversalRequest> &a, const std::vector<UniversalRequest> &b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            if (a[i].SerializeAsString() != b[i].SerializeAsString())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace
+
+// 测试打包与拆包往返
+void test_roundtrip()
+{
+    print_section("Batch Round Trip");
+
+    const std::vector<UniversalRequest> requests = make_requests(5);
+    UniversalRequest envelope;
+    pack_batch(requests, &envelope);
+    print_test_result("Envelope type", true, is_batch_envelope(envelope));
+    print_test_result("Envelope base id", 1000, envelope.requestid());
+    print_test_result("Envelope checksum", true, verify_checksum(envelope));
+
+    std::vector<UniversalRequest> out;
+    print_test_result("Unpack", true, unpack_batch(envelope, &out));
+    print_test_result("Requests identical", true, same_requests(requests, out));
+    bool checksums = true;
+    for (const UniversalRequest &request : out)
+    {
+        checksums = checksums && verify_checksum(request);
+    }
+    print_test_result("Item checksums preserved", true, checksums);
+
+    // requestId 回绕与时间戳回退按差值编码
+    std::vector<UniversalRequest> wrapping{make_request(2147483647, 500, "a"), make_request(-2147483647 - 1, 400, ""),
+                                           make_request(-5, -10, "c")};
+    pack_batch(wrapping, &envelope);
+    out.clear();
+    print_test_result("Wrapping unpack", true, unpack_batch(envelope, &out));
+    print_test_result("Wrapping identical", true, same_requests(wrapping, out));
+
+    pack_batch({}, &envelope);
+    out.clear();
+    print_test_result("Empty batch", true, unpack_batch(envelope, &out) && out.empty());
+
+    // 追加到已有内容之后
+    out.assign(1, make_request(1, 1, "existing"));
+    pack_batch(requests, &envelope);
+    print_test_result("Appends after existing", true, unpack_batch(envelope, &out) && out.size() == 6 && out[0].payload() == "existing");
+}
+
+// 测试压缩负载：编码、可接受编码与原始 payloadSize 随条目往返
+void test_compressed()
+{
+    print_section("Compressed Payloads");
+    if (!codec_available(PAYLOAD_CODEC_LZ4))
+    {
+        std::cout << "lz4 not compiled in, skipped" << std::endl;
+        return;
+    }
+
+    CodecOptions options;
+    options.codec = PAYLOAD_CODEC_LZ4;
+    options.min_size = 16;
+    PayloadCompressor compressor(options);
+
+    std::vector<UniversalRequest> requests;
+    const std::string raw(512, 'r');
+    for (int i = 0; i < 3; ++i)
+    {
+        UniversalRequest request = make_request(3000 + i, 100 + i, raw);
+        advertise_codecs(request.mutable_acceptcodecs());
+        if (i != 1)
+        {
+            compressor.compress(&request);
+        }
+        seal_checksum(&request);
+        requests.push_back(request);
+    }
+    print_test_result("Payload compressed", true, requests[0].payloadcodec() == PAYLOAD_CODEC_LZ4 && requests[0].payload().size() < raw.size());
+
+    UniversalRequest envelope;
+    pack_batch(requests, &envelope);
+    std::vector<UniversalRequest> out;
+    print_test_result("Unpack", true, unpack_batch(envelope, &out));
+    print_test_result("Requests identical", true, same_requests(requests, out));
+    print_test_result("Codec kept", static_cast<int>(PAYLOAD_CODEC_LZ4), out.empty() ? -1 : static_cast<int>(out[0].payloadcodec()));
+    print_test_result("Original size kept", static_cast<int32_t>(raw.size()), out.empty() ? -1 : out[0].payloadsize());
+    print_test_result("Accept codecs kept", requests[0].acceptcodecs_size(), out.empty() ? -1 : out[0].acceptcodecs_size());
+
+    PayloadDecompressor decompressor;
+    print_test_result("Decompressed after unpack", true, out.size() == 3 && verify_checksum(out[0]) && decompressor.decompress(&out[0]) && out[0].payload() == raw);
+
+    // 生成代码解析同一帧，字段与 proto 定义一致
+    RequestBatch batch;
+    print_test_result("Generated parser", true, batch.ParseFromString(envelope.payload()) && batch.requests_size() == 3);
+    print_test_result("Generated payloadSize", static_cast<int32_t>(raw.size()), batch.requests(0).payloadsize());
+    print_test_result("Size omitted when equal", 0, batch.requests(1).payloadsize());
+    print_test_result("Generated accept codecs", requests[0].acceptcodecs_size(), batch.requests(0).acceptcodecs_size());
+}
+
+// 测试追踪上下文随批次传递
+void test_traced()
+{
+    print_section("Traced Requests");
+
+    std::vector<UniversalRequest> requests = make_requests(3);
+    start_trace(requests[0].mutable_trace());
+    add_hop(requests[0].mutable_trace(), humanoid_robot::PB::common::TRACE_STAGE_CAPTURE, 1000, 2000);
+    add_hop(requests[0].mutable_trace(), humanoid_robot::PB::common::TRACE_STAGE_PERCEPTION, 2500, 4000);
+    requests[2].mutable_trace()->set_trace_id(42); // 只有 id、没有阶段
+
+    UniversalRequest envelope;
+    pack_batch(requests, &envelope);
+    std::vector<UniversalRequest> out;
+    print_test_result("Unpack", true, unpack_batch(envelope, &out));
+    print_test_result("Requests identical", true, same_requests(requests, out));
+    print_test_result("Trace hops kept", 2, out.empty() ? -1 : out[0].trace().hops_size());
+    print_test_result("Untraced stays untraced", false, out.size() == 3 && out[1].has_trace());
+    print_test_result("Empty trace kept", static_cast<uint64_t>(42), out.size() == 3 ? out[2].trace().trace_id() : 0);
+
+    RequestBatch batch;
+    print_test_result("Generated parser", true, batch.ParseFromString(envelope.payload()) && batch.requests_size() == 3);
+    print_test_result("Generated trace", requests[0].trace().SerializeAsString(), batch.requests(0).trace().SerializeAsString());
+
+    // trace 长度超出条目边界
+    UniversalRequest single;
+    single.mutable_trace()->set_trace_id(7);
+    pack_batch({single}, &envelope);
+    std::string *frame = envelope.mutable_payload();
+    const std::size_t at = frame->rfind(std::string("\x5a\x09", 2));
+    bool rejected = at != std::string::npos;
+    if (rejected)
+    {
+        (*frame)[at + 1] = 0x7f;
+        seal_checksum(&envelope);
+        rejected = !unpack_batch(envelope, &out);
+    }
+    print_test_result("Overlong trace rejected", true, rejected);
+}
+
+// 测试截断与畸形信封
+void test_malformed()
+{
+    print_section("Malformed Envelope");
+
+    const std::vector<UniversalRequest> requests = make_requests(4);
+    UniversalRequest envelope;
+    pack_batch(requests, &envelope);
+    std::vector<UniversalRequest> out;
+
+    print_test_result("Plain request rejected", false, unpack_batch(requests[0], &out));
+
+    UniversalRequest wrong_version = envelope;
+    wrong_version.set_version(99);
+    print_test_result("Unknown version rejected", false, unpack_batch(wrong_version, &out));
+
+    UniversalRequest corrupted = envelope;
+    (*corrupted.mutable_payload())[corrupted.payload().size() / 2] ^= 0x01;
+    print_test_result("Checksum mismatch rejected", false, unpack_batch(corrupted, &out));
+
+    // 截断后重新封装校验和，只留下格式错误：在条目边界截断是合法的短批量，其余必须拒绝且不追加
+    bool truncation_safe = true;
+    for (std::size_t cut = 1; cut < envelope.payload().size(); ++cut)
+    {
+        UniversalRequest truncated = envelope;
+        truncated.mutable_payload()->resize(cut);
+        seal_checksum(&truncated);
+        std::vector<UniversalRequest> partial;
+        const bool ok = unpack_batch(truncated, &partial);
+        if ((ok && partial.size() >= requests.size()) || (!ok && !partial.empty()))
+        {
+            truncation_safe = false;
+        }
+    }
+    print_test_result("Truncated frames rejected or shorter", true, truncation_safe);
+
+    UniversalRequest garbage = envelope;
+    garbage.set_payload(std::string("\x1a\xff\xff\xff\xff\x0f", 6));
+    seal_checksum(&garbage);
+    out.clear();
+    print_test_result("Oversized item length rejected", false, unpack_batch(garbage, &out));
+    print_test_result("Nothing appended", static_cast<std::size_t>(0), out.size());
+
+    garbage.set_payload(std::string("\x1a\x02\x08", 3));
+    seal_checksum(&garbage);
+    print_test_result("Item past frame end rejected", false, unpack_batch(garbage, &out));
+
+    garbage.set_payload(std::string("\x1f", 1));
+    seal_checksum(&garbage);
+    print_test_result("Invalid wire type rejected", false, unpack_batch(garbage, &out));
+
+    RequestDemultiplexer demux([](UniversalRequest &&) {});
+    print_test_result("Demultiplexer rejects corrupt", false, demux.dispatch(std::move(corrupted)));
+}
+
+// 测试合并器按条数、字节数与时间刷出
+void test_coalescer()
+{
+    print_section("Coalescer");
+
+    std::vector<UniversalRequest> received;
+    std::vector<std::size_t> frame_sizes;
+    RequestDemultiplexer demux([&received](UniversalRequest &&request)
+                               { received.push_back(std::move(request)); });
+    RequestCoalescer *self = nullptr;
+    std::size_t pending_seen_in_sink = 0;
+    bool last_frame_batch = false;
+    auto sink = [&](const UniversalRequest &frame)
+    {
+        last_frame_batch = is_batch_envelope(frame);
+        // sink 在队列锁外调用：这里查询合并器不会死锁
+        pending_seen_in_sink = self->pending_count();
+        std::vector<UniversalRequest> items;
+        frame_sizes.push_back(is_batch_envelope(frame) && unpack_batch(frame, &items) ? items.size() : 1);
+        UniversalRequest copy = frame;
+        return demux.dispatch(std::move(copy));
+    };
+
+    CoalescerOptions options;
+    options.max_count = 4;
+    options.max_bytes = 1024;
+    options.max_latency = std::chrono::milliseconds(5);
+    {
+        RequestCoalescer coalescer(options, sink);
+        self = &coalescer;
+        const std::vector<UniversalRequest> requests = make_requests(9);
+
+        // 条数：第 4 条触发刷出
+        for (int i = 0; i < 4; ++i)
+        {
+            coalescer.add(requests[static_cast<std::size_t>(i)]);
+        }
+        print_test_result("Flush by count", static_cast<std::size_t>(1), frame_sizes.size());
+        print_test_result("Batch of four", static_cast<std::size_t>(4), frame_sizes.back());
+        print_test_result("Sink ran outside queue lock", static_cast<std::size_t>(0), pending_seen_in_sink);
+
+        // 时间：未到 max_latency 时不发送，之后 poll 刷出；单条不加信封
+        coalescer.add(requests[4]);
+        const auto now = std::chrono::steady_clock::now();
+        coalescer.poll(now);
+        print_test_result("Poll before deadline keeps pending", static_cast<std::size_t>(1), coalescer.pending_count());
+        coalescer.poll(now + options.max_latency);
+        print_test_result("Flush by time", static_cast<std::size_t>(2), frame_sizes.size());
+        print_test_result("Single request unwrapped", false, last_frame_batch);
+
+        // 字节数：累计负载超过 max_bytes 触发刷出
+        coalescer.add(make_request(2000, 1, std::string(400, 'a')));
+        coalescer.add(make_request(2001, 2, std::string(400, 'b')));
+        print_test_result("Below byte limit pending", static_cast<std::size_t>(2), coalescer.pending_count());
+        coalescer.add(make_request(2002, 3, std::string(400, 'c')));
+        print_test_result("Flush by bytes", static_cast<std::size_t>(3), frame_sizes.back());
+
+        // 超大请求先刷出已有请求再单独发送，顺序不变
+        coalescer.add(requests[5]);
+        coalescer.add(make_request(2003, 4, std::string(2048, 'd')));
+        print_test_result("Large request after pending", true, received.size() >= 2 && received[received.size() - 2].requestid() == requests[5].requestid() && received.back().requestid() == 2003);
+
+        // 后台线程按 max_latency 刷出
+        coalescer.start();
+        coalescer.add(requests[6]);
+        coalescer.add(requests[7]);
+        for (int i = 0; i < 200 && coalescer.pending_count() != 0; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        print_test_result("Background flush", static_cast<std::size_t>(0), coalescer.pending_count());
+        coalescer.add(requests[8]);
+        coalescer.stop();
+        print_test_result("Stop flushes remainder", static_cast<std::size_t>(0), coalescer.pending_count());
+        print_test_result("Requests counted", static_cast<uint64_t>(received.size()), coalescer.requests_sent());
+        self = nullptr;
+    }
+
+    bool ordered = true;
+    for (std::size_t i = 1; i < 4; ++i)
+    {
+        ordered = ordered && received[i].requestid() == received[i - 1].requestid() + 1;
+    }
+    print_test_result("Order preserved", true, ordered);
+    print_test_result("All requests delivered", static_cast<std::size_t>(13), received.size());
+}
+
+// 测试多线程并发 add 时 sink 不被并发调用、请求不丢失
+void test_concurrent()
+{
+    print_section("Concurrent Producers");
+
+    std::atomic<int> in_sink{0};
+    std::atomic<bool> overlapped{false};
+    std::atomic<std::size_t> delivered{0};
+    CoalescerOptions options;
+    options.max_count = 8;
+    RequestCoalescer coalescer(options, [&](const UniversalRequest &frame)
+                               {
+        if (in_sink.fetch_add(1) != 0)
+        {
+            overlapped = true;
+        }
+        std::vector<UniversalRequest> items;
+        delivered += is_batch_envelope(frame) && unpack_batch(frame, &items) ? items.size() : 1;
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        in_sink.fetch_sub(1);
+        return true; });
+    coalescer.start();
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; ++t)
+    {
+        producers.emplace_back([&coalescer, t]
+                               {
+            for (int i = 0; i < 250; ++i)
+            {
+                coalescer.add(make_request(t * 1000 + i, i, "x"));
+            } });
+    }
+    for (auto &producer : producers)
+    {
+        producer.join();
+    }
+    coalescer.stop();
+    print_test_result("Sink never concurrent", false, overlapped.load());
+    print_test_result("All delivered", static_cast<std::size_t>(1000), delivered.load());
+}
+
+int main()
+{
+    std::cout << "Testing Request Batch Functionality" << std::endl;
+    std::cout << "===================================" << std::endl;
+
+    try
+    {
+        test_roundtrip();
+        test_compressed();
+        test_traced();
+        test_malformed();
+        test_coalescer();
+        test_concurrent();
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "All tests completed successfully!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,218 @@
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "printUtil.h"
+#include "shmTopicRing.h"
+#include "communication/topic_service.pb.h"
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::PB::communication;
+using namespace humanoid_robot::utils::PB;
+
+namespace
+{
+    // 每个进程使用独立的 Topic，避免并行运行的测试互相干扰
+    std::string test_topic(const std::string &suffix)
+    {
+        return "test/shm_ring/" + std::to_string(getpid()) + "/" + suffix;
+    }
+
+    ShmTopicRing::Options small_options()
+    {
+        ShmTopicRing::Options options;
+        options.slot_count = 4;
+        options.slot_size = 256;
+        return options;
+    }
+} // namespace
+
+// 测试创建、挂接、发布与读取
+void test_roundtrip()
+{
+    print_section("Create / Attach / Round Trip");
+
+    const std::string topic = test_topic("roundtrip");
+    auto publisher = ShmTopicRing::create(topic, small_options());
+    print_test_result("Create", true, publisher != nullptr);
+    auto subscriber = ShmTopicRing::open(topic);
+    print_test_result("Attach", true, subscriber != nullptr);
+    print_test_result("Same segment", publisher->segment_name(), subscriber->segment_name());
+    print_test_result("Max payload", publisher->max_payload(), subscriber->max_payload());
+
+    struct stat st;
+    const int fd = shm_open(publisher->segment_name().c_str(), O_RDONLY, 0);
+    print_test_result("Owner only mode", static_cast<mode_t>(0600), fd >= 0 && fstat(fd, &st) == 0 ? (st.st_mode & 0777) : static_cast<mode_t>(0));
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+
+    TopicMessage message;
+    uint64_t lost = 0;
+    print_test_result("Empty before publish", true, subscriber->read(&message, &lost) == ShmTopicRing::ReadStatus::kEmpty);
+    print_test_result("Raw publish", true, publisher->publish(1, 1001, "hello", 5));
+    print_test_result("Read raw", true, subscriber->read(&message, &lost) == ShmTopicRing::ReadStatus::kMessage);
+    print_test_result("Raw payload", std::string("hello"), message.payload());
+    print_test_result("Raw sequence", static_cast<uint64_t>(1), message.sequence());
+    print_test_result("Raw timestamp", static_cast<uint64_t>(1001), message.timestamp());
+
+    // 附加字段随槽位传递
+    TopicMessage sent;
+    sent.set_name_id(7);
+    sent.set_sequence(2);
+    sent.set_timestamp(1002);
+    sent.set_payload("compressed");
+    sent.set_payload_codec(PAYLOAD_CODEC_ZSTD);
+    sent.set_codec_dictionary("dict");
+    sent.mutable_trace()->set_trace_id(0xABCDEF);
+    sent.mutable_trace()->add_hops()->set_stage(TRACE_STAGE_CAPTURE);
+    print_test_result("Message publish", true, publisher->publish(sent));
+    print_test_result("Read message", true, subscriber->read(&message, &lost) == ShmTopicRing::ReadStatus::kMessage);
+    print_test_result("Payload", sent.payload(), message.payload());
+    print_test_result("Name id", static_cast<uint32_t>(7), message.name_id());
+    print_test_result("Payload codec", static_cast<int>(PAYLOAD_CODEC_ZSTD), static_cast<int>(message.payload_codec()));
+    print_test_result("Codec dictionary", std::string("dict"), message.codec_dictionary());
+    print_test_result("Trace id", static_cast<uint64_t>(0xABCDEF), message.trace().trace_id());
+    print_test_result("Trace hops", 1, message.trace().hops_size());
+
+    // 下一条不带附加字段：上一条的字段不得残留
+    print_test_result("Plain publish", true, publisher->publish(3, 1003, "x", 1));
+    subscriber->read(&message, &lost);
+    print_test_result("Fields reset", true, message.name_id() == 0 && !message.has_trace() && message.codec_dictionary().empty());
+    print_test_result("Nothing lost", static_cast<uint64_t>(0), lost);
+
+    // payload 与附加字段合计超过槽位时拒绝，由调用方改走 gRPC
+    print_test_result("Oversized payload", false, publisher->publish(4, 1004, std::string(publisher->max_payload() + 1, 'x').data(), publisher->max_payload() + 1));
+    sent.set_payload(std::string(publisher->max_payload() - 2, 'x'));
+    print_test_result("Oversized with meta", false, publisher->publish(sent));
+    print_test_result("Subscriber cannot publish", false, subscriber->publish(5, 1005, "y", 1));
+}
+
+// 测试读者落后超过一圈
+void test_overrun()
+{
+    print_section("Overrun");
+
+    const std::string topic = test_topic("overrun");
+    auto publisher = ShmTopicRing::create(topic, small_options());
+    auto subscriber = ShmTopicRing::open(topic);
+
+    for (uint64_t i = 1; i <= 10; ++i)
+    {
+        const std::string payload = "msg" + std::to_string(i);
+        publisher->publish(i, 1000 + i, payload.data(), payload.size());
+    }
+
+    TopicMessage message;
+    uint64_t lost = 0;
+    SequenceTracker tracker;
+    int received = 0;
+    uint64_t first = 0;
+    while (subscriber->read(&message, &lost) == ShmTopicRing::ReadStatus::kMessage)
+    {
+        if (received++ == 0)
+        {
+            first = message.sequence();
+        }
+        tracker.observe(message.sequence());
+    }
+    print_test_result("Received one ring", 4, received);
+    print_test_result("Lost counted", static_cast<uint64_t>(6), lost);
+    print_test_result("Oldest valid first", static_cast<uint64_t>(7), first);
+    print_test_result("Last payload", std::string("msg10"), message.payload());
+    print_test_result("No gaps inside ring", static_cast<uint64_t>(0), tracker.total_missing());
+}
+
+// 测试重复创建与畸形段头
+void test_bad_segments()
+{
+    print_section("Bad Segments");
+
+    const std::string topic = test_topic("live");
+    auto publisher = ShmTopicRing::create(topic, small_options());
+    errno = 0;
+    auto second = ShmTopicRing::create(topic, small_options());
+    print_test_result("Live segment kept", true, second == nullptr && errno == EEXIST);
+    print_test_result("Original still readable", true, ShmTopicRing::open(topic) != nullptr);
+    publisher.reset();
+    print_test_result("Unlinked on destroy", true, ShmTopicRing::open(topic) == nullptr);
+    print_test_result("Missing segment", true, ShmTopicRing::open(test_topic("missing")) == nullptr);
+
+    // 手工写入各种不合法的段头
+    auto write_segment = [](const std::string &name, const std::string &bytes)
+    {
+        shm_unlink(name.c_str());
+        const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0)
+        {
+            return false;
+        }
+        const bool ok = write(fd, bytes.data(), bytes.size()) == static_cast<ssize_t>(bytes.size());
+        close(fd);
+        return ok;
+    };
+
+    const std::string bad_topic = test_topic("bad");
+    const std::string name = shm_segment_name(bad_topic);
+    print_test_result("Short segment", true, write_segment(name, std::string(16, '\0')) && ShmTopicRing::open(bad_topic) == nullptr);
+    print_test_result("Bad magic", true, write_segment(name, std::string(4096, '\x5a')) && ShmTopicRing::open(bad_topic) == nullptr);
+
+    // 从合法段拷贝段头后篡改配置
+    const std::string good_topic = test_topic("good");
+    auto good = ShmTopicRing::create(good_topic, small_options());
+    std::string image(128, '\0');
+    const int fd = shm_open(good->segment_name().c_str(), O_RDONLY, 0);
+    print_test_result("Read header", true, fd >= 0 && read(fd, &image[0], image.size()) == static_cast<ssize_t>(image.size()));
+    close(fd);
+    uint32_t slot_count = 0;
+    std::memcpy(&slot_count, image.data() + 12, sizeof(slot_count));
+    print_test_result("Header layout", static_cast<uint32_t>(4), slot_count);
+
+    std::string tampered = image;
+    const uint32_t huge = 1u << 30;
+    std::memcpy(&tampered[12], &huge, sizeof(huge));
+    print_test_result("Slot count beyond segment", true, write_segment(name, tampered) && ShmTopicRing::open(bad_topic) == nullptr);
+    tampered = image;
+    const uint32_t odd = 3;
+    std::memcpy(&tampered[12], &odd, sizeof(odd));
+    print_test_result("Slot count not power of two", true, write_segment(name, tampered + std::string(4096, '\0')) && ShmTopicRing::open(bad_topic) == nullptr);
+    tampered = image;
+    const uint32_t tiny = 8;
+    std::memcpy(&tampered[16], &tiny, sizeof(tiny));
+    print_test_result("Slot size below header", true, write_segment(name, tampered) && ShmTopicRing::open(bad_topic) == nullptr);
+
+    // 创建者已退出的残留段可被重建
+    tampered = image;
+    const uint32_t dead_pid = 0x7FFFFFF0;
+    std::memcpy(&tampered[20], &dead_pid, sizeof(dead_pid));
+    write_segment(name, tampered + std::string(4 * 256, '\0'));
+    auto rebuilt = ShmTopicRing::create(bad_topic, small_options());
+    print_test_result("Stale segment replaced", true, rebuilt != nullptr);
+}
+
+int main()
+{
+    std::cout << "Testing Shared Memory Topic Ring Functionality" << std::endl;
+    std::cout << "==============================================" << std::endl;
+
+    try
+    {
+        test_roundtrip();
+        test_overrun();
+        test_bad_segments();
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "All tests completed successfully!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,277 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <grpcpp/grpcpp.h>
+#include "detectionBatcher.h"
+#include "printUtil.h"
+using namespace detection;
+using namespace humanoid_robot::utils::PB;
+
+DetectionRequest make_request(const std::string &image, const std::string &format, std::vector<std::string> classes)
+{
+    DetectionRequest request;
+    request.set_image_data(image);
+    request.set_format(format);
+    for (auto &name : classes)
+    {
+        request.add_classes(name);
+    }
+    return request;
+}
+
+// 回显推理：object_id 为图像内容，class_name 为批次的分组信息
+bool echo_inference(const DetectionBatch &batch, std::vector<DetectionResponse> *responses)
+{
+    for (const DetectionRequest *request : batch.requests)
+    {
+        DetectionResponse response;
+        response.set_success(true);
+        DetectionResult *result = response.add_results();
+        result->set_object_id(request->image_data());
+        result->set_class_name(batch.format + ":" + std::to_string(batch.requests.size()));
+        responses->push_back(std::move(response));
+    }
+    return true;
+}
+
+// 同步收集 submit 的结果
+struct Collector
+{
+    DetectionBatcher::Completion callback()
+    {
+        return [this](DetectionResponse &&response)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            responses.push_back(std::move(response));
+        };
+    }
+
+    std::size_t wait_for(std::size_t count)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (responses.size() >= count)
+                {
+                    return responses.size();
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        return responses.size();
+    }
+
+    std::mutex mutex;
+    std::vector<DetectionResponse> responses;
+};
+
+// 测试分组 key
+void test_group_key()
+{
+    print_section("Group Key");
+
+    print_test_result("Class order ignored", true,
+                      DetectionBatcher::group_key(make_request("", "jpg", {"car", "person"})) ==
+                          DetectionBatcher::group_key(make_request("", "jpg", {"person", "car", "person"})));
+    print_test_result("Format separates", false,
+                      DetectionBatcher::group_key(make_request("", "jpg", {"car"})) == DetectionBatcher::group_key(make_request("", "png", {"car"})));
+    print_test_result("Classes separate", false,
+                      DetectionBatcher::group_key(make_request("", "jpg", {"car"})) == DetectionBatcher::group_key(make_request("", "jpg", {})));
+}
+
+// 测试满批与截止时间触发
+void test_triggers()
+{
+    print_section("Batch Triggers");
+
+    BatcherOptions options;
+    options.max_batch_size = 4;
+    options.max_wait = std::chrono::milliseconds(20);
+    DetectionBatcher batcher(echo_inference, options);
+    Collector collector;
+
+    const auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < 8; ++i)
+    {
+        batcher.submit(make_request(std::to_string(i), "jpg", {"car"}), collector.callback());
+    }
+    print_test_result("Full batches delivered", static_cast<std::size_t>(8), collector.wait_for(8));
+    const double full_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    print_test_result("Full batches without waiting", true, full_ms < 15.0);
+    print_test_result("Batch size 4", std::string("jpg:4"), collector.responses.back().results(0).class_name());
+
+    batcher.submit(make_request("a", "jpg", {"car"}), collector.callback());
+    batcher.submit(make_request("b", "jpg", {"car"}), collector.callback());
+    const auto partial_begin = std::chrono::steady_clock::now();
+    collector.wait_for(10);
+    const double partial_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - partial_begin).count();
+    print_test_result("Partial batch waits for deadline", true, partial_ms >= 15.0);
+    print_test_result("Partial batch size", std::string("jpg:2"), collector.responses.back().results(0).class_name());
+
+    BatcherStats stats = batcher.stats();
+    print_test_result("Full batch count", static_cast<uint64_t>(2), stats.full_batches);
+    print_test_result("Deadline batch count", static_cast<uint64_t>(1), stats.deadline_batches);
+    print_test_result("Largest batch", static_cast<std::size_t>(4), stats.largest_batch);
+}
+
+// 测试按 format / classes 分组与失败处理
+void test_grouping_and_failure()
+{
+    print_section("Grouping And Failure");
+
+    std::mutex mutex;
+    std::vector<std::string> seen;
+    BatcherOptions options;
+    options.max_wait = std::chrono::milliseconds(5);
+    DetectionBatcher batcher(
+        [&](const DetectionBatch &batch, std::vector<DetectionResponse> *responses)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                seen.push_back(batch.format + "/" + std::to_string(batch.classes.size()) + "/" + std::to_string(batch.requests.size()));
+            }
+            return batch.format != "bad" && echo_inference(batch, responses);
+        },
+        options);
+    Collector collector;
+    batcher.submit(make_request("1", "jpg", {"car", "person"}), collector.callback());
+    batcher.submit(make_request("2", "png", {"car", "person"}), collector.callback());
+    batcher.submit(make_request("3", "jpg", {"person", "car"}), collector.callback());
+    batcher.submit(make_request("4", "bad", {}), collector.callback());
+    collector.wait_for(4);
+
+    std::sort(seen.begin(), seen.end());
+    print_test_result("Three groups", static_cast<std::size_t>(3), seen.size());
+    print_test_result("Same classes batched", true, std::find(seen.begin(), seen.end(), "jpg/2/2") != seen.end());
+
+    int failed = 0;
+    for (const auto &response : collector.responses)
+    {
+        failed += response.success() ? 0 : 1;
+    }
+    print_test_result("Failed batch answered", 1, failed);
+    print_test_result("Failed batch counted", static_cast<uint64_t>(1), batcher.stats().failed_batches);
+
+    batcher.shutdown();
+    print_test_result("Submit after shutdown", false, batcher.submit(make_request("5", "jpg", {}), collector.callback()));
+}
+
+// 测试 gRPC 服务：多条流的请求合批，响应按各自顺序写回
+void test_service()
+{
+    print_section("BatchDetect Service");
+
+    BatcherOptions options;
+    options.max_batch_size = 16;
+    options.max_wait = std::chrono::milliseconds(2);
+    options.workers = 2;
+    DetectionBatcher batcher(echo_inference, options);
+    BatchingDetectionService service(&batcher);
+
+    int port = 0;
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(), &port);
+    builder.RegisterService(&service);
+    auto server = builder.BuildAndStart();
+    auto stub = ObjectDetection::NewStub(grpc::CreateChannel("127.0.0.1:" + std::to_string(port), grpc::InsecureChannelCredentials()));
+
+    const int streams = 4;
+    const int per_stream = 50;
+    std::atomic<int> in_order{0};
+    std::vector<std::thread> clients;
+    for (int s = 0; s < streams; ++s)
+    {
+        clients.emplace_back([&, s]()
+                             {
+            grpc::ClientContext context;
+            auto stream = stub->BatchDetect(&context);
+            std::thread reader([&]() {
+                DetectionResponse response;
+                int index = 0;
+                while (stream->Read(&response))
+                {
+                    in_order += response.results(0).object_id() == std::to_string(s) + "-" + std::to_string(index) ? 1 : 0;
+                    ++index;
+                }
+            });
+            for (int i = 0; i < per_stream; ++i)
+            {
+                stream->Write(make_request(std::to_string(s) + "-" + std::to_string(i), "jpg", {"car"}));
+            }
+            stream->WritesDone();
+            reader.join();
+            stream->Finish(); });
+    }
+    for (auto &client : clients)
+    {
+        client.join();
+    }
+    print_test_result("Responses in per-stream order", streams * per_stream, in_order.load());
+
+    grpc::ClientContext context;
+    DetectionResponse response;
+    print_test_result("DetectObjects ok", true, stub->DetectObjects(&context, make_request("single", "png", {}), &response).ok());
+    print_test_result("DetectObjects result", std::string("single"), response.results(0).object_id());
+
+    BatcherStats stats = batcher.stats();
+    print_test_result("Requests across streams batched", true, stats.batches < stats.requests);
+    server->Shutdown();
+}
+
+// 测试桩后端
+void test_stub_backend()
+{
+    print_section("Stub Backend");
+
+    StubBackendOptions options;
+    options.batch_cost = std::chrono::microseconds(0);
+    options.item_cost = std::chrono::microseconds(0);
+    StubDetectionBackend backend(options);
+
+    DetectionRequest a = make_request("frame-a", "jpg", {"car", "person"});
+    DetectionRequest b = make_request("frame-a", "jpg", {"car", "person"});
+    DetectionBatch batch;
+    batch.format = "jpg";
+    batch.classes = {"car", "person"};
+    batch.requests = {&a, &b};
+    std::vector<DetectionResponse> responses;
+    print_test_result("Backend ok", true, backend(batch, &responses));
+    print_test_result("One response per request", static_cast<std::size_t>(2), responses.size());
+    print_test_result("Deterministic", responses[0].SerializeAsString(), responses[1].SerializeAsString());
+    print_test_result("Objects per image", 3, responses[0].results_size());
+    print_test_result("Requested classes used", std::string("person"), responses[0].results(1).class_name());
+}
+
+int main()
+{
+    std::cout << "Testing Detection Batcher Functionality" << std::endl;
+    std::cout << "=======================================" << std::endl;
+
+    try
+    {
+        test_group_key();
+        test_triggers();
+        test_grouping_and_failure();
+        test_service();
+        test_stub_backend();
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "All tests completed successfully!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -4,6 +4,8 @@
 #include "interfaces/interfaces_request_response.pb.h"
 #include "interfaces/interfaces_grpc.grpc.pb.h"
 #include "printUtil.h"
+#include "dictionaryBuilder.h"
+#include "dictionaryLayout.h"
 using namespace humanoid_robot::PB::interfaces;
 using namespace humanoid_robot::utils::PB;
 using namespace humanoid_robot::PB::common;
@@ -169,6 +171,84 @@ void test_serialization()
     }
 }
 
+// 测试 Arena 上的 DictionaryBuilder
+void test_dictionary_builder()
+{
+    print_section("Dictionary Builder");
+
+    MessageArena arena(8);
+    auto *request = arena.create<humanoid_robot::PB::interfaces::SendRequest>();
+    print_test_result("SendRequest on arena", true, request->GetArena() == arena.arena());
+
+    DictionaryBuilder(request->mutable_input())
+        .set_int16("type", 10001)
+        .set_string("resource_name", "test_resource");
+
+    DictionaryBuilder params(request->mutable_params());
+    params.set_int32("timeout", 500).set_int32("correlationid", 42);
+    params.child("timestamp").set_string("date", "2023-10-10").set_string("time", "12:00:00");
+
+    // 在同一 Arena 上构建后移入
+    humanoid_robot::PB::common::Variant *tmp = params.new_variant();
+    tmp->mutable_int32arrayvalue()->add_values(1);
+    tmp->mutable_int32arrayvalue()->add_values(2);
+    params.set("ids", std::move(*tmp));
+
+    const auto &input = request->input().keyvaluelist();
+    const auto &param_map = request->params().keyvaluelist();
+    print_test_result("Builder input size", static_cast<size_t>(2), input.size());
+    print_test_result("Builder params size", static_cast<size_t>(4), param_map.size());
+    print_test_result("Builder 'type' value", 10001, input.at("type").int16value());
+    print_test_result("Builder 'timeout' value", 500, param_map.at("timeout").int32value());
+    print_test_result("Builder nested size", 2, param_map.at("timestamp").dictvalue().keyvaluelist_size());
+    print_test_result("Builder moved array size", 2, param_map.at("ids").int32arrayvalue().values_size());
+    print_test_result("Builder nested on arena", true,
+                      param_map.at("timestamp").dictvalue().GetArena() == arena.arena());
+
+    // 与逐个 insert 构建的消息序列化结果一致
+    humanoid_robot::PB::interfaces::SendRequest parsed;
+    print_test_result("Builder request parse", true, parsed.ParseFromString(request->SerializeAsString()));
+    print_test_result("Builder parsed 'resource_name'", std::string("test_resource"),
+                      parsed.input().keyvaluelist().at("resource_name").stringvalue());
+}
+
+// ActionRequest 热点参数键表
+static constexpr auto kActionParamKeys = make_dictionary_schema("timeout", "correlationid", "priority");
+
+// 测试编译期键表视图
+void test_dictionary_layout()
+{
+    print_section("Dictionary Layout");
+
+    humanoid_robot::PB::interfaces::ActionRequest request;
+    DictionaryBuilder(request.mutable_params())
+        .set_int32("timeout", 500)
+        .set_int32("correlationid", 42)
+        .set_string("operator", "test");
+
+    DictionaryLayout<kActionParamKeys> layout(request.params());
+    const auto *timeout = layout.get<kActionParamKeys.index_of("timeout")>();
+    print_test_result("Layout 'timeout' present", true, timeout != nullptr);
+    print_test_result("Layout 'timeout' value", 500, timeout ? timeout->int32value() : 0);
+    print_test_result("Layout 'priority' absent", false, layout.has(kActionParamKeys.index_of("priority")));
+    print_test_result("Layout unknown keys", static_cast<size_t>(1), layout.unknown_size());
+    print_test_result("Layout unknown key lookup", std::string("test"),
+                      layout.find("operator") ? layout.find("operator")->stringvalue() : std::string());
+
+    std::string serialized;
+    layout.serialize(&serialized);
+    humanoid_robot::PB::common::Dictionary parsed;
+    print_test_result("Layout serialize parse", true, parsed.ParseFromString(serialized));
+    print_test_result("Layout serialize size", 3, parsed.keyvaluelist_size());
+
+    // 含超长键的键表不能用于 DictionaryLayout，但 index_of 仍须安全返回 npos
+    const std::string long_key(100, 'k');
+    const auto invalid = make_dictionary_schema("timeout", std::string_view(long_key));
+    print_test_result("Invalid schema detected", false, invalid.valid());
+    print_test_result("Over-long key not found", invalid.npos, invalid.index_of(long_key));
+    print_test_result("Short key still found", static_cast<size_t>(0), invalid.index_of("timeout"));
+}
+
 int main()
 {
     std::cout << "Testing Interfaces Protobuf Functionality" << std::endl;
@@ -179,6 +259,8 @@ int main()
         test_request_response_types();
         test_error_info();
         test_serialization();
+        test_dictionary_builder();
+        test_dictionary_layout();
 
         std::cout << "\n=== Test Summary ===" << std::endl;
         std::cout << "All tests completed successfully!" << std::endl;
@@ -0,0 +1,277 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <grpcpp/grpcpp.h>
+#include "interfaces/interfaces_request_response.pb.h"
+#include "interfaces/interfaces_grpc.grpc.pb.h"
+#include "asyncInterfaceServer.h"
+#include "printUtil.h"
+using namespace humanoid_robot::PB::interfaces;
+using namespace humanoid_robot::utils::PB;
+using namespace humanoid_robot::PB::common;
+
+// 测试用处理器：Query 回显，Send 逐条回显，Action 按 input.count 在后台线程推送
+class EchoHandler : public InterfaceHandler
+{
+public:
+    ~EchoHandler() override
+    {
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    grpc::Status query(const QueryRequest &request, QueryResponse *response) override
+    {
+        *response->mutable_output() = request.input();
+        return grpc::Status::OK;
+    }
+
+    void send(const SendRequest &request, const std::shared_ptr<ResponseStream<SendResponse>> &stream) override
+    {
+        SendResponse response;
+        *response.mutable_output() = request.input();
+        stream->write(response);
+    }
+
+    void action(const ActionRequest &request, const std::shared_ptr<ResponseStream<ActionResponse>> &stream) override
+    {
+        const auto &input = request.input().keyvaluelist();
+        const int count = input.count("count") != 0 ? input.at("count").int32value() : 0;
+        if (input.count("flood") != 0)
+        {
+            // 同步写入远超上限的响应，多余部分应被背压拒绝
+            ActionResponse response;
+            for (int i = 0; i < count; ++i)
+            {
+                (*response.mutable_output()->mutable_keyvaluelist())["index"].set_int32value(i);
+                accepted += stream->write(response) ? 1 : 0;
+            }
+            stream->finish(grpc::Status::OK);
+            return;
+        }
+        if (input.count("hold") != 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            held = stream;
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        workers.emplace_back([stream, count]() {
+            ActionResponse response;
+            for (int i = 0; i < count; ++i)
+            {
+                (*response.mutable_output()->mutable_keyvaluelist())["index"].set_int32value(i);
+                while (!stream->write(response) && !stream->closed())
+                {
+                    std::this_thread::yield();
+                }
+            }
+            stream->finish(grpc::Status::OK);
+        });
+    }
+
+    std::mutex mutex;
+    std::vector<std::thread> workers;
+    std::shared_ptr<ResponseStream<ActionResponse>> held;
+    int accepted = 0;
+};
+
+std::unique_ptr<InterfaceService::Stub> connect(int port)
+{
+    return InterfaceService::NewStub(
+        grpc::CreateChannel("127.0.0.1:" + std::to_string(port), grpc::InsecureChannelCredentials()));
+}
+
+// 测试一元调用
+void test_unary(AsyncInterfaceServer &server, InterfaceService::Stub &stub)
+{
+    print_section("Unary");
+
+    QueryRequest request;
+    (*request.mutable_input()->mutable_keyvaluelist())["resource"].set_stringvalue("config");
+    QueryResponse response;
+    int ok_count = 0;
+    for (int i = 0; i < 20; ++i)
+    {
+        grpc::ClientContext context;
+        ok_count += stub.Query(&context, request, &response).ok() ? 1 : 0;
+    }
+    print_test_result("Queries ok", 20, ok_count);
+    print_test_result("Echo", std::string("config"), response.output().keyvaluelist().at("resource").stringvalue());
+
+    grpc::ClientContext context;
+    UnsubscribeResponse unsubscribed;
+    grpc::Status status = stub.Unsubscribe(&context, UnsubscribeRequest(), &unsubscribed);
+    print_test_result("Default unimplemented", static_cast<int>(grpc::StatusCode::UNIMPLEMENTED), static_cast<int>(status.error_code()));
+    print_test_result("Calls counted", true, server.stats().calls >= 21);
+}
+
+// 测试双向流 Send
+void test_send_stream(InterfaceService::Stub &stub)
+{
+    print_section("Send Stream");
+
+    grpc::ClientContext context;
+    auto stream = stub.Send(&context);
+    SendRequest request;
+    SendResponse response;
+    int echoed = 0;
+    for (int i = 0; i < 50; ++i)
+    {
+        (*request.mutable_input()->mutable_keyvaluelist())["seq"].set_int32value(i);
+        stream->Write(request);
+        if (stream->Read(&response) && response.output().keyvaluelist().at("seq").int32value() == i)
+        {
+            ++echoed;
+        }
+    }
+    stream->WritesDone();
+    print_test_result("Echoed in order", 50, echoed);
+    print_test_result("Stream finished", true, stream->Finish().ok());
+}
+
+// 测试服务端流 Action 与背压
+void test_action_stream(AsyncInterfaceServer &server, InterfaceService::Stub &stub, EchoHandler &handler)
+{
+    print_section("Action Stream");
+
+    ActionRequest request;
+    (*request.mutable_input()->mutable_keyvaluelist())["count"].set_int32value(200);
+    grpc::ClientContext context;
+    auto reader = stub.Action(&context, request);
+    ActionResponse response;
+    int received = 0;
+    while (reader->Read(&response))
+    {
+        received += response.output().keyvaluelist().at("index").int32value() == received ? 1 : 0;
+    }
+    print_test_result("Background writes", 200, received);
+    print_test_result("Action finished", true, reader->Finish().ok());
+
+    const uint64_t rejected_before = server.stats().rejected_writes;
+    ActionRequest flood;
+    (*flood.mutable_input()->mutable_keyvaluelist())["count"].set_int32value(100);
+    (*flood.mutable_input()->mutable_keyvaluelist())["flood"].set_boolvalue(true);
+    grpc::ClientContext flood_context;
+    auto flood_reader = stub.Action(&flood_context, flood);
+    int flood_received = 0;
+    while (flood_reader->Read(&response))
+    {
+        ++flood_received;
+    }
+    flood_reader->Finish();
+    print_test_result("Accepted up to limit", 8, handler.accepted);
+    print_test_result("Queued responses delivered", 8, flood_received);
+    print_test_result("Rejected writes", static_cast<uint64_t>(92), server.stats().rejected_writes - rejected_before);
+}
+
+// 测试客户端取消：handler 持有写端不再写入时，调用也要被回收
+void test_cancel(AsyncInterfaceServer &server, InterfaceService::Stub &stub, EchoHandler &handler)
+{
+    print_section("Client Cancel");
+
+    // 之前的流在 done tag 投递后才释放，先等它们全部回收
+    auto wait_active = [&server](uint64_t expected)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (server.stats().active_streams != expected && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return server.stats().active_streams;
+    };
+    print_test_result("No active streams", static_cast<uint64_t>(0), wait_active(0));
+
+    ActionRequest request;
+    (*request.mutable_input()->mutable_keyvaluelist())["hold"].set_boolvalue(true);
+    grpc::ClientContext context;
+    auto reader = stub.Action(&context, request);
+    print_test_result("Stream active", static_cast<uint64_t>(1), wait_active(1));
+
+    context.TryCancel();
+    ActionResponse response;
+    print_test_result("Client sees end", false, reader->Read(&response));
+    print_test_result("Client status cancelled", static_cast<int>(grpc::StatusCode::CANCELLED),
+                      static_cast<int>(reader->Finish().error_code()));
+    print_test_result("Cancelled stream released", static_cast<uint64_t>(0), wait_active(0));
+
+    std::shared_ptr<ResponseStream<ActionResponse>> held;
+    {
+        std::lock_guard<std::mutex> lock(handler.mutex);
+        held = handler.held;
+    }
+    print_test_result("Held stream closed", true, held != nullptr && held->closed());
+    print_test_result("Write after cancel", false, held != nullptr && held->write(response));
+}
+
+// 测试关停时仍有进行中的流
+void test_shutdown(EchoHandler &handler)
+{
+    print_section("Shutdown");
+
+    AsyncServerOptions options;
+    options.address = "127.0.0.1:0";
+    options.threads = 1;
+    options.shutdown_grace = std::chrono::milliseconds(100);
+    auto server = std::make_unique<AsyncInterfaceServer>(&handler, options);
+    server->start();
+    auto stub = connect(server->port());
+
+    ActionRequest request;
+    (*request.mutable_input()->mutable_keyvaluelist())["hold"].set_boolvalue(true);
+    grpc::ClientContext context;
+    auto reader = stub->Action(&context, request);
+    while (server->stats().active_streams == 0)
+    {
+        std::this_thread::yield();
+    }
+    print_test_result("Stream active", static_cast<uint64_t>(1), server->stats().active_streams);
+
+    server->shutdown();
+    ActionResponse response;
+    print_test_result("Client sees end", false, reader->Read(&response));
+    print_test_result("Client status not ok", false, reader->Finish().ok());
+    print_test_result("Write after shutdown", false, handler.held->write(response));
+    print_test_result("Held stream closed", true, handler.held->closed());
+}
+
+int main()
+{
+    std::cout << "Testing Async Interface Server Functionality" << std::endl;
+    std::cout << "============================================" << std::endl;
+
+    try
+    {
+        EchoHandler handler;
+        AsyncServerOptions options;
+        options.address = "127.0.0.1:0";
+        options.threads = 2;
+        options.max_pending_writes = 8;
+        AsyncInterfaceServer server(&handler, options);
+        print_test_result("Server started", true, server.start());
+        auto stub = connect(server.port());
+
+        test_unary(server, *stub);
+        test_send_stream(*stub);
+        test_action_stream(server, *stub, handler);
+        test_cancel(server, *stub, handler);
+        server.shutdown();
+        test_shutdown(handler);
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "All tests completed successfully!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
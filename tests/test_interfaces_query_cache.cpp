@@ -0,0 +1,240 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <grpcpp/grpcpp.h>
+#include "interfaces/interfaces_request_response.pb.h"
+#include "interfaces/interfaces_grpc.grpc.pb.h"
+#include "printUtil.h"
+#include "queryCache.h"
+using namespace humanoid_robot::PB::interfaces;
+using namespace humanoid_robot::utils::PB;
+using namespace humanoid_robot::PB::common;
+
+QueryRequest make_query(const std::string &resource, int correlation)
+{
+    QueryRequest request;
+    (*request.mutable_input()->mutable_keyvaluelist())["resource"].set_stringvalue(resource);
+    (*request.mutable_input()->mutable_keyvaluelist())["robot"].set_int32value(1);
+    (*request.mutable_params()->mutable_keyvaluelist())["detail"].set_boolvalue(true);
+    (*request.mutable_params()->mutable_keyvaluelist())["correlationid"].set_int32value(correlation);
+    return request;
+}
+
+QueryResponse make_response(const std::string &value)
+{
+    QueryResponse response;
+    (*response.mutable_output()->mutable_keyvaluelist())["value"].set_stringvalue(value);
+    return response;
+}
+
+// 计数 Query 调用次数的内层服务
+class CountingService : public InterfaceService::Service
+{
+public:
+    grpc::Status Subscribe(grpc::ServerContext *, const SubscribeRequest *, SubscribeResponse *) override
+    {
+        return grpc::Status::OK;
+    }
+
+    grpc::Status Query(grpc::ServerContext *context, const QueryRequest *request, QueryResponse *response) override
+    {
+        ++calls;
+        last_context = context;
+        const auto client = context->client_metadata().find("x-client");
+        last_client = client == context->client_metadata().end() ? std::string() : std::string(client->second.data(), client->second.size());
+        *response = make_response(request->input().keyvaluelist().at("resource").stringvalue());
+        return grpc::Status::OK;
+    }
+
+    std::atomic<int> calls{0};
+    grpc::ServerContext *last_context = nullptr;
+    std::string last_client;
+};
+
+// 测试命中、未命中与规范化的 key
+void test_hit_miss()
+{
+    print_section("Hit And Miss");
+
+    QueryCacheOptions options;
+    options.ignored_params = {"correlationid"};
+    QueryCache cache(options);
+
+    QueryRequest request = make_query("config", 1);
+    print_test_result("Cold miss", true, cache.find(request) == nullptr);
+    auto stored = cache.store(request, make_response("v1"));
+
+    // 不同的 correlationid 与不同的插入顺序得到同一个 key
+    QueryRequest same;
+    (*same.mutable_params()->mutable_keyvaluelist())["correlationid"].set_int32value(2);
+    (*same.mutable_params()->mutable_keyvaluelist())["detail"].set_boolvalue(true);
+    (*same.mutable_input()->mutable_keyvaluelist())["robot"].set_int32value(1);
+    (*same.mutable_input()->mutable_keyvaluelist())["resource"].set_stringvalue("config");
+    print_test_result("Canonical key", cache.key(request), cache.key(same));
+
+    auto hit = cache.find(same);
+    print_test_result("Hit", true, hit != nullptr);
+    print_test_result("Hit shares bytes", true, hit == stored);
+    QueryResponse parsed;
+    parsed.ParseFromString(*hit);
+    print_test_result("Hit payload", std::string("v1"), parsed.output().keyvaluelist().at("value").stringvalue());
+
+    (*same.mutable_params()->mutable_keyvaluelist())["detail"].set_boolvalue(false);
+    print_test_result("Params participate", true, cache.find(same) == nullptr);
+
+    QueryCacheStats stats = cache.stats();
+    print_test_result("Hits", static_cast<uint64_t>(1), stats.hits);
+    print_test_result("Misses", static_cast<uint64_t>(2), stats.misses);
+    print_test_result("Entries", static_cast<std::size_t>(1), stats.entries);
+}
+
+// 测试 TTL、容量淘汰与可缓存判定
+void test_expiry_and_eviction()
+{
+    print_section("Expiry And Eviction");
+
+    QueryCacheOptions options;
+    options.ttl = std::chrono::milliseconds(20);
+    options.max_entries = 2;
+    options.cacheable = [](const QueryResponse &response) { return response.ret().code().empty(); };
+    QueryCache cache(options);
+
+    QueryRequest a = make_query("a", 0), b = make_query("b", 0), c = make_query("c", 0);
+    cache.store(a, make_response("a"));
+    cache.store(b, make_response("b"));
+    cache.find(a); // a 变为最近使用
+    cache.store(c, make_response("c"));
+    print_test_result("LRU evicted", true, cache.find(b) == nullptr);
+    print_test_result("Recent kept", true, cache.find(a) != nullptr);
+    print_test_result("Evictions", static_cast<uint64_t>(1), cache.stats().evictions);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    print_test_result("Expired", true, cache.find(a) == nullptr);
+    print_test_result("Expired count", static_cast<uint64_t>(1), cache.stats().expired);
+
+    QueryResponse failed = make_response("x");
+    failed.mutable_ret()->set_code("E_BUSY");
+    auto bytes = cache.store(b, failed);
+    print_test_result("Error bytes returned", true, bytes != nullptr && !bytes->empty());
+    print_test_result("Error not cached", true, cache.find(b) == nullptr);
+}
+
+// 测试显式失效与 Subscribe 路径
+void test_invalidation()
+{
+    print_section("Invalidation");
+
+    CountingService inner;
+    CachingInterfaceService service(&inner);
+    QueryCache &cache = service.cache();
+
+    cache.store(make_query("config", 0), make_response("config"));
+    cache.store(make_query("map", 0), make_response("map"));
+
+    Dictionary match;
+    (*match.mutable_keyvaluelist())["resource"].set_stringvalue("map");
+    print_test_result("Invalidate matching", static_cast<std::size_t>(1), cache.invalidate(match));
+    print_test_result("Other kept", true, cache.find(make_query("config", 0)) != nullptr);
+
+    // 订阅成功后按 input 失效
+    grpc::ServerContext context;
+    SubscribeRequest subscribe;
+    (*subscribe.mutable_input()->mutable_keyvaluelist())["resource"].set_stringvalue("config");
+    SubscribeResponse subscribed;
+    print_test_result("Subscribe forwarded", true, service.Subscribe(&context, &subscribe, &subscribed).ok());
+    print_test_result("Subscribe invalidated", true, cache.find(make_query("config", 0)) == nullptr);
+
+    cache.store(make_query("a", 0), make_response("a"));
+    cache.store(make_query("b", 0), make_response("b"));
+    print_test_result("Empty match clears", static_cast<std::size_t>(2), cache.invalidate(Dictionary()));
+    print_test_result("Invalidations", static_cast<uint64_t>(4), cache.stats().invalidations);
+}
+
+// 测试包装层 Query：未命中时以调用方 context 调用内层，命中时不再调用
+void test_service_query()
+{
+    print_section("Service Query");
+
+    CountingService inner;
+    CachingInterfaceService service(&inner);
+    grpc::ServerContext context;
+    const QueryRequest first = make_query("config", 1);
+    QueryResponse response;
+
+    print_test_result("Miss ok", true, service.Query(&context, &first, &response).ok());
+    print_test_result("Inner called", 1, inner.calls.load());
+    print_test_result("Caller context forwarded", true, inner.last_context == &context);
+    print_test_result("Miss response", std::string("config"), response.output().keyvaluelist().at("value").stringvalue());
+
+    grpc::ServerContext second;
+    QueryResponse cached;
+    print_test_result("Hit ok", true, service.Query(&second, &first, &cached).ok());
+    print_test_result("Inner not called on hit", 1, inner.calls.load());
+    print_test_result("Hit response", true, response.SerializeAsString() == cached.SerializeAsString());
+    print_test_result("Hits", static_cast<uint64_t>(1), service.cache().stats().hits);
+}
+
+// 测试经 gRPC 分发的 Query：命中时直接写出缓存字节，未命中时内层看到调用方的元数据
+void test_server_query()
+{
+    print_section("Server Query");
+
+    CountingService inner;
+    CachingInterfaceService service(&inner);
+    int port = 0;
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(), &port);
+    builder.RegisterService(&service);
+    std::unique_ptr<grpc::Server> server = builder.BuildAndStart();
+    auto stub = InterfaceService::NewStub(
+        grpc::CreateChannel("127.0.0.1:" + std::to_string(port), grpc::InsecureChannelCredentials()));
+
+    const QueryRequest request = make_query("config", 1);
+    QueryResponse miss;
+    {
+        grpc::ClientContext context;
+        context.AddMetadata("x-client", "planner");
+        print_test_result("Miss ok", true, stub->Query(&context, request, &miss).ok());
+    }
+    print_test_result("Inner called", 1, inner.calls.load());
+    print_test_result("Client metadata forwarded", std::string("planner"), inner.last_client);
+    print_test_result("Miss response", std::string("config"), miss.output().keyvaluelist().at("value").stringvalue());
+
+    QueryResponse hit;
+    {
+        grpc::ClientContext context;
+        print_test_result("Hit ok", true, stub->Query(&context, request, &hit).ok());
+    }
+    print_test_result("Inner not called on hit", 1, inner.calls.load());
+    print_test_result("Hit response", true, miss.SerializeAsString() == hit.SerializeAsString());
+    print_test_result("Hits", static_cast<uint64_t>(1), service.cache().stats().hits);
+
+    server->Shutdown();
+}
+
+int main()
+{
+    std::cout << "Testing Query Cache Functionality" << std::endl;
+    std::cout << "=================================" << std::endl;
+
+    try
+    {
+        test_hit_miss();
+        test_expiry_and_eviction();
+        test_invalidation();
+        test_service_query();
+        test_server_query();
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "All tests completed successfully!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,299 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <grpcpp/grpcpp.h>
+#include "perceptionPipeline.h"
+#include "printUtil.h"
+#include "spanTracer.h"
+using namespace humanoid_robot::PB::perception;
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::utils::PB;
+
+// 测试用阶段：infer 按 timeStamp 中的帧号休眠，奇数帧更快，制造乱序完成
+class SleepStages : public PerceptionStages
+{
+public:
+    explicit SleepStages(int infer_ms) : infer_ms_(infer_ms) {}
+
+    bool decode(PerceptionFrame &frame) override
+    {
+        if (frame.image.timestamp() == "bad")
+        {
+            return false;
+        }
+        frame.input = std::stoi(frame.image.timestamp());
+        return true;
+    }
+
+    bool infer(PerceptionFrame &frame) override
+    {
+        const int index = std::any_cast<int>(frame.input);
+        std::this_thread::sleep_for(std::chrono::milliseconds(index % 2 == 0 ? infer_ms_ : infer_ms_ / 4));
+        frame.output = index;
+        return true;
+    }
+
+    bool encode(PerceptionFrame &frame) override
+    {
+        auto *row = frame.result.add_rows();
+        row->set_trackid(std::to_string(std::any_cast<int>(frame.output)));
+        return true;
+    }
+
+private:
+    int infer_ms_;
+};
+
+// 启动服务端并收集客户端结果
+struct Harness
+{
+    Harness(PerceptionStages *stages, PipelineServerOptions server_options) : service(stages, server_options)
+    {
+        grpc::ServerBuilder builder;
+        builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(), &port);
+        builder.RegisterService(&service);
+        server = builder.BuildAndStart();
+        stub = PerceptionService::NewStub(
+            grpc::CreateChannel("127.0.0.1:" + std::to_string(port), grpc::InsecureChannelCredentials()));
+    }
+
+    ~Harness()
+    {
+        server->Shutdown();
+    }
+
+    PerceptionPipelineClient::ResultCallback collector()
+    {
+        return [this](const Perception &result, const FrameTiming &)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(result.timestamp());
+            tracks.push_back(result.rows_size() > 0 ? result.rows(0).trackid() : std::string());
+            traces.push_back(result.trace());
+        };
+    }
+
+    int port = 0;
+    PerceptionPipelineService service;
+    std::unique_ptr<grpc::Server> server;
+    std::unique_ptr<PerceptionService::Stub> stub;
+    std::mutex mutex;
+    std::vector<std::string> order;
+    std::vector<std::string> tracks;
+    std::vector<TraceContext> traces;
+};
+
+Image make_image(const std::string &time_stamp)
+{
+    Image image;
+    image.set_timestamp(time_stamp);
+    image.set_img(std::string(1024, 'p'));
+    return image;
+}
+
+// 测试延迟直方图
+void test_histogram()
+{
+    print_section("Latency Histogram");
+
+    LatencyHistogram histogram;
+    for (int i = 1; i <= 1000; ++i)
+    {
+        histogram.record(std::chrono::microseconds(i));
+    }
+    const double p50 = std::chrono::duration<double, std::micro>(histogram.percentile(0.5)).count();
+    const double p99 = std::chrono::duration<double, std::micro>(histogram.percentile(0.99)).count();
+    print_test_result("Count", static_cast<uint64_t>(1000), histogram.count());
+    print_test_result("p50 within bucket error", true, p50 >= 500.0 && p50 <= 500.0 * 1.125);
+    print_test_result("p99 within bucket error", true, p99 >= 990.0 && p99 <= 1000.0);
+    print_test_result("Max exact", 1000.0, histogram.summary().max_us);
+    histogram.clear();
+    print_test_result("Cleared", static_cast<uint64_t>(0), histogram.summary().count);
+}
+
+// 测试多帧在途与乱序匹配
+void test_pipelined()
+{
+    print_section("Pipelined Out Of Order");
+
+    const int frames = 20;
+    const int infer_ms = 20;
+    SleepStages stages(infer_ms);
+    PipelineServerOptions server_options;
+    server_options.infer_workers = 3;
+    Harness harness(&stages, server_options);
+
+    PipelineClientOptions options;
+    options.max_in_flight = 3;
+    options.drop_oldest = false;
+    PerceptionPipelineClient client(harness.stub.get(), harness.collector(), options);
+    client.start();
+    const auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; ++i)
+    {
+        client.submit(make_image(std::to_string(i)));
+    }
+    print_test_result("Close ok", true, client.close().ok());
+    const double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    PipelineClientStats stats = client.stats();
+    print_test_result("All completed", static_cast<uint64_t>(frames), stats.completed);
+    print_test_result("None unmatched", static_cast<uint64_t>(0), stats.unmatched);
+    print_test_result("None lost", static_cast<uint64_t>(0), stats.lost);
+
+    bool out_of_order = false;
+    bool tracks_match = true;
+    for (std::size_t i = 0; i < harness.order.size(); ++i)
+    {
+        out_of_order |= i > 0 && std::stoi(harness.order[i]) < std::stoi(harness.order[i - 1]);
+        tracks_match &= harness.order[i] == harness.tracks[i];
+    }
+    print_test_result("Completed out of order", true, out_of_order);
+    print_test_result("Results matched to frames", true, tracks_match);
+
+    // 串行处理至少需要 10 * 20 + 10 * 5 = 250ms
+    const double lock_step_ms = (frames / 2) * infer_ms + (frames / 2) * (infer_ms / 4);
+    print_test_result("Faster than lock-step", true, elapsed_ms < lock_step_ms * 0.8);
+
+    PipelineServerStats server_stats = harness.service.stats();
+    print_test_result("Server frames", static_cast<uint64_t>(frames), server_stats.frames);
+    print_test_result("Infer stage timed", true, server_stats.infer.count == frames && server_stats.infer.max_us >= infer_ms * 1000.0);
+    print_test_result("Decode stage timed", static_cast<uint64_t>(frames), server_stats.decode.count);
+    print_test_result("Round trip timed", static_cast<uint64_t>(frames), stats.round_trip.count);
+}
+
+// 测试保序模式
+void test_ordered()
+{
+    print_section("Ordered");
+
+    SleepStages stages(12);
+    PipelineServerOptions server_options;
+    server_options.infer_workers = 3;
+    server_options.ordered = true;
+    Harness harness(&stages, server_options);
+
+    PipelineClientOptions options;
+    options.max_in_flight = 4;
+    options.drop_oldest = false;
+    PerceptionPipelineClient client(harness.stub.get(), harness.collector(), options);
+    client.start();
+    for (int i = 0; i < 12; ++i)
+    {
+        client.submit(make_image(std::to_string(i)));
+    }
+    client.close();
+
+    bool in_order = harness.order.size() == 12;
+    for (std::size_t i = 0; in_order && i < harness.order.size(); ++i)
+    {
+        in_order = harness.order[i] == std::to_string(i);
+    }
+    print_test_result("Submission order kept", true, in_order);
+}
+
+// 测试丢弃最旧帧与失败帧
+void test_drop_and_failure()
+{
+    print_section("Drop Oldest And Failure");
+
+    SleepStages stages(40);
+    Harness harness(&stages, PipelineServerOptions());
+
+    PipelineClientOptions options;
+    options.max_in_flight = 1;
+    options.queue_depth = 1;
+    options.drop_oldest = true;
+    PerceptionPipelineClient client(harness.stub.get(), harness.collector(), options);
+    client.start();
+    client.submit(make_image("bad"));
+    while (client.stats().sent == 0)
+    {
+        std::this_thread::yield();
+    }
+    for (int i = 0; i < 10; ++i)
+    {
+        client.submit(make_image(std::to_string(i * 2)));
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    client.close();
+
+    PipelineClientStats stats = client.stats();
+    print_test_result("Frames dropped", true, stats.dropped > 0);
+    print_test_result("Completed + dropped", stats.submitted, stats.completed + stats.dropped);
+    print_test_result("Newest frame kept", std::string("18"), harness.order.back());
+    print_test_result("Failed frame answered", std::string("bad"), harness.order.front());
+    print_test_result("Failed frame empty", std::string(), harness.tracks.front());
+    print_test_result("Server failed count", static_cast<uint64_t>(1), harness.service.stats().failed);
+    print_test_result("Submit after close", false, client.submit(make_image("late")));
+}
+
+// 测试追踪上下文从 Image 传到 Perception
+void test_trace()
+{
+    print_section("Trace Propagation");
+
+    SleepStages stages(2);
+    PipelineServerOptions server_options;
+    server_options.ordered = true;
+    Harness harness(&stages, server_options);
+
+    PipelineClientOptions options;
+    options.drop_oldest = false;
+    PerceptionPipelineClient client(harness.stub.get(), harness.collector(), options);
+    client.start();
+    const uint64_t capture_end = trace_clock_ns();
+    for (const std::string time_stamp : {"1", "bad", "2"})
+    {
+        Image image = make_image(time_stamp);
+        if (time_stamp != "2")
+        {
+            start_trace(image.mutable_trace());
+            add_hop(image.mutable_trace(), TRACE_STAGE_CAPTURE, capture_end - 1000, capture_end);
+        }
+        client.submit(image);
+    }
+    client.close();
+
+    print_test_result("Results", static_cast<std::size_t>(3), harness.traces.size());
+    if (harness.traces.size() != 3)
+    {
+        return;
+    }
+    const TraceContext &traced = harness.traces[0];
+    print_test_result("Trace id kept", true, traced.trace_id() != 0);
+    print_test_result("Perception hop added", true, traced.hops_size() == 2 && traced.hops(1).stage() == TRACE_STAGE_PERCEPTION);
+    print_test_result("Perception after capture", true, traced.hops_size() == 2 && traced.hops(1).start_ns() >= capture_end);
+    print_test_result("Failed frame keeps trace", true, harness.traces[1].trace_id() != 0 && harness.traces[1].hops_size() == 2);
+    print_test_result("Failed frame empty", std::string(), harness.tracks[1]);
+    print_test_result("Untraced frame", 0, harness.traces[2].hops_size());
+}
+
+int main()
+{
+    std::cout << "Testing Perception Pipeline Functionality" << std::endl;
+    std::cout << "=========================================" << std::endl;
+
+    try
+    {
+        test_histogram();
+        test_pipelined();
+        test_ordered();
+        test_drop_and_failure();
+        test_trace();
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "All tests completed successfully!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "frameRateControl.h"
+#include "printUtil.h"
+using namespace humanoid_robot::PB::perception;
+using namespace humanoid_robot::utils::PB;
+using Clock = FrameRateController::Clock;
+using std::chrono::milliseconds;
+
+// 单队列服务端模型：按到达顺序逐帧处理，带掩码的帧耗时 mask_ms，只算跟踪的帧耗时 track_ms
+struct SimulationResult
+{
+    std::vector<double> latencies_ms; // 每个结果的端到端延迟
+    uint64_t delivered = 0;
+    uint64_t fresh = 0;
+    uint64_t mask_frames = 0;
+};
+
+SimulationResult simulate(FrameRateController *controller, int seconds, int mask_ms, int track_ms)
+{
+    struct Queued
+    {
+        std::string time_stamp;
+        bool masks;
+        int sent_ms;
+    };
+    SimulationResult result;
+    std::deque<Queued> queue;
+    int busy_until = 0;
+    bool busy = false;
+    Queued current;
+    const Clock::time_point origin = Clock::now();
+
+    for (int t = 0; t <= seconds * 1000; ++t)
+    {
+        const Clock::time_point now = origin + milliseconds(t);
+        if (busy && t >= busy_until)
+        {
+            busy = false;
+            result.latencies_ms.push_back(t - current.sent_ms);
+            ++result.delivered;
+            if (controller == nullptr || controller->complete(current.time_stamp, now))
+            {
+                ++result.fresh;
+            }
+        }
+        if (!busy && !queue.empty())
+        {
+            current = queue.front();
+            queue.pop_front();
+            busy = true;
+            busy_until = t + (current.masks ? mask_ms : track_ms);
+        }
+        // 30 fps 相机
+        if (t * 3 % 100 < 3)
+        {
+            Img img;
+            img.set_timestamp(std::to_string(t));
+            img.set_requiresmasks(true);
+            if (controller == nullptr || controller->admit(&img, now) == FrameDecision::kSend)
+            {
+                queue.push_back(Queued{img.timestamp(), img.requiresmasks(), t});
+                result.mask_frames += img.requiresmasks() ? 1 : 0;
+            }
+        }
+    }
+    return result;
+}
+
+double percentile(std::vector<double> values, double p)
+{
+    if (values.empty())
+    {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, static_cast<std::size_t>(p * values.size()))];
+}
+
+// 测试不加控制时延迟无界增长
+void test_uncontrolled()
+{
+    print_section("Uncontrolled Baseline");
+
+    SimulationResult result = simulate(nullptr, 10, 60, 15);
+    print_test_result("Latency grows past 1s", true, result.latencies_ms.back() > 1000.0);
+}
+
+// 测试掩码过重时先关闭掩码
+void test_masks_off_under_load()
+{
+    print_section("Masks Off Under Load");
+
+    FrameRateController controller;
+    SimulationResult result = simulate(&controller, 10, 60, 15);
+    RateControlStats stats = controller.stats();
+
+    std::vector<double> tail(result.latencies_ms.begin() + static_cast<long>(result.latencies_ms.size() / 2), result.latencies_ms.end());
+    print_test_result("Masks switched off", true, stats.mask_switches >= 1);
+    print_test_result("Tail p99 bounded", true, percentile(tail, 0.99) <= 250.0);
+    print_test_result("Mostly fresh", true, result.fresh >= result.delivered * 9 / 10);
+    print_test_result("Most frames delivered", true, result.delivered >= 250);
+    print_test_result("Some frames still masked", true, result.mask_frames > 0);
+}
+
+// 测试只算跟踪也超载时降低帧率
+void test_rate_decrease()
+{
+    print_section("Rate Decrease");
+
+    RateControlOptions options;
+    options.target_latency = milliseconds(150);
+    FrameRateController controller(options);
+    SimulationResult result = simulate(&controller, 10, 50, 50);
+    RateControlStats stats = controller.stats();
+
+    std::vector<double> tail(result.latencies_ms.begin() + static_cast<long>(result.latencies_ms.size() / 2), result.latencies_ms.end());
+    print_test_result("Rate reduced", true, stats.fps < options.max_fps);
+    print_test_result("Frames skipped", true, stats.skipped > 0);
+    print_test_result("Tail p99 bounded", true, percentile(tail, 0.99) <= 250.0);
+    print_test_result("Throughput near capacity", true, result.delivered >= 150); // 服务端上限 200 帧
+}
+
+// 测试过期结果、丢失与在途上限
+void test_stale_and_lost()
+{
+    print_section("Stale And Lost");
+
+    RateControlOptions options;
+    options.max_in_flight = 2;
+    options.frame_timeout = milliseconds(500);
+    FrameRateController controller(options);
+    const Clock::time_point t0 = Clock::now();
+
+    bool masks = false;
+    print_test_result("First sent", true, controller.admit("a", &masks, t0) == FrameDecision::kSend);
+    print_test_result("Masks not requested", false, masks);
+    print_test_result("Second sent", true, controller.admit("b", &masks, t0 + milliseconds(40)) == FrameDecision::kSend);
+    print_test_result("Window full", true, controller.admit("c", &masks, t0 + milliseconds(80)) == FrameDecision::kSkipWindow);
+
+    print_test_result("Fresh result", true, controller.complete("a", t0 + milliseconds(50)));
+    print_test_result("Stale result", false, controller.complete("b", t0 + milliseconds(200)));
+    print_test_result("Unknown result", false, controller.complete("zz", t0 + milliseconds(200)));
+
+    controller.admit("d", &masks, t0 + milliseconds(300));
+    controller.admit("e", &masks, t0 + milliseconds(900));
+    RateControlStats stats = controller.stats();
+    print_test_result("Stale counted", static_cast<uint64_t>(1), stats.stale);
+    print_test_result("Lost counted", static_cast<uint64_t>(1), stats.lost);
+    print_test_result("Rate cut after loss", true, stats.fps < options.max_fps);
+}
+
+int main()
+{
+    std::cout << "Testing Perception Rate Control Functionality" << std::endl;
+    std::cout << "=============================================" << std::endl;
+
+    try
+    {
+        test_uncontrolled();
+        test_masks_off_under_load();
+        test_rate_decrease();
+        test_stale_and_lost();
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "All tests completed successfully!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
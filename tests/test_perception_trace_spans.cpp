@@ -0,0 +1,226 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "printUtil.h"
+#include "spanTracer.h"
+#include "communication/communication_service.pb.h"
+#include "communication/topic_service.pb.h"
+#include "perception/perception_request_response.pb.h"
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::PB::communication;
+using namespace humanoid_robot::PB::perception;
+using namespace humanoid_robot::utils::PB;
+
+// 测试追踪上下文随消息传递：采集 → Topic → 感知 → 规划
+void test_context_propagation()
+{
+    print_section("Context Propagation");
+
+    Image image;
+    start_trace(image.mutable_trace());
+    const uint64_t trace_id = image.trace().trace_id();
+    print_test_result("Trace id assigned", true, trace_id != 0);
+    add_hop(image.mutable_trace(), TRACE_STAGE_CAPTURE, 1000, 3000);
+
+    // 经 TopicMessage 转发，接收端解析后继续追加
+    TopicMessage message;
+    *message.mutable_trace() = image.trace();
+    message.set_payload(image.SerializeAsString());
+    TopicMessage received;
+    received.ParseFromString(message.SerializeAsString());
+    add_hop(received.mutable_trace(), TRACE_STAGE_TRANSPORT, 3500, 4000);
+
+    Perception perception;
+    *perception.mutable_trace() = received.trace();
+    add_hop(perception.mutable_trace(), TRACE_STAGE_PERCEPTION, 4200, 9200);
+
+    UniversalRequest request;
+    *request.mutable_trace() = perception.trace();
+    add_hop(request.mutable_trace(), TRACE_STAGE_PLANNER, 9700, 10700);
+
+    const TraceContext &context = request.trace();
+    print_test_result("Trace id preserved", trace_id, context.trace_id());
+    print_test_result("Hop count", 4, context.hops_size());
+    print_test_result("Clock id set", trace_clock_id(), context.hops(0).clock_id());
+    print_test_result("Compact wire", true, context.ByteSizeLong() < 100);
+
+    const std::vector<HopLatency> hops = hop_latencies(context);
+    print_test_result("Capture duration", static_cast<uint64_t>(2000), hops[0].duration_ns);
+    print_test_result("First hop has no gap", static_cast<int64_t>(-1), hops[0].gap_ns);
+    print_test_result("Transport gap", static_cast<int64_t>(500), hops[1].gap_ns);
+    print_test_result("Perception duration", static_cast<uint64_t>(5000), hops[2].duration_ns);
+    print_test_result("Planner gap", static_cast<int64_t>(500), hops[3].gap_ns);
+    print_test_result("End to end", static_cast<int64_t>(9700), end_to_end_ns(context));
+
+    // 来自其他主机的阶段：单调时钟不可比较
+    TraceContext remote = context;
+    remote.mutable_hops(2)->set_clock_id(trace_clock_id() + 1);
+    print_test_result("Cross clock gap unknown", static_cast<int64_t>(-1), hop_latencies(remote)[2].gap_ns);
+    print_test_result("Cross clock end to end unknown", static_cast<int64_t>(-1), end_to_end_ns(remote));
+    print_test_result("Empty context", static_cast<int64_t>(-1), end_to_end_ns(TraceContext()));
+
+    TraceContext existing;
+    existing.set_trace_id(42);
+    start_trace(&existing);
+    print_test_result("Existing trace id kept", static_cast<uint64_t>(42), existing.trace_id());
+}
+
+// 测试 HopScope 与 span 记录
+void test_hop_scope()
+{
+    print_section("Hop Scope");
+
+    SpanTracer tracer;
+    Image image;
+    start_trace(image.mutable_trace());
+    const uint64_t before = trace_clock_ns();
+    {
+        HopScope hop(image.mutable_trace(), TRACE_STAGE_CAPTURE, &tracer);
+    }
+    {
+        HopScope hop(image.mutable_trace(), TRACE_STAGE_PERCEPTION, nullptr, before);
+    }
+    print_test_result("Hops appended", 2, image.trace().hops_size());
+    print_test_result("Capture stage", static_cast<int>(TRACE_STAGE_CAPTURE), static_cast<int>(image.trace().hops(0).stage()));
+    print_test_result("Start after before", true, image.trace().hops(0).start_ns() >= before);
+    print_test_result("Explicit start", before, image.trace().hops(1).start_ns());
+
+    std::vector<SpanRecord> spans;
+    print_test_result("One span recorded", static_cast<std::size_t>(1), tracer.drain(&spans));
+    print_test_result("Span name", std::string("capture"), std::string(spans[0].name));
+    print_test_result("Span trace id", image.trace().trace_id(), spans[0].trace_id);
+    print_test_result("Span thread", static_cast<uint32_t>(1), spans[0].thread);
+    print_test_result("Drained empty", static_cast<std::size_t>(0), tracer.drain(&spans));
+
+    print_test_result("Record hops", static_cast<std::size_t>(2), tracer.record_hops(image.trace()));
+    TraceContext remote = image.trace();
+    remote.mutable_hops(0)->set_clock_id(trace_clock_id() + 1);
+    print_test_result("Remote hops skipped", static_cast<std::size_t>(1), tracer.record_hops(remote));
+}
+
+// 测试多线程记录、丢弃计数与线程退出后的回收
+void test_threads()
+{
+    print_section("Per-thread Buffers");
+
+    SpanTracer tracer(64);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&tracer, t]
+                             {
+            for (int i = 0; i < 100; ++i)
+            {
+                tracer.record("work", static_cast<uint64_t>(t + 1), static_cast<uint64_t>(i), static_cast<uint64_t>(i + 1));
+            } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    std::vector<SpanRecord> spans;
+    print_test_result("Ring capacity respected", static_cast<std::size_t>(4 * 64), tracer.drain(&spans));
+    print_test_result("Dropped counted", static_cast<uint64_t>(4 * 36), tracer.dropped());
+    print_test_result("Recorded counted", static_cast<uint64_t>(4 * 64), tracer.recorded());
+
+    int threads_seen = 0;
+    for (uint32_t id = 1; id <= 4; ++id)
+    {
+        for (const SpanRecord &span : spans)
+        {
+            if (span.thread == id)
+            {
+                ++threads_seen;
+                break;
+            }
+        }
+    }
+    print_test_result("Thread ids distinct", 4, threads_seen);
+    print_test_result("Exited threads retired", static_cast<uint64_t>(4 * 64), tracer.recorded());
+}
+
+// 测试 Chrome trace JSON 导出
+void test_chrome_trace()
+{
+    print_section("Chrome Trace Export");
+
+    SpanTracer tracer;
+    tracer.record("perception", 0xABCDEFull, 1234567, 1239567);
+    tracer.record("say \"hi\"", 1, 10, 20);
+    std::string json;
+    print_test_result("Exported count", static_cast<std::size_t>(2), tracer.export_chrome_trace(&json));
+    print_test_result("Has traceEvents", true, json.find("\"traceEvents\":[") != std::string::npos);
+    print_test_result("Complete event", true, json.find("\"name\":\"perception\",\"ph\":\"X\",\"ts\":1234.567,\"dur\":5.000") != std::string::npos);
+    print_test_result("Trace id hex", true, json.find("\"trace_id\":\"0000000000abcdef\"") != std::string::npos);
+    print_test_result("Name escaped", true, json.find("\"say \\\"hi\\\"\"") != std::string::npos);
+    print_test_result("Closed", true, json.size() > 3 && json.compare(json.size() - 3, 3, "]}\n") == 0);
+
+    std::string empty;
+    format_chrome_trace({}, &empty);
+    print_test_result("Empty export", std::string("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n]}\n"), empty);
+}
+
+// 测试按阶段汇总
+void test_breakdown()
+{
+    print_section("Latency Breakdown");
+
+    LatencyBreakdown breakdown;
+    for (uint64_t i = 0; i < 100; ++i)
+    {
+        TraceContext context;
+        context.set_trace_id(i + 1);
+        const uint64_t base = i * 1000000;
+        add_hop(&context, TRACE_STAGE_CAPTURE, base, base + 1000);
+        add_hop(&context, TRACE_STAGE_PERCEPTION, base + 2000, base + 2000 + 10000 + i * 100);
+        add_hop(&context, TRACE_STAGE_PLANNER, base + 30000, base + 31000);
+        breakdown.add(context);
+    }
+
+    const std::vector<TraceStageLatency> stages = breakdown.stages();
+    print_test_result("Stage count", static_cast<std::size_t>(3), stages.size());
+    print_test_result("Stage order", static_cast<int>(TRACE_STAGE_PERCEPTION), static_cast<int>(stages[1].stage));
+    print_test_result("Perception count", static_cast<uint64_t>(100), stages[1].count);
+    print_test_result("Perception mean", static_cast<uint64_t>(14950), stages[1].mean_ns);
+    print_test_result("Perception max", static_cast<uint64_t>(19900), stages[1].max_ns);
+    // 分位数取桶上界：误差不超过 12.5%
+    print_test_result("Perception p50 bound", true, stages[1].p50_ns >= 14900 && stages[1].p50_ns <= 14900 * 9 / 8);
+    print_test_result("Perception p99 bound", true, stages[1].p99_ns >= 19800 && stages[1].p99_ns <= 19900);
+    print_test_result("Capture has no gap", static_cast<uint64_t>(0), stages[0].gap_count);
+    print_test_result("Perception gap", static_cast<uint64_t>(1000), stages[1].gap_mean_ns);
+
+    const TraceStageLatency total = breakdown.end_to_end();
+    print_test_result("End to end count", static_cast<uint64_t>(100), total.count);
+    print_test_result("End to end max", static_cast<uint64_t>(31000), total.max_ns);
+    const std::string report = breakdown.report();
+    print_test_result("Report rows", true, report.find("perception") != std::string::npos && report.find("end_to_end") != std::string::npos);
+
+    breakdown.reset();
+    print_test_result("Reset", static_cast<std::size_t>(0), breakdown.stages().size());
+}
+
+int main()
+{
+    std::cout << "Testing Trace Span Functionality" << std::endl;
+    std::cout << "================================" << std::endl;
+
+    try
+    {
+        test_context_propagation();
+        test_hop_scope();
+        test_threads();
+        test_chrome_trace();
+        test_breakdown();
+
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "All tests completed successfully!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,123 @@
+#ifndef ASYNC_INTERFACE_SERVER_H
+#define ASYNC_INTERFACE_SERVER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <grpcpp/grpcpp.h>
+#include "interfaces/interfaces_grpc.grpc.pb.h"
+#include "interfaces/interfaces_request_response.pb.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            // 流式响应的写端，可在任意线程使用；调用结束后写入直接返回 false
+            template <typename Response>
+            class ResponseStream
+            {
+            public:
+                virtual ~ResponseStream() = default;
+
+                // 排队一条响应。流已结束，或未完成的写入达到 max_pending_writes（背压）时返回 false，
+                // 调用方自行决定丢弃或稍后重试
+                virtual bool write(const Response &response) = 0;
+                // 结束调用；已排队的响应会先发送完
+                virtual void finish(const grpc::Status &status) = 0;
+
+                virtual std::size_t pending() const = 0;
+                virtual bool closed() const = 0;
+            };
+
+            // 业务处理接口，在完成队列线程上调用，不应长时间阻塞；
+            // 耗时的工作应保存 stream 后在其他线程完成。request 只在调用期间有效
+            class InterfaceHandler
+            {
+            public:
+                virtual ~InterfaceHandler() = default;
+
+                virtual grpc::Status subscribe(const humanoid_robot::PB::interfaces::SubscribeRequest &request,
+                                               humanoid_robot::PB::interfaces::SubscribeResponse *response);
+                virtual grpc::Status unsubscribe(const humanoid_robot::PB::interfaces::UnsubscribeRequest &request,
+                                                 humanoid_robot::PB::interfaces::UnsubscribeResponse *response);
+                virtual grpc::Status query(const humanoid_robot::PB::interfaces::QueryRequest &request,
+                                           humanoid_robot::PB::interfaces::QueryResponse *response);
+
+                // Send 流上每收到一条请求调用一次
+                virtual void send(const humanoid_robot::PB::interfaces::SendRequest &request,
+                                  const std::shared_ptr<ResponseStream<humanoid_robot::PB::interfaces::SendResponse>> &stream);
+                // 客户端结束写入；默认以 OK 结束调用
+                virtual void send_closed(const std::shared_ptr<ResponseStream<humanoid_robot::PB::interfaces::SendResponse>> &stream);
+                // Action 请求；响应写完后需调用 stream->finish()
+                virtual void action(const humanoid_robot::PB::interfaces::ActionRequest &request,
+                                    const std::shared_ptr<ResponseStream<humanoid_robot::PB::interfaces::ActionResponse>> &stream);
+            };
+
+            struct AsyncServerOptions
+            {
+                std::string address = "0.0.0.0:50051";
+                std::shared_ptr<grpc::ServerCredentials> credentials; // 为空时使用不加密连接
+                int threads = 0;                                     // 完成队列数（每个一个线程），0 表示 CPU 核数
+                bool pin_threads = true;                             // 完成队列线程绑定到各自的 CPU
+                std::size_t max_pending_writes = 64;                 // 每个流未发送完的响应上限
+                std::size_t pool_size = 256;                         // 每个完成队列、每种 RPC 缓存的空闲调用对象数
+                std::chrono::milliseconds shutdown_grace{1000};      // 关停时等待进行中调用的时间
+            };
+
+            struct AsyncServerStats
+            {
+                uint64_t calls = 0;           // 已接收的调用
+                uint64_t active_streams = 0;  // 进行中的 Send / Action 流
+                uint64_t rejected_writes = 0; // 因背压被拒绝的写入
+                uint64_t paused_reads = 0;    // Send 流因写入积压暂停读取的次数
+            };
+
+            // 基于 CompletionQueue 异步接口的 InterfaceService 服务端：
+            // 每个核一个完成队列和一个线程，调用对象按 RPC 类型池化复用；
+            // Send 流在响应积压时暂停读取，由 HTTP/2 流控把压力传回客户端
+            class AsyncInterfaceServer
+            {
+            public:
+                AsyncInterfaceServer(InterfaceHandler *handler, AsyncServerOptions options = AsyncServerOptions());
+                ~AsyncInterfaceServer();
+
+                AsyncInterfaceServer(const AsyncInterfaceServer &) = delete;
+                AsyncInterfaceServer &operator=(const AsyncInterfaceServer &) = delete;
+
+                // 端口绑定失败时返回 false
+                bool start();
+                void shutdown();
+
+                // 实际监听的端口（address 使用 ":0" 时由系统分配）
+                int port() const { return port_; }
+                AsyncServerStats stats() const;
+
+            private:
+                class Worker;
+                friend class Worker;
+
+                InterfaceHandler *handler_;
+                AsyncServerOptions options_;
+                humanoid_robot::PB::interfaces::InterfaceService::AsyncService service_;
+                std::unique_ptr<grpc::Server> server_;
+                std::vector<std::unique_ptr<Worker>> workers_;
+                int port_ = 0;
+
+                std::atomic<uint64_t> calls_{0};
+                std::atomic<uint64_t> active_streams_{0};
+                std::atomic<uint64_t> rejected_writes_{0};
+                std::atomic<uint64_t> paused_reads_{0};
+            };
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // ASYNC_INTERFACE_SERVER_H
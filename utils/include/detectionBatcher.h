@@ -0,0 +1,155 @@
+#ifndef DETECTION_BATCHER_H
+#define DETECTION_BATCHER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <grpcpp/grpcpp.h>
+#include "detection/detection.pb.h"
+#include "detection/detection.grpc.pb.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            // 同一批中的请求 format 相同、classes 集合相同（已排序去重）
+            struct DetectionBatch
+            {
+                std::string format;
+                std::vector<std::string> classes;
+                std::vector<const detection::DetectionRequest *> requests;
+            };
+
+            // 推理回调：为 batch.requests 的每一项按顺序填写一个响应。
+            // 返回 false、抛出异常或响应数量不符时，整批回复 success = false
+            using BatchInference = std::function<bool(const DetectionBatch &batch, std::vector<detection::DetectionResponse> *responses)>;
+
+            struct BatcherOptions
+            {
+                std::size_t max_batch_size = 8;
+                std::chrono::microseconds max_wait{2000}; // 批次中最早的请求最多等待的时间
+                int workers = 1;                          // 并发执行推理回调的线程数
+                std::size_t max_queued = 1024;            // 排队请求上限，达到后 submit 阻塞
+            };
+
+            struct BatcherStats
+            {
+                uint64_t requests = 0;
+                uint64_t batches = 0;
+                uint64_t full_batches = 0;     // 达到 max_batch_size 触发
+                uint64_t deadline_batches = 0; // 达到 max_wait 或关停时触发
+                uint64_t failed_batches = 0;
+                std::size_t largest_batch = 0;
+                std::size_t queued = 0;
+            };
+
+            // 动态微批调度：收集来自所有流的 DetectionRequest，按 (format, classes) 分组，
+            // 凑满 max_batch_size 或最早的请求等待超过 max_wait 时交给推理回调，再把响应逐个分发回去
+            class DetectionBatcher
+            {
+            public:
+                using Completion = std::function<void(detection::DetectionResponse &&response)>;
+
+                DetectionBatcher(BatchInference inference, BatcherOptions options = BatcherOptions());
+                ~DetectionBatcher();
+
+                DetectionBatcher(const DetectionBatcher &) = delete;
+                DetectionBatcher &operator=(const DetectionBatcher &) = delete;
+
+                // done 在工作线程上调用。关停后返回 false，done 不会被调用
+                bool submit(detection::DetectionRequest request, Completion done);
+                // 处理完已排队的请求后停止工作线程
+                void shutdown();
+
+                BatcherStats stats() const;
+
+                // 分组 key：format 与排序去重后的 classes
+                static std::string group_key(const detection::DetectionRequest &request);
+
+            private:
+                using Clock = std::chrono::steady_clock;
+
+                struct Item
+                {
+                    detection::DetectionRequest request;
+                    Completion done;
+                    Clock::time_point enqueued;
+                };
+
+                struct Group
+                {
+                    std::string format;
+                    std::vector<std::string> classes;
+                    std::deque<Item> items;
+                };
+
+                void worker_loop();
+                // 取出一个可执行的批次；没有时返回 false，*wake 为下一个截止时间
+                bool take_batch_locked(Clock::time_point now, std::vector<Item> *items, DetectionBatch *batch, Clock::time_point *wake);
+                void run_batch(std::vector<Item> &items, DetectionBatch &batch);
+
+                BatchInference inference_;
+                BatcherOptions options_;
+
+                mutable std::mutex mutex_;
+                std::condition_variable work_cv_;
+                std::condition_variable space_cv_;
+                std::map<std::string, Group> groups_;
+                std::size_t queued_ = 0;
+                bool stopping_ = false;
+                BatcherStats stats_;
+                std::vector<std::thread> workers_;
+            };
+
+            // 批处理的 ObjectDetection 服务：DetectObjects 与 BatchDetect 的请求都进入同一个 DetectionBatcher，
+            // BatchDetect 的响应按该流的请求顺序写回
+            class BatchingDetectionService : public detection::ObjectDetection::Service
+            {
+            public:
+                explicit BatchingDetectionService(DetectionBatcher *batcher);
+
+                grpc::Status DetectObjects(grpc::ServerContext *context, const detection::DetectionRequest *request,
+                                           detection::DetectionResponse *response) override;
+                grpc::Status BatchDetect(grpc::ServerContext *context,
+                                         grpc::ServerReaderWriter<detection::DetectionResponse, detection::DetectionRequest> *stream) override;
+
+            private:
+                DetectionBatcher *batcher_;
+            };
+
+            struct StubBackendOptions
+            {
+                std::chrono::microseconds batch_cost{2000}; // 每批的固定开销（模拟一次 kernel 启动 / 数据搬运）
+                std::chrono::microseconds item_cost{200};   // 每张图像的增量开销
+                int objects_per_image = 3;
+            };
+
+            // 仅用 CPU 的桩推理后端，用于联调与压测：按图像内容确定性地生成检测框，
+            // 耗时按 batch_cost + n * item_cost 忙等，体现批处理摊薄固定开销的效果
+            class StubDetectionBackend
+            {
+            public:
+                explicit StubDetectionBackend(StubBackendOptions options = StubBackendOptions());
+
+                bool operator()(const DetectionBatch &batch, std::vector<detection::DetectionResponse> *responses) const;
+
+            private:
+                StubBackendOptions options_;
+            };
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // DETECTION_BATCHER_H
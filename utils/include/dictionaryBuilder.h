@@ -0,0 +1,93 @@
+#ifndef DICTIONARY_BUILDER_H
+#define DICTIONARY_BUILDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <google/protobuf/arena.h>
+#include "common/variant.pb.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            // 带预估容量的消息 Arena。
+            // 一个请求/响应及其所有 Dictionary、Variant 都分配在同一个 Arena 上，
+            // 析构或 reset() 时一次性释放，避免每个键值对单独 malloc/free
+            class MessageArena
+            {
+            public:
+                // expected_entries: 预计的键值对总数，用于预分配首块内存
+                explicit MessageArena(std::size_t expected_entries = 32);
+
+                MessageArena(const MessageArena &) = delete;
+                MessageArena &operator=(const MessageArena &) = delete;
+
+                template <typename T>
+                T *create()
+                {
+                    return ::google::protobuf::Arena::CreateMessage<T>(&arena_);
+                }
+
+                // 释放全部消息并复用 Arena，返回释放前使用的字节数
+                uint64_t reset() { return arena_.Reset(); }
+
+                ::google::protobuf::Arena *arena() { return &arena_; }
+
+            private:
+                static ::google::protobuf::ArenaOptions make_options(std::size_t expected_entries);
+
+                ::google::protobuf::Arena arena_;
+            };
+
+            // 就地构建 Dictionary.keyValueList。
+            // 值直接写入 map 中的槽位，不再经过栈上 Variant 再 insert 拷贝；
+            // 目标 Dictionary 在 Arena 上时，所有节点和字符串都从该 Arena 分配
+            class DictionaryBuilder
+            {
+            public:
+                explicit DictionaryBuilder(humanoid_robot::PB::common::Dictionary *target);
+
+                DictionaryBuilder &set_bool(const std::string &key, bool value);
+                DictionaryBuilder &set_int8(const std::string &key, int8_t value);
+                DictionaryBuilder &set_uint8(const std::string &key, uint8_t value);
+                DictionaryBuilder &set_int16(const std::string &key, int16_t value);
+                DictionaryBuilder &set_uint16(const std::string &key, uint16_t value);
+                DictionaryBuilder &set_int32(const std::string &key, int32_t value);
+                DictionaryBuilder &set_uint32(const std::string &key, uint32_t value);
+                DictionaryBuilder &set_int64(const std::string &key, int64_t value);
+                DictionaryBuilder &set_uint64(const std::string &key, uint64_t value);
+                DictionaryBuilder &set_float(const std::string &key, float value);
+                DictionaryBuilder &set_double(const std::string &key, double value);
+                DictionaryBuilder &set_string(const std::string &key, std::string value);
+                DictionaryBuilder &set_bytes(const std::string &key, std::string value);
+
+                // 移入一个已构建好的 Variant；与目标在同一 Arena 上时只交换指针
+                DictionaryBuilder &set(const std::string &key, humanoid_robot::PB::common::Variant &&value);
+
+                // 返回 key 对应的槽位（不存在则创建），调用方可直接填充任意类型
+                humanoid_robot::PB::common::Variant *slot(const std::string &key);
+
+                // 返回嵌套字典的构建器，嵌套字典与父字典共享 Arena
+                DictionaryBuilder child(const std::string &key);
+
+                // 在目标所在 Arena 上创建临时 Variant，配合 set() 使用可避免拷贝；
+                // 目标不在 Arena 上时返回堆对象，需由调用方释放
+                humanoid_robot::PB::common::Variant *new_variant() const;
+
+                humanoid_robot::PB::common::Dictionary *get() const { return target_; }
+                ::google::protobuf::Arena *arena() const { return target_->GetArena(); }
+
+            private:
+                ::google::protobuf::Map<std::string, humanoid_robot::PB::common::Variant> *map_;
+                humanoid_robot::PB::common::Dictionary *target_;
+            };
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // DICTIONARY_BUILDER_H
@@ -0,0 +1,89 @@
+#ifndef DICTIONARY_DELTA_H
+#define DICTIONARY_DELTA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "common/variant.pb.h"
+#include "variantHash.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            // 订阅时在 SubscribeRequest.params 中设置该 key（boolValue = true）表示客户端能处理
+            // Notification.delta；未声明的旧客户端继续收到完整的 notifyMessage
+            constexpr char kAcceptDeltaKey[] = "acceptDelta";
+
+            bool accepts_delta(const humanoid_robot::PB::common::Dictionary &params);
+
+            struct DeltaOptions
+            {
+                uint32_t keyframe_interval = 100; // 每 N 次更新强制发送一次关键帧，让丢失增量的客户端自动恢复
+                double keyframe_ratio = 0.5;      // 变化的 key 超过该比例时直接发送关键帧
+            };
+
+            // 服务端：对同一订阅的连续 Dictionary 快照做差分。
+            // 每个 key 只保存值的 64 位哈希，快照中只有哈希变化的 key 进入增量；
+            // 同时维护最新完整状态，用于给新订阅者发送关键帧
+            class DeltaEncoder
+            {
+            public:
+                explicit DeltaEncoder(DeltaOptions options = DeltaOptions());
+
+                // 用新快照更新状态并生成增量（或关键帧）。快照与上次相同时返回 false，out 为空，不需要推送
+                bool encode(const humanoid_robot::PB::common::Dictionary &snapshot,
+                            humanoid_robot::PB::common::DictionaryDelta *out);
+
+                // 当前完整状态的关键帧（新订阅者加入或客户端请求重同步时）
+                void keyframe(humanoid_robot::PB::common::DictionaryDelta *out) const;
+
+                uint64_t version() const { return version_; }
+                const humanoid_robot::PB::common::Dictionary &state() const { return state_; }
+                // 当前状态的结构哈希，等于 hash_dictionary(state())
+                uint64_t state_hash() const { return hashes_.value(); }
+
+            private:
+                DeltaOptions options_;
+                humanoid_robot::PB::common::Dictionary state_;
+                DictionaryHash hashes_; // key -> 上次推送值的哈希
+                uint64_t version_ = 0;
+                uint32_t since_keyframe_ = 0;
+            };
+
+            // 客户端：按版本号应用增量，维护物化后的完整状态
+            class DeltaDecoder
+            {
+            public:
+                enum class Result
+                {
+                    kApplied,  // 增量已应用
+                    kKeyframe, // 关键帧已替换全部状态
+                    kStale,    // 版本不新于当前状态（重复或乱序），已忽略
+                    kGap,      // baseVersion 与当前版本不符（中间增量丢失），等待下一个关键帧
+                };
+
+                Result apply(const humanoid_robot::PB::common::DictionaryDelta &delta);
+
+                const humanoid_robot::PB::common::Dictionary &state() const { return state_; }
+                uint64_t version() const { return version_; }
+                bool synced() const { return synced_; }
+
+            private:
+                humanoid_robot::PB::common::Dictionary state_;
+                uint64_t version_ = 0;
+                bool synced_ = false;
+            };
+
+            // 把增量的 set / remove 应用到 target（不检查版本）
+            void apply_delta(const humanoid_robot::PB::common::DictionaryDelta &delta,
+                             humanoid_robot::PB::common::Dictionary *target);
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // DICTIONARY_DELTA_H
@@ -0,0 +1,246 @@
+#ifndef DICTIONARY_LAYOUT_H
+#define DICTIONARY_LAYOUT_H
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "common/variant.pb.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            // 编译期键表。键按长度分桶，运行时匹配只比较同长度的候选键，不做字符串哈希
+            template <std::size_t N>
+            class DictionarySchema
+            {
+            public:
+                static constexpr std::size_t npos = N;
+
+                constexpr explicit DictionarySchema(const std::array<std::string_view, N> &keys)
+                    : keys_(keys), order_(), bucket_begin_(), max_length_(0)
+                {
+                    for (std::size_t i = 0; i < N; ++i)
+                    {
+                        order_[i] = i;
+                        if (keys_[i].size() > max_length_)
+                        {
+                            max_length_ = keys_[i].size();
+                        }
+                    }
+                    // 插入排序（编译期执行，N 很小）
+                    for (std::size_t i = 1; i < N; ++i)
+                    {
+                        for (std::size_t j = i; j > 0 && keys_[order_[j]].size() < keys_[order_[j - 1]].size(); --j)
+                        {
+                            std::size_t tmp = order_[j];
+                            order_[j] = order_[j - 1];
+                            order_[j - 1] = tmp;
+                        }
+                    }
+                    std::size_t pos = 0;
+                    for (std::size_t len = 0; len < kMaxKeyLength + 2; ++len)
+                    {
+                        while (pos < N && keys_[order_[pos]].size() < len)
+                        {
+                            ++pos;
+                        }
+                        bucket_begin_[len] = pos;
+                    }
+                }
+
+                constexpr std::size_t size() const { return N; }
+                constexpr std::string_view key(std::size_t index) const { return keys_[index]; }
+
+                // 键表合法：无重复键且长度不超过 kMaxKeyLength
+                constexpr bool valid() const
+                {
+                    for (std::size_t i = 0; i < N; ++i)
+                    {
+                        if (keys_[i].size() > kMaxKeyLength)
+                        {
+                            return false;
+                        }
+                        for (std::size_t j = i + 1; j < N; ++j)
+                        {
+                            if (keys_[i] == keys_[j])
+                            {
+                                return false;
+                            }
+                        }
+                    }
+                    return true;
+                }
+
+                // 返回键的槽位下标，不在键表中返回 npos；常量表达式中调用时在编译期求值
+                constexpr std::size_t index_of(std::string_view key) const
+                {
+                    // 键表可能含超长键（valid() 为 false，max_length_ 超过分桶表），按分桶表上限截断
+                    if (key.size() > max_length_ || key.size() > kMaxKeyLength)
+                    {
+                        return npos;
+                    }
+                    for (std::size_t i = bucket_begin_[key.size()]; i < bucket_begin_[key.size() + 1]; ++i)
+                    {
+                        const std::string_view candidate = keys_[order_[i]];
+                        if (candidate.empty() || (candidate[0] == key[0] && candidate == key))
+                        {
+                            return order_[i];
+                        }
+                    }
+                    return npos;
+                }
+
+                static constexpr std::size_t kMaxKeyLength = 64;
+
+            private:
+                std::array<std::string_view, N> keys_;
+                std::array<std::size_t, N> order_;
+                std::array<std::size_t, kMaxKeyLength + 2> bucket_begin_;
+                std::size_t max_length_;
+            };
+
+            template <typename... Keys>
+            constexpr DictionarySchema<sizeof...(Keys)> make_dictionary_schema(Keys... keys)
+            {
+                return DictionarySchema<sizeof...(Keys)>(std::array<std::string_view, sizeof...(Keys)>{std::string_view(keys)...});
+            }
+
+            // 按 Dictionary map entry 的线格式追加一个键值对，结果可直接按 Dictionary 解析
+            void append_dictionary_entry(std::string_view key, const humanoid_robot::PB::common::Variant &value, std::string *out);
+
+            // 基于编译期键表的 Dictionary 定长视图。
+            // load() 单次遍历 map，把键表中的键放入固定槽位，之后按下标 O(1) 访问；
+            // 槽位只保存指向源 Dictionary 的指针，源消息须在视图使用期间保持有效。
+            // 不在键表中的键仍通过源 map 查找
+            //
+            //   static constexpr auto kActionKeys = make_dictionary_schema("timeout", "correlationid");
+            //   DictionaryLayout<kActionKeys> layout;
+            //   layout.load(request.params());
+            //   const Variant *timeout = layout.get<kActionKeys.index_of("timeout")>();
+            template <const auto &Schema>
+            class DictionaryLayout
+            {
+            public:
+                static constexpr std::size_t kSize = Schema.size();
+                static_assert(Schema.valid(), "dictionary schema has duplicate or over-long keys");
+
+                using Dictionary = humanoid_robot::PB::common::Dictionary;
+                using Variant = humanoid_robot::PB::common::Variant;
+                using Map = ::google::protobuf::Map<std::string, Variant>;
+
+                DictionaryLayout() { slots_.fill(nullptr); }
+                explicit DictionaryLayout(const Dictionary &dict) { load(dict); }
+
+                // 单次遍历填充槽位；复用同一个视图时不会重新分配内存
+                void load(const Dictionary &dict)
+                {
+                    slots_.fill(nullptr);
+                    unknown_.clear();
+                    source_ = &dict;
+                    for (const auto &entry : dict.keyvaluelist())
+                    {
+                        const std::size_t index = Schema.index_of(entry.first);
+                        if (index != Schema.npos)
+                        {
+                            slots_[index] = &entry.second;
+                        }
+                        else
+                        {
+                            unknown_.push_back(&entry);
+                        }
+                    }
+                }
+
+                template <std::size_t I>
+                const Variant *get() const
+                {
+                    static_assert(I < kSize, "key is not part of the dictionary schema");
+                    return slots_[I];
+                }
+
+                const Variant *get(std::size_t index) const
+                {
+                    return index < kSize ? slots_[index] : nullptr;
+                }
+
+                bool has(std::size_t index) const { return get(index) != nullptr; }
+
+                // 替换槽位内容（例如在转发前修改某个键），value 的生命周期由调用方保证
+                void set(std::size_t index, const Variant *value)
+                {
+                    if (index < kSize)
+                    {
+                        slots_[index] = value;
+                    }
+                }
+
+                // 任意键查找：键表中的键走槽位，其余键走源 map
+                const Variant *find(const std::string &key) const
+                {
+                    const std::size_t index = Schema.index_of(key);
+                    if (index != Schema.npos)
+                    {
+                        return slots_[index];
+                    }
+                    if (source_ == nullptr)
+                    {
+                        return nullptr;
+                    }
+                    auto it = source_->keyvaluelist().find(key);
+                    return it == source_->keyvaluelist().end() ? nullptr : &it->second;
+                }
+
+                std::size_t unknown_size() const { return unknown_.size(); }
+
+                // 写回一个 Dictionary（槽位 + 未知键）
+                void write_to(Dictionary *out) const
+                {
+                    auto *map = out->mutable_keyvaluelist();
+                    map->clear();
+                    for (std::size_t i = 0; i < kSize; ++i)
+                    {
+                        if (slots_[i] != nullptr)
+                        {
+                            (*map)[std::string(Schema.key(i))] = *slots_[i];
+                        }
+                    }
+                    for (const auto *entry : unknown_)
+                    {
+                        (*map)[entry->first] = entry->second;
+                    }
+                }
+
+                // 直接序列化为 Dictionary 线格式，不构建中间 map
+                void serialize(std::string *out) const
+                {
+                    out->clear();
+                    for (std::size_t i = 0; i < kSize; ++i)
+                    {
+                        if (slots_[i] != nullptr)
+                        {
+                            append_dictionary_entry(Schema.key(i), *slots_[i], out);
+                        }
+                    }
+                    for (const auto *entry : unknown_)
+                    {
+                        append_dictionary_entry(entry->first, entry->second, out);
+                    }
+                }
+
+            private:
+                std::array<const Variant *, kSize> slots_;
+                std::vector<const typename Map::value_type *> unknown_;
+                const Dictionary *source_ = nullptr;
+            };
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // DICTIONARY_LAYOUT_H
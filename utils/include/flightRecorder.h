@@ -0,0 +1,215 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "communication/communication_service.pb.h"
+#include "communication/topic_service.pb.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            struct FlightBlock;
+            struct FlightIndexEntry;
+            struct FlightChannel;
+
+            // 黑匣子记录格式（小端主机）：
+            //   <prefix>-NNNNNN.rec  段文件：32 字节段头 + 若干记录，每条记录 32 字节记录头 + 负载，按 8 字节对齐
+            //   <prefix>-NNNNNN.idx  段索引：段关闭时写出，含通道表和每条记录的 {timestamp, sequence, offset}
+            // 通道 = (topic_name, publisher_id)，段内编号；通道定义同时以记录形式写入段文件，
+            // 因此 .idx 缺失（进程崩溃）时读取端可以扫描段文件重建索引，截断的尾部记录被丢弃。
+            enum class RecordKind : uint16_t
+            {
+                kChannel = 0,          // 段内通道定义（读取端内部使用，不会返回给调用方）
+                kTopicMessage = 1,     // 负载为 TopicMessage.payload
+                kUniversalRequest = 2, // 负载为序列化的 UniversalRequest
+                kTopicEnvelope = 3,    // 负载为序列化的 TopicMessage（带 name_id / payload_codec / codec_dictionary / trace）
+            };
+
+            struct RecorderOptions
+            {
+                std::string directory;                           // 输出目录，不存在时创建
+                std::string prefix = "flight";                   // 段文件名前缀
+                std::size_t segment_bytes = 256u << 20;          // 段文件达到该大小后切换新段
+                std::size_t block_bytes = 4u << 20;              // 内存写缓冲块大小
+                std::size_t max_buffered_bytes = 256u << 20;     // 待写盘数据上限，超过后丢弃新记录
+            };
+
+            // 生产者把记录拷贝进内存缓冲块（锁内只做空间预留，拷贝与校验在锁外），
+            // 写满的块交给后台线程顺序写盘。磁盘跟不上时丢弃新记录并计数，发布者从不阻塞。
+            class FlightRecorder
+            {
+            public:
+                // 创建目录并从已有段号之后开始编号；目录不可用时返回 nullptr
+                static std::unique_ptr<FlightRecorder> open(const RecorderOptions &options);
+                ~FlightRecorder();
+
+                FlightRecorder(const FlightRecorder &) = delete;
+                FlightRecorder &operator=(const FlightRecorder &) = delete;
+
+                // 记录 Topic 消息的负载；共享内存握手消息不含数据，直接忽略。
+                // 带 name_id、压缩编码、字典或 trace 的消息整条序列化为 kTopicEnvelope，回放时原样还原；
+                // 只带 name_id 的消息通道 topic 为空，按 topic 过滤前需先用 TopicNameDecoder 还原名称
+                bool record(const humanoid_robot::PB::communication::TopicMessage &message);
+
+                // 记录一条 UniversalRequest，channel 用作 topic_name（例如服务名），
+                // sequence 为符号扩展后的 requestId
+                bool record(std::string_view channel, const humanoid_robot::PB::communication::UniversalRequest &request);
+
+                // 记录任意负载
+                bool record_raw(RecordKind kind, std::string_view topic_name, std::string_view publisher_id,
+                                uint64_t timestamp, uint64_t sequence, std::string_view payload);
+
+                // 阻塞直到调用前记录的数据全部写盘（不关闭当前段）
+                void flush();
+
+                // 写出剩余数据和当前段索引，停止后台线程；之后的 record() 返回 false
+                void close();
+
+                uint64_t recorded() const;      // 成功记录的条数
+                uint64_t dropped() const;       // 缓冲区满或已关闭而丢弃的条数
+                uint64_t bytes_written() const; // 已写盘字节数（含记录头）
+                uint64_t segments() const;      // 已创建的段数
+
+            private:
+                explicit FlightRecorder(const RecorderOptions &options, uint32_t first_segment);
+
+                // message 非空时直接序列化进缓冲块，payload_size 为其 ByteSizeLong()；否则拷贝 payload
+                bool append(RecordKind kind, std::string_view topic_name, std::string_view publisher_id,
+                            uint64_t timestamp, uint64_t sequence, std::string_view payload,
+                            const google::protobuf::MessageLite *message, std::size_t payload_size);
+                char *reserve(std::size_t size, FlightBlock **block, uint64_t *offset);
+                bool seal_current();
+                void roll_segment();
+                void run();
+                bool write_block(FlightBlock *block);
+                void abandon_segment(int64_t keep_bytes);
+                void close_segment();
+
+                RecorderOptions options_;
+
+                std::mutex mutex_;
+                std::condition_variable cv_;
+                std::unique_ptr<FlightBlock> current_;
+                std::deque<std::unique_ptr<FlightBlock>> sealed_;
+                std::vector<std::unique_ptr<FlightBlock>> free_;
+                std::size_t buffered_bytes_ = 0;
+                uint32_t segment_number_;
+                uint64_t segment_offset_ = 0; // 生产者视角的当前段写入位置
+                std::unordered_map<std::string, uint32_t> channels_;
+                std::string channel_key_;
+                uint64_t flush_requested_ = 0;
+                uint64_t flush_completed_ = 0;
+                bool running_ = true;
+                std::thread writer_;
+
+                // 后台线程状态
+                int fd_ = -1;
+                uint32_t file_segment_ = 0;
+                uint32_t failed_segment_ = 0; // 写盘失败的段：其余块的偏移已失效，全部丢弃
+                std::vector<FlightIndexEntry> segment_index_;
+                std::vector<FlightChannel> segment_channels_;
+
+                std::atomic<uint64_t> recorded_{0};
+                std::atomic<uint64_t> dropped_{0};
+                std::atomic<uint64_t> bytes_written_{0};
+                std::atomic<uint64_t> segments_{0};
+            };
+
+            // 读取端返回的记录视图，指向 mmap 的段文件，在 FlightReader 销毁前有效
+            struct RecordView
+            {
+                RecordKind kind = RecordKind::kTopicMessage;
+                std::string_view topic_name;
+                std::string_view publisher_id;
+                uint64_t timestamp = 0;
+                uint64_t sequence = 0;
+                std::string_view payload;
+            };
+
+            // 把记录还原为消息（拷贝负载）；kTopicEnvelope 解析失败或记录不是 Topic 消息时返回 false
+            bool to_topic_message(const RecordView &record, humanoid_robot::PB::communication::TopicMessage *out);
+            bool to_universal_request(const RecordView &record, humanoid_robot::PB::communication::UniversalRequest *out);
+
+            struct ReaderOptions
+            {
+                bool verify_checksums = false; // next() 时校验负载 CRC32C，失败的记录跳过并计数
+            };
+
+            class FlightReader
+            {
+            public:
+                // 打开目录下所有 <prefix>-NNNNNN.rec 段；没有可读段时返回 nullptr
+                static std::unique_ptr<FlightReader> open(const std::string &directory, const std::string &prefix = "flight",
+                                                          const ReaderOptions &options = ReaderOptions());
+                ~FlightReader();
+
+                FlightReader(const FlightReader &) = delete;
+                FlightReader &operator=(const FlightReader &) = delete;
+
+                // 只返回时间戳在 [begin, end) 内的记录
+                void set_time_range(uint64_t begin, uint64_t end);
+                // 只返回指定 topic 的记录；空字符串表示全部
+                void set_topic(std::string_view topic_name);
+
+                // 借助索引定位到第一条时间戳 >= timestamp 的记录附近（之后由 next() 过滤）
+                void seek(uint64_t timestamp);
+                void rewind() { seek(0); }
+
+                // 按写入顺序取下一条满足过滤条件的记录；结束时返回 false
+                bool next(RecordView *out);
+
+                std::size_t segment_count() const { return segments_.size(); }
+                uint64_t record_count() const;        // 全部段的记录总数
+                uint64_t checksum_failures() const { return checksum_failures_; }
+                uint64_t first_timestamp() const;     // 全部记录的最小时间戳
+                uint64_t last_timestamp() const;      // 全部记录的最大时间戳
+
+            private:
+                struct Segment;
+
+                explicit FlightReader(const ReaderOptions &options);
+
+                ReaderOptions options_;
+                std::vector<std::unique_ptr<Segment>> segments_;
+                std::size_t segment_ = 0;
+                std::size_t entry_ = 0;
+                uint64_t begin_ = 0;
+                uint64_t end_ = std::numeric_limits<uint64_t>::max();
+                std::string topic_;
+                uint64_t checksum_failures_ = 0;
+            };
+
+            struct ReplayOptions
+            {
+                double speed = 1.0;          // 相对录制时的倍速；<= 0 表示尽快回放
+                uint64_t begin = 0;          // 时间范围 [begin, end)，单位同记录时间戳（毫秒）
+                uint64_t end = std::numeric_limits<uint64_t>::max();
+                std::string topic_name;      // 为空表示全部 topic
+            };
+
+            // 按记录时间戳的间隔回放，handler 返回 false 时提前结束。返回回放的记录数
+            uint64_t replay(FlightReader *reader, const ReplayOptions &options,
+                            const std::function<bool(const RecordView &)> &handler);
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // FLIGHT_RECORDER_H
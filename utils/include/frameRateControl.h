@@ -0,0 +1,104 @@
+#ifndef FRAME_RATE_CONTROL_H
+#define FRAME_RATE_CONTROL_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "perception/imgs.pb.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            struct RateControlOptions
+            {
+                std::chrono::milliseconds target_latency{100}; // 期望的端到端延迟上限
+                std::chrono::milliseconds stale_after{0};      // 结果超过该延迟视为过期，0 表示等于 target_latency
+                std::chrono::milliseconds frame_timeout{1000}; // 超时未返回的帧按丢失处理，并视为拥塞
+                std::size_t max_in_flight = 4;                 // 已发送未返回的帧上限
+                double max_fps = 30.0;                         // 发送帧率上限，一般为相机帧率
+                double min_fps = 1.0;
+                double increase_fps = 5.0;    // 延迟低于目标时每秒增加的帧率（加性增）
+                double decrease_factor = 0.7; // 延迟超过目标时帧率乘以该系数（乘性减），每个 RTT 最多一次
+                double masks_on_ratio = 0.5;  // 帧率已满且延迟低于 target * ratio 时恢复掩码
+                std::chrono::milliseconds mask_hold{2000};      // 关闭掩码后至少保持的时间
+                std::chrono::milliseconds max_mask_hold{30000}; // 恢复掩码后很快又拥塞时，保持时间翻倍的上限
+            };
+
+            enum class FrameDecision
+            {
+                kSend,       // 发送该帧
+                kSkipRate,   // 为降低帧率而跳过
+                kSkipWindow, // 在途帧已满而跳过
+            };
+
+            struct RateControlStats
+            {
+                uint64_t offered = 0;
+                uint64_t sent = 0;
+                uint64_t skipped = 0;
+                uint64_t completed = 0;
+                uint64_t stale = 0; // 返回时已超过 stale_after
+                uint64_t lost = 0;
+                uint64_t mask_switches = 0;
+                double fps = 0.0;    // 当前允许的发送帧率
+                double rtt_ms = 0.0; // 往返延迟的指数滑动平均
+                bool masks_enabled = true;
+                std::size_t in_flight = 0;
+            };
+
+            // continuousTrack / continuousMask / continuousInfo 等流的发送端流量控制，与传输方式无关：
+            // 每帧发送前调用 admit()，收到结果时调用 complete()，二者可在不同线程。
+            //
+            // 按 timeStamp 测量往返延迟，超过目标时先关闭 requiresMasks（只算跟踪），仍然超过再按 AIMD 降低帧率，
+            // 多余的帧在客户端直接跳过，不在服务端排队。对避障而言过期的感知比缺失更糟，
+            // 因此 complete() 对超过 stale_after 的结果返回 false，调用方应丢弃
+            class FrameRateController
+            {
+            public:
+                using Clock = std::chrono::steady_clock;
+
+                explicit FrameRateController(RateControlOptions options = RateControlOptions());
+
+                // 决定是否发送该帧；*requires_masks 为调用方的期望，负载高时被改为 false
+                FrameDecision admit(const std::string &time_stamp, bool *requires_masks, Clock::time_point now = Clock::now());
+                FrameDecision admit(humanoid_robot::PB::perception::Img *img, Clock::time_point now = Clock::now());
+
+                // 收到 time_stamp 对应的结果。结果未过期时返回 true；过期或未知的 timeStamp 返回 false
+                bool complete(const std::string &time_stamp, Clock::time_point now = Clock::now());
+
+                RateControlStats stats() const;
+
+            private:
+                void on_sample_locked(Clock::time_point sent, Clock::time_point now);
+                void on_congestion_locked(Clock::time_point now);
+                void expire_locked(Clock::time_point now);
+
+                RateControlOptions options_;
+
+                mutable std::mutex mutex_;
+                std::unordered_map<std::string, Clock::time_point> in_flight_;
+                double fps_;
+                double tokens_ = 1.0;
+                double rtt_ewma_ms_ = 0.0;
+                bool masks_enabled_ = true;
+                bool masks_requested_ = false; // 调用方是否请求过掩码
+                std::chrono::milliseconds mask_hold_;
+                Clock::time_point last_offer_{};
+                Clock::time_point last_decrease_{};
+                Clock::time_point masks_off_since_{};
+                Clock::time_point masks_on_since_{};
+                RateControlStats stats_;
+            };
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // FRAME_RATE_CONTROL_H
@@ -0,0 +1,125 @@
+#ifndef IMAGE_TRANSPORT_H
+#define IMAGE_TRANSPORT_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <grpcpp/impl/serialization_traits.h>
+#include <grpcpp/support/byte_buffer.h>
+#include <grpcpp/support/slice.h>
+#include <grpcpp/support/status.h>
+#include "common/variant.pb.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            // 零拷贝图像帧，线格式与 common::Image / perception::Img 完全一致
+            // （1: timeStamp, 2: img, 3: requiresMasks, 4: trace），可与生成代码互通。
+            //
+            // 发送侧：attach_image() 挂接相机 DMA / 共享内存缓冲区，序列化时图像数据
+            //         以外部 slice 的形式交给 gRPC，不拷贝进 std::string；
+            // 接收侧：图像数据以 slice 分段视图暴露，只在调用方需要连续内存时才拷贝。
+            //
+            // 配合 grpc::SerializationTraits<ImageFrame>，可直接用于
+            // grpc::TemplatedGenericStub<ImageFrame, Resp> 或泛型服务端
+            class ImageFrame
+            {
+            public:
+                ImageFrame() = default;
+
+                // -------- 发送侧 --------
+                void set_time_stamp(std::string time_stamp) { time_stamp_ = std::move(time_stamp); }
+                void set_requires_masks(bool requires_masks) { requires_masks_ = requires_masks; }
+                // 端到端追踪上下文，随帧头一起序列化（体积很小，直接拷贝）
+                humanoid_robot::PB::common::TraceContext *mutable_trace()
+                {
+                    has_trace_ = true;
+                    return &trace_;
+                }
+                void clear_trace()
+                {
+                    has_trace_ = false;
+                    trace_.Clear();
+                }
+
+                // 挂接外部图像缓冲区。owner 在最后一个引用该缓冲区的 gRPC slice 释放后析构，
+                // 可在其删除器中把 DMA 缓冲区归还给相机驱动
+                void attach_image(const char *data, std::size_t size, std::shared_ptr<const void> owner);
+
+                // -------- 接收侧 / 通用访问 --------
+                const std::string &time_stamp() const { return time_stamp_; }
+                bool requires_masks() const { return requires_masks_; }
+                bool has_trace() const { return has_trace_; }
+                const humanoid_robot::PB::common::TraceContext &trace() const { return trace_; }
+                std::size_t image_size() const { return image_size_; }
+
+                // 图像数据的分段视图（接收到的大帧通常由多个 slice 组成）
+                const std::vector<std::string_view> &image_segments() const { return segments_; }
+
+                // 图像数据位于单个连续段时返回 true 并给出视图
+                bool image_contiguous(std::string_view *out) const;
+
+                // 把图像数据拷贝到 dst（至少 image_size() 字节）
+                void copy_image_to(char *dst) const;
+
+                // -------- 序列化 --------
+                // 生成 [头部 slice][图像 slice...]，图像部分不拷贝
+                ::grpc::Status serialize(::grpc::ByteBuffer *out) const;
+
+                // 解析 ByteBuffer，图像段引用 buffer 内部的 slice（持有引用计数）
+                ::grpc::Status parse(::grpc::ByteBuffer *buffer);
+
+                // 解析连续内存（例如共享内存中的已序列化帧），图像段直接指向 data，
+                // owner 用于保证 data 在本帧存活期间有效
+                bool parse(const char *data, std::size_t size, std::shared_ptr<const void> owner = nullptr);
+
+                // 与生成的 protobuf 消息互转（会拷贝图像数据，仅用于兼容旧接口）
+                void to_message(humanoid_robot::PB::common::Image *image) const;
+                void from_message(const humanoid_robot::PB::common::Image &image);
+
+                void clear();
+
+            private:
+                bool parse_segments(const std::vector<std::string_view> &chunks);
+
+                std::string time_stamp_;
+                bool requires_masks_ = false;
+                bool has_trace_ = false;
+                humanoid_robot::PB::common::TraceContext trace_;
+                std::size_t image_size_ = 0;
+                std::vector<std::string_view> segments_;
+                std::shared_ptr<const void> owner_;
+            };
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+namespace grpc
+{
+    template <>
+    class SerializationTraits<::humanoid_robot::utils::PB::ImageFrame, void>
+    {
+    public:
+        static Status Serialize(const ::humanoid_robot::utils::PB::ImageFrame &frame, ByteBuffer *buffer, bool *own_buffer)
+        {
+            *own_buffer = true;
+            return frame.serialize(buffer);
+        }
+
+        static Status Deserialize(ByteBuffer *buffer, ::humanoid_robot::utils::PB::ImageFrame *frame)
+        {
+            Status status = frame->parse(buffer);
+            buffer->Clear();
+            return status;
+        }
+    };
+} // namespace grpc
+
+#endif // IMAGE_TRANSPORT_H
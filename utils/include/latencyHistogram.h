@@ -0,0 +1,54 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            struct StageLatency
+            {
+                uint64_t count = 0;
+                double mean_us = 0.0;
+                double p50_us = 0.0;
+                double p99_us = 0.0;
+                double max_us = 0.0;
+            };
+
+            // 固定桶延迟直方图：每个 2 的幂区间 8 个桶（相对误差 < 12.5%），记录时不分配。非线程安全。
+            // 感知流水线的阶段统计与 spanTracer 的 LatencyBreakdown 共用
+            class LatencyHistogram
+            {
+            public:
+                void record(std::chrono::nanoseconds value);
+                void record(uint64_t ns);
+                void clear();
+
+                uint64_t count() const { return count_; }
+                uint64_t mean_ns() const { return count_ == 0 ? 0 : total_ns_ / count_; }
+                uint64_t max_ns() const { return max_ns_; }
+                // 分位数取所在桶的上界
+                std::chrono::nanoseconds percentile(double p) const;
+                StageLatency summary() const;
+
+            private:
+                static constexpr std::size_t kBuckets = 496;
+
+                std::array<uint64_t, kBuckets> buckets_{};
+                uint64_t count_ = 0;
+                uint64_t total_ns_ = 0;
+                uint64_t max_ns_ = 0;
+            };
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,120 @@
+#ifndef MASK_CODEC_H
+#define MASK_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "common/variant.pb.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            // 掩码紧凑编码：MaskRle（游程）与 MaskContour（差分多边形），
+            // 用于替代逐像素的 repeated Mask { x, y }。x86 上编码/解码热点使用 SSE2，其余平台为标量实现。
+
+            // 位图 → RLE。bitmap 按行存储，每行 stride 字节，非零即前景；不修改 rle 的 originX/originY
+            void encode_rle(const uint8_t *bitmap, uint32_t width, uint32_t height, std::size_t stride,
+                            humanoid_robot::PB::common::MaskRle *rle);
+
+            // RLE → 位图（width*height 字节，写入 0/1）。游程总长与区域大小不符时返回 false
+            bool decode_rle(const humanoid_robot::PB::common::MaskRle &rle, uint8_t *bitmap);
+
+            // 前景像素数
+            uint64_t rle_area(const humanoid_robot::PB::common::MaskRle &rle);
+
+            // 像素点（x、y 交替）→ RLE，区域取点集外接矩形。稀疏点集不经过位图，
+            // 外接矩形面积超过 2^32-1 时返回 false（rle 被清空）
+            bool points_to_rle(const int32_t *xy, std::size_t point_count, humanoid_robot::PB::common::MaskRle *rle);
+
+            // RLE → 像素点（x、y 交替），按行优先顺序输出。游程总长不符或前景像素数超过 max_points 时返回 false，
+            // 两项检查都在分配输出之前完成
+            bool rle_to_points(const humanoid_robot::PB::common::MaskRle &rle, std::vector<int32_t> *xy,
+                               std::size_t max_points = 16u << 20);
+
+            // 轮廓点（x、y 交替）→ 差分编码
+            void encode_contour(const int32_t *xy, std::size_t point_count, humanoid_robot::PB::common::MaskContour *contour);
+
+            inline std::size_t contour_point_count(const humanoid_robot::PB::common::MaskContour &contour)
+            {
+                return static_cast<std::size_t>(contour.deltas_size()) / 2;
+            }
+
+            // 差分编码 → 轮廓点，xy 至少 2*contour_point_count() 个元素
+            void decode_contour(const humanoid_robot::PB::common::MaskContour &contour, int32_t *xy);
+
+            // 旧版点列表适配：Point 为 common::Mask 或 perception::Masks 等带 x/y 字段的消息
+            namespace detail
+            {
+                template <typename Point>
+                std::vector<int32_t> flatten_points(const google::protobuf::RepeatedPtrField<Point> &points)
+                {
+                    std::vector<int32_t> xy;
+                    xy.reserve(2 * static_cast<std::size_t>(points.size()));
+                    for (const Point &point : points)
+                    {
+                        xy.push_back(point.x());
+                        xy.push_back(point.y());
+                    }
+                    return xy;
+                }
+
+                template <typename Point>
+                void expand_points(const int32_t *xy, std::size_t point_count,
+                                   google::protobuf::RepeatedPtrField<Point> *points)
+                {
+                    points->Clear();
+                    points->Reserve(static_cast<int>(point_count));
+                    for (std::size_t i = 0; i < point_count; ++i)
+                    {
+                        Point *point = points->Add();
+                        point->set_x(xy[2 * i]);
+                        point->set_y(xy[2 * i + 1]);
+                    }
+                }
+            } // namespace detail
+
+            template <typename Point>
+            bool points_to_rle(const google::protobuf::RepeatedPtrField<Point> &points,
+                               humanoid_robot::PB::common::MaskRle *rle)
+            {
+                const std::vector<int32_t> xy = detail::flatten_points(points);
+                return points_to_rle(xy.data(), static_cast<std::size_t>(points.size()), rle);
+            }
+
+            template <typename Point>
+            bool rle_to_points(const humanoid_robot::PB::common::MaskRle &rle,
+                               google::protobuf::RepeatedPtrField<Point> *points,
+                               std::size_t max_points = 16u << 20)
+            {
+                std::vector<int32_t> xy;
+                const bool ok = rle_to_points(rle, &xy, max_points);
+                detail::expand_points(xy.data(), xy.size() / 2, points);
+                return ok;
+            }
+
+            template <typename Point>
+            void encode_contour(const google::protobuf::RepeatedPtrField<Point> &points,
+                                humanoid_robot::PB::common::MaskContour *contour)
+            {
+                const std::vector<int32_t> xy = detail::flatten_points(points);
+                encode_contour(xy.data(), static_cast<std::size_t>(points.size()), contour);
+            }
+
+            template <typename Point>
+            void decode_contour(const humanoid_robot::PB::common::MaskContour &contour,
+                                google::protobuf::RepeatedPtrField<Point> *points)
+            {
+                std::vector<int32_t> xy(2 * contour_point_count(contour));
+                decode_contour(contour, xy.data());
+                detail::expand_points(xy.data(), xy.size() / 2, points);
+            }
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // MASK_CODEC_H
@@ -0,0 +1,240 @@
+#ifndef NAME_ROUTING_H
+#define NAME_ROUTING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <grpcpp/grpcpp.h>
+#include "communication/rpc_service.pb.h"
+#include "communication/rpc_service.grpc.pb.h"
+#include "communication/topic_service.pb.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            // 名称驻留表：字符串 key -> 从 1 开始连续分配的 id（0 表示无效），条目只增不删。
+            // 按 id 读取无锁，条目存放在定长分块中，分配后地址不变
+            template <typename Entry>
+            class InternTable
+            {
+            public:
+                explicit InternTable(uint32_t capacity = 1u << 16)
+                    : chunks_((static_cast<std::size_t>(capacity) + kChunkSize - 1) / kChunkSize)
+                {
+                }
+
+                InternTable(const InternTable &) = delete;
+                InternTable &operator=(const InternTable &) = delete;
+
+                // 返回 key 的 id；首次出现时以 make() 的返回值构造条目。表满时返回 0
+                template <typename Make>
+                uint32_t intern(const std::string &key, Make &&make)
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    auto it = ids_.find(key);
+                    if (it != ids_.end())
+                    {
+                        return it->second;
+                    }
+                    const uint32_t index = size_.load(std::memory_order_relaxed);
+                    if (index >= chunks_.size() * kChunkSize)
+                    {
+                        return 0;
+                    }
+                    std::unique_ptr<Entry[]> &chunk = chunks_[index >> kChunkBits];
+                    if (!chunk)
+                    {
+                        chunk.reset(new Entry[kChunkSize]);
+                    }
+                    chunk[index & kChunkMask] = make();
+                    ids_.emplace(key, index + 1);
+                    size_.store(index + 1, std::memory_order_release);
+                    return index + 1;
+                }
+
+                uint32_t find(const std::string &key) const
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    auto it = ids_.find(key);
+                    return it == ids_.end() ? 0 : it->second;
+                }
+
+                // id 无效时返回 nullptr
+                const Entry *get(uint32_t id) const
+                {
+                    if (id == 0 || id > size_.load(std::memory_order_acquire))
+                    {
+                        return nullptr;
+                    }
+                    const uint32_t index = id - 1;
+                    return &chunks_[index >> kChunkBits][index & kChunkMask];
+                }
+
+                uint32_t size() const { return size_.load(std::memory_order_acquire); }
+
+            private:
+                static constexpr uint32_t kChunkBits = 8;
+                static constexpr uint32_t kChunkSize = 1u << kChunkBits;
+                static constexpr uint32_t kChunkMask = kChunkSize - 1;
+
+                mutable std::mutex mutex_;
+                std::unordered_map<std::string, uint32_t> ids_;
+                std::vector<std::unique_ptr<Entry[]>> chunks_;
+                std::atomic<uint32_t> size_{0};
+            };
+
+            // ---------------------------------------------------------------- RpcService
+
+            // 一条路由：(service_name, client_id, node_name) 及其服务 id
+            struct RpcRoute
+            {
+                std::string service_name;
+                std::string client_id;
+                std::string node_name;
+                uint32_t service = 0;
+            };
+
+            using RpcHandler = std::function<grpc::Status(const RpcRoute &route,
+                                                          const humanoid_robot::PB::communication::ServiceRequest &request,
+                                                          humanoid_robot::PB::communication::ServiceResponse *response)>;
+
+            struct RpcRouterStats
+            {
+                uint64_t by_name = 0;         // 按名称解析（握手或旧版 Client）
+                uint64_t by_id = 0;           // 按 route_id 查表
+                uint64_t unknown_route = 0;   // route_id 无效
+                uint64_t unknown_service = 0; // service_name 未注册
+                uint32_t routes = 0;
+            };
+
+            // ServiceServer 侧的分发表。协商流程（复用 RpcService::Call，不增加 RPC）：
+            //   1. Client 首次调用带三个名称，服务端分配路由 id 并在 ServiceResponse.route_id 返回；
+            //   2. Client 之后只发 route_id，服务端按 id 直接索引路由表，不再做字符串哈希与比较；
+            //   3. 服务端不认识 route_id 时回复 unknown_route，Client 带名称重发。route_id 的高 32 位是
+            //      每个 RpcRouter 实例随机生成的 epoch，服务端重启后旧 id 不会被误解析到其他路由。
+            // 旧版 Client 从不发 route_id，旧版服务端从不返回 route_id，双方自动回退为按名称调用
+            class RpcRouter
+            {
+            public:
+                explicit RpcRouter(uint32_t max_routes = 1u << 16);
+
+                // 在开始服务前注册。同名服务只保留首次注册的处理函数，返回服务 id
+                uint32_t add_service(const std::string &service_name, RpcHandler handler);
+
+                // 解析请求的路由：带名称时分配（或复用）路由 id 并写入 response->route_id，只带 id 时查表；
+                // 路由表满时不分配 id，仍按名称处理。
+                // 失败时返回 nullptr，并在 response 中设置 error_message（以及 unknown_route）
+                const RpcRoute *resolve(const humanoid_robot::PB::communication::ServiceRequest &request,
+                                        humanoid_robot::PB::communication::ServiceResponse *response);
+
+                // resolve 后调用对应服务的处理函数；路由失败时回复 success = false
+                grpc::Status dispatch(const humanoid_robot::PB::communication::ServiceRequest &request,
+                                      humanoid_robot::PB::communication::ServiceResponse *response);
+
+                RpcRouterStats stats() const;
+
+            private:
+                uint64_t epoch_;
+                InternTable<RpcHandler> services_;
+                InternTable<RpcRoute> routes_;
+                std::atomic<uint64_t> by_name_{0};
+                std::atomic<uint64_t> by_id_{0};
+                std::atomic<uint64_t> unknown_route_{0};
+                std::atomic<uint64_t> unknown_service_{0};
+            };
+
+            // 以 RpcRouter 分发的 RpcService 实现
+            class RoutedRpcService : public humanoid_robot::PB::communication::RpcService::Service
+            {
+            public:
+                explicit RoutedRpcService(RpcRouter *router);
+
+                grpc::Status Call(grpc::ServerContext *context, const humanoid_robot::PB::communication::ServiceRequest *request,
+                                  humanoid_robot::PB::communication::ServiceResponse *response) override;
+
+            private:
+                RpcRouter *router_;
+            };
+
+            // ServiceClient 侧的一个调用点：握手前带名称，收到 route_id 后只带 id。可多线程共用
+            class RpcRouteHandle
+            {
+            public:
+                RpcRouteHandle(std::string service_name, std::string client_id, std::string node_name);
+
+                // 填写 service_name / client_id / node_name 或 route_id
+                void prepare(humanoid_robot::PB::communication::ServiceRequest *request) const;
+
+                // 记录服务端分配的 route_id。返回 true 表示服务端不认识本次使用的 id，
+                // 应重新 prepare（此时会带名称）后重发
+                bool on_response(const humanoid_robot::PB::communication::ServiceResponse &response);
+
+                uint64_t route_id() const { return route_id_.load(std::memory_order_relaxed); }
+
+            private:
+                std::string service_name_;
+                std::string client_id_;
+                std::string node_name_;
+                std::atomic<uint64_t> route_id_{0};
+            };
+
+            // ---------------------------------------------------------------- TopicService
+
+            struct TopicNames
+            {
+                std::string topic_name;
+                std::string publisher_id;
+            };
+
+            // Subscriber 侧：声明支持只带 name_id 的消息
+            inline void prepare_name_ids(humanoid_robot::PB::communication::SubscribeRequest *request)
+            {
+                request->set_accept_name_ids(true);
+            }
+
+            // Publisher 侧，每条 Subscribe 流一个：名称在该流上首次出现时与 name_id 一起发送，之后只发 name_id。
+            // Subscriber 未设置 accept_name_ids 时总是发送名称
+            class TopicNameEncoder
+            {
+            public:
+                explicit TopicNameEncoder(const humanoid_robot::PB::communication::SubscribeRequest &request);
+
+                void stamp(const std::string &topic_name, const std::string &publisher_id,
+                           humanoid_robot::PB::communication::TopicMessage *message);
+
+            private:
+                bool enabled_;
+                uint32_t last_ = 0;
+                std::vector<TopicNames> sent_; // 下标 + 1 为 name_id
+            };
+
+            // Subscriber 侧，每条 Subscribe 流一个
+            class TopicNameDecoder
+            {
+            public:
+                // 返回消息的 name_id（旧版 Publisher 为 0）。带名称的消息登记名称；
+                // restore_names 为 true 时为只带 id 的消息补回名称
+                uint32_t observe(humanoid_robot::PB::communication::TopicMessage *message, bool restore_names = false);
+
+                // 尚未收到该 id 的名称时返回 nullptr
+                const TopicNames *names(uint32_t name_id) const;
+
+            private:
+                std::vector<TopicNames> names_;
+            };
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // NAME_ROUTING_H
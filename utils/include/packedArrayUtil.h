@@ -0,0 +1,203 @@
+#ifndef PACKED_ARRAY_UTIL_H
+#define PACKED_ARRAY_UTIL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "common/variant.pb.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+            constexpr bool kHostLittleEndian = false;
+#else
+            constexpr bool kHostLittleEndian = true;
+#endif
+
+            // 连续内存的只读视图（工程使用 C++17，作为 std::span 的最小替代）
+            template <typename T>
+            class ArraySpan
+            {
+            public:
+                constexpr ArraySpan() noexcept = default;
+                constexpr ArraySpan(T *data, std::size_t size) noexcept : data_(data), size_(size) {}
+
+                constexpr T *data() const noexcept { return data_; }
+                constexpr std::size_t size() const noexcept { return size_; }
+                constexpr std::size_t size_bytes() const noexcept { return size_ * sizeof(T); }
+                constexpr bool empty() const noexcept { return size_ == 0; }
+                constexpr T &operator[](std::size_t i) const noexcept { return data_[i]; }
+                constexpr T *begin() const noexcept { return data_; }
+                constexpr T *end() const noexcept { return data_ + size_; }
+
+            private:
+                T *data_ = nullptr;
+                std::size_t size_ = 0;
+            };
+
+            // Packed 数组消息与元素类型、旧版 repeated 数组消息的对应关系
+            template <typename Packed>
+            struct PackedTraits;
+
+            template <>
+            struct PackedTraits<humanoid_robot::PB::common::PackedInt8Array>
+            {
+                using value_type = int8_t;
+                using legacy_type = humanoid_robot::PB::common::Int8Array;
+            };
+
+            template <>
+            struct PackedTraits<humanoid_robot::PB::common::PackedUInt8Array>
+            {
+                using value_type = uint8_t;
+                using legacy_type = humanoid_robot::PB::common::UInt8Array;
+            };
+
+            template <>
+            struct PackedTraits<humanoid_robot::PB::common::PackedInt16Array>
+            {
+                using value_type = int16_t;
+                using legacy_type = humanoid_robot::PB::common::Int16Array;
+            };
+
+            template <>
+            struct PackedTraits<humanoid_robot::PB::common::PackedUInt16Array>
+            {
+                using value_type = uint16_t;
+                using legacy_type = humanoid_robot::PB::common::UInt16Array;
+            };
+
+            template <typename Packed>
+            using packed_value_t = typename PackedTraits<Packed>::value_type;
+
+            namespace detail
+            {
+                template <typename T>
+                inline T load_le(const char *p)
+                {
+                    T v;
+                    std::memcpy(&v, p, sizeof(T));
+                    if (!kHostLittleEndian && sizeof(T) == 2)
+                    {
+                        v = static_cast<T>(__builtin_bswap16(static_cast<uint16_t>(v)));
+                    }
+                    return v;
+                }
+
+                template <typename T>
+                inline void store_le(char *p, T v)
+                {
+                    if (!kHostLittleEndian && sizeof(T) == 2)
+                    {
+                        v = static_cast<T>(__builtin_bswap16(static_cast<uint16_t>(v)));
+                    }
+                    std::memcpy(p, &v, sizeof(T));
+                }
+            } // namespace detail
+
+            // 元素个数；字节长度不是元素大小整数倍时多余的尾部字节被忽略
+            template <typename Packed>
+            inline std::size_t packed_size(const Packed &packed)
+            {
+                return packed.values().size() / sizeof(packed_value_t<Packed>);
+            }
+
+            // 零拷贝访问：直接把 bytes 缓冲区解释为 T 数组。
+            // 大端主机、缓冲区未按 T 对齐或长度不整齐时返回 false，此时请改用 packed_copy
+            template <typename Packed>
+            inline bool packed_span(const Packed &packed, ArraySpan<const packed_value_t<Packed>> *out)
+            {
+                using T = packed_value_t<Packed>;
+                const std::string &raw = packed.values();
+                if (raw.size() % sizeof(T) != 0)
+                {
+                    return false;
+                }
+                if (sizeof(T) > 1)
+                {
+                    if (!kHostLittleEndian || reinterpret_cast<std::uintptr_t>(raw.data()) % alignof(T) != 0)
+                    {
+                        return false;
+                    }
+                }
+                *out = ArraySpan<const T>(reinterpret_cast<const T *>(raw.data()), raw.size() / sizeof(T));
+                return true;
+            }
+
+            // 逐元素遍历，不要求对齐，任何主机字节序下都可用
+            template <typename Packed, typename Fn>
+            inline void packed_for_each(const Packed &packed, Fn &&fn)
+            {
+                using T = packed_value_t<Packed>;
+                const char *p = packed.values().data();
+                const std::size_t n = packed_size(packed);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    fn(detail::load_le<T>(p + i * sizeof(T)));
+                }
+            }
+
+            // 拷贝到 vector，作为 packed_span 不可用时的兜底路径
+            template <typename Packed>
+            inline void packed_copy(const Packed &packed, std::vector<packed_value_t<Packed>> *out)
+            {
+                using T = packed_value_t<Packed>;
+                const std::size_t n = packed_size(packed);
+                out->resize(n);
+                if (kHostLittleEndian || sizeof(T) == 1)
+                {
+                    if (n != 0)
+                    {
+                        std::memcpy(out->data(), packed.values().data(), n * sizeof(T));
+                    }
+                    return;
+                }
+                const char *p = packed.values().data();
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    (*out)[i] = detail::load_le<T>(p + i * sizeof(T));
+                }
+            }
+
+            // 一次性写入 count 个元素（唯一的一次拷贝发生在 bytes 字段内部）
+            template <typename Packed>
+            inline void set_packed_values(Packed *packed, const packed_value_t<Packed> *data, std::size_t count)
+            {
+                using T = packed_value_t<Packed>;
+                if (kHostLittleEndian || sizeof(T) == 1)
+                {
+                    packed->set_values(reinterpret_cast<const char *>(data), count * sizeof(T));
+                    return;
+                }
+                std::string *raw = packed->mutable_values();
+                raw->resize(count * sizeof(T));
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    detail::store_le<T>(&(*raw)[i * sizeof(T)], data[i]);
+                }
+            }
+
+            // 旧版 repeated 数组 -> packed 数组；存在超出目标位宽的元素时返回 false 且不修改输出
+            bool to_packed(const humanoid_robot::PB::common::Int8Array &legacy, humanoid_robot::PB::common::PackedInt8Array *packed);
+            bool to_packed(const humanoid_robot::PB::common::UInt8Array &legacy, humanoid_robot::PB::common::PackedUInt8Array *packed);
+            bool to_packed(const humanoid_robot::PB::common::Int16Array &legacy, humanoid_robot::PB::common::PackedInt16Array *packed);
+            bool to_packed(const humanoid_robot::PB::common::UInt16Array &legacy, humanoid_robot::PB::common::PackedUInt16Array *packed);
+
+            // packed 数组 -> 旧版 repeated 数组
+            void to_legacy(const humanoid_robot::PB::common::PackedInt8Array &packed, humanoid_robot::PB::common::Int8Array *legacy);
+            void to_legacy(const humanoid_robot::PB::common::PackedUInt8Array &packed, humanoid_robot::PB::common::UInt8Array *legacy);
+            void to_legacy(const humanoid_robot::PB::common::PackedInt16Array &packed, humanoid_robot::PB::common::Int16Array *legacy);
+            void to_legacy(const humanoid_robot::PB::common::PackedUInt16Array &packed, humanoid_robot::PB::common::UInt16Array *legacy);
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // PACKED_ARRAY_UTIL_H
@@ -0,0 +1,96 @@
+#ifndef PAYLOAD_CHECKSUM_H
+#define PAYLOAD_CHECKSUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "communication/communication_service.pb.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            // UniversalRequest / UniversalResponse 的 checksum 字段定义为 payload 的 CRC32C（Castagnoli），
+            // 按位存入 int32。x86 上使用 SSE4.2 crc32 指令，ARMv8 上使用 CRC 扩展指令（运行时检测），
+            // 其余平台为 slicing-by-8 查表实现，三者结果一致。
+
+            // 在 crc 基础上继续计算 data 的 CRC32C，crc 为此前数据的结果（初始为 0）。
+            // crc32c_extend(crc32c_extend(0, a), b) == CRC32C(a + b)
+            uint32_t crc32c_extend(uint32_t crc, const void *data, std::size_t size);
+
+            // 可移植的查表实现，用于测试与基准对比
+            uint32_t crc32c_extend_portable(uint32_t crc, const void *data, std::size_t size);
+
+            // 当前使用的实现："sse4.2"、"armv8-crc" 或 "table"
+            const char *crc32c_implementation();
+
+            inline uint32_t crc32c(const void *data, std::size_t size)
+            {
+                return crc32c_extend(0, data, size);
+            }
+
+            inline uint32_t crc32c(std::string_view data)
+            {
+                return crc32c_extend(0, data.data(), data.size());
+            }
+
+            // 增量计算，用于流式接收或分段（例如 ImageFrame::image_segments()）的负载
+            class Crc32c
+            {
+            public:
+                void update(const void *data, std::size_t size) { crc_ = crc32c_extend(crc_, data, size); }
+                void update(std::string_view data) { update(data.data(), data.size()); }
+                void update(const std::vector<std::string_view> &segments)
+                {
+                    for (std::string_view segment : segments)
+                    {
+                        update(segment);
+                    }
+                }
+
+                uint32_t value() const { return crc_; }
+                void reset() { crc_ = 0; }
+
+                // 与 checksum 字段比较
+                bool matches(int32_t checksum) const { return crc_ == static_cast<uint32_t>(checksum); }
+
+            private:
+                uint32_t crc_ = 0;
+            };
+
+            inline int32_t payload_checksum(std::string_view payload)
+            {
+                return static_cast<int32_t>(crc32c(payload));
+            }
+
+            // 计算 payload 的校验和并写入 checksum 字段
+            inline void seal_checksum(humanoid_robot::PB::communication::UniversalRequest *request)
+            {
+                request->set_checksum(payload_checksum(request->payload()));
+            }
+
+            inline void seal_checksum(humanoid_robot::PB::communication::UniversalResponse *response)
+            {
+                response->set_checksum(payload_checksum(response->payload()));
+            }
+
+            // 校验 payload 与 checksum 字段是否一致
+            inline bool verify_checksum(const humanoid_robot::PB::communication::UniversalRequest &request)
+            {
+                return payload_checksum(request.payload()) == request.checksum();
+            }
+
+            inline bool verify_checksum(const humanoid_robot::PB::communication::UniversalResponse &response)
+            {
+                return payload_checksum(response.payload()) == response.checksum();
+            }
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // PAYLOAD_CHECKSUM_H
@@ -0,0 +1,167 @@
+#ifndef PAYLOAD_CODEC_H
+#define PAYLOAD_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "communication/payload_codec.pb.h"
+#include "communication/communication_service.pb.h"
+#include "communication/rpc_service.pb.h"
+#include "communication/topic_service.pb.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            // TopicMessage / UniversalRequest / ServiceRequest 等消息 payload 的可选压缩。
+            // LZ4 与 Zstd 在编译时按需启用（PB_HAS_LZ4 / PB_HAS_ZSTD），都未启用时所有负载原样发送。
+            //
+            // 协商：接收方用 advertise_codecs() 填写 accept_codecs / acceptCodecs，发送方用
+            // negotiate_codec() 选出双方都支持的编码；旧版对端不声明编码，发送方自动退回不压缩。
+            // UniversalRequest / UniversalResponse 的 checksum 按压缩后的 payload 计算，payloadSize 保持原始大小。
+
+            // 本进程编译进来的压缩编码（不含 PAYLOAD_CODEC_NONE）
+            std::vector<humanoid_robot::PB::communication::PayloadCodec> available_codecs();
+            bool codec_available(humanoid_robot::PB::communication::PayloadCodec codec);
+
+            void advertise_codecs(google::protobuf::RepeatedField<int> *accept_codecs);
+
+            // preferred 双方都支持时返回 preferred，否则返回另一个双方都支持的编码，都没有时返回 NONE
+            humanoid_robot::PB::communication::PayloadCodec negotiate_codec(humanoid_robot::PB::communication::PayloadCodec preferred,
+                                                                            const google::protobuf::RepeatedField<int> &accept_codecs);
+
+            // 训练好的 Zstd 字典，压缩端与解压端共享同一份内容，按 id（Zstd dictID）区分
+            class ZstdDictionary
+            {
+            public:
+                // 由样本负载训练。样本过少、训练失败或未启用 Zstd 时返回 nullptr
+                static std::shared_ptr<const ZstdDictionary> train(const std::vector<std::string> &samples,
+                                                                   std::size_t capacity = 16 * 1024, int level = 3);
+                // 加载对端发来的字典内容，格式不符时返回 nullptr
+                static std::shared_ptr<const ZstdDictionary> load(std::string_view content, int level = 3);
+
+                ~ZstdDictionary();
+
+                ZstdDictionary(const ZstdDictionary &) = delete;
+                ZstdDictionary &operator=(const ZstdDictionary &) = delete;
+
+                uint32_t id() const { return id_; }
+                const std::string &content() const { return content_; }
+
+            private:
+                friend class PayloadCompressor;
+                friend class PayloadDecompressor;
+                struct Impl;
+
+                ZstdDictionary(std::string content, uint32_t id, std::unique_ptr<Impl> impl);
+
+                std::string content_;
+                uint32_t id_;
+                std::unique_ptr<Impl> impl_;
+            };
+
+            struct CodecOptions
+            {
+                humanoid_robot::PB::communication::PayloadCodec codec = humanoid_robot::PB::communication::PAYLOAD_CODEC_LZ4;
+                std::size_t min_size = 64;                   // 小于该字节数的负载不压缩
+                int zstd_level = 3;
+                std::size_t train_samples = 0;               // >0 时 Zstd 用前 N 条负载训练字典。只有 TopicMessage 会随消息
+                                                             // 下发字典，其他消息需双方预先 set_dictionary / add_dictionary
+                std::size_t dictionary_capacity = 16 * 1024; // 训练字典的最大字节数
+            };
+
+            struct CodecStats
+            {
+                uint64_t messages = 0;
+                uint64_t compressed = 0;
+                uint64_t below_threshold = 0; // 小于 min_size
+                uint64_t no_gain = 0;         // 压缩后不比原始负载小
+                uint64_t raw_bytes = 0;
+                uint64_t wire_bytes = 0;
+            };
+
+            // 发送端，每条流一个（持有压缩上下文，不可多线程共用）
+            class PayloadCompressor
+            {
+            public:
+                explicit PayloadCompressor(CodecOptions options = CodecOptions());
+                ~PayloadCompressor();
+
+                PayloadCompressor(const PayloadCompressor &) = delete;
+                PayloadCompressor &operator=(const PayloadCompressor &) = delete;
+
+                // 改用协商结果（例如 negotiate_codec() 的返回值）
+                void set_codec(humanoid_robot::PB::communication::PayloadCodec codec) { options_.codec = codec; }
+                // 使用已训练的字典（仅 Zstd），例如同一 Topic 的多条流共享一个字典
+                void set_dictionary(std::shared_ptr<const ZstdDictionary> dictionary);
+                const std::shared_ptr<const ZstdDictionary> &dictionary() const { return dictionary_; }
+
+                // 压缩 raw 写入 *out，返回实际使用的编码；返回 NONE 时 *out 为 raw 的拷贝
+                humanoid_robot::PB::communication::PayloadCodec compress(std::string_view raw, std::string *out);
+
+                // 就地压缩 payload 并设置编码字段。TopicMessage 在某个字典首次使用时附带 codec_dictionary
+                void compress(humanoid_robot::PB::communication::TopicMessage *message);
+                void compress(humanoid_robot::PB::communication::UniversalRequest *request);
+                void compress(humanoid_robot::PB::communication::UniversalResponse *response);
+                void compress(humanoid_robot::PB::communication::ServiceRequest *request);
+                void compress(humanoid_robot::PB::communication::ServiceResponse *response);
+
+                const CodecStats &stats() const { return stats_; }
+
+            private:
+                struct Contexts;
+
+                // 返回 NONE 时不写 *out
+                humanoid_robot::PB::communication::PayloadCodec encode(std::string_view raw, std::string *out);
+                void collect_sample(std::string_view raw);
+
+                CodecOptions options_;
+                std::unique_ptr<Contexts> contexts_;
+                std::shared_ptr<const ZstdDictionary> dictionary_;
+                uint32_t announced_dictionary_ = 0;
+                std::vector<std::string> samples_;
+                CodecStats stats_;
+            };
+
+            // 接收端，每条流一个
+            class PayloadDecompressor
+            {
+            public:
+                explicit PayloadDecompressor(std::size_t max_payload = 64u << 20);
+                ~PayloadDecompressor();
+
+                PayloadDecompressor(const PayloadDecompressor &) = delete;
+                PayloadDecompressor &operator=(const PayloadDecompressor &) = delete;
+
+                void add_dictionary(std::shared_ptr<const ZstdDictionary> dictionary);
+
+                // 解压失败（数据损坏、缺少字典、超过 max_payload 或编码未启用）时返回 false
+                bool decompress(humanoid_robot::PB::communication::PayloadCodec codec, std::string_view wire, std::string *out);
+
+                // 就地解压并把编码字段复位为 NONE；TopicMessage 附带的 codec_dictionary 先登记再解压
+                bool decompress(humanoid_robot::PB::communication::TopicMessage *message);
+                bool decompress(humanoid_robot::PB::communication::UniversalRequest *request);
+                bool decompress(humanoid_robot::PB::communication::UniversalResponse *response);
+                bool decompress(humanoid_robot::PB::communication::ServiceRequest *request);
+                bool decompress(humanoid_robot::PB::communication::ServiceResponse *response);
+
+            private:
+                struct Contexts;
+
+                std::size_t max_payload_;
+                std::unique_ptr<Contexts> contexts_;
+                std::unordered_map<uint32_t, std::shared_ptr<const ZstdDictionary>> dictionaries_;
+            };
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // PAYLOAD_CODEC_H
@@ -0,0 +1,189 @@
+#ifndef PERCEPTION_PIPELINE_H
+#define PERCEPTION_PIPELINE_H
+
+#include <any>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <grpcpp/grpcpp.h>
+#include "latencyHistogram.h"
+#include "common/variant.pb.h"
+#include "perception/perception_request_response.pb.h"
+#include "perception/perception_service.grpc.pb.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            // ---------------------------------------------------------------- 服务端
+
+            // 一帧在各阶段之间传递的数据；input / output 由实现自行定义（如解码后的张量、推理输出）
+            struct PerceptionFrame
+            {
+                humanoid_robot::PB::common::Image image;
+                std::any input;
+                std::any output;
+                humanoid_robot::PB::perception::Perception result; // timeStamp 由流水线填写；trace 未设置时沿用 image.trace 并追加感知阶段
+            };
+
+            // 三个阶段分别在独立线程上运行，不同帧的各阶段互相重叠；
+            // infer 可由多个线程并发调用（infer_workers > 1 时实现需线程安全）。
+            // 任一阶段返回 false 时该帧跳过后续阶段，回复一个只有 timeStamp 的 Perception，客户端据此释放在途名额
+            class PerceptionStages
+            {
+            public:
+                virtual ~PerceptionStages() = default;
+
+                virtual bool decode(PerceptionFrame &frame) = 0;
+                virtual bool infer(PerceptionFrame &frame) = 0;
+                virtual bool encode(PerceptionFrame &frame) = 0;
+            };
+
+            struct PipelineServerOptions
+            {
+                int infer_workers = 1; // 每个流的并发推理线程数
+                bool ordered = false;  // true 时按到达顺序回复；false 时先完成先回复
+            };
+
+            struct PipelineServerStats
+            {
+                uint64_t frames = 0; // 已回复的帧
+                uint64_t failed = 0; // 有阶段返回 false 的帧
+                StageLatency decode;
+                StageLatency queue; // 解码完成到开始推理的等待
+                StageLatency infer;
+                StageLatency encode;
+                StageLatency total; // 收到请求到写出响应
+            };
+
+            // GetPerceptionResult 的流水线实现：读取线程只负责接收，解码 / 推理 / 编码在各自线程上重叠执行，
+            // 客户端可同时有多帧在途。其余两个一元方法保持 UNIMPLEMENTED，可由派生类覆盖
+            class PerceptionPipelineService : public humanoid_robot::PB::perception::PerceptionService::Service
+            {
+            public:
+                PerceptionPipelineService(PerceptionStages *stages, PipelineServerOptions options = PipelineServerOptions());
+
+                grpc::Status GetPerceptionResult(
+                    grpc::ServerContext *context,
+                    grpc::ServerReaderWriter<humanoid_robot::PB::perception::Perception, humanoid_robot::PB::common::Image> *stream) override;
+
+                PipelineServerStats stats() const;
+
+            private:
+                class StreamPipeline;
+
+                PerceptionStages *stages_;
+                PipelineServerOptions options_;
+
+                mutable std::mutex stats_mutex_;
+                uint64_t frames_ = 0;
+                uint64_t failed_ = 0;
+                LatencyHistogram decode_, queue_, infer_, encode_, total_;
+            };
+
+            // ---------------------------------------------------------------- 客户端
+
+            struct PipelineClientOptions
+            {
+                std::size_t max_in_flight = 3;                 // 已发送未返回的帧上限（K）
+                std::size_t queue_depth = 2;                   // 等待发送的帧上限
+                bool drop_oldest = true;                       // 队列满时丢弃最旧的未发送帧；false 时 submit 阻塞
+                std::chrono::milliseconds frame_timeout{1000}; // 超时未返回的帧视为丢失，释放在途名额
+            };
+
+            struct FrameTiming
+            {
+                std::chrono::microseconds queued{0};     // submit 到发送
+                std::chrono::microseconds round_trip{0}; // 发送到收到结果
+            };
+
+            struct PipelineClientStats
+            {
+                uint64_t submitted = 0;
+                uint64_t sent = 0;
+                uint64_t completed = 0;
+                uint64_t dropped = 0;   // drop_oldest 丢弃的未发送帧
+                uint64_t lost = 0;      // 超时未返回
+                uint64_t unmatched = 0; // timeStamp 不在在途表中的结果
+                std::size_t in_flight = 0;
+                StageLatency round_trip;
+            };
+
+            // 双向流客户端：保持最多 K 帧在途，按 timeStamp 匹配乱序返回的结果。
+            // 在途帧的 timeStamp 应互不相同
+            class PerceptionPipelineClient
+            {
+            public:
+                using ResultCallback = std::function<void(const humanoid_robot::PB::perception::Perception &, const FrameTiming &)>;
+
+                // on_result 在接收线程上调用
+                PerceptionPipelineClient(humanoid_robot::PB::perception::PerceptionService::Stub *stub, ResultCallback on_result,
+                                         PipelineClientOptions options = PipelineClientOptions());
+                ~PerceptionPipelineClient();
+
+                PerceptionPipelineClient(const PerceptionPipelineClient &) = delete;
+                PerceptionPipelineClient &operator=(const PerceptionPipelineClient &) = delete;
+
+                void start();
+                // 流已关闭时返回 false
+                bool submit(humanoid_robot::PB::common::Image image);
+                // 发送完已排队的帧、等待在途结果后结束调用
+                grpc::Status close();
+
+                PipelineClientStats stats() const;
+
+            private:
+                using Clock = std::chrono::steady_clock;
+
+                struct Pending
+                {
+                    humanoid_robot::PB::common::Image image;
+                    Clock::time_point submitted;
+                };
+
+                struct InFlight
+                {
+                    Clock::time_point submitted;
+                    Clock::time_point sent;
+                };
+
+                void write_loop();
+                void read_loop();
+                void expire_locked(Clock::time_point now);
+
+                humanoid_robot::PB::perception::PerceptionService::Stub *stub_;
+                ResultCallback on_result_;
+                PipelineClientOptions options_;
+
+                grpc::ClientContext context_;
+                std::unique_ptr<grpc::ClientReaderWriter<humanoid_robot::PB::common::Image, humanoid_robot::PB::perception::Perception>> stream_;
+                std::thread writer_;
+                std::thread reader_;
+
+                mutable std::mutex mutex_;
+                std::condition_variable cv_;
+                std::deque<Pending> queue_;
+                std::unordered_multimap<std::string, InFlight> in_flight_;
+                bool started_ = false;
+                bool closing_ = false;
+                bool broken_ = false;
+                PipelineClientStats stats_;
+                LatencyHistogram round_trip_;
+            };
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // PERCEPTION_PIPELINE_H
@@ -0,0 +1,137 @@
+#ifndef QUERY_CACHE_H
+#define QUERY_CACHE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <grpcpp/grpcpp.h>
+#include "common/variant.pb.h"
+#include "interfaces/interfaces_grpc.grpc.pb.h"
+#include "interfaces/interfaces_request_response.pb.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            struct QueryCacheOptions
+            {
+                std::chrono::milliseconds ttl{1000}; // 条目有效期，0 表示只靠显式失效
+                std::size_t max_entries = 1024;      // 超出后淘汰最久未命中的条目
+                // 计算 key 时忽略的 params（如每次都不同的 correlationid、timeout）
+                std::unordered_set<std::string> ignored_params;
+                // 响应是否可缓存；为空时缓存所有 grpc::Status::OK 的响应
+                std::function<bool(const humanoid_robot::PB::interfaces::QueryResponse &)> cacheable;
+            };
+
+            struct QueryCacheStats
+            {
+                uint64_t hits = 0;
+                uint64_t misses = 0;
+                uint64_t expired = 0;       // 因 TTL 到期而未命中的次数（已计入 misses）
+                uint64_t evictions = 0;     // 因容量淘汰的条目
+                uint64_t invalidations = 0; // 因显式失效删除的条目
+                std::size_t entries = 0;
+            };
+
+            // QueryRequest -> 序列化后的 QueryResponse 缓存，线程安全。
+            // key 是 input / params 的结构哈希（与 map 顺序无关，见 variantHash.h），
+            // 命中时再与保存的请求做深度比较，哈希冲突不会返回错误响应。
+            // 响应以共享的序列化字节保存，命中时不重新执行 handler、不重新序列化
+            class QueryCache
+            {
+            public:
+                using Bytes = std::shared_ptr<const std::string>;
+                using Clock = std::chrono::steady_clock;
+
+                explicit QueryCache(QueryCacheOptions options = QueryCacheOptions());
+
+                uint64_t key(const humanoid_robot::PB::interfaces::QueryRequest &request) const;
+
+                // 未命中或已过期时返回空指针
+                Bytes find(const humanoid_robot::PB::interfaces::QueryRequest &request);
+                Bytes find(const humanoid_robot::PB::interfaces::QueryRequest &request, uint64_t key);
+
+                // 序列化并保存响应，返回序列化结果；options.cacheable 拒绝时只返回字节不保存
+                Bytes store(const humanoid_robot::PB::interfaces::QueryRequest &request,
+                            const humanoid_robot::PB::interfaces::QueryResponse &response);
+                Bytes store(const humanoid_robot::PB::interfaces::QueryRequest &request, uint64_t key,
+                            const humanoid_robot::PB::interfaces::QueryResponse &response);
+
+                // 删除 input 包含 match 中全部 key 且值相等的条目；match 为空时清空缓存。返回删除数
+                std::size_t invalidate(const humanoid_robot::PB::common::Dictionary &match);
+                void clear();
+
+                QueryCacheStats stats() const;
+                const QueryCacheOptions &options() const { return options_; }
+
+            private:
+                struct Entry
+                {
+                    uint64_t key;
+                    humanoid_robot::PB::interfaces::QueryRequest request;
+                    Bytes response;
+                    Clock::time_point expires;
+                };
+                using EntryList = std::list<Entry>;
+
+                bool same_request(const humanoid_robot::PB::interfaces::QueryRequest &a,
+                                  const humanoid_robot::PB::interfaces::QueryRequest &b) const;
+                void erase(EntryList::iterator it);
+
+                QueryCacheOptions options_;
+                mutable std::mutex mutex_;
+                EntryList lru_; // 头部为最近命中
+                std::unordered_map<uint64_t, EntryList::iterator> index_;
+                QueryCacheStats stats_;
+            };
+
+            // 包装已有的 InterfaceService::Service 实现：
+            //   - Query 注册为 streamed unary（StreamedQuery），运行在同步服务线程池上。命中时把缓存的响应字节
+            //     包成 ByteBuffer 直接写出，不解析、不重新序列化，也不执行内层 handler；未命中时以调用方的
+            //     ServerContext（截止时间、取消状态、客户端元数据）调用内层 Query，写出 store() 返回的字节
+            //   - Subscribe / Unsubscribe 转发给内层实现，成功后按请求的 input 使缓存失效
+            //   - Send / Action 原样转发
+            class CachingInterfaceService : public humanoid_robot::PB::interfaces::InterfaceService::Service
+            {
+            public:
+                explicit CachingInterfaceService(humanoid_robot::PB::interfaces::InterfaceService::Service *inner,
+                                                 QueryCacheOptions options = QueryCacheOptions());
+
+                QueryCache &cache() { return cache_; }
+
+                grpc::Status Send(grpc::ServerContext *context,
+                                  grpc::ServerReaderWriter<humanoid_robot::PB::interfaces::SendResponse,
+                                                           humanoid_robot::PB::interfaces::SendRequest> *stream) override;
+                grpc::Status Action(grpc::ServerContext *context, const humanoid_robot::PB::interfaces::ActionRequest *request,
+                                    grpc::ServerWriter<humanoid_robot::PB::interfaces::ActionResponse> *writer) override;
+                grpc::Status Subscribe(grpc::ServerContext *context, const humanoid_robot::PB::interfaces::SubscribeRequest *request,
+                                       humanoid_robot::PB::interfaces::SubscribeResponse *response) override;
+                grpc::Status Unsubscribe(grpc::ServerContext *context, const humanoid_robot::PB::interfaces::UnsubscribeRequest *request,
+                                         humanoid_robot::PB::interfaces::UnsubscribeResponse *response) override;
+                // gRPC 分发 Query 的入口
+                grpc::Status StreamedQuery(grpc::ServerContext *context,
+                                           grpc::ServerUnaryStreamer<humanoid_robot::PB::interfaces::QueryRequest, grpc::ByteBuffer> *stream);
+                // 进程内直接调用：命中时解析缓存的字节
+                grpc::Status Query(grpc::ServerContext *context, const humanoid_robot::PB::interfaces::QueryRequest *request,
+                                   humanoid_robot::PB::interfaces::QueryResponse *response) override;
+
+            private:
+                humanoid_robot::PB::interfaces::InterfaceService::Service *inner_;
+                QueryCache cache_;
+            };
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // QUERY_CACHE_H
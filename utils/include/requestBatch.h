@@ -0,0 +1,117 @@
+#ifndef REQUEST_BATCH_H
+#define REQUEST_BATCH_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "communication/communication_service.pb.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            // CommunicationService::sendRequest 的批量复用。
+            // 客户端用 RequestCoalescer 把高频小请求合并为一个批量信封（payloadType 为
+            // RESERVED_PAYLOAD_REQUEST_BATCH 的 UniversalRequest），服务端用 RequestDemultiplexer
+            // 按原顺序拆回单条请求；非批量请求原样透传，新旧客户端可以混用同一服务端。
+
+            inline bool is_batch_envelope(const humanoid_robot::PB::communication::UniversalRequest &request)
+            {
+                return request.payloadtype() == humanoid_robot::PB::communication::RESERVED_PAYLOAD_REQUEST_BATCH;
+            }
+
+            // 将 requests 按顺序打包为批量信封（payload 为 RequestBatch 线格式，checksum 为其 CRC32C）
+            void pack_batch(const std::vector<humanoid_robot::PB::communication::UniversalRequest> &requests,
+                            humanoid_robot::PB::communication::UniversalRequest *envelope);
+
+            // 拆包，按原顺序追加到 out。信封格式错误或校验和不符时返回 false
+            bool unpack_batch(const humanoid_robot::PB::communication::UniversalRequest &envelope,
+                              std::vector<humanoid_robot::PB::communication::UniversalRequest> *out);
+
+            struct CoalescerOptions
+            {
+                std::chrono::microseconds max_latency{2000}; // 第一条待发请求最多等待的时间
+                std::size_t max_bytes = 16 * 1024;           // 累计负载达到此值立即发送
+                std::size_t max_count = 256;                 // 累计条数达到此值立即发送
+            };
+
+            // 客户端合并器，线程安全。sink 由发送锁串行化，保证帧按顺序写出且不会并发调用
+            // （可直接传入 ClientReaderWriter::Write）；sink 返回 false 表示流已断开。
+            // 调用 sink 时不持有待发队列的锁，写出阻塞期间其他线程的 add() 照常入队。
+            class RequestCoalescer
+            {
+            public:
+                using Sink = std::function<bool(const humanoid_robot::PB::communication::UniversalRequest &)>;
+
+                RequestCoalescer(const CoalescerOptions &options, Sink sink);
+                ~RequestCoalescer();
+
+                RequestCoalescer(const RequestCoalescer &) = delete;
+                RequestCoalescer &operator=(const RequestCoalescer &) = delete;
+
+                // 追加一条请求。超过 max_bytes 的请求先刷出已有请求再单独发送
+                bool add(humanoid_robot::PB::communication::UniversalRequest request);
+
+                // 立即发送所有待发请求；只有一条时不加信封直接发送
+                bool flush();
+
+                // 由调用方的事件循环驱动：最早的待发请求已超过 max_latency 时发送
+                bool poll(std::chrono::steady_clock::time_point now);
+
+                // 启动/停止后台线程按 max_latency 自动刷出；stop() 会刷出剩余请求
+                void start();
+                void stop();
+
+                std::size_t pending_count() const;
+                uint64_t frames_sent() const;
+                uint64_t requests_sent() const;
+
+            private:
+                // 调用方持有 send_mutex_
+                bool send_pending();
+
+                const CoalescerOptions options_;
+                Sink sink_;
+                std::mutex send_mutex_; // 串行化 sink；先于 mutex_ 获取
+                std::vector<humanoid_robot::PB::communication::UniversalRequest> sending_;
+                humanoid_robot::PB::communication::UniversalRequest envelope_;
+                mutable std::mutex mutex_; // 保护待发队列与计数
+                std::condition_variable cv_;
+                std::vector<humanoid_robot::PB::communication::UniversalRequest> pending_;
+                std::size_t pending_bytes_ = 0;
+                std::chrono::steady_clock::time_point oldest_;
+                uint64_t frames_sent_ = 0;
+                uint64_t requests_sent_ = 0;
+                bool running_ = false;
+                std::thread flusher_;
+            };
+
+            // 服务端拆包器：信封按原顺序逐条交给 handler，普通请求直接交给 handler
+            class RequestDemultiplexer
+            {
+            public:
+                using Handler = std::function<void(humanoid_robot::PB::communication::UniversalRequest &&)>;
+
+                explicit RequestDemultiplexer(Handler handler) : handler_(std::move(handler)) {}
+
+                // 返回 false 表示信封格式错误，此时没有任何请求被分发
+                bool dispatch(humanoid_robot::PB::communication::UniversalRequest &&request);
+
+            private:
+                Handler handler_;
+                std::vector<humanoid_robot::PB::communication::UniversalRequest> scratch_;
+            };
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // REQUEST_BATCH_H
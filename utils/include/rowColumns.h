@@ -0,0 +1,112 @@
+#ifndef ROW_COLUMNS_H
+#define ROW_COLUMNS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "common/variant.pb.h"
+#include "packedArrayUtil.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            // 行式（repeated XxxRow）与列式（RowColumns）结果互转。
+            // 列式编码中 x1/y1/x2/y2/conf 为连续 float 数组，cls/trackId 为字典下标，
+            // 200 个检测结果只需十几次内存分配，且可以直接对整列做阈值过滤、IoU 等计算。
+            // 紧凑掩码（maskRle / maskContour）按行逐条保存在同名列中，空消息表示该行未设置
+
+            void to_columns(const google::protobuf::RepeatedPtrField<humanoid_robot::PB::common::PerceptionRow> &rows,
+                            humanoid_robot::PB::common::RowColumns *columns);
+            void to_columns(const google::protobuf::RepeatedPtrField<humanoid_robot::PB::common::DetectionRow> &rows,
+                            humanoid_robot::PB::common::RowColumns *columns);
+            void to_columns(const google::protobuf::RepeatedPtrField<humanoid_robot::PB::common::DivisionRow> &rows,
+                            humanoid_robot::PB::common::RowColumns *columns);
+
+            // 列 → 行，列长度不一致或字典下标越界时返回 false（rows 内容未定义）
+            bool to_rows(const humanoid_robot::PB::common::RowColumns &columns,
+                         google::protobuf::RepeatedPtrField<humanoid_robot::PB::common::PerceptionRow> *rows);
+            bool to_rows(const humanoid_robot::PB::common::RowColumns &columns,
+                         google::protobuf::RepeatedPtrField<humanoid_robot::PB::common::DetectionRow> *rows);
+            bool to_rows(const humanoid_robot::PB::common::RowColumns &columns,
+                         google::protobuf::RepeatedPtrField<humanoid_robot::PB::common::DivisionRow> *rows);
+
+            // 检查各列长度与 count 一致、字典下标有效、掩码偏移单调。
+            // requires_bbox 为 true 时 x1/y1/x2/y2 必须完整（Perception/Detection）
+            bool columns_valid(const humanoid_robot::PB::common::RowColumns &columns, bool requires_bbox);
+
+            // 检测框列视图，指向消息内部存储
+            struct BoxColumns
+            {
+                ArraySpan<const float> x1;
+                ArraySpan<const float> y1;
+                ArraySpan<const float> x2;
+                ArraySpan<const float> y2;
+                ArraySpan<const float> conf;
+            };
+
+            inline BoxColumns box_columns(const humanoid_robot::PB::common::RowColumns &columns)
+            {
+                return BoxColumns{
+                    ArraySpan<const float>(columns.x1().data(), static_cast<std::size_t>(columns.x1_size())),
+                    ArraySpan<const float>(columns.y1().data(), static_cast<std::size_t>(columns.y1_size())),
+                    ArraySpan<const float>(columns.x2().data(), static_cast<std::size_t>(columns.x2_size())),
+                    ArraySpan<const float>(columns.y2().data(), static_cast<std::size_t>(columns.y2_size())),
+                    ArraySpan<const float>(columns.conf().data(), static_cast<std::size_t>(columns.conf_size())),
+                };
+            }
+
+            inline bool row_is_move(const humanoid_robot::PB::common::RowColumns &columns, std::size_t row)
+            {
+                const std::string &bits = columns.ismove();
+                return row / 8 < bits.size() && (static_cast<uint8_t>(bits[row / 8]) >> (row % 8)) & 1;
+            }
+
+            inline const std::string &row_cls(const humanoid_robot::PB::common::RowColumns &columns, std::size_t row)
+            {
+                return columns.clsdict(static_cast<int>(columns.cls(static_cast<int>(row))));
+            }
+
+            inline const std::string &row_track_id(const humanoid_robot::PB::common::RowColumns &columns, std::size_t row)
+            {
+                return columns.trackiddict(static_cast<int>(columns.trackid(static_cast<int>(row))));
+            }
+
+            // 第 row 行的掩码点，x、y 交替排列
+            inline ArraySpan<const int32_t> row_mask(const humanoid_robot::PB::common::RowColumns &columns, std::size_t row)
+            {
+                if (columns.maskoffsets_size() == 0)
+                {
+                    return ArraySpan<const int32_t>();
+                }
+                const uint32_t begin = columns.maskoffsets(static_cast<int>(row));
+                const uint32_t end = columns.maskoffsets(static_cast<int>(row) + 1);
+                return ArraySpan<const int32_t>(columns.maskxy().data() + 2 * static_cast<std::size_t>(begin),
+                                                2 * static_cast<std::size_t>(end - begin));
+            }
+
+            // 置信度不低于 threshold 的行号按升序写入 indices，返回数量
+            std::size_t select_by_confidence(const humanoid_robot::PB::common::RowColumns &columns, float threshold,
+                                             std::vector<uint32_t> *indices);
+
+            // 计算每个检测框与给定框的 IoU，out 至少 count 个元素
+            void iou_with_box(const humanoid_robot::PB::common::RowColumns &columns,
+                              float x1, float y1, float x2, float y2, float *out);
+
+            float row_iou(const humanoid_robot::PB::common::RowColumns &columns, std::size_t a, std::size_t b);
+
+            // 按 indices 顺序抽取行到 out（字典原样保留），用于过滤后的结果压缩。
+            // columns 不合法或下标不小于 count 时返回 false（out 内容未定义）
+            bool gather_rows(const humanoid_robot::PB::common::RowColumns &columns,
+                             const std::vector<uint32_t> &indices,
+                             humanoid_robot::PB::common::RowColumns *out);
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // ROW_COLUMNS_H
@@ -0,0 +1,151 @@
+#ifndef SHM_TOPIC_RING_H
+#define SHM_TOPIC_RING_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "communication/topic_service.pb.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            // 同机 Topic 快速通道：POSIX 共享内存中的单写多读无锁环形缓冲区。
+            //
+            // 协商流程（复用 TopicService::Subscribe）：
+            //   1. Publisher 启动时 ShmTopicRing::create(topic_name)；
+            //   2. Subscriber 订阅前 ShmTopicRing::open(topic_name)，成功则
+            //      prepare_local_subscribe(&req, true)，失败则 prepare_local_subscribe(&req, false)；
+            //   3. Publisher 在 Subscribe 中调用 accepts_local_transport(req)：
+            //      接受时只发送一条 make_shm_handshake() 握手消息并保持流打开，
+            //      之后 publish() 写入共享内存；否则照常通过 gRPC 推送；
+            //   4. Subscriber 收到 is_shm_handshake() 为真的消息后改为 read()/wait() 读共享内存，
+            //      否则把 gRPC 消息当作普通消息处理（旧版 Publisher 会忽略新字段，自动回退）。
+            // gRPC 流在共享内存模式下仍保持打开，用于感知 Publisher 退出和传递超出槽位大小的消息。
+            class ShmTopicRing
+            {
+            public:
+                struct Options
+                {
+                    uint32_t slot_count = 256;      // 槽位数，向上取整为 2 的幂
+                    uint32_t slot_size = 64 * 1024; // 每个槽位字节数（含槽位头）
+                    uint32_t mode = 0600;           // 共享内存段权限；Subscriber 以其他用户运行时需放宽
+                };
+
+                enum class ReadStatus
+                {
+                    kMessage, // 读到一条消息
+                    kEmpty,   // 暂无新消息
+                };
+
+                ~ShmTopicRing();
+
+                ShmTopicRing(const ShmTopicRing &) = delete;
+                ShmTopicRing &operator=(const ShmTopicRing &) = delete;
+
+                // Publisher 侧：创建共享内存段，析构时 shm_unlink。同名段已被存活的 Publisher 占用时
+                // 返回 nullptr（errno 为 EEXIST）；创建者进程已退出的残留段会被清理后重建
+                static std::unique_ptr<ShmTopicRing> create(const std::string &topic_name, const Options &options);
+                static std::unique_ptr<ShmTopicRing> create(const std::string &topic_name) { return create(topic_name, Options()); }
+
+                // Subscriber 侧：挂接已存在的共享内存段，不存在或格式不符时返回 nullptr。
+                // 挂接后从当前写位置开始读取
+                static std::unique_ptr<ShmTopicRing> open(const std::string &topic_name);
+
+                const std::string &segment_name() const { return name_; }
+                std::size_t max_payload() const;
+
+                // 写入一条消息。除 sequence/timestamp/payload 外，name_id、payload_codec、codec_dictionary、trace
+                // 等字段（shm_segment 除外）序列化后与 payload 放在同一槽位，合计超过 max_payload() 时返回 false
+                bool publish(const humanoid_robot::PB::communication::TopicMessage &message);
+                bool publish(uint64_t sequence, uint64_t timestamp, const void *payload, std::size_t size);
+
+                // 读取下一条消息。读者落后超过一圈时跳到最旧的有效槽位，
+                // 被覆盖的消息数累加到 *lost（可为 nullptr）
+                ReadStatus read(humanoid_robot::PB::communication::TopicMessage *out, uint64_t *lost);
+
+                // 等待新消息：先自旋，再让出 CPU，最后短睡眠，直到超时
+                ReadStatus wait(humanoid_robot::PB::communication::TopicMessage *out, uint64_t *lost,
+                                std::chrono::microseconds timeout);
+
+            private:
+                struct Header;
+                struct SlotHeader;
+
+                ShmTopicRing(std::string name, void *base, std::size_t mapped_size, bool owner,
+                             uint32_t slot_count, uint32_t slot_size);
+                // 同名段的创建者进程已退出
+                static bool stale_segment(const std::string &name);
+                SlotHeader *slot(uint64_t index) const;
+                bool publish_slot(uint64_t sequence, uint64_t timestamp, const std::string &meta,
+                                  const void *payload, std::size_t size);
+
+                std::string name_;
+                void *base_;
+                std::size_t mapped_size_;
+                bool owner_;
+                Header *header_;
+                // 挂接时校验过的配置，之后不再从共享内存读取（段头可被其他进程改写）
+                uint64_t slot_count_;
+                std::size_t slot_size_;
+                uint64_t read_index_ = 0;
+                std::string meta_; // publish(TopicMessage) 的附加字段缓冲，仅 Publisher 线程使用
+            };
+
+            // 按 Topic 名称生成共享内存段名
+            std::string shm_segment_name(const std::string &topic_name);
+
+            // 本机标识（主机名 + 内核 boot_id），用于判断 Publisher/Subscriber 是否同机
+            const std::string &local_host_id();
+
+            // Subscriber 侧：填写同机协商字段
+            void prepare_local_subscribe(humanoid_robot::PB::communication::SubscribeRequest *request, bool ring_attached);
+
+            // Publisher 侧：请求是否来自本机且已挂接共享内存
+            bool accepts_local_transport(const humanoid_robot::PB::communication::SubscribeRequest &request);
+
+            // Publisher 侧：生成握手消息
+            void make_shm_handshake(const std::string &topic_name, const std::string &publisher_id,
+                                    const ShmTopicRing &ring, humanoid_robot::PB::communication::TopicMessage *out);
+
+            inline bool is_shm_handshake(const humanoid_robot::PB::communication::TopicMessage &message)
+            {
+                return !message.shm_segment().empty();
+            }
+
+            // 基于 TopicMessage.sequence 的丢包检测，两种传输方式通用
+            class SequenceTracker
+            {
+            public:
+                // 返回本条消息之前缺失的消息数；序列号回退（Publisher 重启）时重新开始计数
+                uint64_t observe(uint64_t sequence)
+                {
+                    uint64_t missing = 0;
+                    if (started_ && sequence > last_ + 1)
+                    {
+                        missing = sequence - last_ - 1;
+                    }
+                    started_ = true;
+                    last_ = sequence;
+                    total_missing_ += missing;
+                    return missing;
+                }
+
+                uint64_t total_missing() const { return total_missing_; }
+
+            private:
+                bool started_ = false;
+                uint64_t last_ = 0;
+                uint64_t total_missing_ = 0;
+            };
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // SHM_TOPIC_RING_H
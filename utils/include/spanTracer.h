@@ -0,0 +1,164 @@
+#ifndef SPAN_TRACER_H
+#define SPAN_TRACER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "common/trace.pb.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            // 端到端延迟追踪：TraceContext 随 Image / Perception / TopicMessage / UniversalRequest 传递，
+            // 每个阶段追加一个 TraceHop（单调时钟纳秒 + 时钟域 id），下游据此算出 采集→感知→规划 的逐段耗时。
+            // 各阶段的 span 同时可记录进 SpanTracer 的每线程无锁队列，导出为 Chrome trace JSON。
+
+            // 单调时钟（steady_clock）纳秒，TraceHop 与 span 都使用此时钟
+            uint64_t trace_clock_ns();
+            // 本机时钟域 id：同一主机同一次开机的所有进程相同（Linux 上取自 boot_id），非 0
+            uint32_t trace_clock_id();
+            // 随机的非 0 追踪 id
+            uint64_t new_trace_id();
+            // 阶段名称（"capture"、"perception" 等），自定义阶段返回 "stage"
+            const char *trace_stage_name(humanoid_robot::PB::common::TraceStage stage);
+
+            // trace_id 为 0 时分配新的 id
+            void start_trace(humanoid_robot::PB::common::TraceContext *context);
+            // 追加一个在本机时钟域完成的阶段
+            humanoid_robot::PB::common::TraceHop *add_hop(humanoid_robot::PB::common::TraceContext *context,
+                                                          humanoid_robot::PB::common::TraceStage stage,
+                                                          uint64_t start_ns, uint64_t end_ns);
+
+            struct HopLatency
+            {
+                humanoid_robot::PB::common::TraceStage stage = humanoid_robot::PB::common::TRACE_STAGE_UNSPECIFIED;
+                uint64_t duration_ns = 0;
+                int64_t gap_ns = -1; // 与上一阶段结束之间的间隔（排队 + 传输）；首个阶段或跨时钟域时为 -1
+            };
+
+            std::vector<HopLatency> hop_latencies(const humanoid_robot::PB::common::TraceContext &context);
+            // 首个阶段开始到最后一个阶段结束；跨时钟域或没有阶段时返回 -1
+            int64_t end_to_end_ns(const humanoid_robot::PB::common::TraceContext &context);
+
+            struct SpanRecord
+            {
+                const char *name = nullptr; // 静态字符串
+                uint64_t trace_id = 0;
+                uint64_t start_ns = 0;
+                uint64_t duration_ns = 0;
+                uint32_t thread = 0; // 记录线程在本 tracer 中的序号，从 1 开始
+            };
+
+            class SpanRing;
+            class LatencyHistogram;
+
+            // span 记录器：每个记录线程独占一个无锁 SPSC 队列，记录只写入固定大小的槽位，不分配不加锁。
+            // 队列满时丢弃新 span 并计数。没有后台线程，由导出方定期调用 drain() / export_chrome_trace()
+            class SpanTracer
+            {
+            public:
+                explicit SpanTracer(std::size_t ring_capacity = 4096); // 每线程容量，向上取整为 2 的幂
+                ~SpanTracer();
+
+                SpanTracer(const SpanTracer &) = delete;
+                SpanTracer &operator=(const SpanTracer &) = delete;
+
+                // name 必须是静态字符串。队列满时返回 false
+                bool record(const char *name, uint64_t trace_id, uint64_t start_ns, uint64_t end_ns);
+                // 记录 context 中属于本机时钟域的所有阶段（例如链路末端的规划节点），返回记录条数
+                std::size_t record_hops(const humanoid_robot::PB::common::TraceContext &context);
+
+                // 取出所有线程已记录的 span 追加到 *out，返回条数。可与 record() 并发调用
+                std::size_t drain(std::vector<SpanRecord> *out);
+                // drain() 后格式化为 Chrome trace JSON（chrome://tracing、Perfetto 可直接打开），返回 span 数
+                std::size_t export_chrome_trace(std::string *out);
+                bool write_chrome_trace(const std::string &path);
+
+                uint64_t recorded() const; // 成功记录的 span 数
+                uint64_t dropped() const;  // 队列满而丢弃的 span 数
+
+            private:
+                SpanRing *local_ring();
+                SpanRing *register_local_ring();
+
+                const std::size_t ring_capacity_;
+                const uint64_t id_;
+
+                mutable std::mutex mutex_;
+                std::vector<std::shared_ptr<SpanRing>> rings_;
+                uint32_t next_thread_ = 1;
+                uint64_t retired_recorded_ = 0; // 已回收队列（记录线程已退出）的计数
+                uint64_t retired_dropped_ = 0;
+            };
+
+            // 把一组 span 格式化为 Chrome trace JSON（"X" 完整事件，ts / dur 单位为微秒）
+            void format_chrome_trace(const std::vector<SpanRecord> &spans, std::string *out);
+
+            // 作用域内的一个阶段：析构时向 context 追加 hop，tracer 非空时同时记录 span。
+            // start_ns 可指定为更早的时间（例如消息到达时间），默认为构造时刻
+            class HopScope
+            {
+            public:
+                HopScope(humanoid_robot::PB::common::TraceContext *context, humanoid_robot::PB::common::TraceStage stage,
+                         SpanTracer *tracer = nullptr, uint64_t start_ns = 0);
+                ~HopScope();
+
+                HopScope(const HopScope &) = delete;
+                HopScope &operator=(const HopScope &) = delete;
+
+            private:
+                humanoid_robot::PB::common::TraceContext *context_;
+                humanoid_robot::PB::common::TraceStage stage_;
+                SpanTracer *tracer_;
+                uint64_t start_ns_;
+            };
+
+            struct TraceStageLatency
+            {
+                humanoid_robot::PB::common::TraceStage stage = humanoid_robot::PB::common::TRACE_STAGE_UNSPECIFIED;
+                uint64_t count = 0;
+                uint64_t mean_ns = 0;
+                uint64_t p50_ns = 0; // 分位数为直方图桶上界，相对误差不超过 12.5%
+                uint64_t p99_ns = 0;
+                uint64_t max_ns = 0;
+                uint64_t gap_count = 0; // 有已知间隔（与上一阶段同一时钟域）的样本数
+                uint64_t gap_mean_ns = 0;
+                uint64_t gap_p99_ns = 0;
+            };
+
+            // 按阶段汇总大量 TraceContext 的耗时分布（直方图与感知流水线共用 LatencyHistogram），内存固定，add() 不分配（首次出现新阶段除外）。不加锁
+            class LatencyBreakdown
+            {
+            public:
+                LatencyBreakdown();
+                ~LatencyBreakdown();
+
+                void add(const humanoid_robot::PB::common::TraceContext &context);
+
+                // 按阶段首次出现的顺序
+                std::vector<TraceStageLatency> stages() const;
+                // 端到端（stage 为 UNSPECIFIED，gap 字段不使用）
+                TraceStageLatency end_to_end() const;
+                // 每阶段一行的文本表格
+                std::string report() const;
+                void reset();
+
+            private:
+                struct Entry;
+
+                std::vector<std::unique_ptr<Entry>> entries_;
+                std::unique_ptr<LatencyHistogram> total_;
+            };
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // SPAN_TRACER_H
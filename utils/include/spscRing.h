@@ -0,0 +1,95 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            // 单生产者单消费者环形队列：槽位预先分配并就地复用，队列满时丢弃新元素并计数。
+            // TraceSink 与 SpanTracer 的每线程队列共用；detached / closed 供所属线程与所有者各自标记退出
+            template <typename Slot>
+            class SpscRing
+            {
+            public:
+                explicit SpscRing(std::size_t capacity) : slots_(round_up_pow2(capacity)), mask_(slots_.size() - 1) {}
+
+                // 仅由生产者调用：fill(Slot &) 就地填写槽位
+                template <typename Fill>
+                bool push(Fill &&fill)
+                {
+                    const uint64_t head = head_.load(std::memory_order_relaxed);
+                    if (head - cached_tail_ >= slots_.size())
+                    {
+                        cached_tail_ = tail_.load(std::memory_order_acquire);
+                        if (head - cached_tail_ >= slots_.size())
+                        {
+                            dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                            return false;
+                        }
+                    }
+                    fill(slots_[head & mask_]);
+                    head_.store(head + 1, std::memory_order_release);
+                    return true;
+                }
+
+                // 仅由消费者调用：fn(Slot &) 逐条处理，返回处理的条数
+                template <typename Fn>
+                std::size_t consume(Fn &&fn)
+                {
+                    uint64_t tail = tail_.load(std::memory_order_relaxed);
+                    const uint64_t head = head_.load(std::memory_order_acquire);
+                    const std::size_t count = static_cast<std::size_t>(head - tail);
+                    for (; tail != head; ++tail)
+                    {
+                        fn(slots_[tail & mask_]);
+                    }
+                    tail_.store(tail, std::memory_order_release);
+                    return count;
+                }
+
+                bool empty() const
+                {
+                    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+                }
+
+                uint64_t enqueued() const { return head_.load(std::memory_order_acquire); }
+                uint64_t consumed() const { return tail_.load(std::memory_order_acquire); }
+                uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+                std::atomic<bool> detached{false}; // 生产者线程已退出
+                std::atomic<bool> closed{false};   // 所有者已析构
+
+            private:
+                static constexpr std::size_t kCacheLine = 64;
+
+                static std::size_t round_up_pow2(std::size_t n)
+                {
+                    std::size_t p = 2;
+                    while (p < n)
+                    {
+                        p <<= 1;
+                    }
+                    return p;
+                }
+
+                std::vector<Slot> slots_;
+                const std::size_t mask_;
+                alignas(kCacheLine) std::atomic<uint64_t> head_{0};
+                uint64_t cached_tail_ = 0;
+                std::atomic<uint64_t> dropped_{0};
+                alignas(kCacheLine) std::atomic<uint64_t> tail_{0};
+            };
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // SPSC_RING_H
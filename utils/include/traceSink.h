@@ -0,0 +1,115 @@
+#ifndef TRACE_SINK_H
+#define TRACE_SINK_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <google/protobuf/message.h>
+#include "variantFormatter.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            class TraceRing;
+            struct TraceRecord;
+
+            struct TraceOptions
+            {
+                std::string path;                               // 追加写入的文件；为空且未设置 writer 时写 stderr
+                std::function<void(std::string_view)> writer;   // 自定义输出（在后台线程调用），设置后忽略 path
+                std::size_t ring_capacity = 1024;               // 每个生产者线程的环形队列容量，向上取整为 2 的幂
+                std::chrono::microseconds poll_interval{1000};  // 队列为空时后台线程的休眠间隔
+                std::chrono::milliseconds flush_interval{100};  // 文件缓冲区的最长刷盘间隔
+                FormatOptions format;                           // 消息格式化选项
+            };
+
+            // 异步消息跟踪：生产者（例如 gRPC handler 线程）只把消息快照的引用计数指针放入本线程独占的
+            // 无锁 SPSC 队列，格式化与文件 I/O 全部在后台线程完成。队列满时丢弃新记录并计数，
+            // 后台线程会在输出中写入丢弃提示，生产者从不阻塞。
+            //
+            // 输出格式：每条记录一行 "<秒>.<纳秒> <tag> <format_message 结果>"
+            class TraceSink
+            {
+            public:
+                explicit TraceSink(TraceOptions options);
+                ~TraceSink();
+
+                TraceSink(const TraceSink &) = delete;
+                TraceSink &operator=(const TraceSink &) = delete;
+
+                // 打开输出并启动后台线程；输出文件打开失败时返回 false
+                bool start();
+
+                // 写出所有已入队记录后停止后台线程
+                void stop();
+
+                // 入队一条记录，tag 必须是静态字符串（例如方法名）。队列满时返回 false
+                bool trace(const char *tag, std::shared_ptr<const google::protobuf::Message> message);
+
+                // 把 message 序列化进队列槽位作为快照，用于只拿得到 const 引用的场景（例如 gRPC handler 的 request）。
+                // 槽位缓冲区复用，稳态不分配；message 须为生成类型
+                bool trace_copy(const char *tag, const google::protobuf::Message &message);
+
+                // 阻塞直到调用前入队的记录全部写出并刷盘（后台线程未运行时直接返回）。
+                // 按调用时各队列的写位置判断完成，其他线程持续写入不会使其无限等待
+                void flush();
+
+                uint64_t enqueued() const; // 成功入队的记录数
+                uint64_t dropped() const;  // 队列满而丢弃的记录数
+                uint64_t written() const;  // 已写出的记录数
+
+            private:
+                TraceRing *local_ring();
+                TraceRing *register_local_ring();
+                const google::protobuf::Message *parse_snapshot(const TraceRecord &record);
+                void run();
+                bool drain(const std::vector<std::shared_ptr<TraceRing>> &rings, std::string *buffer);
+                void write(std::string *buffer);
+
+                struct FlushRequest
+                {
+                    uint64_t id;
+                    std::vector<std::pair<std::shared_ptr<TraceRing>, uint64_t>> marks; // 请求时各非空队列的写位置
+                };
+
+                TraceOptions options_;
+                const uint64_t id_;
+                std::FILE *file_ = nullptr;
+
+                mutable std::mutex mutex_;
+                std::condition_variable cv_;
+                std::vector<std::shared_ptr<TraceRing>> rings_;
+                uint64_t rings_version_ = 0;
+                uint64_t retired_enqueued_ = 0; // 已回收队列（生产者线程已退出）的计数
+                uint64_t retired_dropped_ = 0;
+                uint64_t flush_requested_ = 0;
+                uint64_t flush_completed_ = 0;
+                std::vector<FlushRequest> flush_requests_; // 按 id 递增，由后台线程从头部完成
+                bool running_ = false;
+                std::thread consumer_;
+
+                std::atomic<uint64_t> written_{0};
+                // 后台线程解析 trace_copy() 快照用的消息，按类型复用
+                std::vector<std::pair<const google::protobuf::Descriptor *, std::unique_ptr<google::protobuf::Message>>> parse_cache_;
+            };
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // TRACE_SINK_H
@@ -0,0 +1,57 @@
+#ifndef VARIANT_FORMATTER_H
+#define VARIANT_FORMATTER_H
+
+#include <cstddef>
+#include <string>
+#include <google/protobuf/message.h>
+#include "common/variant.pb.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            // Variant / Dictionary / 任意 protobuf 消息的格式化，用于日志。
+            // 结果追加到调用方提供的缓冲区：std::string 重复使用时稳态无内存分配；
+            // 定长 char 缓冲区版本从不分配，写满即截断。不经过 iostream，不拷贝消息。
+
+            enum class FormatStyle
+            {
+                kText, // 紧凑文本：{timeout: 500, name: "arm", pose: [0.1, 0.2, ...(+98)]}
+                kJson, // 合法 JSON；被截断的部分以字符串 "...(+N)" 标记
+            };
+
+            struct FormatOptions
+            {
+                FormatStyle style = FormatStyle::kText;
+                int max_depth = 8;              // Dictionary / 消息嵌套超过此深度时只输出条目数
+                std::size_t max_elements = 64;  // 每个数组 / 字典 / repeated 字段最多输出的元素数
+                std::size_t max_string = 256;   // string 最多输出的字节数，bytes 按十六进制输出其一半
+            };
+
+            // 以下函数均追加到 out，不清空已有内容
+            void format_variant(const humanoid_robot::PB::common::Variant &variant, std::string *out,
+                                const FormatOptions &options = FormatOptions());
+
+            void format_dictionary(const humanoid_robot::PB::common::Dictionary &dictionary, std::string *out,
+                                   const FormatOptions &options = FormatOptions());
+
+            // 通过反射格式化任意消息（例如 interfaces::SendRequest），其中的 Variant / Dictionary 走专用路径
+            void format_message(const google::protobuf::Message &message, std::string *out,
+                                const FormatOptions &options = FormatOptions());
+
+            // 写入 buffer[0, capacity)，返回写入的字节数（不含结尾 '\0'，也不写 '\0'）。
+            // 输出超出容量时截断，并以 "..." 结尾
+            std::size_t format_variant(const humanoid_robot::PB::common::Variant &variant, char *buffer, std::size_t capacity,
+                                       const FormatOptions &options = FormatOptions());
+
+            std::size_t format_message(const google::protobuf::Message &message, char *buffer, std::size_t capacity,
+                                       const FormatOptions &options = FormatOptions());
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // VARIANT_FORMATTER_H
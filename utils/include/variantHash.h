@@ -0,0 +1,73 @@
+#ifndef VARIANT_HASH_H
+#define VARIANT_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "common/variant.pb.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            // 64 位字节哈希（XXH64 算法，4 路独立累加，每轮处理 32 字节）
+            uint64_t hash_bytes(const void *data, std::size_t size, uint64_t seed = 0);
+
+            inline uint64_t hash_bytes(std::string_view data, uint64_t seed = 0)
+            {
+                return hash_bytes(data.data(), data.size(), seed);
+            }
+
+            // Variant / Dictionary 的结构哈希，不序列化、不分配：
+            //   - Dictionary 与 map 的迭代顺序无关（各条目哈希求和后再混合）
+            //   - 数值数组直接对 RepeatedField 的连续内存做字节哈希
+            //   - 浮点数按位比较：-0.0 与 0.0 不同，位模式相同的 NaN 相等（与序列化后比较的语义一致）
+            // 相等的值哈希一定相同；哈希相同时仍需 *_equal 确认
+            uint64_t hash_variant(const humanoid_robot::PB::common::Variant &value);
+            uint64_t hash_dictionary(const humanoid_robot::PB::common::Dictionary &dict);
+
+            // 深度比较，类型、长度或大小不同时立即返回
+            bool variant_equal(const humanoid_robot::PB::common::Variant &a, const humanoid_robot::PB::common::Variant &b);
+            bool dictionary_equal(const humanoid_robot::PB::common::Dictionary &a, const humanoid_robot::PB::common::Dictionary &b);
+
+            // 单个条目对 hash_dictionary 的贡献
+            uint64_t dictionary_entry_hash(std::string_view key, uint64_t value_hash);
+            // 由条目贡献之和与条目数得到 hash_dictionary 的结果
+            uint64_t finish_dictionary_hash(uint64_t entry_sum, std::size_t entry_count);
+
+            // 可增量更新的 Dictionary 哈希缓存：修改单个 key 时只重新计算该 key 的值，
+            // 整体哈希按条目贡献之和更新，结果与 hash_dictionary 一致
+            class DictionaryHash
+            {
+            public:
+                // 完整计算
+                void reset(const humanoid_robot::PB::common::Dictionary &dict);
+                void clear();
+
+                // 更新或新增一个 key；返回值哈希是否变化（新增 key 也视为变化）
+                bool set(const std::string &key, const humanoid_robot::PB::common::Variant &value);
+                // 删除 key；key 不存在时返回 false
+                bool remove(const std::string &key);
+
+                // key 的值哈希，不存在时返回 false
+                bool find(const std::string &key, uint64_t *value_hash) const;
+
+                uint64_t value() const { return finish_dictionary_hash(sum_, entries_.size()); }
+                std::size_t size() const { return entries_.size(); }
+                const std::unordered_map<std::string, uint64_t> &entries() const { return entries_; }
+
+            private:
+                std::unordered_map<std::string, uint64_t> entries_; // key -> 值哈希
+                uint64_t sum_ = 0;
+            };
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // VARIANT_HASH_H
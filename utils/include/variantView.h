@@ -0,0 +1,154 @@
+#ifndef VARIANT_VIEW_H
+#define VARIANT_VIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "common/variant.pb.h"
+
+namespace humanoid_robot
+{
+    namespace utils
+    {
+        namespace PB
+        {
+
+            class DictionaryView;
+            class ArrayView;
+
+            // 直接在序列化字节上读取 Variant，不解析整棵树、不分配内存。
+            // 视图只引用原始缓冲区，缓冲区须在视图使用期间保持有效。
+            // 与生成代码的解析语义一致：oneof 出现多次时以最后一次为准（生成代码会合并重复出现的同一消息字段，
+            // 而序列化器从不产生这种输入）；字符串不做 UTF-8 校验；格式错误时 valid() 为 false。
+            class VariantView
+            {
+            public:
+                using ValueCase = humanoid_robot::PB::common::Variant::ValueCase;
+
+                VariantView() = default;
+                explicit VariantView(std::string_view bytes);
+
+                bool valid() const { return valid_; }
+                ValueCase value_case() const { return case_; }
+                bool empty() const { return case_ == humanoid_robot::PB::common::Variant::VALUE_NOT_SET; }
+
+                // 标量读取：类型不匹配时返回 false，out 不变
+                bool as_bool(bool *out) const;
+                bool as_int64(int64_t *out) const;   // 所有整数类型及 char；超出 int64 的 uint64 返回 false
+                bool as_uint64(uint64_t *out) const; // 无符号整数及非负的有符号整数
+                bool as_double(double *out) const;   // float / double 及整数
+                bool as_string(std::string_view *out) const; // stringValue / byteValue
+
+                // 嵌套结构
+                bool as_dictionary(DictionaryView *out) const;
+                bool as_array(ArrayView *out) const; // 1xx 数组与 2xx packed 数组
+
+                // 其余消息类型（Date、Timestamp、Image、BBox、PerceptionRow 等）的序列化字节，可按需单独解析
+                bool as_message(std::string_view *out) const;
+
+                // 整个 Variant 的序列化字节
+                std::string_view bytes() const { return data_; }
+
+                // 完整解析（需要修改或长期持有时）
+                bool materialize(humanoid_robot::PB::common::Variant *out) const;
+
+            private:
+                std::string_view data_;
+                ValueCase case_ = humanoid_robot::PB::common::Variant::VALUE_NOT_SET;
+                uint64_t scalar_ = 0;   // varint / fixed 字段的原始值
+                std::string_view span_; // 长度限定字段的内容
+                bool valid_ = true;
+            };
+
+            // Dictionary 的只读视图：按需遍历 map 条目
+            class DictionaryView
+            {
+            public:
+                DictionaryView() = default;
+                explicit DictionaryView(std::string_view bytes) : data_(bytes) {}
+
+                // 查找 key；重复 key 以最后一个为准（与 map 解析一致）。未找到或格式错误时返回 false
+                bool find(std::string_view key, VariantView *out) const;
+                bool contains(std::string_view key) const;
+
+                // 条目数（含重复 key）；格式错误时返回 0
+                std::size_t size() const;
+
+                // 按线格式顺序遍历 f(std::string_view key, const VariantView &value)，f 返回 false 时停止。
+                // 格式错误时返回 false
+                template <typename F>
+                bool for_each(F &&f) const
+                {
+                    std::size_t pos = 0;
+                    std::string_view key;
+                    VariantView value;
+                    int status;
+                    while ((status = next_entry(&pos, &key, &value)) > 0)
+                    {
+                        if (!f(key, static_cast<const VariantView &>(value)))
+                        {
+                            return true;
+                        }
+                    }
+                    return status == 0;
+                }
+
+                // 校验整棵树（含嵌套 Dictionary）的线格式
+                bool validate() const;
+
+                std::string_view bytes() const { return data_; }
+                bool materialize(humanoid_robot::PB::common::Dictionary *out) const;
+
+            private:
+                // 读取 pos 处的下一个条目：1 成功，0 结束，-1 格式错误
+                int next_entry(std::size_t *pos, std::string_view *key, VariantView *value) const;
+
+                std::string_view data_;
+            };
+
+            // 数组视图：逐元素读取，兼容 packed 与非 packed 两种 repeated 编码
+            class ArrayView
+            {
+            public:
+                using ValueCase = humanoid_robot::PB::common::Variant::ValueCase;
+
+                ArrayView() = default;
+                ArrayView(ValueCase value_case, std::string_view bytes);
+
+                ValueCase value_case() const { return case_; }
+
+                // 元素个数；格式错误时返回 0
+                std::size_t size() const;
+
+                // 完整遍历一次，检查元素编码
+                bool validate() const;
+
+                // 逐元素读取，结束、类型不匹配或格式错误时返回 false
+                bool next(int64_t *out);          // Bool/Int/UInt 数组与 packed 数组（uint64 按位转换）
+                bool next(double *out);           // Float/Double 数组
+                bool next(std::string_view *out); // Char/String 数组
+                void rewind();
+
+                // ByteArray 与 packed 数组的元素字节（小端定宽）；Float/Double 数组为单块 packed 编码时
+                // 返回其小端元素字节。其他情况返回空
+                std::string_view bytes() const;
+
+            private:
+                bool next_scalar(uint64_t *raw);
+
+                ValueCase case_ = humanoid_robot::PB::common::Variant::VALUE_NOT_SET;
+                std::string_view data_;
+                std::size_t pos_ = 0;         // data_ 中下一个字段的位置
+                std::string_view chunk_;      // 当前 packed 块中未读的部分
+                bool failed_ = false;         // 遇到格式错误
+            };
+
+            // 在任意消息的序列化字节中查找长度限定字段（例如 Notification.notifyMessage = 1、
+            // SendRequest.input = 1），返回其内容。字段出现多次时返回最后一次
+            bool find_message_field(std::string_view message, uint32_t field_number, std::string_view *out);
+
+        } // namespace PB
+    } // namespace utils
+} // namespace humanoid_robot
+
+#endif // VARIANT_VIEW_H
@@ -0,0 +1,899 @@
+#include "asyncInterfaceServer.h"
+
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_set>
+#include <grpcpp/alarm.h>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace humanoid_robot::PB::interfaces;
+using humanoid_robot::utils::PB::AsyncServerOptions;
+using humanoid_robot::utils::PB::InterfaceHandler;
+using humanoid_robot::utils::PB::ResponseStream;
+
+namespace
+{
+    enum Method : int
+    {
+        kSend,
+        kAction,
+        kSubscribe,
+        kUnsubscribe,
+        kQuery,
+        kMethodCount
+    };
+
+    enum class OpKind
+    {
+        kRequested,
+        kRead,
+        kWrite,
+        kFinish,
+        kDone // AsyncNotifyWhenDone：调用结束或被客户端取消
+    };
+
+    class CallBase;
+
+    // 完成队列 tag：所属调用 + 操作类型。call 为空表示 worker 自身的关停事件
+    struct Operation
+    {
+        CallBase *call;
+        OpKind kind;
+    };
+
+    // 调用对象所在完成队列的上下文，由 Worker 实现
+    class CallHost
+    {
+    public:
+        virtual ~CallHost() = default;
+
+        // 挂起一个同类型的新等待对象，使下一次调用可以被接收
+        virtual void spawn(Method method) = 0;
+        // 调用结束，放回对象池
+        virtual void recycle(CallBase *call) = 0;
+
+        InterfaceService::AsyncService *service = nullptr;
+        InterfaceHandler *handler = nullptr;
+        grpc::ServerCompletionQueue *cq = nullptr;
+        const AsyncServerOptions *options = nullptr;
+        std::atomic<bool> draining{false}; // 置位后不再发起新的异步操作
+        std::atomic<uint64_t> *calls = nullptr;
+        std::atomic<uint64_t> *active_streams = nullptr;
+        std::atomic<uint64_t> *rejected_writes = nullptr;
+        std::atomic<uint64_t> *paused_reads = nullptr;
+    };
+
+    class CallBase
+    {
+    public:
+        CallBase(CallHost *host, Method method) : host_(host), method_(method) {}
+        virtual ~CallBase() = default;
+
+        // 重置状态并向 gRPC 登记等待一次新调用
+        virtual void request() = 0;
+        virtual void proceed(OpKind kind, bool ok) = 0;
+        // 关停：拒绝后续写入
+        virtual void close() {}
+
+        Method method() const { return method_; }
+
+    protected:
+        CallHost *host_;
+        Method method_;
+        Operation request_op_{this, OpKind::kRequested};
+        Operation finish_op_{this, OpKind::kFinish};
+    };
+
+    grpc::Status handler_exception(const char *what)
+    {
+        return grpc::Status(grpc::StatusCode::INTERNAL, what);
+    }
+
+    // ---------------------------------------------------------------- 一元调用
+
+    template <typename Request, typename Response>
+    class UnaryCall final : public CallBase
+    {
+    public:
+        using RequestFn = void (InterfaceService::AsyncService::*)(grpc::ServerContext *, Request *,
+                                                                   grpc::ServerAsyncResponseWriter<Response> *,
+                                                                   grpc::CompletionQueue *, grpc::ServerCompletionQueue *, void *);
+        using HandleFn = grpc::Status (InterfaceHandler::*)(const Request &, Response *);
+
+        UnaryCall(CallHost *host, Method method, RequestFn request_fn, HandleFn handle_fn)
+            : CallBase(host, method), request_fn_(request_fn), handle_fn_(handle_fn)
+        {
+        }
+
+        void request() override
+        {
+            request_.Clear();
+            response_.Clear();
+            responder_.reset();
+            context_.emplace();
+            responder_.emplace(&*context_);
+            (host_->service->*request_fn_)(&*context_, &request_, &*responder_, host_->cq, host_->cq, &request_op_);
+        }
+
+        void proceed(OpKind kind, bool ok) override
+        {
+            if (kind != OpKind::kRequested || !ok || host_->draining)
+            {
+                host_->recycle(this);
+                return;
+            }
+            host_->spawn(method_);
+            host_->calls->fetch_add(1, std::memory_order_relaxed);
+
+            grpc::Status status;
+            try
+            {
+                status = (host_->handler->*handle_fn_)(request_, &response_);
+            }
+            catch (const std::exception &e)
+            {
+                status = handler_exception(e.what());
+            }
+            responder_->Finish(response_, status, &finish_op_);
+        }
+
+    private:
+        RequestFn request_fn_;
+        HandleFn handle_fn_;
+        Request request_;
+        Response response_;
+        std::optional<grpc::ServerContext> context_; // ServerContext 不能复用，每次调用重新构造
+        std::optional<grpc::ServerAsyncResponseWriter<Response>> responder_;
+    };
+
+    // ---------------------------------------------------------------- 流式调用
+
+    template <typename Response>
+    class StreamCall;
+
+    // 交给 handler 的写端；调用结束或对象被复用前断开 call 指针。
+    // mutex 同时保护所属调用的全部状态
+    template <typename Response>
+    class StreamHandle final : public ResponseStream<Response>
+    {
+    public:
+        bool write(const Response &response) override
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return call != nullptr && call->write_locked(response);
+        }
+
+        void finish(const grpc::Status &status) override
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (call != nullptr)
+            {
+                call->finish_locked(status);
+            }
+        }
+
+        std::size_t pending() const override
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return call != nullptr ? call->pending_locked() : 0;
+        }
+
+        bool closed() const override
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return call == nullptr || call->closed_locked();
+        }
+
+        mutable std::mutex mutex;
+        StreamCall<Response> *call = nullptr;
+    };
+
+    // 单写者队列：gRPC 同一时刻只允许一个未完成的 Write，其余响应在 queue_ 中排队
+    template <typename Response>
+    class StreamCall : public CallBase
+    {
+    public:
+        using CallBase::CallBase;
+
+        ~StreamCall() override
+        {
+            // handler 可能仍持有写端
+            std::lock_guard<std::mutex> lock(handle_->mutex);
+            handle_->call = nullptr;
+        }
+
+        bool write_locked(const Response &response)
+        {
+            if (closed_locked())
+            {
+                return false;
+            }
+            if (pending_locked() >= host_->options->max_pending_writes)
+            {
+                host_->rejected_writes->fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (writing_)
+            {
+                queue_.push_back(response);
+                return true;
+            }
+            // Write 返回前已完成序列化，response 不需要保留到写完成
+            writing_ = true;
+            start_write(response);
+            return true;
+        }
+
+        void finish_locked(const grpc::Status &status)
+        {
+            if (finish_requested_ || closed_)
+            {
+                return;
+            }
+            finish_requested_ = true;
+            status_ = status;
+            if (!writing_)
+            {
+                start_finish_locked();
+            }
+        }
+
+        std::size_t pending_locked() const { return queue_.size() + (writing_ ? 1 : 0); }
+        bool closed_locked() const { return closed_ || finish_requested_; }
+
+        void close() override
+        {
+            auto handle = handle_;
+            std::lock_guard<std::mutex> lock(handle->mutex);
+            closed_ = true;
+            queue_.clear();
+        }
+
+        void proceed(OpKind kind, bool ok) override
+        {
+            auto handle = handle_;
+            std::unique_lock<std::mutex> lock(handle->mutex);
+            if (kind == OpKind::kWrite)
+            {
+                on_write_done_locked(ok);
+            }
+            else if (kind == OpKind::kFinish)
+            {
+                finishing_ = false;
+                finished_ = true;
+                closed_ = true;
+                queue_.clear();
+            }
+            else if (kind == OpKind::kDone)
+            {
+                on_done_locked();
+            }
+            release_if_done(lock);
+        }
+
+    protected:
+        virtual void start_write(const Response &response) = 0;
+        virtual void start_finish(const grpc::Status &status) = 0;
+        // 写入队列变短后的回调（Send 流用于恢复读取）
+        virtual void after_write_locked() {}
+
+        void reset_stream()
+        {
+            queue_.clear();
+            writing_ = false;
+            reading_ = false;
+            finish_requested_ = false;
+            finishing_ = false;
+            finished_ = false;
+            closed_ = false;
+            released_ = false;
+            done_pending_ = false;
+            status_ = grpc::Status::OK;
+            handle_ = std::make_shared<StreamHandle<Response>>();
+            handle_->call = this;
+            // 必须在 Request* 之前登记；调用被接收后 gRPC 保证投递一次
+            context_->AsyncNotifyWhenDone(&done_op_);
+        }
+
+        // 调用已被接收，done tag 之后一定会投递
+        void on_started()
+        {
+            done_pending_ = true;
+            host_->calls->fetch_add(1, std::memory_order_relaxed);
+            host_->active_streams->fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void start_finish_locked()
+        {
+            if (host_->draining || finishing_ || finished_)
+            {
+                return;
+            }
+            finishing_ = true;
+            start_finish(status_);
+        }
+
+        void on_write_done_locked(bool ok)
+        {
+            writing_ = false;
+            if (!ok)
+            {
+                // 客户端已断开
+                closed_ = true;
+                queue_.clear();
+                if (!finish_requested_)
+                {
+                    finish_requested_ = true;
+                    status_ = grpc::Status(grpc::StatusCode::CANCELLED, "stream closed");
+                }
+            }
+            if (host_->draining)
+            {
+                return;
+            }
+            if (!queue_.empty())
+            {
+                writing_ = true;
+                Response next = std::move(queue_.front());
+                queue_.pop_front();
+                start_write(next);
+            }
+            else if (finish_requested_)
+            {
+                start_finish_locked();
+            }
+            after_write_locked();
+        }
+
+        void on_done_locked()
+        {
+            done_pending_ = false;
+            if (!context_->IsCancelled())
+            {
+                return;
+            }
+            // 客户端取消或超时：handler 可能一直持有写端不再写入，不能等它调用 finish()。
+            // 未完成的读写会以 ok=false 返回；没有进行中的 Finish 时直接视为结束
+            closed_ = true;
+            queue_.clear();
+            if (!finish_requested_)
+            {
+                finish_requested_ = true;
+                status_ = grpc::Status(grpc::StatusCode::CANCELLED, "cancelled by client");
+            }
+            if (!finishing_)
+            {
+                finished_ = true;
+            }
+        }
+
+        // 结束、done tag 已投递且没有未完成的读写时放回对象池；之后不能再访问 this
+        void release_if_done(std::unique_lock<std::mutex> &lock)
+        {
+            if (!finished_ || writing_ || reading_ || done_pending_ || released_)
+            {
+                return;
+            }
+            released_ = true;
+            handle_->call = nullptr;
+            host_->active_streams->fetch_sub(1, std::memory_order_relaxed);
+            lock.unlock();
+            host_->recycle(this);
+        }
+
+        std::optional<grpc::ServerContext> context_; // ServerContext 不能复用，每次调用重新构造
+        std::shared_ptr<StreamHandle<Response>> handle_ = std::make_shared<StreamHandle<Response>>();
+        std::deque<Response> queue_;
+        grpc::Status status_;
+        bool writing_ = false;
+        bool reading_ = false;
+        bool finish_requested_ = false;
+        bool finishing_ = false;
+        bool finished_ = false;
+        bool closed_ = false;
+        bool released_ = false;
+        bool done_pending_ = false; // done tag 已登记且调用已接收，尚未投递
+        Operation write_op_{this, OpKind::kWrite};
+        Operation done_op_{this, OpKind::kDone};
+    };
+
+    class SendCall final : public StreamCall<SendResponse>
+    {
+    public:
+        explicit SendCall(CallHost *host) : StreamCall<SendResponse>(host, kSend) {}
+
+        void request() override
+        {
+            request_.Clear();
+            stream_.reset();
+            context_.emplace();
+            stream_.emplace(&*context_);
+            reset_stream();
+            paused_ = false;
+            host_->service->RequestSend(&*context_, &*stream_, host_->cq, host_->cq, &request_op_);
+        }
+
+        void proceed(OpKind kind, bool ok) override
+        {
+            if (kind == OpKind::kRequested)
+            {
+                if (!ok || host_->draining)
+                {
+                    host_->recycle(this);
+                    return;
+                }
+                host_->spawn(method_);
+                auto handle = handle_;
+                std::lock_guard<std::mutex> lock(handle->mutex);
+                on_started();
+                start_read_locked();
+                return;
+            }
+            if (kind != OpKind::kRead)
+            {
+                StreamCall<SendResponse>::proceed(kind, ok);
+                return;
+            }
+
+            auto handle = handle_;
+            if (ok)
+            {
+                try
+                {
+                    host_->handler->send(request_, handle);
+                }
+                catch (const std::exception &e)
+                {
+                    handle->finish(handler_exception(e.what()));
+                }
+                std::unique_lock<std::mutex> lock(handle->mutex);
+                reading_ = false;
+                if (!closed_locked() && !host_->draining)
+                {
+                    if (pending_locked() >= host_->options->max_pending_writes)
+                    {
+                        // 响应积压：暂停读取，客户端的写入由 HTTP/2 流控挡住
+                        paused_ = true;
+                        host_->paused_reads->fetch_add(1, std::memory_order_relaxed);
+                    }
+                    else
+                    {
+                        start_read_locked();
+                    }
+                }
+                release_if_done(lock);
+                return;
+            }
+
+            // 客户端已结束写入（WritesDone 或断开）
+            {
+                std::lock_guard<std::mutex> lock(handle->mutex);
+                reading_ = false;
+            }
+            if (!handle->closed())
+            {
+                try
+                {
+                    host_->handler->send_closed(handle);
+                }
+                catch (const std::exception &e)
+                {
+                    handle->finish(handler_exception(e.what()));
+                }
+            }
+            std::unique_lock<std::mutex> lock(handle->mutex);
+            release_if_done(lock);
+        }
+
+    protected:
+        void start_write(const SendResponse &response) override { stream_->Write(response, &write_op_); }
+        void start_finish(const grpc::Status &status) override { stream_->Finish(status, &finish_op_); }
+
+        void after_write_locked() override
+        {
+            // 积压降到一半以下再恢复读取，避免在阈值附近反复暂停
+            if (paused_ && !closed_locked() && pending_locked() <= host_->options->max_pending_writes / 2)
+            {
+                paused_ = false;
+                start_read_locked();
+            }
+        }
+
+    private:
+        void start_read_locked()
+        {
+            if (host_->draining)
+            {
+                return;
+            }
+            reading_ = true;
+            stream_->Read(&request_, &read_op_);
+        }
+
+        SendRequest request_;
+        std::optional<grpc::ServerAsyncReaderWriter<SendResponse, SendRequest>> stream_;
+        bool paused_ = false;
+        Operation read_op_{this, OpKind::kRead};
+    };
+
+    class ActionCall final : public StreamCall<ActionResponse>
+    {
+    public:
+        explicit ActionCall(CallHost *host) : StreamCall<ActionResponse>(host, kAction) {}
+
+        void request() override
+        {
+            request_.Clear();
+            writer_.reset();
+            context_.emplace();
+            writer_.emplace(&*context_);
+            reset_stream();
+            host_->service->RequestAction(&*context_, &request_, &*writer_, host_->cq, host_->cq, &request_op_);
+        }
+
+        void proceed(OpKind kind, bool ok) override
+        {
+            if (kind != OpKind::kRequested)
+            {
+                StreamCall<ActionResponse>::proceed(kind, ok);
+                return;
+            }
+            if (!ok || host_->draining)
+            {
+                host_->recycle(this);
+                return;
+            }
+            host_->spawn(method_);
+            auto handle = handle_;
+            {
+                std::lock_guard<std::mutex> lock(handle->mutex);
+                on_started();
+            }
+            try
+            {
+                host_->handler->action(request_, handle);
+            }
+            catch (const std::exception &e)
+            {
+                handle->finish(handler_exception(e.what()));
+            }
+        }
+
+    protected:
+        void start_write(const ActionResponse &response) override { writer_->Write(response, &write_op_); }
+        void start_finish(const grpc::Status &status) override { writer_->Finish(status, &finish_op_); }
+
+    private:
+        ActionRequest request_;
+        std::optional<grpc::ServerAsyncWriter<ActionResponse>> writer_;
+    };
+
+    void pin_to_cpu(std::thread &thread, int index)
+    {
+#ifdef __linux__
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0)
+        {
+            return;
+        }
+        int target = index % CPU_COUNT(&allowed);
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &allowed) && target-- == 0)
+            {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(cpu, &set);
+                pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+                return;
+            }
+        }
+#else
+        (void)thread;
+        (void)index;
+#endif
+    }
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    grpc::Status InterfaceHandler::subscribe(const SubscribeRequest &, SubscribeResponse *)
+    {
+        return grpc::Status(grpc::StatusCode::UNIMPLEMENTED, "Subscribe");
+    }
+
+    grpc::Status InterfaceHandler::unsubscribe(const UnsubscribeRequest &, UnsubscribeResponse *)
+    {
+        return grpc::Status(grpc::StatusCode::UNIMPLEMENTED, "Unsubscribe");
+    }
+
+    grpc::Status InterfaceHandler::query(const QueryRequest &, QueryResponse *)
+    {
+        return grpc::Status(grpc::StatusCode::UNIMPLEMENTED, "Query");
+    }
+
+    void InterfaceHandler::send(const SendRequest &, const std::shared_ptr<ResponseStream<SendResponse>> &stream)
+    {
+        stream->finish(grpc::Status(grpc::StatusCode::UNIMPLEMENTED, "Send"));
+    }
+
+    void InterfaceHandler::send_closed(const std::shared_ptr<ResponseStream<SendResponse>> &stream)
+    {
+        stream->finish(grpc::Status::OK);
+    }
+
+    void InterfaceHandler::action(const ActionRequest &, const std::shared_ptr<ResponseStream<ActionResponse>> &stream)
+    {
+        stream->finish(grpc::Status(grpc::StatusCode::UNIMPLEMENTED, "Action"));
+    }
+
+    // ---------------------------------------------------------------- Worker
+
+    // 一个完成队列 + 一个线程；调用对象只在本线程上创建、复用，关停时统一释放
+    class AsyncInterfaceServer::Worker final : public CallHost
+    {
+    public:
+        Worker(AsyncInterfaceServer *server, std::unique_ptr<grpc::ServerCompletionQueue> queue, int index)
+            : queue_(std::move(queue)), index_(index)
+        {
+            service = &server->service_;
+            handler = server->handler_;
+            cq = queue_.get();
+            options = &server->options_;
+            calls = &server->calls_;
+            active_streams = &server->active_streams_;
+            rejected_writes = &server->rejected_writes_;
+            paused_reads = &server->paused_reads_;
+        }
+
+        ~Worker() override
+        {
+            join();
+            release_calls();
+        }
+
+        void start()
+        {
+            for (int method = 0; method < kMethodCount; ++method)
+            {
+                spawn(static_cast<Method>(method));
+            }
+            thread_ = std::thread(&Worker::run, this);
+            if (options->pin_threads)
+            {
+                pin_to_cpu(thread_, index_);
+            }
+        }
+
+        void stop_accepting() { accepting_ = false; }
+
+        // 服务端 Shutdown 之后调用：拒绝后续写入，由本线程关闭完成队列并排空
+        void drain()
+        {
+            draining = true;
+            {
+                std::lock_guard<std::mutex> lock(calls_mutex_);
+                for (CallBase *call : calls_)
+                {
+                    call->close();
+                }
+            }
+            alarm_.Set(queue_.get(), std::chrono::system_clock::now(), &shutdown_op_);
+        }
+
+        void join()
+        {
+            if (thread_.joinable())
+            {
+                thread_.join();
+            }
+        }
+
+        void release_calls()
+        {
+            std::lock_guard<std::mutex> lock(calls_mutex_);
+            for (CallBase *call : calls_)
+            {
+                delete call;
+            }
+            calls_.clear();
+            for (auto &pool : free_)
+            {
+                pool.clear();
+            }
+        }
+
+        void spawn(Method method) override
+        {
+            // request() 会重置调用状态，与 drain() 中的 close() 互斥
+            std::lock_guard<std::mutex> lock(calls_mutex_);
+            if (!accepting_ || draining)
+            {
+                return;
+            }
+            CallBase *call = nullptr;
+            auto &pool = free_[method];
+            if (!pool.empty())
+            {
+                call = pool.back();
+                pool.pop_back();
+            }
+            else
+            {
+                call = create(method);
+                calls_.insert(call);
+            }
+            call->request();
+        }
+
+        void recycle(CallBase *call) override
+        {
+            if (draining)
+            {
+                return; // 关停时由 release_calls 统一释放
+            }
+            std::lock_guard<std::mutex> lock(calls_mutex_);
+            auto &pool = free_[call->method()];
+            if (pool.size() < options->pool_size)
+            {
+                pool.push_back(call);
+                return;
+            }
+            calls_.erase(call);
+            delete call;
+        }
+
+    private:
+        CallBase *create(Method method)
+        {
+            switch (method)
+            {
+            case kSend:
+                return new SendCall(this);
+            case kAction:
+                return new ActionCall(this);
+            case kSubscribe:
+                return new UnaryCall<SubscribeRequest, SubscribeResponse>(
+                    this, method, &InterfaceService::AsyncService::RequestSubscribe, &InterfaceHandler::subscribe);
+            case kUnsubscribe:
+                return new UnaryCall<UnsubscribeRequest, UnsubscribeResponse>(
+                    this, method, &InterfaceService::AsyncService::RequestUnsubscribe, &InterfaceHandler::unsubscribe);
+            case kQuery:
+            default:
+                return new UnaryCall<QueryRequest, QueryResponse>(
+                    this, kQuery, &InterfaceService::AsyncService::RequestQuery, &InterfaceHandler::query);
+            }
+        }
+
+        void run()
+        {
+            void *tag = nullptr;
+            bool ok = false;
+            while (queue_->Next(&tag, &ok))
+            {
+                auto *op = static_cast<Operation *>(tag);
+                if (op->call == nullptr)
+                {
+                    queue_->Shutdown();
+                    continue;
+                }
+                op->call->proceed(op->kind, ok);
+            }
+        }
+
+        std::unique_ptr<grpc::ServerCompletionQueue> queue_;
+        int index_;
+        std::thread thread_;
+        std::atomic<bool> accepting_{true};
+        grpc::Alarm alarm_;
+        Operation shutdown_op_{nullptr, OpKind::kFinish};
+
+        std::mutex calls_mutex_;              // calls_ / free_ 会在关停线程上遍历
+        std::unordered_set<CallBase *> calls_; // 本队列创建的全部调用对象
+        std::vector<CallBase *> free_[kMethodCount];
+    };
+
+    // ---------------------------------------------------------------- AsyncInterfaceServer
+
+    AsyncInterfaceServer::AsyncInterfaceServer(InterfaceHandler *handler, AsyncServerOptions options)
+        : handler_(handler), options_(std::move(options))
+    {
+    }
+
+    AsyncInterfaceServer::~AsyncInterfaceServer()
+    {
+        shutdown();
+    }
+
+    bool AsyncInterfaceServer::start()
+    {
+        if (server_)
+        {
+            return true;
+        }
+
+        int threads = options_.threads;
+        if (threads <= 0)
+        {
+            threads = static_cast<int>(std::thread::hardware_concurrency());
+            threads = threads > 0 ? threads : 1;
+        }
+
+        grpc::ServerBuilder builder;
+        builder.AddListeningPort(options_.address,
+                                 options_.credentials ? options_.credentials : grpc::InsecureServerCredentials(), &port_);
+        builder.RegisterService(&service_);
+        std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> queues;
+        for (int i = 0; i < threads; ++i)
+        {
+            queues.push_back(builder.AddCompletionQueue());
+        }
+
+        server_ = builder.BuildAndStart();
+        if (!server_)
+        {
+            for (auto &queue : queues)
+            {
+                queue->Shutdown();
+                void *tag = nullptr;
+                bool ok = false;
+                while (queue->Next(&tag, &ok))
+                {
+                }
+            }
+            return false;
+        }
+
+        for (int i = 0; i < threads; ++i)
+        {
+            workers_.emplace_back(new Worker(this, std::move(queues[i]), i));
+        }
+        for (auto &worker : workers_)
+        {
+            worker->start();
+        }
+        return true;
+    }
+
+    void AsyncInterfaceServer::shutdown()
+    {
+        if (!server_)
+        {
+            return;
+        }
+        for (auto &worker : workers_)
+        {
+            worker->stop_accepting();
+        }
+        server_->Shutdown(std::chrono::system_clock::now() + options_.shutdown_grace);
+        for (auto &worker : workers_)
+        {
+            worker->drain();
+        }
+        for (auto &worker : workers_)
+        {
+            worker->join();
+            worker->release_calls();
+        }
+        server_.reset();
+        workers_.clear();
+    }
+
+    AsyncServerStats AsyncInterfaceServer::stats() const
+    {
+        AsyncServerStats stats;
+        stats.calls = calls_.load(std::memory_order_relaxed);
+        stats.active_streams = active_streams_.load(std::memory_order_relaxed);
+        stats.rejected_writes = rejected_writes_.load(std::memory_order_relaxed);
+        stats.paused_reads = paused_reads_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+} // namespace humanoid_robot::utils::PB
@@ -0,0 +1,378 @@
+#include "detectionBatcher.h"
+
+#include <algorithm>
+#include <future>
+#include <memory>
+#include "variantHash.h"
+
+using namespace detection;
+
+namespace
+{
+    std::vector<std::string> normalized_classes(const DetectionRequest &request)
+    {
+        std::vector<std::string> classes(request.classes().begin(), request.classes().end());
+        std::sort(classes.begin(), classes.end());
+        classes.erase(std::unique(classes.begin(), classes.end()), classes.end());
+        return classes;
+    }
+
+    DetectionResponse failed_response()
+    {
+        DetectionResponse response;
+        response.set_success(false);
+        response.set_timestamp(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   std::chrono::system_clock::now().time_since_epoch())
+                                   .count());
+        return response;
+    }
+
+    void spin_for(std::chrono::microseconds duration)
+    {
+        const auto until = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < until)
+        {
+        }
+    }
+
+    // 一条 BatchDetect 流的有序回写状态
+    struct StreamState
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::map<uint64_t, DetectionResponse> ready;
+        uint64_t submitted = 0;
+        bool reading_done = false;
+    };
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    // ---------------------------------------------------------------- DetectionBatcher
+
+    DetectionBatcher::DetectionBatcher(BatchInference inference, BatcherOptions options)
+        : inference_(std::move(inference)), options_(options)
+    {
+        options_.max_batch_size = std::max<std::size_t>(1, options_.max_batch_size);
+        options_.max_queued = std::max(options_.max_queued, options_.max_batch_size);
+        for (int i = 0; i < std::max(1, options_.workers); ++i)
+        {
+            workers_.emplace_back(&DetectionBatcher::worker_loop, this);
+        }
+    }
+
+    DetectionBatcher::~DetectionBatcher()
+    {
+        shutdown();
+    }
+
+    std::string DetectionBatcher::group_key(const DetectionRequest &request)
+    {
+        // format 与类别名之间用 '\0' 分隔，不会与合法名称冲突
+        std::string key = request.format();
+        for (const auto &name : normalized_classes(request))
+        {
+            key.push_back('\0');
+            key += name;
+        }
+        return key;
+    }
+
+    bool DetectionBatcher::submit(DetectionRequest request, Completion done)
+    {
+        std::string key = group_key(request);
+        std::unique_lock<std::mutex> lock(mutex_);
+        space_cv_.wait(lock, [this]() { return queued_ < options_.max_queued || stopping_; });
+        if (stopping_)
+        {
+            return false;
+        }
+
+        auto it = groups_.find(key);
+        if (it == groups_.end())
+        {
+            Group group;
+            group.format = request.format();
+            group.classes = normalized_classes(request);
+            it = groups_.emplace(std::move(key), std::move(group)).first;
+        }
+        it->second.items.push_back(Item{std::move(request), std::move(done), Clock::now()});
+        ++queued_;
+        ++stats_.requests;
+        // 新组需要重新计算截止时间，满批需要立即执行，其余情况不必唤醒
+        if (it->second.items.size() == 1 || it->second.items.size() >= options_.max_batch_size)
+        {
+            work_cv_.notify_one();
+        }
+        return true;
+    }
+
+    void DetectionBatcher::shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_ && workers_.empty())
+            {
+                return;
+            }
+            stopping_ = true;
+        }
+        work_cv_.notify_all();
+        space_cv_.notify_all();
+        for (auto &worker : workers_)
+        {
+            worker.join();
+        }
+        workers_.clear();
+    }
+
+    BatcherStats DetectionBatcher::stats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        BatcherStats stats = stats_;
+        stats.queued = queued_;
+        return stats;
+    }
+
+    void DetectionBatcher::worker_loop()
+    {
+        std::vector<Item> items;
+        DetectionBatch batch;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true)
+        {
+            Clock::time_point wake;
+            if (take_batch_locked(Clock::now(), &items, &batch, &wake))
+            {
+                lock.unlock();
+                space_cv_.notify_all();
+                run_batch(items, batch);
+                lock.lock();
+                continue;
+            }
+            if (stopping_ && queued_ == 0)
+            {
+                break;
+            }
+            if (wake == Clock::time_point::max())
+            {
+                work_cv_.wait(lock);
+            }
+            else
+            {
+                work_cv_.wait_until(lock, wake);
+            }
+        }
+    }
+
+    bool DetectionBatcher::take_batch_locked(Clock::time_point now, std::vector<Item> *items, DetectionBatch *batch,
+                                             Clock::time_point *wake)
+    {
+        // 优先满批；否则取已到截止时间的组（关停时所有组都视为到期），都按最早请求的先后选
+        auto chosen = groups_.end();
+        bool full = false;
+        *wake = Clock::time_point::max();
+        for (auto it = groups_.begin(); it != groups_.end(); ++it)
+        {
+            const Group &group = it->second;
+            if (group.items.empty())
+            {
+                continue;
+            }
+            const bool group_full = group.items.size() >= options_.max_batch_size;
+            const Clock::time_point deadline = group.items.front().enqueued + options_.max_wait;
+            const bool due = group_full || stopping_ || deadline <= now;
+            if (!due)
+            {
+                *wake = std::min(*wake, deadline);
+                continue;
+            }
+            if (chosen == groups_.end() || (group_full && !full) ||
+                (group_full == full && group.items.front().enqueued < chosen->second.items.front().enqueued))
+            {
+                chosen = it;
+                full = group_full;
+            }
+        }
+        if (chosen == groups_.end())
+        {
+            return false;
+        }
+
+        Group &group = chosen->second;
+        const std::size_t count = std::min(group.items.size(), options_.max_batch_size);
+        items->clear();
+        batch->format = group.format;
+        batch->classes = group.classes;
+        batch->requests.clear();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            items->push_back(std::move(group.items.front()));
+            group.items.pop_front();
+        }
+        for (const auto &item : *items)
+        {
+            batch->requests.push_back(&item.request);
+        }
+        if (group.items.empty())
+        {
+            groups_.erase(chosen);
+        }
+
+        queued_ -= count;
+        ++stats_.batches;
+        ++(full ? stats_.full_batches : stats_.deadline_batches);
+        stats_.largest_batch = std::max(stats_.largest_batch, count);
+        return true;
+    }
+
+    void DetectionBatcher::run_batch(std::vector<Item> &items, DetectionBatch &batch)
+    {
+        std::vector<DetectionResponse> responses;
+        responses.reserve(items.size());
+        bool ok = false;
+        try
+        {
+            ok = inference_(batch, &responses) && responses.size() == items.size();
+        }
+        catch (const std::exception &)
+        {
+            ok = false;
+        }
+        if (!ok)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++stats_.failed_batches;
+        }
+
+        for (std::size_t i = 0; i < items.size(); ++i)
+        {
+            if (items[i].done)
+            {
+                items[i].done(ok ? std::move(responses[i]) : failed_response());
+            }
+        }
+        items.clear();
+    }
+
+    // ---------------------------------------------------------------- BatchingDetectionService
+
+    BatchingDetectionService::BatchingDetectionService(DetectionBatcher *batcher) : batcher_(batcher)
+    {
+    }
+
+    grpc::Status BatchingDetectionService::DetectObjects(grpc::ServerContext *, const DetectionRequest *request,
+                                                         DetectionResponse *response)
+    {
+        auto promise = std::make_shared<std::promise<DetectionResponse>>();
+        std::future<DetectionResponse> result = promise->get_future();
+        if (!batcher_->submit(*request, [promise](DetectionResponse &&done) { promise->set_value(std::move(done)); }))
+        {
+            return grpc::Status(grpc::StatusCode::UNAVAILABLE, "detection batcher stopped");
+        }
+        *response = result.get();
+        return grpc::Status::OK;
+    }
+
+    grpc::Status BatchingDetectionService::BatchDetect(grpc::ServerContext *,
+                                                       grpc::ServerReaderWriter<DetectionResponse, DetectionRequest> *stream)
+    {
+        auto state = std::make_shared<StreamState>();
+
+        // 写线程按请求顺序写回；批处理工作线程只把结果放进 ready，不会被慢客户端阻塞
+        std::thread writer([state, stream]() {
+            uint64_t next = 0;
+            bool broken = false;
+            std::unique_lock<std::mutex> lock(state->mutex);
+            while (true)
+            {
+                state->cv.wait(lock, [&]() {
+                    return state->ready.count(next) != 0 || (state->reading_done && next == state->submitted);
+                });
+                auto it = state->ready.find(next);
+                if (it == state->ready.end())
+                {
+                    break;
+                }
+                DetectionResponse response = std::move(it->second);
+                state->ready.erase(it);
+                ++next;
+                lock.unlock();
+                // 客户端断开后继续排空，保证所有已提交的请求都被回收
+                broken = broken || !stream->Write(response);
+                lock.lock();
+            }
+        });
+
+        grpc::Status status = grpc::Status::OK;
+        DetectionRequest request;
+        while (stream->Read(&request))
+        {
+            uint64_t sequence = 0;
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                sequence = state->submitted++;
+            }
+            const bool accepted = batcher_->submit(std::move(request), [state, sequence](DetectionResponse &&response) {
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->ready.emplace(sequence, std::move(response));
+                }
+                state->cv.notify_all();
+            });
+            if (!accepted)
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                --state->submitted;
+                status = grpc::Status(grpc::StatusCode::UNAVAILABLE, "detection batcher stopped");
+                break;
+            }
+            request.Clear();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->reading_done = true;
+        }
+        state->cv.notify_all();
+        writer.join();
+        return status;
+    }
+
+    // ---------------------------------------------------------------- StubDetectionBackend
+
+    StubDetectionBackend::StubDetectionBackend(StubBackendOptions options) : options_(options)
+    {
+    }
+
+    bool StubDetectionBackend::operator()(const DetectionBatch &batch, std::vector<DetectionResponse> *responses) const
+    {
+        spin_for(options_.batch_cost + options_.item_cost * static_cast<int64_t>(batch.requests.size()));
+
+        const int64_t now_ms =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        for (const DetectionRequest *request : batch.requests)
+        {
+            DetectionResponse response;
+            response.set_timestamp(now_ms);
+            response.set_success(true);
+            const uint64_t seed = hash_bytes(request->image_data().data(), request->image_data().size());
+            for (int i = 0; i < options_.objects_per_image; ++i)
+            {
+                const uint64_t bits = seed ^ (0x9E3779B97F4A7C15ULL * static_cast<uint64_t>(i + 1));
+                DetectionResult *result = response.add_results();
+                result->set_object_id(std::to_string(i));
+                result->set_class_name(batch.classes.empty() ? std::string("object") : batch.classes[static_cast<std::size_t>(i) % batch.classes.size()]);
+                result->set_confidence(static_cast<float>(bits % 1000) / 1000.0f);
+                BoundingBox *bbox = result->mutable_bbox();
+                bbox->set_x(static_cast<float>((bits >> 10) % 640));
+                bbox->set_y(static_cast<float>((bits >> 20) % 480));
+                bbox->set_width(static_cast<float>(16 + (bits >> 30) % 128));
+                bbox->set_height(static_cast<float>(16 + (bits >> 40) % 128));
+            }
+            responses->push_back(std::move(response));
+        }
+        return true;
+    }
+
+} // namespace humanoid_robot::utils::PB
@@ -0,0 +1,135 @@
+#include "dictionaryBuilder.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace humanoid_robot::PB::common;
+
+namespace
+{
+    // 单个键值对（map 节点 + key + 标量 Variant）在 Arena 上的大致开销
+    constexpr std::size_t kBytesPerEntry = 128;
+    constexpr std::size_t kMinStartBlock = 1024;
+    constexpr std::size_t kMaxStartBlock = 64 * 1024;
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    ::google::protobuf::ArenaOptions MessageArena::make_options(std::size_t expected_entries)
+    {
+        ::google::protobuf::ArenaOptions options;
+        options.start_block_size = std::min(kMaxStartBlock, std::max(kMinStartBlock, expected_entries * kBytesPerEntry));
+        options.max_block_size = std::max(options.max_block_size, options.start_block_size);
+        return options;
+    }
+
+    MessageArena::MessageArena(std::size_t expected_entries)
+        : arena_(make_options(expected_entries))
+    {
+    }
+
+    DictionaryBuilder::DictionaryBuilder(Dictionary *target)
+        : map_(target->mutable_keyvaluelist()), target_(target)
+    {
+    }
+
+    Variant *DictionaryBuilder::slot(const std::string &key)
+    {
+        return &(*map_)[key];
+    }
+
+    DictionaryBuilder &DictionaryBuilder::set_bool(const std::string &key, bool value)
+    {
+        slot(key)->set_boolvalue(value);
+        return *this;
+    }
+
+    DictionaryBuilder &DictionaryBuilder::set_int8(const std::string &key, int8_t value)
+    {
+        slot(key)->set_int8value(value);
+        return *this;
+    }
+
+    DictionaryBuilder &DictionaryBuilder::set_uint8(const std::string &key, uint8_t value)
+    {
+        slot(key)->set_uint8value(value);
+        return *this;
+    }
+
+    DictionaryBuilder &DictionaryBuilder::set_int16(const std::string &key, int16_t value)
+    {
+        slot(key)->set_int16value(value);
+        return *this;
+    }
+
+    DictionaryBuilder &DictionaryBuilder::set_uint16(const std::string &key, uint16_t value)
+    {
+        slot(key)->set_uint16value(value);
+        return *this;
+    }
+
+    DictionaryBuilder &DictionaryBuilder::set_int32(const std::string &key, int32_t value)
+    {
+        slot(key)->set_int32value(value);
+        return *this;
+    }
+
+    DictionaryBuilder &DictionaryBuilder::set_uint32(const std::string &key, uint32_t value)
+    {
+        slot(key)->set_uint32value(value);
+        return *this;
+    }
+
+    DictionaryBuilder &DictionaryBuilder::set_int64(const std::string &key, int64_t value)
+    {
+        slot(key)->set_int64value(value);
+        return *this;
+    }
+
+    DictionaryBuilder &DictionaryBuilder::set_uint64(const std::string &key, uint64_t value)
+    {
+        slot(key)->set_uint64value(value);
+        return *this;
+    }
+
+    DictionaryBuilder &DictionaryBuilder::set_float(const std::string &key, float value)
+    {
+        slot(key)->set_floatvalue(value);
+        return *this;
+    }
+
+    DictionaryBuilder &DictionaryBuilder::set_double(const std::string &key, double value)
+    {
+        slot(key)->set_doublevalue(value);
+        return *this;
+    }
+
+    DictionaryBuilder &DictionaryBuilder::set_string(const std::string &key, std::string value)
+    {
+        slot(key)->set_stringvalue(std::move(value));
+        return *this;
+    }
+
+    DictionaryBuilder &DictionaryBuilder::set_bytes(const std::string &key, std::string value)
+    {
+        slot(key)->set_bytevalue(std::move(value));
+        return *this;
+    }
+
+    DictionaryBuilder &DictionaryBuilder::set(const std::string &key, Variant &&value)
+    {
+        // 同一 Arena（或都在堆上）时 protobuf 的移动赋值只做内部交换
+        *slot(key) = std::move(value);
+        return *this;
+    }
+
+    DictionaryBuilder DictionaryBuilder::child(const std::string &key)
+    {
+        return DictionaryBuilder(slot(key)->mutable_dictvalue());
+    }
+
+    Variant *DictionaryBuilder::new_variant() const
+    {
+        return ::google::protobuf::Arena::CreateMessage<Variant>(target_->GetArena());
+    }
+} // namespace humanoid_robot::utils::PB
@@ -0,0 +1,115 @@
+#include "dictionaryDelta.h"
+
+using namespace humanoid_robot::PB::common;
+
+namespace humanoid_robot::utils::PB
+{
+    bool accepts_delta(const Dictionary &params)
+    {
+        auto it = params.keyvaluelist().find(kAcceptDeltaKey);
+        return it != params.keyvaluelist().end() && it->second.value_case() == Variant::kBoolValue && it->second.boolvalue();
+    }
+
+    DeltaEncoder::DeltaEncoder(DeltaOptions options) : options_(options)
+    {
+    }
+
+    bool DeltaEncoder::encode(const Dictionary &snapshot, DictionaryDelta *out)
+    {
+        out->Clear();
+        auto *set = out->mutable_set();
+        auto *state = state_.mutable_keyvaluelist();
+
+        for (const auto &entry : snapshot.keyvaluelist())
+        {
+            if (!hashes_.set(entry.first, entry.second))
+            {
+                continue;
+            }
+            (*set)[entry.first] = entry.second;
+            (*state)[entry.first] = entry.second;
+        }
+
+        // 快照中的 key 都已在 hashes_ 中，数量更多说明有 key 被删除
+        if (hashes_.size() > static_cast<std::size_t>(snapshot.keyvaluelist().size()))
+        {
+            for (const auto &entry : hashes_.entries())
+            {
+                if (snapshot.keyvaluelist().count(entry.first) == 0)
+                {
+                    out->add_remove(entry.first);
+                }
+            }
+            for (const auto &key : out->remove())
+            {
+                hashes_.remove(key);
+                state->erase(key);
+            }
+        }
+
+        const std::size_t changed = static_cast<std::size_t>(set->size() + out->remove_size());
+        if (changed == 0)
+        {
+            return false;
+        }
+
+        ++version_;
+        ++since_keyframe_;
+        if (since_keyframe_ >= options_.keyframe_interval ||
+            static_cast<double>(changed) > options_.keyframe_ratio * static_cast<double>(hashes_.size()))
+        {
+            keyframe(out);
+            since_keyframe_ = 0;
+            return true;
+        }
+        out->set_version(version_);
+        out->set_baseversion(version_ - 1);
+        return true;
+    }
+
+    void DeltaEncoder::keyframe(DictionaryDelta *out) const
+    {
+        out->Clear();
+        out->set_version(version_);
+        out->set_keyframe(true);
+        *out->mutable_set() = state_.keyvaluelist();
+    }
+
+    void apply_delta(const DictionaryDelta &delta, Dictionary *target)
+    {
+        auto *map = target->mutable_keyvaluelist();
+        for (const auto &key : delta.remove())
+        {
+            map->erase(key);
+        }
+        for (const auto &entry : delta.set())
+        {
+            (*map)[entry.first] = entry.second;
+        }
+    }
+
+    DeltaDecoder::Result DeltaDecoder::apply(const DictionaryDelta &delta)
+    {
+        if (synced_ && delta.version() <= version_)
+        {
+            return Result::kStale;
+        }
+        if (delta.keyframe())
+        {
+            state_.Clear();
+            *state_.mutable_keyvaluelist() = delta.set();
+            version_ = delta.version();
+            synced_ = true;
+            return Result::kKeyframe;
+        }
+        if (!synced_ || delta.baseversion() != version_)
+        {
+            synced_ = false;
+            return Result::kGap;
+        }
+        apply_delta(delta, &state_);
+        version_ = delta.version();
+        return Result::kApplied;
+    }
+
+} // namespace humanoid_robot::utils::PB
@@ -0,0 +1,49 @@
+#include "dictionaryLayout.h"
+
+#include <cstring>
+#include <google/protobuf/io/coded_stream.h>
+
+using namespace humanoid_robot::PB::common;
+
+namespace
+{
+    // map<string, Variant> 的线格式：field 1 (LEN) 包含 entry { 1: key, 2: value }
+    constexpr uint8_t kMapEntryTag = (1 << 3) | 2;
+    constexpr uint8_t kEntryKeyTag = (1 << 3) | 2;
+    constexpr uint8_t kEntryValueTag = (2 << 3) | 2;
+
+    uint8_t *write_varint(uint64_t value, uint8_t *p)
+    {
+        return ::google::protobuf::io::CodedOutputStream::WriteVarint64ToArray(value, p);
+    }
+
+    std::size_t varint_size(uint64_t value)
+    {
+        return ::google::protobuf::io::CodedOutputStream::VarintSize64(value);
+    }
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    void append_dictionary_entry(std::string_view key, const Variant &value, std::string *out)
+    {
+        const std::size_t value_size = value.ByteSizeLong();
+        const std::size_t entry_size = 1 + varint_size(key.size()) + key.size() +
+                                       1 + varint_size(value_size) + value_size;
+        const std::size_t total = 1 + varint_size(entry_size) + entry_size;
+
+        const std::size_t offset = out->size();
+        out->resize(offset + total);
+        uint8_t *p = reinterpret_cast<uint8_t *>(&(*out)[offset]);
+
+        *p++ = kMapEntryTag;
+        p = write_varint(entry_size, p);
+        *p++ = kEntryKeyTag;
+        p = write_varint(key.size(), p);
+        std::memcpy(p, key.data(), key.size());
+        p += key.size();
+        *p++ = kEntryValueTag;
+        p = write_varint(value_size, p);
+        value.SerializeWithCachedSizesToArray(p);
+    }
+} // namespace humanoid_robot::utils::PB
@@ -0,0 +1,986 @@
+#include "flightRecorder.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "payloadChecksum.h"
+
+namespace
+{
+    using humanoid_robot::utils::PB::RecordKind;
+
+    constexpr char kSegmentMagic[4] = {'P', 'B', 'F', 'R'};
+    constexpr char kIndexMagic[4] = {'P', 'B', 'F', 'I'};
+    constexpr uint32_t kFormatVersion = 1;
+
+    struct SegmentHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t created_ns;
+        uint64_t reserved[2];
+    };
+
+    struct RecordHeader
+    {
+        uint32_t length; // 负载字节数（不含记录头和对齐填充）
+        uint32_t crc;    // 负载的 CRC32C
+        uint32_t channel;
+        uint16_t kind;
+        uint16_t reserved;
+        uint64_t timestamp;
+        uint64_t sequence;
+    };
+
+    struct IndexHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t record_count;
+        uint32_t channel_count;
+        uint32_t reserved;
+        uint64_t data_bytes; // 索引对应的段文件长度
+    };
+
+    static_assert(sizeof(SegmentHeader) == 32, "segment header layout");
+    static_assert(sizeof(RecordHeader) == 32, "record header layout");
+    static_assert(sizeof(IndexHeader) == 32, "index header layout");
+
+    constexpr std::size_t align8(std::size_t size)
+    {
+        return (size + 7) & ~static_cast<std::size_t>(7);
+    }
+
+    constexpr std::size_t record_size(std::size_t payload_size)
+    {
+        return align8(sizeof(RecordHeader) + payload_size);
+    }
+
+    std::string segment_path(const std::string &directory, const std::string &prefix, uint32_t number, const char *extension)
+    {
+        char suffix[32];
+        std::snprintf(suffix, sizeof(suffix), "-%06" PRIu32 ".%s", number, extension);
+        return directory + "/" + prefix + suffix;
+    }
+
+    // 解析 "<prefix>-NNNNNN.rec"，返回段号，不匹配时返回 0
+    uint32_t parse_segment_number(const std::string &filename, const std::string &prefix)
+    {
+        if (filename.size() != prefix.size() + 11 || filename.compare(0, prefix.size(), prefix) != 0 ||
+            filename[prefix.size()] != '-' || filename.compare(filename.size() - 4, 4, ".rec") != 0)
+        {
+            return 0;
+        }
+        uint32_t number = 0;
+        for (std::size_t i = prefix.size() + 1; i < filename.size() - 4; ++i)
+        {
+            if (filename[i] < '0' || filename[i] > '9')
+            {
+                return 0;
+            }
+            number = number * 10 + static_cast<uint32_t>(filename[i] - '0');
+        }
+        return number;
+    }
+
+    std::vector<uint32_t> list_segments(const std::string &directory, const std::string &prefix)
+    {
+        std::vector<uint32_t> numbers;
+        std::error_code ec;
+        for (const auto &entry : std::filesystem::directory_iterator(directory, ec))
+        {
+            const uint32_t number = parse_segment_number(entry.path().filename().string(), prefix);
+            if (number != 0)
+            {
+                numbers.push_back(number);
+            }
+        }
+        std::sort(numbers.begin(), numbers.end());
+        return numbers;
+    }
+
+    bool write_all(int fd, const char *data, std::size_t size)
+    {
+        while (size > 0)
+        {
+            const ssize_t written = ::write(fd, data, size);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+
+    uint64_t now_ns()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::system_clock::now().time_since_epoch())
+                                         .count());
+    }
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    using humanoid_robot::PB::communication::PAYLOAD_CODEC_NONE;
+    using humanoid_robot::PB::communication::TopicMessage;
+    using humanoid_robot::PB::communication::UniversalRequest;
+
+    struct FlightIndexEntry
+    {
+        uint64_t timestamp;
+        uint64_t sequence;
+        uint64_t offset; // 记录头在段文件中的偏移
+        uint32_t channel;
+        uint16_t kind;
+        uint16_t reserved;
+    };
+    static_assert(sizeof(FlightIndexEntry) == 32, "index entry layout");
+
+    struct FlightChannel
+    {
+        uint32_t id;
+        std::string name; // topic_name '\0' publisher_id
+    };
+
+    // 内存写缓冲块：只属于一个段，按预留顺序写盘
+    struct FlightBlock
+    {
+        std::unique_ptr<char[]> data;
+        std::size_t capacity = 0;
+        std::size_t size = 0;
+        uint32_t segment = 0;
+        std::atomic<uint32_t> writers{0}; // 已预留空间但尚未填完的生产者数
+        std::vector<FlightIndexEntry> index;
+        std::vector<FlightChannel> channels;
+    };
+
+    // ---------------------------------------------------------------- FlightRecorder
+
+    std::unique_ptr<FlightRecorder> FlightRecorder::open(const RecorderOptions &options)
+    {
+        if (options.directory.empty() || options.prefix.empty() || options.block_bytes < sizeof(RecordHeader))
+        {
+            return nullptr;
+        }
+        std::error_code ec;
+        std::filesystem::create_directories(options.directory, ec);
+        if (!std::filesystem::is_directory(options.directory, ec))
+        {
+            return nullptr;
+        }
+        const auto existing = list_segments(options.directory, options.prefix);
+        const uint32_t first = existing.empty() ? 1 : existing.back() + 1;
+        return std::unique_ptr<FlightRecorder>(new FlightRecorder(options, first));
+    }
+
+    FlightRecorder::FlightRecorder(const RecorderOptions &options, uint32_t first_segment)
+        : options_(options), segment_number_(first_segment), segment_offset_(sizeof(SegmentHeader))
+    {
+        writer_ = std::thread([this]
+                              { run(); });
+    }
+
+    FlightRecorder::~FlightRecorder()
+    {
+        close();
+    }
+
+    bool FlightRecorder::record(const TopicMessage &message)
+    {
+        if (!message.shm_segment().empty())
+        {
+            return false;
+        }
+        if (message.name_id() == 0 && message.payload_codec() == PAYLOAD_CODEC_NONE && message.codec_dictionary().empty() &&
+            !message.has_trace())
+        {
+            return append(RecordKind::kTopicMessage, message.topic_name(), message.publisher_id(), message.timestamp(),
+                          message.sequence(), message.payload(), nullptr, message.payload().size());
+        }
+        const std::size_t size = message.ByteSizeLong();
+        return append(RecordKind::kTopicEnvelope, message.topic_name(), message.publisher_id(), message.timestamp(),
+                      message.sequence(), std::string_view(), &message, size);
+    }
+
+    bool FlightRecorder::record(std::string_view channel, const UniversalRequest &request)
+    {
+        const std::size_t size = request.ByteSizeLong();
+        return append(RecordKind::kUniversalRequest, channel, std::string_view(), static_cast<uint64_t>(request.sendrequesttimestamp()),
+                      static_cast<uint64_t>(static_cast<int64_t>(request.requestid())), std::string_view(), &request, size);
+    }
+
+    bool FlightRecorder::record_raw(RecordKind kind, std::string_view topic_name, std::string_view publisher_id,
+                                    uint64_t timestamp, uint64_t sequence, std::string_view payload)
+    {
+        if (kind == RecordKind::kChannel)
+        {
+            return false;
+        }
+        return append(kind, topic_name, publisher_id, timestamp, sequence, payload, nullptr, payload.size());
+    }
+
+    bool FlightRecorder::append(RecordKind kind, std::string_view topic_name, std::string_view publisher_id,
+                                uint64_t timestamp, uint64_t sequence, std::string_view payload,
+                                const google::protobuf::MessageLite *message, std::size_t payload_size)
+    {
+        if (payload_size > UINT32_MAX - sizeof(RecordHeader))
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        FlightBlock *block = nullptr;
+        uint64_t offset = 0;
+        uint32_t channel = 0;
+        char *slot = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_)
+            {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            channel_key_.assign(topic_name.data(), topic_name.size());
+            channel_key_.push_back('\0');
+            channel_key_.append(publisher_id.data(), publisher_id.size());
+            auto found = channels_.find(channel_key_);
+            const std::size_t needed = record_size(payload_size) +
+                                       (found == channels_.end() ? record_size(channel_key_.size()) : 0);
+
+            // 段写满后切换：封存当前块，之后的块属于新段，通道表重新开始
+            if (segment_offset_ > sizeof(SegmentHeader) && segment_offset_ + needed > options_.segment_bytes)
+            {
+                roll_segment();
+                found = channels_.end();
+            }
+
+            if (found == channels_.end())
+            {
+                const uint32_t id = static_cast<uint32_t>(channels_.size());
+                FlightBlock *def_block = nullptr;
+                uint64_t def_offset = 0;
+                char *def = reserve(record_size(channel_key_.size()), &def_block, &def_offset);
+                if (def == nullptr)
+                {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                RecordHeader header{};
+                header.length = static_cast<uint32_t>(channel_key_.size());
+                header.crc = crc32c(channel_key_);
+                header.channel = id;
+                header.kind = static_cast<uint16_t>(RecordKind::kChannel);
+                std::memcpy(def, &header, sizeof(header));
+                std::memcpy(def + sizeof(header), channel_key_.data(), channel_key_.size());
+                std::memset(def + sizeof(header) + channel_key_.size(), 0,
+                            record_size(channel_key_.size()) - sizeof(header) - channel_key_.size());
+                def_block->channels.push_back(FlightChannel{id, channel_key_});
+                found = channels_.emplace(channel_key_, id).first;
+            }
+            channel = found->second;
+
+            slot = reserve(record_size(payload_size), &block, &offset);
+            if (slot == nullptr)
+            {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            block->index.push_back(FlightIndexEntry{timestamp, sequence, offset, channel, static_cast<uint16_t>(kind), 0});
+            block->writers.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // 锁外填充负载：大消息的拷贝与校验不阻塞其他发布者
+        char *body = slot + sizeof(RecordHeader);
+        if (message != nullptr)
+        {
+            message->SerializeWithCachedSizesToArray(reinterpret_cast<uint8_t *>(body));
+        }
+        else if (payload_size > 0)
+        {
+            std::memcpy(body, payload.data(), payload_size);
+        }
+        std::memset(body + payload_size, 0, record_size(payload_size) - sizeof(RecordHeader) - payload_size);
+
+        RecordHeader header{};
+        header.length = static_cast<uint32_t>(payload_size);
+        header.crc = crc32c(body, payload_size);
+        header.channel = channel;
+        header.kind = static_cast<uint16_t>(kind);
+        header.timestamp = timestamp;
+        header.sequence = sequence;
+        std::memcpy(slot, &header, sizeof(header));
+
+        recorded_.fetch_add(1, std::memory_order_relaxed);
+        block->writers.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    // 调用方持有 mutex_。在当前块中预留 size 字节，空间不足时封存并换块；缓冲超限时返回 nullptr
+    char *FlightRecorder::reserve(std::size_t size, FlightBlock **block, uint64_t *offset)
+    {
+        if (current_ && current_->capacity - current_->size < size)
+        {
+            seal_current();
+        }
+        if (!current_)
+        {
+            const std::size_t capacity = std::max(options_.block_bytes, size);
+            if (buffered_bytes_ + capacity > options_.max_buffered_bytes)
+            {
+                return nullptr;
+            }
+            if (capacity == options_.block_bytes && !free_.empty())
+            {
+                current_ = std::move(free_.back());
+                free_.pop_back();
+            }
+            else
+            {
+                current_ = std::make_unique<FlightBlock>();
+                current_->data.reset(new char[capacity]);
+                current_->capacity = capacity;
+            }
+            current_->size = 0;
+            current_->segment = segment_number_;
+            current_->index.clear();
+            current_->channels.clear();
+            buffered_bytes_ += capacity;
+        }
+
+        char *slot = current_->data.get() + current_->size;
+        current_->size += size;
+        *block = current_.get();
+        *offset = segment_offset_;
+        segment_offset_ += size;
+        return slot;
+    }
+
+    // 调用方持有 mutex_
+    bool FlightRecorder::seal_current()
+    {
+        if (!current_)
+        {
+            return false;
+        }
+        if (current_->size == 0)
+        {
+            return false;
+        }
+        sealed_.push_back(std::move(current_));
+        cv_.notify_all();
+        return true;
+    }
+
+    // 调用方持有 mutex_：封存当前块，之后的块属于新段，通道表重新开始
+    void FlightRecorder::roll_segment()
+    {
+        seal_current();
+        ++segment_number_;
+        segment_offset_ = sizeof(SegmentHeader);
+        channels_.clear();
+    }
+
+    void FlightRecorder::flush()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!writer_.joinable())
+        {
+            return;
+        }
+        seal_current();
+        const uint64_t ticket = ++flush_requested_;
+        cv_.notify_all();
+        cv_.wait(lock, [&]
+                 { return flush_completed_ >= ticket; });
+    }
+
+    void FlightRecorder::close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_)
+            {
+                return;
+            }
+            seal_current();
+            running_ = false;
+            cv_.notify_all();
+        }
+        writer_.join();
+        close_segment();
+    }
+
+    void FlightRecorder::run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true)
+        {
+            cv_.wait(lock, [&]
+                     { return !sealed_.empty() || !running_ || flush_completed_ != flush_requested_; });
+            if (sealed_.empty())
+            {
+                flush_completed_ = flush_requested_;
+                cv_.notify_all();
+                if (!running_)
+                {
+                    break;
+                }
+                continue;
+            }
+
+            std::unique_ptr<FlightBlock> block = std::move(sealed_.front());
+            sealed_.pop_front();
+            lock.unlock();
+
+            // 等待已预留空间的生产者填完
+            while (block->writers.load(std::memory_order_acquire) != 0)
+            {
+                std::this_thread::yield();
+            }
+            if (!write_block(block.get()))
+            {
+                const uint64_t lost = block->index.size();
+                recorded_.fetch_sub(lost, std::memory_order_relaxed);
+                dropped_.fetch_add(lost, std::memory_order_relaxed);
+            }
+
+            lock.lock();
+            // 写盘失败的段仍在接收记录时立即切到新段，之后的偏移从新段头开始计算
+            if (block->segment == failed_segment_ && segment_number_ == failed_segment_)
+            {
+                roll_segment();
+            }
+            buffered_bytes_ -= block->capacity;
+            if (block->capacity == options_.block_bytes)
+            {
+                free_.push_back(std::move(block));
+            }
+            if (sealed_.empty() && flush_completed_ != flush_requested_)
+            {
+                flush_completed_ = flush_requested_;
+                cv_.notify_all();
+            }
+        }
+    }
+
+    bool FlightRecorder::write_block(FlightBlock *block)
+    {
+        // 块内索引偏移在预留时按段内位置算好，段中有块没写进去后，同段后续块的偏移都不再成立
+        if (block->segment == failed_segment_)
+        {
+            return false;
+        }
+        if (fd_ < 0 || block->segment != file_segment_)
+        {
+            close_segment();
+            const std::string path = segment_path(options_.directory, options_.prefix, block->segment, "rec");
+            fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd_ < 0)
+            {
+                std::fprintf(stderr, "flight recorder: cannot open %s: %s\n", path.c_str(), std::strerror(errno));
+                failed_segment_ = block->segment;
+                return false;
+            }
+            file_segment_ = block->segment;
+            SegmentHeader header{};
+            std::memcpy(header.magic, kSegmentMagic, sizeof(header.magic));
+            header.version = kFormatVersion;
+            header.created_ns = now_ns();
+            if (!write_all(fd_, reinterpret_cast<const char *>(&header), sizeof(header)))
+            {
+                std::fprintf(stderr, "flight recorder: write failed: %s\n", std::strerror(errno));
+                abandon_segment(0);
+                return false;
+            }
+            bytes_written_.fetch_add(sizeof(header), std::memory_order_relaxed);
+            segments_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        const off_t start = ::lseek(fd_, 0, SEEK_CUR);
+        if (!write_all(fd_, block->data.get(), block->size))
+        {
+            std::fprintf(stderr, "flight recorder: write failed: %s\n", std::strerror(errno));
+            abandon_segment(static_cast<int64_t>(start));
+            return false;
+        }
+        bytes_written_.fetch_add(block->size, std::memory_order_relaxed);
+        segment_index_.insert(segment_index_.end(), block->index.begin(), block->index.end());
+        for (auto &channel : block->channels)
+        {
+            segment_channels_.push_back(std::move(channel));
+        }
+        return true;
+    }
+
+    // 写盘失败：截掉写了一半的块，按已写入的块关闭段，之后属于该段的块全部丢弃
+    void FlightRecorder::abandon_segment(int64_t keep_bytes)
+    {
+        if (keep_bytes >= 0 && ::ftruncate(fd_, static_cast<off_t>(keep_bytes)) != 0)
+        {
+            std::fprintf(stderr, "flight recorder: truncate failed: %s\n", std::strerror(errno));
+        }
+        failed_segment_ = file_segment_;
+        close_segment();
+    }
+
+    // 关闭当前段文件并写出其索引（先写临时文件再改名，读取端不会看到半个索引）
+    void FlightRecorder::close_segment()
+    {
+        if (fd_ < 0)
+        {
+            return;
+        }
+        struct stat st{};
+        const uint64_t data_bytes = ::fstat(fd_, &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+        ::close(fd_);
+        fd_ = -1;
+
+        std::string buffer;
+        IndexHeader header{};
+        std::memcpy(header.magic, kIndexMagic, sizeof(header.magic));
+        header.version = kFormatVersion;
+        header.record_count = segment_index_.size();
+        header.channel_count = static_cast<uint32_t>(segment_channels_.size());
+        header.data_bytes = data_bytes;
+        buffer.append(reinterpret_cast<const char *>(&header), sizeof(header));
+        for (const auto &channel : segment_channels_)
+        {
+            const uint32_t fields[2] = {channel.id, static_cast<uint32_t>(channel.name.size())};
+            buffer.append(reinterpret_cast<const char *>(fields), sizeof(fields));
+            buffer.append(channel.name);
+            buffer.resize(align8(buffer.size()), '\0');
+        }
+        buffer.append(reinterpret_cast<const char *>(segment_index_.data()), segment_index_.size() * sizeof(FlightIndexEntry));
+        segment_index_.clear();
+        segment_channels_.clear();
+
+        const std::string path = segment_path(options_.directory, options_.prefix, file_segment_, "idx");
+        const std::string temp = path + ".tmp";
+        const int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+            return;
+        }
+        const bool ok = write_all(fd, buffer.data(), buffer.size());
+        ::close(fd);
+        if (!ok || std::rename(temp.c_str(), path.c_str()) != 0)
+        {
+            std::remove(temp.c_str());
+        }
+    }
+
+    uint64_t FlightRecorder::recorded() const
+    {
+        return recorded_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t FlightRecorder::dropped() const
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t FlightRecorder::bytes_written() const
+    {
+        return bytes_written_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t FlightRecorder::segments() const
+    {
+        return segments_.load(std::memory_order_relaxed);
+    }
+
+    // ---------------------------------------------------------------- FlightReader
+
+    struct FlightReader::Segment
+    {
+        const char *data = nullptr;
+        std::size_t size = 0;
+        std::vector<std::string> channels; // 按通道号：topic_name '\0' publisher_id
+        std::vector<FlightIndexEntry> index;
+        std::vector<uint64_t> running_max; // index 前缀的最大时间戳，单调不减，用于二分定位
+        uint64_t min_timestamp = UINT64_MAX;
+        uint64_t max_timestamp = 0;
+
+        ~Segment()
+        {
+            if (data != nullptr)
+            {
+                ::munmap(const_cast<char *>(data), size);
+            }
+        }
+
+        bool map(const std::string &path)
+        {
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                return false;
+            }
+            struct stat st{};
+            if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(SegmentHeader))
+            {
+                ::close(fd);
+                return false;
+            }
+            void *mapped = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (mapped == MAP_FAILED)
+            {
+                return false;
+            }
+            data = static_cast<const char *>(mapped);
+            size = static_cast<std::size_t>(st.st_size);
+            ::madvise(mapped, size, MADV_SEQUENTIAL);
+
+            SegmentHeader header;
+            std::memcpy(&header, data, sizeof(header));
+            return std::memcmp(header.magic, kSegmentMagic, sizeof(header.magic)) == 0 && header.version == kFormatVersion;
+        }
+
+        void add_channel(uint32_t id, std::string name)
+        {
+            if (channels.size() <= id)
+            {
+                channels.resize(id + 1);
+            }
+            channels[id] = std::move(name);
+        }
+
+        bool load_index(const std::string &path)
+        {
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                return false;
+            }
+            struct stat st{};
+            std::string buffer;
+            if (::fstat(fd, &st) == 0)
+            {
+                buffer.resize(static_cast<std::size_t>(st.st_size));
+                std::size_t done = 0;
+                while (done < buffer.size())
+                {
+                    const ssize_t n = ::read(fd, &buffer[done], buffer.size() - done);
+                    if (n <= 0)
+                    {
+                        break;
+                    }
+                    done += static_cast<std::size_t>(n);
+                }
+                buffer.resize(done);
+            }
+            ::close(fd);
+
+            IndexHeader header;
+            if (buffer.size() < sizeof(header))
+            {
+                return false;
+            }
+            std::memcpy(&header, buffer.data(), sizeof(header));
+            if (std::memcmp(header.magic, kIndexMagic, sizeof(header.magic)) != 0 || header.version != kFormatVersion ||
+                header.data_bytes > size)
+            {
+                return false;
+            }
+            std::size_t pos = sizeof(header);
+            for (uint32_t i = 0; i < header.channel_count; ++i)
+            {
+                uint32_t fields[2];
+                if (buffer.size() - pos < sizeof(fields))
+                {
+                    return false;
+                }
+                std::memcpy(fields, buffer.data() + pos, sizeof(fields));
+                pos += sizeof(fields);
+                if (buffer.size() - pos < fields[1])
+                {
+                    return false;
+                }
+                add_channel(fields[0], buffer.substr(pos, fields[1]));
+                pos = align8(pos + fields[1]);
+            }
+            if (pos > buffer.size() || (buffer.size() - pos) / sizeof(FlightIndexEntry) != header.record_count)
+            {
+                return false;
+            }
+            index.resize(header.record_count);
+            std::memcpy(index.data(), buffer.data() + pos, index.size() * sizeof(FlightIndexEntry));
+            for (const auto &entry : index)
+            {
+                if (entry.channel >= channels.size() || entry.offset + sizeof(RecordHeader) > header.data_bytes)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // 没有索引（录制进程未正常关闭）时顺序扫描，遇到截断或校验失败的记录即停止
+        void scan()
+        {
+            channels.clear();
+            index.clear();
+            std::size_t offset = sizeof(SegmentHeader);
+            while (size - offset >= sizeof(RecordHeader))
+            {
+                RecordHeader header;
+                std::memcpy(&header, data + offset, sizeof(header));
+                if (header.kind > static_cast<uint16_t>(RecordKind::kTopicEnvelope) ||
+                    header.length > size - offset - sizeof(RecordHeader))
+                {
+                    break;
+                }
+                const char *body = data + offset + sizeof(RecordHeader);
+                if (crc32c(body, header.length) != header.crc)
+                {
+                    break;
+                }
+                if (header.kind == static_cast<uint16_t>(RecordKind::kChannel))
+                {
+                    add_channel(header.channel, std::string(body, header.length));
+                }
+                else if (header.channel < channels.size())
+                {
+                    index.push_back(FlightIndexEntry{header.timestamp, header.sequence, offset, header.channel, header.kind, 0});
+                }
+                offset += record_size(header.length);
+                if (offset > size)
+                {
+                    break;
+                }
+            }
+        }
+
+        void finish()
+        {
+            running_max.resize(index.size());
+            uint64_t max = 0;
+            for (std::size_t i = 0; i < index.size(); ++i)
+            {
+                max = std::max(max, index[i].timestamp);
+                running_max[i] = max;
+                min_timestamp = std::min(min_timestamp, index[i].timestamp);
+            }
+            max_timestamp = max;
+        }
+    };
+
+    std::unique_ptr<FlightReader> FlightReader::open(const std::string &directory, const std::string &prefix,
+                                                     const ReaderOptions &options)
+    {
+        std::unique_ptr<FlightReader> reader(new FlightReader(options));
+        for (uint32_t number : list_segments(directory, prefix))
+        {
+            auto segment = std::make_unique<Segment>();
+            if (!segment->map(segment_path(directory, prefix, number, "rec")))
+            {
+                continue;
+            }
+            if (!segment->load_index(segment_path(directory, prefix, number, "idx")))
+            {
+                segment->scan();
+            }
+            segment->finish();
+            reader->segments_.push_back(std::move(segment));
+        }
+        if (reader->segments_.empty())
+        {
+            return nullptr;
+        }
+        return reader;
+    }
+
+    FlightReader::FlightReader(const ReaderOptions &options) : options_(options)
+    {
+    }
+
+    FlightReader::~FlightReader() = default;
+
+    void FlightReader::set_time_range(uint64_t begin, uint64_t end)
+    {
+        begin_ = begin;
+        end_ = end;
+    }
+
+    void FlightReader::set_topic(std::string_view topic_name)
+    {
+        topic_.assign(topic_name.data(), topic_name.size());
+    }
+
+    void FlightReader::seek(uint64_t timestamp)
+    {
+        segment_ = 0;
+        entry_ = 0;
+        while (segment_ < segments_.size() &&
+               (segments_[segment_]->index.empty() || segments_[segment_]->max_timestamp < timestamp))
+        {
+            ++segment_;
+        }
+        if (segment_ < segments_.size())
+        {
+            const auto &running_max = segments_[segment_]->running_max;
+            entry_ = static_cast<std::size_t>(std::lower_bound(running_max.begin(), running_max.end(), timestamp) - running_max.begin());
+        }
+    }
+
+    bool FlightReader::next(RecordView *out)
+    {
+        for (; segment_ < segments_.size(); ++segment_, entry_ = 0)
+        {
+            const Segment &segment = *segments_[segment_];
+            if (segment.index.empty() || segment.max_timestamp < begin_ || segment.min_timestamp >= end_)
+            {
+                continue;
+            }
+            while (entry_ < segment.index.size())
+            {
+                const FlightIndexEntry &entry = segment.index[entry_++];
+                if (entry.timestamp < begin_ || entry.timestamp >= end_)
+                {
+                    continue;
+                }
+                const std::string &channel = segment.channels[entry.channel];
+                const std::size_t split = channel.find('\0');
+                const std::string_view topic(channel.data(), split == std::string::npos ? channel.size() : split);
+                if (!topic_.empty() && topic != topic_)
+                {
+                    continue;
+                }
+
+                RecordHeader header;
+                std::memcpy(&header, segment.data + entry.offset, sizeof(header));
+                if (header.length > segment.size - entry.offset - sizeof(RecordHeader))
+                {
+                    ++checksum_failures_;
+                    continue;
+                }
+                const char *body = segment.data + entry.offset + sizeof(RecordHeader);
+                if (options_.verify_checksums && crc32c(body, header.length) != header.crc)
+                {
+                    ++checksum_failures_;
+                    continue;
+                }
+
+                out->kind = static_cast<RecordKind>(entry.kind);
+                out->topic_name = topic;
+                out->publisher_id = split == std::string::npos ? std::string_view()
+                                                               : std::string_view(channel).substr(split + 1);
+                out->timestamp = entry.timestamp;
+                out->sequence = entry.sequence;
+                out->payload = std::string_view(body, header.length);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint64_t FlightReader::record_count() const
+    {
+        uint64_t count = 0;
+        for (const auto &segment : segments_)
+        {
+            count += segment->index.size();
+        }
+        return count;
+    }
+
+    uint64_t FlightReader::first_timestamp() const
+    {
+        uint64_t first = UINT64_MAX;
+        for (const auto &segment : segments_)
+        {
+            first = std::min(first, segment->min_timestamp);
+        }
+        return first == UINT64_MAX ? 0 : first;
+    }
+
+    uint64_t FlightReader::last_timestamp() const
+    {
+        uint64_t last = 0;
+        for (const auto &segment : segments_)
+        {
+            last = std::max(last, segment->max_timestamp);
+        }
+        return last;
+    }
+
+    bool to_topic_message(const RecordView &record, TopicMessage *out)
+    {
+        if (record.kind == RecordKind::kTopicEnvelope)
+        {
+            return out->ParseFromArray(record.payload.data(), static_cast<int>(record.payload.size()));
+        }
+        if (record.kind != RecordKind::kTopicMessage)
+        {
+            return false;
+        }
+        out->Clear();
+        out->set_topic_name(record.topic_name.data(), record.topic_name.size());
+        out->set_publisher_id(record.publisher_id.data(), record.publisher_id.size());
+        out->set_timestamp(record.timestamp);
+        out->set_sequence(record.sequence);
+        out->set_payload(record.payload.data(), record.payload.size());
+        return true;
+    }
+
+    bool to_universal_request(const RecordView &record, UniversalRequest *out)
+    {
+        return record.kind == RecordKind::kUniversalRequest &&
+               out->ParseFromArray(record.payload.data(), static_cast<int>(record.payload.size()));
+    }
+
+    uint64_t replay(FlightReader *reader, const ReplayOptions &options,
+                    const std::function<bool(const RecordView &)> &handler)
+    {
+        reader->set_time_range(options.begin, options.end);
+        reader->set_topic(options.topic_name);
+        reader->seek(options.begin);
+
+        using Clock = std::chrono::steady_clock;
+        Clock::time_point start;
+        uint64_t base = 0;
+        uint64_t count = 0;
+        RecordView record;
+        while (reader->next(&record))
+        {
+            if (options.speed > 0)
+            {
+                if (count == 0)
+                {
+                    start = Clock::now();
+                    base = record.timestamp;
+                }
+                else if (record.timestamp > base)
+                {
+                    // 时间戳单位为毫秒；乱序（早于起点）的记录立即回放
+                    const std::chrono::duration<double, std::milli> offset((record.timestamp - base) / options.speed);
+                    std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(offset));
+                }
+            }
+            ++count;
+            if (!handler(record))
+            {
+                break;
+            }
+        }
+        return count;
+    }
+
+} // namespace humanoid_robot::utils::PB
@@ -0,0 +1,177 @@
+#include "frameRateControl.h"
+
+#include <algorithm>
+
+namespace
+{
+    constexpr double kRttAlpha = 0.2;
+    // 相机帧间隔抖动时仍按整帧计数
+    constexpr double kTokenThreshold = 0.9;
+    // 令牌上限：保留跳帧时的小数部分，使实际帧率接近目标帧率
+    constexpr double kTokenBurst = 2.0;
+
+    double to_ms(std::chrono::steady_clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    FrameRateController::FrameRateController(RateControlOptions options)
+        : options_(options), fps_(options.max_fps), mask_hold_(options.mask_hold)
+    {
+        if (options_.stale_after.count() <= 0)
+        {
+            options_.stale_after = options_.target_latency;
+        }
+        options_.max_in_flight = std::max<std::size_t>(1, options_.max_in_flight);
+        options_.min_fps = std::max(0.1, std::min(options_.min_fps, options_.max_fps));
+    }
+
+    FrameDecision FrameRateController::admit(const std::string &time_stamp, bool *requires_masks, Clock::time_point now)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.offered;
+        expire_locked(now);
+
+        // 令牌桶：按当前帧率累积，多余的帧均匀地跳过
+        if (last_offer_ != Clock::time_point())
+        {
+            tokens_ = std::min(kTokenBurst, tokens_ + fps_ * std::chrono::duration<double>(now - last_offer_).count());
+        }
+        last_offer_ = now;
+
+        if (in_flight_.size() >= options_.max_in_flight)
+        {
+            ++stats_.skipped;
+            return FrameDecision::kSkipWindow;
+        }
+        if (tokens_ < kTokenThreshold)
+        {
+            ++stats_.skipped;
+            return FrameDecision::kSkipRate;
+        }
+        tokens_ -= 1.0;
+
+        if (requires_masks != nullptr)
+        {
+            masks_requested_ = masks_requested_ || *requires_masks;
+            *requires_masks = *requires_masks && masks_enabled_;
+        }
+        in_flight_[time_stamp] = now;
+        ++stats_.sent;
+        return FrameDecision::kSend;
+    }
+
+    FrameDecision FrameRateController::admit(humanoid_robot::PB::perception::Img *img, Clock::time_point now)
+    {
+        bool requires_masks = img->requiresmasks();
+        FrameDecision decision = admit(img->timestamp(), &requires_masks, now);
+        img->set_requiresmasks(requires_masks);
+        return decision;
+    }
+
+    bool FrameRateController::complete(const std::string &time_stamp, Clock::time_point now)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = in_flight_.find(time_stamp);
+        if (it == in_flight_.end())
+        {
+            return false;
+        }
+        const Clock::time_point sent = it->second;
+        const Clock::duration rtt = now - sent;
+        in_flight_.erase(it);
+        ++stats_.completed;
+        on_sample_locked(sent, now);
+        if (rtt > options_.stale_after)
+        {
+            ++stats_.stale;
+            return false;
+        }
+        return true;
+    }
+
+    RateControlStats FrameRateController::stats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        RateControlStats stats = stats_;
+        stats.fps = fps_;
+        stats.rtt_ms = rtt_ewma_ms_;
+        stats.masks_enabled = masks_enabled_;
+        stats.in_flight = in_flight_.size();
+        return stats;
+    }
+
+    void FrameRateController::on_sample_locked(Clock::time_point sent, Clock::time_point now)
+    {
+        const Clock::duration rtt = now - sent;
+        const double rtt_ms = to_ms(rtt);
+        rtt_ewma_ms_ = rtt_ewma_ms_ == 0.0 ? rtt_ms : rtt_ewma_ms_ + kRttAlpha * (rtt_ms - rtt_ewma_ms_);
+
+        if (rtt > options_.target_latency)
+        {
+            // 上次降级之前发出的帧仍在排空积压，它们的延迟不再计入
+            if (sent >= last_decrease_)
+            {
+                on_congestion_locked(now);
+            }
+        }
+        else
+        {
+            // 加性增：每个结果增加 increase_fps / fps，约合每秒 increase_fps
+            fps_ = std::min(options_.max_fps, fps_ + options_.increase_fps / std::max(fps_, 1.0));
+            const double target_ms = static_cast<double>(options_.target_latency.count());
+            if (!masks_enabled_ && fps_ >= options_.max_fps && rtt_ewma_ms_ < target_ms * options_.masks_on_ratio &&
+                now - masks_off_since_ >= mask_hold_)
+            {
+                masks_enabled_ = true;
+                masks_on_since_ = now;
+                ++stats_.mask_switches;
+            }
+        }
+    }
+
+    void FrameRateController::on_congestion_locked(Clock::time_point now)
+    {
+        last_decrease_ = now;
+
+        if (masks_enabled_ && masks_requested_)
+        {
+            // 先放弃掩码，只算跟踪；刚恢复掩码就又拥塞时加长下一次的保持时间，避免来回切换
+            if (masks_on_since_ != Clock::time_point() && now - masks_on_since_ < mask_hold_)
+            {
+                mask_hold_ = std::min(mask_hold_ * 2, options_.max_mask_hold);
+            }
+            masks_enabled_ = false;
+            masks_off_since_ = now;
+            ++stats_.mask_switches;
+            return;
+        }
+        fps_ = std::max(options_.min_fps, fps_ * options_.decrease_factor);
+    }
+
+    void FrameRateController::expire_locked(Clock::time_point now)
+    {
+        bool lost = false;
+        for (auto it = in_flight_.begin(); it != in_flight_.end();)
+        {
+            if (now - it->second >= options_.frame_timeout)
+            {
+                it = in_flight_.erase(it);
+                ++stats_.lost;
+                lost = true;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        if (lost)
+        {
+            on_congestion_locked(now);
+        }
+    }
+
+} // namespace humanoid_robot::utils::PB
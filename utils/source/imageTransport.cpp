@@ -0,0 +1,407 @@
+#include "imageTransport.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <google/protobuf/io/coded_stream.h>
+
+using namespace humanoid_robot::PB::common;
+
+namespace
+{
+    // common::Image / perception::Img 的字段号
+    constexpr uint32_t kTimeStampField = 1;
+    constexpr uint32_t kImgField = 2;
+    constexpr uint32_t kRequiresMasksField = 3;
+    constexpr uint32_t kTraceField = 4;
+
+    constexpr uint32_t kWireVarint = 0;
+    constexpr uint32_t kWireFixed64 = 1;
+    constexpr uint32_t kWireLengthDelimited = 2;
+    constexpr uint32_t kWireFixed32 = 5;
+
+    // 跨多个分段顺序读取 protobuf 线格式
+    class ChunkCursor
+    {
+    public:
+        explicit ChunkCursor(const std::vector<std::string_view> &chunks) : chunks_(chunks)
+        {
+            for (const auto &chunk : chunks_)
+            {
+                remaining_ += chunk.size();
+            }
+            skip_empty();
+        }
+
+        bool eof() const { return index_ >= chunks_.size(); }
+        std::size_t remaining() const { return remaining_; }
+
+        bool read_varint(uint64_t *value)
+        {
+            uint64_t result = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                if (eof())
+                {
+                    return false;
+                }
+                const uint8_t byte = static_cast<uint8_t>(chunks_[index_][offset_]);
+                advance(1);
+                result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    *value = result;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // 取出 n 字节的分段视图，不拷贝
+        bool take(std::size_t n, std::vector<std::string_view> *segments)
+        {
+            if (n > remaining_)
+            {
+                return false;
+            }
+            while (n > 0)
+            {
+                if (eof())
+                {
+                    return false;
+                }
+                const std::string_view &chunk = chunks_[index_];
+                const std::size_t len = std::min(n, chunk.size() - offset_);
+                segments->emplace_back(chunk.data() + offset_, len);
+                advance(len);
+                n -= len;
+            }
+            return true;
+        }
+
+        bool copy(std::size_t n, std::string *out)
+        {
+            // 长度来自线上数据，先与剩余字节比较再分配
+            out->clear();
+            if (n > remaining_)
+            {
+                return false;
+            }
+            out->reserve(n);
+            while (n > 0)
+            {
+                if (eof())
+                {
+                    return false;
+                }
+                const std::string_view &chunk = chunks_[index_];
+                const std::size_t len = std::min(n, chunk.size() - offset_);
+                out->append(chunk.data() + offset_, len);
+                advance(len);
+                n -= len;
+            }
+            return true;
+        }
+
+        bool skip(std::size_t n)
+        {
+            if (n > remaining_)
+            {
+                return false;
+            }
+            while (n > 0)
+            {
+                if (eof())
+                {
+                    return false;
+                }
+                const std::size_t len = std::min(n, chunks_[index_].size() - offset_);
+                advance(len);
+                n -= len;
+            }
+            return true;
+        }
+
+    private:
+        void advance(std::size_t n)
+        {
+            remaining_ -= n;
+            offset_ += n;
+            if (offset_ == chunks_[index_].size())
+            {
+                ++index_;
+                offset_ = 0;
+                skip_empty();
+            }
+        }
+
+        void skip_empty()
+        {
+            while (index_ < chunks_.size() && chunks_[index_].empty())
+            {
+                ++index_;
+            }
+        }
+
+        const std::vector<std::string_view> &chunks_;
+        std::size_t index_ = 0;
+        std::size_t offset_ = 0;
+        std::size_t remaining_ = 0;
+    };
+
+    void release_owner(void *user_data)
+    {
+        delete static_cast<std::shared_ptr<const void> *>(user_data);
+    }
+
+    void append_varint(uint64_t value, std::string *out)
+    {
+        uint8_t buf[10];
+        uint8_t *end = ::google::protobuf::io::CodedOutputStream::WriteVarint64ToArray(value, buf);
+        out->append(reinterpret_cast<const char *>(buf), static_cast<std::size_t>(end - buf));
+    }
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    void ImageFrame::attach_image(const char *data, std::size_t size, std::shared_ptr<const void> owner)
+    {
+        segments_.clear();
+        if (size != 0)
+        {
+            segments_.emplace_back(data, size);
+        }
+        image_size_ = size;
+        owner_ = std::move(owner);
+    }
+
+    bool ImageFrame::image_contiguous(std::string_view *out) const
+    {
+        if (segments_.size() > 1)
+        {
+            return false;
+        }
+        *out = segments_.empty() ? std::string_view() : segments_.front();
+        return true;
+    }
+
+    void ImageFrame::copy_image_to(char *dst) const
+    {
+        for (const auto &segment : segments_)
+        {
+            std::memcpy(dst, segment.data(), segment.size());
+            dst += segment.size();
+        }
+    }
+
+    ::grpc::Status ImageFrame::serialize(::grpc::ByteBuffer *out) const
+    {
+        std::string trace;
+        if (has_trace_)
+        {
+            trace_.SerializeToString(&trace);
+        }
+        std::string header;
+        header.reserve(32 + time_stamp_.size() + trace.size());
+        if (!time_stamp_.empty())
+        {
+            append_varint((kTimeStampField << 3) | kWireLengthDelimited, &header);
+            append_varint(time_stamp_.size(), &header);
+            header.append(time_stamp_);
+        }
+        if (requires_masks_)
+        {
+            append_varint((kRequiresMasksField << 3) | kWireVarint, &header);
+            append_varint(1, &header);
+        }
+        if (has_trace_)
+        {
+            append_varint((kTraceField << 3) | kWireLengthDelimited, &header);
+            append_varint(trace.size(), &header);
+            header.append(trace);
+        }
+        if (image_size_ != 0)
+        {
+            append_varint((kImgField << 3) | kWireLengthDelimited, &header);
+            append_varint(image_size_, &header);
+        }
+
+        std::vector<::grpc::Slice> slices;
+        slices.reserve(1 + segments_.size());
+        slices.emplace_back(header);
+        for (const auto &segment : segments_)
+        {
+            // 每个 slice 持有一份 owner 引用，gRPC 发送完毕后释放
+            auto *holder = new std::shared_ptr<const void>(owner_);
+            slices.emplace_back(const_cast<char *>(segment.data()), segment.size(), &release_owner, holder);
+        }
+        ::grpc::ByteBuffer buffer(slices.data(), slices.size());
+        out->Swap(&buffer);
+        return ::grpc::Status::OK;
+    }
+
+    ::grpc::Status ImageFrame::parse(::grpc::ByteBuffer *buffer)
+    {
+        auto slices = std::make_shared<std::vector<::grpc::Slice>>();
+        ::grpc::Status status = buffer->Dump(slices.get());
+        if (!status.ok())
+        {
+            return status;
+        }
+
+        std::vector<std::string_view> chunks;
+        chunks.reserve(slices->size());
+        for (const auto &slice : *slices)
+        {
+            chunks.emplace_back(reinterpret_cast<const char *>(slice.begin()), slice.size());
+        }
+        if (!parse_segments(chunks))
+        {
+            clear();
+            return ::grpc::Status(::grpc::StatusCode::INTERNAL, "malformed Image message");
+        }
+        owner_ = std::move(slices);
+        return ::grpc::Status::OK;
+    }
+
+    bool ImageFrame::parse(const char *data, std::size_t size, std::shared_ptr<const void> owner)
+    {
+        std::vector<std::string_view> chunks{std::string_view(data, size)};
+        if (!parse_segments(chunks))
+        {
+            clear();
+            return false;
+        }
+        owner_ = std::move(owner);
+        return true;
+    }
+
+    bool ImageFrame::parse_segments(const std::vector<std::string_view> &chunks)
+    {
+        clear();
+        ChunkCursor cursor(chunks);
+        std::string bytes;
+        while (!cursor.eof())
+        {
+            uint64_t tag = 0;
+            if (!cursor.read_varint(&tag))
+            {
+                return false;
+            }
+            const uint32_t field = static_cast<uint32_t>(tag >> 3);
+            const uint32_t wire_type = static_cast<uint32_t>(tag & 0x7);
+            uint64_t value = 0;
+
+            if (field == kTimeStampField && wire_type == kWireLengthDelimited)
+            {
+                if (!cursor.read_varint(&value) || !cursor.copy(value, &time_stamp_))
+                {
+                    return false;
+                }
+            }
+            else if (field == kImgField && wire_type == kWireLengthDelimited)
+            {
+                // 与 protobuf 语义一致：重复出现时以最后一次为准
+                segments_.clear();
+                if (!cursor.read_varint(&value) || !cursor.take(value, &segments_))
+                {
+                    return false;
+                }
+                image_size_ = value;
+            }
+            else if (field == kRequiresMasksField && wire_type == kWireVarint)
+            {
+                if (!cursor.read_varint(&value))
+                {
+                    return false;
+                }
+                requires_masks_ = value != 0;
+            }
+            else if (field == kTraceField && wire_type == kWireLengthDelimited)
+            {
+                // 嵌套消息重复出现时按 protobuf 语义合并
+                if (!cursor.read_varint(&value) || !cursor.copy(value, &bytes) || !trace_.MergeFromString(bytes))
+                {
+                    return false;
+                }
+                has_trace_ = true;
+            }
+            else
+            {
+                // 未知字段：按线格式跳过
+                bool ok = false;
+                switch (wire_type)
+                {
+                case kWireVarint:
+                    ok = cursor.read_varint(&value);
+                    break;
+                case kWireFixed64:
+                    ok = cursor.skip(8);
+                    break;
+                case kWireLengthDelimited:
+                    ok = cursor.read_varint(&value) && cursor.skip(value);
+                    break;
+                case kWireFixed32:
+                    ok = cursor.skip(4);
+                    break;
+                default:
+                    ok = false;
+                    break;
+                }
+                if (!ok)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void ImageFrame::to_message(Image *image) const
+    {
+        image->set_timestamp(time_stamp_);
+        image->set_requiresmasks(requires_masks_);
+        if (has_trace_)
+        {
+            *image->mutable_trace() = trace_;
+        }
+        else
+        {
+            image->clear_trace();
+        }
+        std::string *img = image->mutable_img();
+        img->resize(image_size_);
+        if (image_size_ != 0)
+        {
+            copy_image_to(&(*img)[0]);
+        }
+    }
+
+    void ImageFrame::from_message(const Image &image)
+    {
+        time_stamp_ = image.timestamp();
+        requires_masks_ = image.requiresmasks();
+        has_trace_ = image.has_trace();
+        if (has_trace_)
+        {
+            trace_ = image.trace();
+        }
+        else
+        {
+            trace_.Clear();
+        }
+        auto owned = std::make_shared<const std::string>(image.img());
+        attach_image(owned->data(), owned->size(), owned);
+    }
+
+    void ImageFrame::clear()
+    {
+        time_stamp_.clear();
+        requires_masks_ = false;
+        has_trace_ = false;
+        trace_.Clear();
+        image_size_ = 0;
+        segments_.clear();
+        owner_.reset();
+    }
+} // namespace humanoid_robot::utils::PB
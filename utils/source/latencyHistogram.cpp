@@ -0,0 +1,96 @@
+#include "latencyHistogram.h"
+
+#include <algorithm>
+
+namespace
+{
+    std::size_t bucket_index(uint64_t ns)
+    {
+        if (ns < 8)
+        {
+            return static_cast<std::size_t>(ns);
+        }
+        int msb = 3;
+        while ((ns >> (msb + 1)) != 0)
+        {
+            ++msb;
+        }
+        // 每个 [2^msb, 2^(msb+1)) 区间按次高 3 位分成 8 个桶
+        return 8 + static_cast<std::size_t>(msb - 3) * 8 + static_cast<std::size_t>((ns >> (msb - 3)) - 8);
+    }
+
+    uint64_t bucket_upper(std::size_t index)
+    {
+        if (index < 8)
+        {
+            return index;
+        }
+        const std::size_t shift = (index - 8) / 8;
+        const uint64_t lower = static_cast<uint64_t>(8 + (index - 8) % 8) << shift;
+        return lower + (uint64_t(1) << shift) - 1;
+    }
+
+    double to_us(uint64_t ns)
+    {
+        return static_cast<double>(ns) / 1000.0;
+    }
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    void LatencyHistogram::record(std::chrono::nanoseconds value)
+    {
+        record(value.count() > 0 ? static_cast<uint64_t>(value.count()) : uint64_t(0));
+    }
+
+    void LatencyHistogram::record(uint64_t ns)
+    {
+        ++buckets_[bucket_index(ns)];
+        ++count_;
+        total_ns_ += ns;
+        max_ns_ = std::max(max_ns_, ns);
+    }
+
+    void LatencyHistogram::clear()
+    {
+        buckets_.fill(0);
+        count_ = 0;
+        total_ns_ = 0;
+        max_ns_ = 0;
+    }
+
+    std::chrono::nanoseconds LatencyHistogram::percentile(double p) const
+    {
+        if (count_ == 0)
+        {
+            return std::chrono::nanoseconds(0);
+        }
+        const double clamped = std::min(std::max(p, 0.0), 1.0);
+        const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(clamped * static_cast<double>(count_) + 0.5));
+        uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBuckets; ++i)
+        {
+            seen += buckets_[i];
+            if (seen >= target)
+            {
+                return std::chrono::nanoseconds(static_cast<int64_t>(std::min(bucket_upper(i), max_ns_)));
+            }
+        }
+        return std::chrono::nanoseconds(static_cast<int64_t>(max_ns_));
+    }
+
+    StageLatency LatencyHistogram::summary() const
+    {
+        StageLatency latency;
+        latency.count = count_;
+        if (count_ == 0)
+        {
+            return latency;
+        }
+        latency.mean_us = to_us(mean_ns());
+        latency.p50_us = to_us(static_cast<uint64_t>(percentile(0.50).count()));
+        latency.p99_us = to_us(static_cast<uint64_t>(percentile(0.99).count()));
+        latency.max_us = to_us(max_ns_);
+        return latency;
+    }
+} // namespace humanoid_robot::utils::PB
@@ -0,0 +1,298 @@
+#include "maskCodec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace humanoid_robot::PB::common;
+
+namespace
+{
+    // 游程为 uint32，外接矩形面积不得超过其范围
+    constexpr uint64_t kMaxRleArea = std::numeric_limits<uint32_t>::max();
+    // 面积不超过点数的该倍数时使用位图编码，否则按排序后的点直接生成游程
+    constexpr uint64_t kDenseAreaPerPoint = 64;
+
+    // 在 row[begin, end) 中查找第一个与 foreground 不同的位置，找不到返回 end
+    std::size_t find_transition(const uint8_t *row, std::size_t begin, std::size_t end, bool foreground)
+    {
+        std::size_t i = begin;
+#if defined(__SSE2__)
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 16 <= end; i += 16)
+        {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+            // 每字节一位：1 表示该字节为 0（背景）
+            unsigned zeros = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, zero)));
+            const unsigned hits = foreground ? zeros : (~zeros & 0xFFFFu);
+            if (hits != 0)
+            {
+                return i + static_cast<std::size_t>(__builtin_ctz(hits));
+            }
+        }
+#endif
+        for (; i < end; ++i)
+        {
+            if ((row[i] != 0) != foreground)
+            {
+                return i;
+            }
+        }
+        return end;
+    }
+
+    // 逐个前景游程回调 (起始下标, 长度)；游程总长不符时返回 false
+    template <typename Fn>
+    bool for_each_foreground_run(const MaskRle &rle, Fn &&fn)
+    {
+        const uint64_t total = static_cast<uint64_t>(rle.width()) * rle.height();
+        uint64_t pos = 0;
+        bool foreground = false;
+        for (uint32_t count : rle.counts())
+        {
+            if (count > total - pos)
+            {
+                return false;
+            }
+            if (foreground && count != 0)
+            {
+                fn(pos, count);
+            }
+            pos += count;
+            foreground = !foreground;
+        }
+        return pos == total;
+    }
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    void encode_rle(const uint8_t *bitmap, uint32_t width, uint32_t height, std::size_t stride, MaskRle *rle)
+    {
+        rle->set_width(width);
+        rle->set_height(height);
+        auto *counts = rle->mutable_counts();
+        counts->Clear();
+        if (width == 0 || height == 0)
+        {
+            return;
+        }
+
+        bool foreground = false;
+        uint64_t run = 0;
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            const uint8_t *row = bitmap + static_cast<std::size_t>(y) * stride;
+            std::size_t x = 0;
+            while (x < width)
+            {
+                const std::size_t next = find_transition(row, x, width, foreground);
+                run += next - x;
+                x = next;
+                if (x < width)
+                {
+                    counts->Add(static_cast<uint32_t>(run));
+                    run = 0;
+                    foreground = !foreground;
+                }
+            }
+        }
+        counts->Add(static_cast<uint32_t>(run));
+    }
+
+    bool decode_rle(const MaskRle &rle, uint8_t *bitmap)
+    {
+        const uint64_t total = static_cast<uint64_t>(rle.width()) * rle.height();
+        std::memset(bitmap, 0, static_cast<std::size_t>(total));
+        return for_each_foreground_run(rle, [bitmap](uint64_t pos, uint32_t count)
+                                        { std::memset(bitmap + pos, 1, count); });
+    }
+
+    uint64_t rle_area(const MaskRle &rle)
+    {
+        uint64_t area = 0;
+        for (int i = 1; i < rle.counts_size(); i += 2)
+        {
+            area += rle.counts(i);
+        }
+        return area;
+    }
+
+    bool points_to_rle(const int32_t *xy, std::size_t point_count, MaskRle *rle)
+    {
+        rle->Clear();
+        if (point_count == 0)
+        {
+            return true;
+        }
+
+        int32_t min_x = std::numeric_limits<int32_t>::max();
+        int32_t min_y = std::numeric_limits<int32_t>::max();
+        int32_t max_x = std::numeric_limits<int32_t>::min();
+        int32_t max_y = std::numeric_limits<int32_t>::min();
+        for (std::size_t i = 0; i < point_count; ++i)
+        {
+            min_x = std::min(min_x, xy[2 * i]);
+            min_y = std::min(min_y, xy[2 * i + 1]);
+            max_x = std::max(max_x, xy[2 * i]);
+            max_y = std::max(max_y, xy[2 * i + 1]);
+        }
+
+        // 外接矩形在 64 位下计算：跨度可达 2^32，面积须能用 uint32 游程表示
+        const uint64_t span_x = static_cast<uint64_t>(static_cast<int64_t>(max_x) - min_x) + 1;
+        const uint64_t span_y = static_cast<uint64_t>(static_cast<int64_t>(max_y) - min_y) + 1;
+        if (span_x > kMaxRleArea || span_y > kMaxRleArea || span_x * span_y > kMaxRleArea)
+        {
+            return false;
+        }
+        const uint32_t width = static_cast<uint32_t>(span_x);
+        const uint32_t height = static_cast<uint32_t>(span_y);
+        const uint64_t area = span_x * span_y;
+
+        if (area <= kDenseAreaPerPoint * point_count)
+        {
+            // 点集较密：位图 + SIMD 游程编码
+            std::vector<uint8_t> bitmap(static_cast<std::size_t>(area), 0);
+            for (std::size_t i = 0; i < point_count; ++i)
+            {
+                const std::size_t x = static_cast<std::size_t>(static_cast<int64_t>(xy[2 * i]) - min_x);
+                const std::size_t y = static_cast<std::size_t>(static_cast<int64_t>(xy[2 * i + 1]) - min_y);
+                bitmap[y * width + x] = 1;
+            }
+            encode_rle(bitmap.data(), width, height, width, rle);
+        }
+        else
+        {
+            // 点集稀疏：按行优先下标排序后直接生成游程，内存只与点数有关
+            std::vector<uint64_t> positions(point_count);
+            for (std::size_t i = 0; i < point_count; ++i)
+            {
+                const uint64_t x = static_cast<uint64_t>(static_cast<int64_t>(xy[2 * i]) - min_x);
+                const uint64_t y = static_cast<uint64_t>(static_cast<int64_t>(xy[2 * i + 1]) - min_y);
+                positions[i] = y * width + x;
+            }
+            std::sort(positions.begin(), positions.end());
+            positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+
+            rle->set_width(width);
+            rle->set_height(height);
+            auto *counts = rle->mutable_counts();
+            uint64_t covered = 0;
+            for (std::size_t i = 0; i < positions.size();)
+            {
+                std::size_t j = i + 1;
+                while (j < positions.size() && positions[j] == positions[j - 1] + 1)
+                {
+                    ++j;
+                }
+                counts->Add(static_cast<uint32_t>(positions[i] - covered));
+                counts->Add(static_cast<uint32_t>(j - i));
+                covered = positions[j - 1] + 1;
+                i = j;
+            }
+            // 与 encode_rle 一致：以前景结束时不追加 0 长度的背景游程
+            if (covered < area)
+            {
+                counts->Add(static_cast<uint32_t>(area - covered));
+            }
+        }
+        rle->set_originx(min_x);
+        rle->set_originy(min_y);
+        return true;
+    }
+
+    bool rle_to_points(const MaskRle &rle, std::vector<int32_t> *xy, std::size_t max_points)
+    {
+        xy->clear();
+        // 先校验游程总长再按前景像素数预留：counts 来自线上，不可信
+        if (!for_each_foreground_run(rle, [](uint64_t, uint32_t) {}))
+        {
+            return false;
+        }
+        const uint64_t area = rle_area(rle);
+        if (area > max_points)
+        {
+            return false;
+        }
+        xy->reserve(2 * static_cast<std::size_t>(area));
+        const uint32_t width = rle.width();
+        const int32_t origin_x = rle.originx();
+        const int32_t origin_y = rle.originy();
+
+        auto emit_run = [&](uint64_t pos, uint32_t count)
+        {
+            uint32_t x = static_cast<uint32_t>(pos % width);
+            uint32_t y = static_cast<uint32_t>(pos / width);
+            for (uint32_t k = 0; k < count; ++k)
+            {
+                xy->push_back(origin_x + static_cast<int32_t>(x));
+                xy->push_back(origin_y + static_cast<int32_t>(y));
+                if (++x == width)
+                {
+                    x = 0;
+                    ++y;
+                }
+            }
+        };
+
+        if (!for_each_foreground_run(rle, emit_run))
+        {
+            xy->clear();
+            return false;
+        }
+        return true;
+    }
+
+    void encode_contour(const int32_t *xy, std::size_t point_count, MaskContour *contour)
+    {
+        auto *deltas = contour->mutable_deltas();
+        deltas->Clear();
+        if (point_count == 0)
+        {
+            return;
+        }
+        const std::size_t n = 2 * point_count;
+        deltas->Resize(static_cast<int>(n), 0);
+        int32_t *out = deltas->mutable_data();
+        out[0] = xy[0];
+        out[1] = xy[1];
+        // 以无符号运算避免有符号溢出，解码端同样按 2^32 取模还原
+        for (std::size_t i = 2; i < n; ++i)
+        {
+            out[i] = static_cast<int32_t>(static_cast<uint32_t>(xy[i]) - static_cast<uint32_t>(xy[i - 2]));
+        }
+    }
+
+    void decode_contour(const MaskContour &contour, int32_t *xy)
+    {
+        const std::size_t n = 2 * contour_point_count(contour);
+        const int32_t *in = contour.deltas().data();
+        std::size_t i = 0;
+#if defined(__SSE2__)
+        // 每次处理两个点 [dx0, dy0, dx1, dy1]：块内前缀和后加上一块的末点
+        __m128i carry = _mm_setzero_si128();
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+            v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+            v = _mm_add_epi32(v, carry);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(xy + i), v);
+            carry = _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 2, 3, 2));
+        }
+#endif
+        uint32_t x = i >= 2 ? static_cast<uint32_t>(xy[i - 2]) : 0;
+        uint32_t y = i >= 2 ? static_cast<uint32_t>(xy[i - 1]) : 0;
+        for (; i < n; i += 2)
+        {
+            x += static_cast<uint32_t>(in[i]);
+            y += static_cast<uint32_t>(in[i + 1]);
+            xy[i] = static_cast<int32_t>(x);
+            xy[i + 1] = static_cast<int32_t>(y);
+        }
+    }
+} // namespace humanoid_robot::utils::PB
@@ -0,0 +1,242 @@
+#include "nameRouting.h"
+
+#include <random>
+
+using namespace humanoid_robot::PB::communication;
+
+namespace
+{
+    constexpr uint32_t kMaxServices = 1u << 12;
+
+    uint64_t random_epoch()
+    {
+        std::random_device device;
+        const uint64_t epoch = static_cast<uint64_t>(device()) & 0xFFFFFFFFULL;
+        return (epoch == 0 ? 1 : epoch) << 32;
+    }
+
+    std::string route_key(const ServiceRequest &request)
+    {
+        std::string key;
+        key.reserve(request.service_name().size() + request.client_id().size() + request.node_name().size() + 2);
+        key += request.service_name();
+        key.push_back('\0');
+        key += request.client_id();
+        key.push_back('\0');
+        key += request.node_name();
+        return key;
+    }
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    // ---------------------------------------------------------------- RpcRouter
+
+    RpcRouter::RpcRouter(uint32_t max_routes) : epoch_(random_epoch()), services_(kMaxServices), routes_(max_routes)
+    {
+    }
+
+    uint32_t RpcRouter::add_service(const std::string &service_name, RpcHandler handler)
+    {
+        return services_.intern(service_name, [&]() { return std::move(handler); });
+    }
+
+    const RpcRoute *RpcRouter::resolve(const ServiceRequest &request, ServiceResponse *response)
+    {
+        if (!request.service_name().empty())
+        {
+            by_name_.fetch_add(1, std::memory_order_relaxed);
+            const uint32_t service = services_.find(request.service_name());
+            if (service == 0)
+            {
+                unknown_service_.fetch_add(1, std::memory_order_relaxed);
+                response->set_error_message("unknown service: " + request.service_name());
+                return nullptr;
+            }
+            const uint32_t id = routes_.intern(route_key(request), [&]()
+                                               { return RpcRoute{request.service_name(), request.client_id(), request.node_name(), service}; });
+            if (id == 0)
+            {
+                // 路由表已满：本次按名称处理，不下发 route_id
+                thread_local RpcRoute overflow;
+                overflow = RpcRoute{request.service_name(), request.client_id(), request.node_name(), service};
+                return &overflow;
+            }
+            response->set_route_id(epoch_ | id);
+            return routes_.get(id);
+        }
+
+        if (request.route_id() != 0)
+        {
+            const RpcRoute *route = nullptr;
+            if ((request.route_id() & 0xFFFFFFFF00000000ULL) == epoch_)
+            {
+                route = routes_.get(static_cast<uint32_t>(request.route_id()));
+            }
+            if (route == nullptr)
+            {
+                unknown_route_.fetch_add(1, std::memory_order_relaxed);
+                response->set_unknown_route(true);
+                response->set_error_message("unknown route id");
+                return nullptr;
+            }
+            by_id_.fetch_add(1, std::memory_order_relaxed);
+            return route;
+        }
+
+        unknown_service_.fetch_add(1, std::memory_order_relaxed);
+        response->set_error_message("missing service_name");
+        return nullptr;
+    }
+
+    grpc::Status RpcRouter::dispatch(const ServiceRequest &request, ServiceResponse *response)
+    {
+        response->set_request_id(request.request_id());
+        const RpcRoute *route = resolve(request, response);
+        if (route == nullptr)
+        {
+            response->set_success(false);
+            return grpc::Status::OK;
+        }
+        return (*services_.get(route->service))(*route, request, response);
+    }
+
+    RpcRouterStats RpcRouter::stats() const
+    {
+        RpcRouterStats stats;
+        stats.by_name = by_name_.load(std::memory_order_relaxed);
+        stats.by_id = by_id_.load(std::memory_order_relaxed);
+        stats.unknown_route = unknown_route_.load(std::memory_order_relaxed);
+        stats.unknown_service = unknown_service_.load(std::memory_order_relaxed);
+        stats.routes = routes_.size();
+        return stats;
+    }
+
+    // ---------------------------------------------------------------- RoutedRpcService
+
+    RoutedRpcService::RoutedRpcService(RpcRouter *router) : router_(router)
+    {
+    }
+
+    grpc::Status RoutedRpcService::Call(grpc::ServerContext *, const ServiceRequest *request, ServiceResponse *response)
+    {
+        return router_->dispatch(*request, response);
+    }
+
+    // ---------------------------------------------------------------- RpcRouteHandle
+
+    RpcRouteHandle::RpcRouteHandle(std::string service_name, std::string client_id, std::string node_name)
+        : service_name_(std::move(service_name)), client_id_(std::move(client_id)), node_name_(std::move(node_name))
+    {
+    }
+
+    void RpcRouteHandle::prepare(ServiceRequest *request) const
+    {
+        const uint64_t id = route_id_.load(std::memory_order_relaxed);
+        if (id != 0)
+        {
+            request->clear_service_name();
+            request->clear_client_id();
+            request->clear_node_name();
+            request->set_route_id(id);
+            return;
+        }
+        request->set_service_name(service_name_);
+        request->set_client_id(client_id_);
+        request->set_node_name(node_name_);
+        request->set_route_id(0);
+    }
+
+    bool RpcRouteHandle::on_response(const ServiceResponse &response)
+    {
+        if (response.unknown_route())
+        {
+            route_id_.store(0, std::memory_order_relaxed);
+            return true;
+        }
+        if (response.route_id() != 0)
+        {
+            route_id_.store(response.route_id(), std::memory_order_relaxed);
+        }
+        return false;
+    }
+
+    // ---------------------------------------------------------------- TopicNameEncoder / TopicNameDecoder
+
+    TopicNameEncoder::TopicNameEncoder(const SubscribeRequest &request) : enabled_(request.accept_name_ids())
+    {
+    }
+
+    void TopicNameEncoder::stamp(const std::string &topic_name, const std::string &publisher_id, TopicMessage *message)
+    {
+        if (!enabled_)
+        {
+            message->set_topic_name(topic_name);
+            message->set_publisher_id(publisher_id);
+            return;
+        }
+
+        // 一条流上通常只有一组名称，先比较上一次的，不做哈希
+        auto matches = [&](uint32_t id)
+        {
+            const TopicNames &names = sent_[id - 1];
+            return names.topic_name == topic_name && names.publisher_id == publisher_id;
+        };
+        uint32_t id = last_ != 0 && matches(last_) ? last_ : 0;
+        for (uint32_t i = 1; id == 0 && i <= sent_.size(); ++i)
+        {
+            id = matches(i) ? i : 0;
+        }
+
+        if (id != 0)
+        {
+            message->clear_topic_name();
+            message->clear_publisher_id();
+        }
+        else
+        {
+            sent_.push_back(TopicNames{topic_name, publisher_id});
+            id = static_cast<uint32_t>(sent_.size());
+            message->set_topic_name(topic_name);
+            message->set_publisher_id(publisher_id);
+        }
+        message->set_name_id(id);
+        last_ = id;
+    }
+
+    uint32_t TopicNameDecoder::observe(TopicMessage *message, bool restore_names)
+    {
+        const uint32_t id = message->name_id();
+        if (id == 0)
+        {
+            return 0;
+        }
+        if (!message->topic_name().empty() || !message->publisher_id().empty())
+        {
+            // Publisher 按顺序分配 id，跳号的 id 不登记，避免被异常消息撑大
+            if (id <= names_.size() + 1)
+            {
+                if (id > names_.size())
+                {
+                    names_.emplace_back();
+                }
+                names_[id - 1] = TopicNames{message->topic_name(), message->publisher_id()};
+            }
+        }
+        else if (restore_names)
+        {
+            if (const TopicNames *names = this->names(id))
+            {
+                message->set_topic_name(names->topic_name);
+                message->set_publisher_id(names->publisher_id);
+            }
+        }
+        return id;
+    }
+
+    const TopicNames *TopicNameDecoder::names(uint32_t name_id) const
+    {
+        return name_id == 0 || name_id > names_.size() ? nullptr : &names_[name_id - 1];
+    }
+
+} // namespace humanoid_robot::utils::PB
@@ -0,0 +1,86 @@
+#include "packedArrayUtil.h"
+
+#include <limits>
+
+using namespace humanoid_robot::PB::common;
+
+namespace
+{
+    template <typename Legacy, typename Packed>
+    bool legacy_to_packed(const Legacy &legacy, Packed *packed)
+    {
+        using T = humanoid_robot::utils::PB::packed_value_t<Packed>;
+        const auto &values = legacy.values();
+        for (const auto v : values)
+        {
+            const int64_t wide = static_cast<int64_t>(v);
+            if (wide < std::numeric_limits<T>::min() || wide > std::numeric_limits<T>::max())
+            {
+                return false;
+            }
+        }
+
+        std::string *raw = packed->mutable_values();
+        raw->resize(static_cast<std::size_t>(values.size()) * sizeof(T));
+        char *p = &(*raw)[0];
+        for (const auto v : values)
+        {
+            humanoid_robot::utils::PB::detail::store_le<T>(p, static_cast<T>(v));
+            p += sizeof(T);
+        }
+        return true;
+    }
+
+    template <typename Packed, typename Legacy>
+    void packed_to_legacy(const Packed &packed, Legacy *legacy)
+    {
+        auto *values = legacy->mutable_values();
+        values->Clear();
+        values->Reserve(static_cast<int>(humanoid_robot::utils::PB::packed_size(packed)));
+        humanoid_robot::utils::PB::packed_for_each(packed, [values](auto v)
+                                                   { values->AddAlreadyReserved(v); });
+    }
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    bool to_packed(const Int8Array &legacy, PackedInt8Array *packed)
+    {
+        return legacy_to_packed(legacy, packed);
+    }
+
+    bool to_packed(const UInt8Array &legacy, PackedUInt8Array *packed)
+    {
+        return legacy_to_packed(legacy, packed);
+    }
+
+    bool to_packed(const Int16Array &legacy, PackedInt16Array *packed)
+    {
+        return legacy_to_packed(legacy, packed);
+    }
+
+    bool to_packed(const UInt16Array &legacy, PackedUInt16Array *packed)
+    {
+        return legacy_to_packed(legacy, packed);
+    }
+
+    void to_legacy(const PackedInt8Array &packed, Int8Array *legacy)
+    {
+        packed_to_legacy(packed, legacy);
+    }
+
+    void to_legacy(const PackedUInt8Array &packed, UInt8Array *legacy)
+    {
+        packed_to_legacy(packed, legacy);
+    }
+
+    void to_legacy(const PackedInt16Array &packed, Int16Array *legacy)
+    {
+        packed_to_legacy(packed, legacy);
+    }
+
+    void to_legacy(const PackedUInt16Array &packed, UInt16Array *legacy)
+    {
+        packed_to_legacy(packed, legacy);
+    }
+} // namespace humanoid_robot::utils::PB
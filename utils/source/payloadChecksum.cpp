@@ -0,0 +1,326 @@
+#include "payloadChecksum.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <nmmintrin.h>
+#define PB_CRC32C_X86 1
+#elif defined(__aarch64__) && defined(__linux__)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#define PB_CRC32C_ARM 1
+#endif
+
+namespace
+{
+    constexpr uint32_t kPoly = 0x82F63B78u; // Castagnoli，反射形式
+
+    // 三路交错：crc32 指令延迟约 3 周期、吞吐 1 周期，三个独立流可以填满流水线，
+    // 各流结果再通过“移过 N 个零字节”的线性变换合并
+    constexpr std::size_t kLongBlock = 8192;
+    constexpr std::size_t kShortBlock = 256;
+
+    uint32_t gf2_matrix_times(const uint32_t *mat, uint32_t vec)
+    {
+        uint32_t sum = 0;
+        while (vec != 0)
+        {
+            if (vec & 1)
+            {
+                sum ^= *mat;
+            }
+            vec >>= 1;
+            ++mat;
+        }
+        return sum;
+    }
+
+    void gf2_matrix_square(uint32_t *square, const uint32_t *mat)
+    {
+        for (int n = 0; n < 32; ++n)
+        {
+            square[n] = gf2_matrix_times(mat, mat[n]);
+        }
+    }
+
+    // 生成 crc 后接 len 个零字节的变换矩阵
+    void zeros_operator(uint32_t *even, std::size_t len)
+    {
+        uint32_t odd[32];
+        odd[0] = kPoly; // 一个零比特
+        uint32_t row = 1;
+        for (int n = 1; n < 32; ++n)
+        {
+            odd[n] = row;
+            row <<= 1;
+        }
+        gf2_matrix_square(even, odd); // 2 个零比特
+        gf2_matrix_square(odd, even); // 4 个零比特
+        // 每次平方后零比特数翻倍，第一次得到一个零字节
+        do
+        {
+            gf2_matrix_square(even, odd);
+            len >>= 1;
+            if (len == 0)
+            {
+                return;
+            }
+            gf2_matrix_square(odd, even);
+            len >>= 1;
+        } while (len != 0);
+        std::memcpy(even, odd, sizeof(odd));
+    }
+
+    struct ShiftTable
+    {
+        uint32_t t[4][256];
+
+        explicit ShiftTable(std::size_t len)
+        {
+            uint32_t op[32];
+            zeros_operator(op, len);
+            for (uint32_t n = 0; n < 256; ++n)
+            {
+                t[0][n] = gf2_matrix_times(op, n);
+                t[1][n] = gf2_matrix_times(op, n << 8);
+                t[2][n] = gf2_matrix_times(op, n << 16);
+                t[3][n] = gf2_matrix_times(op, n << 24);
+            }
+        }
+
+        uint32_t shift(uint32_t crc) const
+        {
+            return t[0][crc & 0xFF] ^ t[1][(crc >> 8) & 0xFF] ^ t[2][(crc >> 16) & 0xFF] ^ t[3][crc >> 24];
+        }
+    };
+
+    struct SlicingTable
+    {
+        uint32_t t[8][256];
+
+        SlicingTable()
+        {
+            for (uint32_t n = 0; n < 256; ++n)
+            {
+                uint32_t crc = n;
+                for (int k = 0; k < 8; ++k)
+                {
+                    crc = (crc & 1) ? (crc >> 1) ^ kPoly : crc >> 1;
+                }
+                t[0][n] = crc;
+            }
+            for (uint32_t n = 0; n < 256; ++n)
+            {
+                for (int k = 1; k < 8; ++k)
+                {
+                    t[k][n] = (t[k - 1][n] >> 8) ^ t[0][t[k - 1][n] & 0xFF];
+                }
+            }
+        }
+    };
+
+    const SlicingTable &slicing_table()
+    {
+        static const SlicingTable table;
+        return table;
+    }
+
+    uint64_t load64(const uint8_t *p)
+    {
+        uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint32_t extend_table(uint32_t crc, const uint8_t *p, std::size_t size)
+    {
+        const auto &t = slicing_table().t;
+        crc = ~crc;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        for (; size >= 8; size -= 8, p += 8)
+        {
+            // 小端序下低 4 字节与 crc 异或
+            const uint64_t word = load64(p) ^ crc;
+            crc = t[7][word & 0xFF] ^ t[6][(word >> 8) & 0xFF] ^ t[5][(word >> 16) & 0xFF] ^
+                  t[4][(word >> 24) & 0xFF] ^ t[3][(word >> 32) & 0xFF] ^ t[2][(word >> 40) & 0xFF] ^
+                  t[1][(word >> 48) & 0xFF] ^ t[0][word >> 56];
+        }
+#endif
+        for (; size > 0; --size, ++p)
+        {
+            crc = (crc >> 8) ^ t[0][(crc ^ *p) & 0xFF];
+        }
+        return ~crc;
+    }
+
+    const ShiftTable &long_shift()
+    {
+        static const ShiftTable table(kLongBlock);
+        return table;
+    }
+
+    const ShiftTable &short_shift()
+    {
+        static const ShiftTable table(kShortBlock);
+        return table;
+    }
+
+#if defined(PB_CRC32C_X86)
+    __attribute__((target("sse4.2"))) uint32_t extend_hw(uint32_t crc, const uint8_t *p, std::size_t size)
+    {
+        const ShiftTable &long_table = long_shift();
+        const ShiftTable &short_table = short_shift();
+        uint64_t crc0 = ~crc;
+        for (; size > 0 && (reinterpret_cast<uintptr_t>(p) & 7) != 0; --size, ++p)
+        {
+            crc0 = _mm_crc32_u8(static_cast<uint32_t>(crc0), *p);
+        }
+#if defined(__x86_64__)
+        for (; size >= 3 * kLongBlock; size -= 3 * kLongBlock, p += 3 * kLongBlock)
+        {
+            uint64_t crc1 = 0;
+            uint64_t crc2 = 0;
+            for (std::size_t i = 0; i < kLongBlock; i += 8)
+            {
+                crc0 = _mm_crc32_u64(crc0, load64(p + i));
+                crc1 = _mm_crc32_u64(crc1, load64(p + kLongBlock + i));
+                crc2 = _mm_crc32_u64(crc2, load64(p + 2 * kLongBlock + i));
+            }
+            crc0 = long_table.shift(static_cast<uint32_t>(crc0)) ^ crc1;
+            crc0 = long_table.shift(static_cast<uint32_t>(crc0)) ^ crc2;
+        }
+        for (; size >= 3 * kShortBlock; size -= 3 * kShortBlock, p += 3 * kShortBlock)
+        {
+            uint64_t crc1 = 0;
+            uint64_t crc2 = 0;
+            for (std::size_t i = 0; i < kShortBlock; i += 8)
+            {
+                crc0 = _mm_crc32_u64(crc0, load64(p + i));
+                crc1 = _mm_crc32_u64(crc1, load64(p + kShortBlock + i));
+                crc2 = _mm_crc32_u64(crc2, load64(p + 2 * kShortBlock + i));
+            }
+            crc0 = short_table.shift(static_cast<uint32_t>(crc0)) ^ crc1;
+            crc0 = short_table.shift(static_cast<uint32_t>(crc0)) ^ crc2;
+        }
+        for (; size >= 8; size -= 8, p += 8)
+        {
+            crc0 = _mm_crc32_u64(crc0, load64(p));
+        }
+#else
+        (void)long_table;
+        (void)short_table;
+#endif
+        for (; size > 0; --size, ++p)
+        {
+            crc0 = _mm_crc32_u8(static_cast<uint32_t>(crc0), *p);
+        }
+        return ~static_cast<uint32_t>(crc0);
+    }
+
+    bool hw_supported()
+    {
+        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+        return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_SSE4_2) != 0;
+    }
+
+    constexpr const char *kHwName = "sse4.2";
+#elif defined(PB_CRC32C_ARM)
+    __attribute__((target("+crc"))) uint32_t extend_hw(uint32_t crc, const uint8_t *p, std::size_t size)
+    {
+        const ShiftTable &long_table = long_shift();
+        const ShiftTable &short_table = short_shift();
+        uint32_t crc0 = ~crc;
+        for (; size > 0 && (reinterpret_cast<uintptr_t>(p) & 7) != 0; --size, ++p)
+        {
+            crc0 = __crc32cb(crc0, *p);
+        }
+        for (; size >= 3 * kLongBlock; size -= 3 * kLongBlock, p += 3 * kLongBlock)
+        {
+            uint32_t crc1 = 0;
+            uint32_t crc2 = 0;
+            for (std::size_t i = 0; i < kLongBlock; i += 8)
+            {
+                crc0 = __crc32cd(crc0, load64(p + i));
+                crc1 = __crc32cd(crc1, load64(p + kLongBlock + i));
+                crc2 = __crc32cd(crc2, load64(p + 2 * kLongBlock + i));
+            }
+            crc0 = long_table.shift(crc0) ^ crc1;
+            crc0 = long_table.shift(crc0) ^ crc2;
+        }
+        for (; size >= 3 * kShortBlock; size -= 3 * kShortBlock, p += 3 * kShortBlock)
+        {
+            uint32_t crc1 = 0;
+            uint32_t crc2 = 0;
+            for (std::size_t i = 0; i < kShortBlock; i += 8)
+            {
+                crc0 = __crc32cd(crc0, load64(p + i));
+                crc1 = __crc32cd(crc1, load64(p + kShortBlock + i));
+                crc2 = __crc32cd(crc2, load64(p + 2 * kShortBlock + i));
+            }
+            crc0 = short_table.shift(crc0) ^ crc1;
+            crc0 = short_table.shift(crc0) ^ crc2;
+        }
+        for (; size >= 8; size -= 8, p += 8)
+        {
+            crc0 = __crc32cd(crc0, load64(p));
+        }
+        for (; size > 0; --size, ++p)
+        {
+            crc0 = __crc32cb(crc0, *p);
+        }
+        return ~crc0;
+    }
+
+    bool hw_supported()
+    {
+        return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+    }
+
+    constexpr const char *kHwName = "armv8-crc";
+#endif
+
+    using ExtendFn = uint32_t (*)(uint32_t, const uint8_t *, std::size_t);
+
+    struct Dispatch
+    {
+        ExtendFn extend = extend_table;
+        const char *name = "table";
+
+        Dispatch()
+        {
+#if defined(PB_CRC32C_X86) || defined(PB_CRC32C_ARM)
+            if (hw_supported())
+            {
+                extend = extend_hw;
+                name = kHwName;
+            }
+#endif
+        }
+    };
+
+    const Dispatch &dispatch()
+    {
+        static const Dispatch instance;
+        return instance;
+    }
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    uint32_t crc32c_extend(uint32_t crc, const void *data, std::size_t size)
+    {
+        return dispatch().extend(crc, static_cast<const uint8_t *>(data), size);
+    }
+
+    uint32_t crc32c_extend_portable(uint32_t crc, const void *data, std::size_t size)
+    {
+        return extend_table(crc, static_cast<const uint8_t *>(data), size);
+    }
+
+    const char *crc32c_implementation()
+    {
+        return dispatch().name;
+    }
+} // namespace humanoid_robot::utils::PB
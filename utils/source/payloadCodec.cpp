@@ -0,0 +1,524 @@
+#include "payloadCodec.h"
+
+#include <algorithm>
+#include <climits>
+
+#if defined(PB_HAS_LZ4)
+#include <lz4.h>
+#endif
+#if defined(PB_HAS_ZSTD)
+#include <zdict.h>
+#include <zstd.h>
+#endif
+
+using namespace humanoid_robot::PB::communication;
+
+namespace
+{
+    // ZDICT 样本太少时训练不出有效字典
+    constexpr std::size_t kMinTrainSamples = 8;
+
+#if defined(PB_HAS_LZ4)
+    // LZ4 block 不含原始长度，负载以 varint 原始长度开头
+    constexpr std::size_t kMaxVarint = 10;
+
+    std::size_t put_varint(char *out, uint64_t value)
+    {
+        std::size_t size = 0;
+        while (value >= 0x80)
+        {
+            out[size++] = static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        out[size++] = static_cast<char>(value);
+        return size;
+    }
+
+    bool get_varint(std::string_view *in, uint64_t *value)
+    {
+        uint64_t result = 0;
+        for (std::size_t i = 0; i < in->size() && i < kMaxVarint; ++i)
+        {
+            const auto byte = static_cast<uint8_t>((*in)[i]);
+            result |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+            if ((byte & 0x80) == 0)
+            {
+                *value = result;
+                in->remove_prefix(i + 1);
+                return true;
+            }
+        }
+        return false;
+    }
+#endif
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    // ---------------------------------------------------------------- 协商
+
+    std::vector<PayloadCodec> available_codecs()
+    {
+        std::vector<PayloadCodec> codecs;
+#if defined(PB_HAS_LZ4)
+        codecs.push_back(PAYLOAD_CODEC_LZ4);
+#endif
+#if defined(PB_HAS_ZSTD)
+        codecs.push_back(PAYLOAD_CODEC_ZSTD);
+#endif
+        return codecs;
+    }
+
+    bool codec_available(PayloadCodec codec)
+    {
+        const std::vector<PayloadCodec> codecs = available_codecs();
+        return codec == PAYLOAD_CODEC_NONE || std::find(codecs.begin(), codecs.end(), codec) != codecs.end();
+    }
+
+    void advertise_codecs(google::protobuf::RepeatedField<int> *accept_codecs)
+    {
+        accept_codecs->Clear();
+        for (PayloadCodec codec : available_codecs())
+        {
+            accept_codecs->Add(codec);
+        }
+    }
+
+    PayloadCodec negotiate_codec(PayloadCodec preferred, const google::protobuf::RepeatedField<int> &accept_codecs)
+    {
+        if (preferred == PAYLOAD_CODEC_NONE)
+        {
+            return PAYLOAD_CODEC_NONE;
+        }
+        auto peer_accepts = [&](PayloadCodec codec)
+        { return std::find(accept_codecs.begin(), accept_codecs.end(), static_cast<int>(codec)) != accept_codecs.end(); };
+        if (codec_available(preferred) && peer_accepts(preferred))
+        {
+            return preferred;
+        }
+        for (PayloadCodec codec : available_codecs())
+        {
+            if (peer_accepts(codec))
+            {
+                return codec;
+            }
+        }
+        return PAYLOAD_CODEC_NONE;
+    }
+
+    // ---------------------------------------------------------------- ZstdDictionary
+
+    struct ZstdDictionary::Impl
+    {
+#if defined(PB_HAS_ZSTD)
+        ZSTD_CDict *cdict = nullptr;
+        ZSTD_DDict *ddict = nullptr;
+
+        ~Impl()
+        {
+            ZSTD_freeCDict(cdict);
+            ZSTD_freeDDict(ddict);
+        }
+#endif
+    };
+
+    ZstdDictionary::ZstdDictionary(std::string content, uint32_t id, std::unique_ptr<Impl> impl)
+        : content_(std::move(content)), id_(id), impl_(std::move(impl))
+    {
+    }
+
+    ZstdDictionary::~ZstdDictionary() = default;
+
+    std::shared_ptr<const ZstdDictionary> ZstdDictionary::train(const std::vector<std::string> &samples, std::size_t capacity, int level)
+    {
+#if defined(PB_HAS_ZSTD)
+        if (samples.size() < kMinTrainSamples)
+        {
+            return nullptr;
+        }
+        std::string buffer;
+        std::vector<size_t> sizes;
+        sizes.reserve(samples.size());
+        for (const auto &sample : samples)
+        {
+            buffer += sample;
+            sizes.push_back(sample.size());
+        }
+        std::string content(capacity, '\0');
+        const size_t size = ZDICT_trainFromBuffer(content.data(), content.size(), buffer.data(), sizes.data(),
+                                                  static_cast<unsigned>(sizes.size()));
+        if (ZDICT_isError(size))
+        {
+            return nullptr;
+        }
+        content.resize(size);
+        return load(content, level);
+#else
+        (void)samples;
+        (void)capacity;
+        (void)level;
+        return nullptr;
+#endif
+    }
+
+    std::shared_ptr<const ZstdDictionary> ZstdDictionary::load(std::string_view content, int level)
+    {
+#if defined(PB_HAS_ZSTD)
+        // 没有 dictID 的原始内容字典无法从 frame 头识别，不接受
+        const uint32_t id = ZSTD_getDictID_fromDict(content.data(), content.size());
+        if (id == 0)
+        {
+            return nullptr;
+        }
+        auto impl = std::make_unique<Impl>();
+        impl->cdict = ZSTD_createCDict(content.data(), content.size(), level);
+        impl->ddict = ZSTD_createDDict(content.data(), content.size());
+        if (impl->cdict == nullptr || impl->ddict == nullptr)
+        {
+            return nullptr;
+        }
+        return std::shared_ptr<const ZstdDictionary>(new ZstdDictionary(std::string(content), id, std::move(impl)));
+#else
+        (void)content;
+        (void)level;
+        return nullptr;
+#endif
+    }
+
+    // ---------------------------------------------------------------- PayloadCompressor
+
+    struct PayloadCompressor::Contexts
+    {
+#if defined(PB_HAS_LZ4)
+        std::vector<char> lz4_state = std::vector<char>(static_cast<std::size_t>(LZ4_sizeofState()));
+#endif
+#if defined(PB_HAS_ZSTD)
+        ZSTD_CCtx *zstd = ZSTD_createCCtx();
+
+        ~Contexts() { ZSTD_freeCCtx(zstd); }
+#endif
+    };
+
+    PayloadCompressor::PayloadCompressor(CodecOptions options)
+        : options_(options), contexts_(std::make_unique<Contexts>())
+    {
+    }
+
+    PayloadCompressor::~PayloadCompressor() = default;
+
+    void PayloadCompressor::set_dictionary(std::shared_ptr<const ZstdDictionary> dictionary)
+    {
+        dictionary_ = std::move(dictionary);
+        samples_.clear();
+    }
+
+    PayloadCodec PayloadCompressor::compress(std::string_view raw, std::string *out)
+    {
+        const PayloadCodec codec = encode(raw, out);
+        if (codec == PAYLOAD_CODEC_NONE)
+        {
+            out->assign(raw.data(), raw.size());
+        }
+        return codec;
+    }
+
+    void PayloadCompressor::compress(TopicMessage *message)
+    {
+        std::string out;
+        const PayloadCodec codec = encode(message->payload(), &out);
+        if (codec != PAYLOAD_CODEC_NONE)
+        {
+            message->set_payload(std::move(out));
+        }
+        message->set_payload_codec(codec);
+        message->clear_codec_dictionary();
+        if (codec == PAYLOAD_CODEC_ZSTD && dictionary_ && announced_dictionary_ != dictionary_->id())
+        {
+            message->set_codec_dictionary(dictionary_->content());
+            announced_dictionary_ = dictionary_->id();
+            stats_.wire_bytes += dictionary_->content().size();
+        }
+    }
+
+    void PayloadCompressor::compress(UniversalRequest *request)
+    {
+        std::string out;
+        const PayloadCodec codec = encode(request->payload(), &out);
+        if (codec != PAYLOAD_CODEC_NONE)
+        {
+            request->set_payload(std::move(out));
+        }
+        request->set_payloadcodec(codec);
+    }
+
+    void PayloadCompressor::compress(UniversalResponse *response)
+    {
+        std::string out;
+        const PayloadCodec codec = encode(response->payload(), &out);
+        if (codec != PAYLOAD_CODEC_NONE)
+        {
+            response->set_payload(std::move(out));
+        }
+        response->set_payloadcodec(codec);
+    }
+
+    void PayloadCompressor::compress(ServiceRequest *request)
+    {
+        std::string out;
+        const PayloadCodec codec = encode(request->payload(), &out);
+        if (codec != PAYLOAD_CODEC_NONE)
+        {
+            request->set_payload(std::move(out));
+        }
+        request->set_payload_codec(codec);
+    }
+
+    void PayloadCompressor::compress(ServiceResponse *response)
+    {
+        std::string out;
+        const PayloadCodec codec = encode(response->payload(), &out);
+        if (codec != PAYLOAD_CODEC_NONE)
+        {
+            response->set_payload(std::move(out));
+        }
+        response->set_payload_codec(codec);
+    }
+
+    PayloadCodec PayloadCompressor::encode(std::string_view raw, std::string *out)
+    {
+        ++stats_.messages;
+        stats_.raw_bytes += raw.size();
+
+        PayloadCodec codec = codec_available(options_.codec) ? options_.codec : PAYLOAD_CODEC_NONE;
+        if (codec != PAYLOAD_CODEC_NONE && raw.size() < options_.min_size)
+        {
+            ++stats_.below_threshold;
+            codec = PAYLOAD_CODEC_NONE;
+        }
+
+        std::size_t size = 0;
+#if defined(PB_HAS_LZ4)
+        if (codec == PAYLOAD_CODEC_LZ4 && raw.size() <= static_cast<std::size_t>(INT_MAX / 2))
+        {
+            const int bound = LZ4_compressBound(static_cast<int>(raw.size()));
+            out->resize(kMaxVarint + static_cast<std::size_t>(bound));
+            const std::size_t header = put_varint(out->data(), raw.size());
+            const int written = LZ4_compress_fast_extState(contexts_->lz4_state.data(), raw.data(), out->data() + header,
+                                                           static_cast<int>(raw.size()), bound, 1);
+            size = written > 0 ? header + static_cast<std::size_t>(written) : 0;
+        }
+#endif
+#if defined(PB_HAS_ZSTD)
+        if (codec == PAYLOAD_CODEC_ZSTD)
+        {
+            collect_sample(raw);
+            out->resize(ZSTD_compressBound(raw.size()));
+            const size_t written =
+                dictionary_ ? ZSTD_compress_usingCDict(contexts_->zstd, out->data(), out->size(), raw.data(), raw.size(),
+                                                       dictionary_->impl_->cdict)
+                            : ZSTD_compressCCtx(contexts_->zstd, out->data(), out->size(), raw.data(), raw.size(), options_.zstd_level);
+            size = ZSTD_isError(written) ? 0 : written;
+        }
+#endif
+
+        if (codec != PAYLOAD_CODEC_NONE && (size == 0 || size >= raw.size()))
+        {
+            ++stats_.no_gain;
+            codec = PAYLOAD_CODEC_NONE;
+        }
+        if (codec == PAYLOAD_CODEC_NONE)
+        {
+            stats_.wire_bytes += raw.size();
+            return PAYLOAD_CODEC_NONE;
+        }
+        out->resize(size);
+        ++stats_.compressed;
+        stats_.wire_bytes += size;
+        return codec;
+    }
+
+    void PayloadCompressor::collect_sample(std::string_view raw)
+    {
+        if (options_.train_samples == 0 || dictionary_)
+        {
+            return;
+        }
+        samples_.emplace_back(raw);
+        if (samples_.size() < std::max(options_.train_samples, kMinTrainSamples))
+        {
+            return;
+        }
+        dictionary_ = ZstdDictionary::train(samples_, options_.dictionary_capacity, options_.zstd_level);
+        if (!dictionary_)
+        {
+            // 负载不适合训练（例如过于随机），之后不再收集
+            options_.train_samples = 0;
+        }
+        samples_.clear();
+        samples_.shrink_to_fit();
+    }
+
+    // ---------------------------------------------------------------- PayloadDecompressor
+
+    struct PayloadDecompressor::Contexts
+    {
+#if defined(PB_HAS_ZSTD)
+        ZSTD_DCtx *zstd = ZSTD_createDCtx();
+
+        ~Contexts() { ZSTD_freeDCtx(zstd); }
+#endif
+    };
+
+    PayloadDecompressor::PayloadDecompressor(std::size_t max_payload)
+        : max_payload_(max_payload), contexts_(std::make_unique<Contexts>())
+    {
+    }
+
+    PayloadDecompressor::~PayloadDecompressor() = default;
+
+    void PayloadDecompressor::add_dictionary(std::shared_ptr<const ZstdDictionary> dictionary)
+    {
+        if (dictionary)
+        {
+            const uint32_t id = dictionary->id();
+            dictionaries_[id] = std::move(dictionary);
+        }
+    }
+
+    bool PayloadDecompressor::decompress(PayloadCodec codec, std::string_view wire, std::string *out)
+    {
+        switch (codec)
+        {
+        case PAYLOAD_CODEC_NONE:
+            out->assign(wire.data(), wire.size());
+            return true;
+#if defined(PB_HAS_LZ4)
+        case PAYLOAD_CODEC_LZ4:
+        {
+            uint64_t size = 0;
+            if (!get_varint(&wire, &size) || size > max_payload_ || size > static_cast<uint64_t>(INT_MAX) ||
+                wire.size() > static_cast<std::size_t>(INT_MAX))
+            {
+                return false;
+            }
+            out->resize(static_cast<std::size_t>(size));
+            const int read = LZ4_decompress_safe(wire.data(), out->data(), static_cast<int>(wire.size()), static_cast<int>(size));
+            return read >= 0 && static_cast<uint64_t>(read) == size;
+        }
+#endif
+#if defined(PB_HAS_ZSTD)
+        case PAYLOAD_CODEC_ZSTD:
+        {
+            const unsigned long long size = ZSTD_getFrameContentSize(wire.data(), wire.size());
+            if (size == ZSTD_CONTENTSIZE_UNKNOWN || size == ZSTD_CONTENTSIZE_ERROR || size > max_payload_)
+            {
+                return false;
+            }
+            const ZSTD_DDict *ddict = nullptr;
+            if (const unsigned id = ZSTD_getDictID_fromFrame(wire.data(), wire.size()); id != 0)
+            {
+                auto it = dictionaries_.find(id);
+                if (it == dictionaries_.end())
+                {
+                    return false;
+                }
+                ddict = it->second->impl_->ddict;
+            }
+            out->resize(static_cast<std::size_t>(size));
+            const size_t read = ddict != nullptr
+                                    ? ZSTD_decompress_usingDDict(contexts_->zstd, out->data(), out->size(), wire.data(), wire.size(), ddict)
+                                    : ZSTD_decompressDCtx(contexts_->zstd, out->data(), out->size(), wire.data(), wire.size());
+            return !ZSTD_isError(read) && read == size;
+        }
+#endif
+        default:
+            return false;
+        }
+    }
+
+    bool PayloadDecompressor::decompress(TopicMessage *message)
+    {
+        if (!message->codec_dictionary().empty())
+        {
+            add_dictionary(ZstdDictionary::load(message->codec_dictionary()));
+            message->clear_codec_dictionary();
+        }
+        if (message->payload_codec() == PAYLOAD_CODEC_NONE)
+        {
+            return true;
+        }
+        std::string out;
+        if (!decompress(message->payload_codec(), message->payload(), &out))
+        {
+            return false;
+        }
+        message->set_payload(std::move(out));
+        message->set_payload_codec(PAYLOAD_CODEC_NONE);
+        return true;
+    }
+
+    bool PayloadDecompressor::decompress(UniversalRequest *request)
+    {
+        if (request->payloadcodec() == PAYLOAD_CODEC_NONE)
+        {
+            return true;
+        }
+        std::string out;
+        if (!decompress(request->payloadcodec(), request->payload(), &out))
+        {
+            return false;
+        }
+        request->set_payload(std::move(out));
+        request->set_payloadcodec(PAYLOAD_CODEC_NONE);
+        return true;
+    }
+
+    bool PayloadDecompressor::decompress(UniversalResponse *response)
+    {
+        if (response->payloadcodec() == PAYLOAD_CODEC_NONE)
+        {
+            return true;
+        }
+        std::string out;
+        if (!decompress(response->payloadcodec(), response->payload(), &out))
+        {
+            return false;
+        }
+        response->set_payload(std::move(out));
+        response->set_payloadcodec(PAYLOAD_CODEC_NONE);
+        return true;
+    }
+
+    bool PayloadDecompressor::decompress(ServiceRequest *request)
+    {
+        if (request->payload_codec() == PAYLOAD_CODEC_NONE)
+        {
+            return true;
+        }
+        std::string out;
+        if (!decompress(request->payload_codec(), request->payload(), &out))
+        {
+            return false;
+        }
+        request->set_payload(std::move(out));
+        request->set_payload_codec(PAYLOAD_CODEC_NONE);
+        return true;
+    }
+
+    bool PayloadDecompressor::decompress(ServiceResponse *response)
+    {
+        if (response->payload_codec() == PAYLOAD_CODEC_NONE)
+        {
+            return true;
+        }
+        std::string out;
+        if (!decompress(response->payload_codec(), response->payload(), &out))
+        {
+            return false;
+        }
+        response->set_payload(std::move(out));
+        response->set_payload_codec(PAYLOAD_CODEC_NONE);
+        return true;
+    }
+
+} // namespace humanoid_robot::utils::PB
@@ -0,0 +1,440 @@
+#include "perceptionPipeline.h"
+#include "spanTracer.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::PB::perception;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // 阶段之间的无界队列；客户端的在途上限决定了队列实际长度
+    template <typename T>
+    class BlockingQueue
+    {
+    public:
+        void push(T value)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                items_.push_back(std::move(value));
+            }
+            cv_.notify_one();
+        }
+
+        // 队列关闭且已取空时返回 false
+        bool pop(T *out)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return !items_.empty() || closed_; });
+            if (items_.empty())
+            {
+                return false;
+            }
+            *out = std::move(items_.front());
+            items_.pop_front();
+            return true;
+        }
+
+        void close()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                closed_ = true;
+            }
+            cv_.notify_all();
+        }
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::deque<T> items_;
+        bool closed_ = false;
+    };
+
+    struct Job
+    {
+        uint64_t sequence = 0;
+        humanoid_robot::utils::PB::PerceptionFrame frame;
+        bool failed = false;
+        Clock::time_point received;
+        Clock::duration decode{0};
+        Clock::time_point decoded;
+        Clock::duration queue{0};
+        Clock::duration infer{0};
+        Clock::duration encode{0};
+    };
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    // ---------------------------------------------------------------- 服务端
+
+    // 单个 GetPerceptionResult 调用的流水线：调用线程读取，decode / infer / encode 各自的线程处理
+    class PerceptionPipelineService::StreamPipeline
+    {
+    public:
+        StreamPipeline(PerceptionPipelineService *service, grpc::ServerReaderWriter<Perception, Image> *stream)
+            : service_(service), stream_(stream)
+        {
+        }
+
+        void run()
+        {
+            std::thread decoder(&StreamPipeline::decode_loop, this);
+            std::vector<std::thread> inferers;
+            for (int i = 0; i < std::max(1, service_->options_.infer_workers); ++i)
+            {
+                inferers.emplace_back(&StreamPipeline::infer_loop, this);
+            }
+            std::thread encoder(&StreamPipeline::encode_loop, this);
+
+            uint64_t sequence = 0;
+            auto job = std::make_unique<Job>();
+            while (stream_->Read(&job->frame.image))
+            {
+                job->sequence = sequence++;
+                job->received = Clock::now();
+                decode_queue_.push(std::move(job));
+                job = std::make_unique<Job>();
+            }
+
+            // 客户端结束写入（或断开）后依次排空各阶段
+            decode_queue_.close();
+            decoder.join();
+            infer_queue_.close();
+            for (auto &thread : inferers)
+            {
+                thread.join();
+            }
+            encode_queue_.close();
+            encoder.join();
+        }
+
+    private:
+        void decode_loop()
+        {
+            std::unique_ptr<Job> job;
+            while (decode_queue_.pop(&job))
+            {
+                const Clock::time_point start = Clock::now();
+                job->failed = !service_->stages_->decode(job->frame);
+                job->decoded = Clock::now();
+                job->decode = job->decoded - start;
+                (job->failed ? encode_queue_ : infer_queue_).push(std::move(job));
+            }
+        }
+
+        void infer_loop()
+        {
+            std::unique_ptr<Job> job;
+            while (infer_queue_.pop(&job))
+            {
+                const Clock::time_point start = Clock::now();
+                job->queue = start - job->decoded;
+                job->failed = !service_->stages_->infer(job->frame);
+                job->infer = Clock::now() - start;
+                encode_queue_.push(std::move(job));
+            }
+        }
+
+        void encode_loop()
+        {
+            std::unique_ptr<Job> job;
+            while (encode_queue_.pop(&job))
+            {
+                if (!job->failed)
+                {
+                    const Clock::time_point start = Clock::now();
+                    job->failed = !service_->stages_->encode(job->frame);
+                    job->encode = Clock::now() - start;
+                }
+                if (job->failed)
+                {
+                    job->frame.result.Clear();
+                }
+                job->frame.result.set_timestamp(job->frame.image.timestamp());
+                if (job->frame.image.has_trace() && !job->frame.result.has_trace())
+                {
+                    // 结果沿用图像的追踪上下文（失败帧也保留），追加从收到图像到编码完成的感知阶段
+                    auto *trace = job->frame.result.mutable_trace();
+                    trace->Swap(job->frame.image.mutable_trace());
+                    const auto received = std::chrono::duration_cast<std::chrono::nanoseconds>(job->received.time_since_epoch());
+                    add_hop(trace, TRACE_STAGE_PERCEPTION, static_cast<uint64_t>(received.count()), trace_clock_ns());
+                }
+
+                if (!service_->options_.ordered)
+                {
+                    write(*job);
+                    continue;
+                }
+                // 保序模式：先完成的帧暂存，等前面的帧写出
+                reorder_.emplace(job->sequence, std::move(job));
+                for (auto it = reorder_.begin(); it != reorder_.end() && it->first == next_sequence_; it = reorder_.begin())
+                {
+                    write(*it->second);
+                    reorder_.erase(it);
+                    ++next_sequence_;
+                }
+            }
+        }
+
+        void write(const Job &job)
+        {
+            // 客户端已断开时写入失败，继续排空即可
+            stream_->Write(job.frame.result);
+
+            std::lock_guard<std::mutex> lock(service_->stats_mutex_);
+            ++service_->frames_;
+            service_->failed_ += job.failed ? 1 : 0;
+            service_->decode_.record(job.decode);
+            if (job.infer.count() > 0)
+            {
+                service_->queue_.record(job.queue);
+                service_->infer_.record(job.infer);
+            }
+            if (job.encode.count() > 0)
+            {
+                service_->encode_.record(job.encode);
+            }
+            service_->total_.record(Clock::now() - job.received);
+        }
+
+        PerceptionPipelineService *service_;
+        grpc::ServerReaderWriter<Perception, Image> *stream_;
+        BlockingQueue<std::unique_ptr<Job>> decode_queue_;
+        BlockingQueue<std::unique_ptr<Job>> infer_queue_;
+        BlockingQueue<std::unique_ptr<Job>> encode_queue_;
+        std::map<uint64_t, std::unique_ptr<Job>> reorder_;
+        uint64_t next_sequence_ = 0;
+    };
+
+    PerceptionPipelineService::PerceptionPipelineService(PerceptionStages *stages, PipelineServerOptions options)
+        : stages_(stages), options_(options)
+    {
+    }
+
+    grpc::Status PerceptionPipelineService::GetPerceptionResult(grpc::ServerContext *context,
+                                                                grpc::ServerReaderWriter<Perception, Image> *stream)
+    {
+        StreamPipeline pipeline(this, stream);
+        pipeline.run();
+        if (context->IsCancelled())
+        {
+            return grpc::Status::CANCELLED;
+        }
+        return grpc::Status::OK;
+    }
+
+    PipelineServerStats PerceptionPipelineService::stats() const
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        PipelineServerStats stats;
+        stats.frames = frames_;
+        stats.failed = failed_;
+        stats.decode = decode_.summary();
+        stats.queue = queue_.summary();
+        stats.infer = infer_.summary();
+        stats.encode = encode_.summary();
+        stats.total = total_.summary();
+        return stats;
+    }
+
+    // ---------------------------------------------------------------- 客户端
+
+    PerceptionPipelineClient::PerceptionPipelineClient(PerceptionService::Stub *stub, ResultCallback on_result,
+                                                       PipelineClientOptions options)
+        : stub_(stub), on_result_(std::move(on_result)), options_(options)
+    {
+        options_.max_in_flight = std::max<std::size_t>(1, options_.max_in_flight);
+        options_.queue_depth = std::max<std::size_t>(1, options_.queue_depth);
+    }
+
+    PerceptionPipelineClient::~PerceptionPipelineClient()
+    {
+        bool started = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            started = started_;
+        }
+        if (started)
+        {
+            context_.TryCancel();
+            close();
+        }
+    }
+
+    void PerceptionPipelineClient::start()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (started_ || stream_)
+        {
+            return;
+        }
+        stream_ = stub_->GetPerceptionResult(&context_);
+        started_ = true;
+        writer_ = std::thread(&PerceptionPipelineClient::write_loop, this);
+        reader_ = std::thread(&PerceptionPipelineClient::read_loop, this);
+    }
+
+    bool PerceptionPipelineClient::submit(Image image)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!started_ || closing_ || broken_)
+        {
+            return false;
+        }
+        ++stats_.submitted;
+        if (queue_.size() >= options_.queue_depth)
+        {
+            if (options_.drop_oldest)
+            {
+                // 推理跟不上时优先处理最新的画面
+                queue_.pop_front();
+                ++stats_.dropped;
+            }
+            else
+            {
+                cv_.wait(lock, [this]() { return queue_.size() < options_.queue_depth || closing_ || broken_; });
+                if (closing_ || broken_)
+                {
+                    return false;
+                }
+            }
+        }
+        queue_.push_back(Pending{std::move(image), Clock::now()});
+        cv_.notify_all();
+        return true;
+    }
+
+    grpc::Status PerceptionPipelineClient::close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!started_)
+            {
+                return grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, "pipeline not started");
+            }
+            closing_ = true;
+        }
+        cv_.notify_all();
+        writer_.join();
+        reader_.join();
+        grpc::Status status = stream_->Finish();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.lost += in_flight_.size();
+        in_flight_.clear();
+        started_ = false;
+        return status;
+    }
+
+    PipelineClientStats PerceptionPipelineClient::stats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        PipelineClientStats stats = stats_;
+        stats.in_flight = in_flight_.size();
+        stats.round_trip = round_trip_.summary();
+        return stats;
+    }
+
+    void PerceptionPipelineClient::write_loop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!broken_)
+        {
+            const Clock::time_point now = Clock::now();
+            expire_locked(now);
+            if (!queue_.empty() && in_flight_.size() < options_.max_in_flight)
+            {
+                Pending pending = std::move(queue_.front());
+                queue_.pop_front();
+                // 先登记再写入，结果不会早于登记到达
+                in_flight_.emplace(pending.image.timestamp(), InFlight{pending.submitted, now});
+                ++stats_.sent;
+                cv_.notify_all();
+
+                lock.unlock();
+                const bool ok = stream_->Write(pending.image);
+                lock.lock();
+                if (!ok)
+                {
+                    broken_ = true;
+                }
+                continue;
+            }
+            if (closing_ && queue_.empty())
+            {
+                break;
+            }
+
+            // 等待新帧、在途名额或最早一帧超时
+            Clock::time_point wake = now + options_.frame_timeout;
+            for (const auto &entry : in_flight_)
+            {
+                wake = std::min(wake, entry.second.sent + options_.frame_timeout);
+            }
+            cv_.wait_until(lock, wake);
+        }
+        cv_.notify_all();
+        lock.unlock();
+        stream_->WritesDone();
+    }
+
+    void PerceptionPipelineClient::read_loop()
+    {
+        Perception result;
+        while (stream_->Read(&result))
+        {
+            const Clock::time_point now = Clock::now();
+            FrameTiming timing;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = in_flight_.find(result.timestamp());
+                if (it == in_flight_.end())
+                {
+                    ++stats_.unmatched;
+                    continue;
+                }
+                timing.queued = std::chrono::duration_cast<std::chrono::microseconds>(it->second.sent - it->second.submitted);
+                timing.round_trip = std::chrono::duration_cast<std::chrono::microseconds>(now - it->second.sent);
+                round_trip_.record(now - it->second.sent);
+                in_flight_.erase(it);
+                ++stats_.completed;
+            }
+            cv_.notify_all();
+            if (on_result_)
+            {
+                on_result_(result, timing);
+            }
+        }
+
+        // 服务端结束了调用：后续 submit 直接失败
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            broken_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    void PerceptionPipelineClient::expire_locked(Clock::time_point now)
+    {
+        for (auto it = in_flight_.begin(); it != in_flight_.end();)
+        {
+            if (now - it->second.sent >= options_.frame_timeout)
+            {
+                it = in_flight_.erase(it);
+                ++stats_.lost;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+} // namespace humanoid_robot::utils::PB
@@ -1,117 +1,33 @@
 #include "printUtil.h"
+#include "variantFormatter.h"
 
 using namespace humanoid_robot::utils::PB;
 using namespace humanoid_robot::PB::common;
 
-#define CASE_PRINT(VARIANT_TYPE, VARIANT_FUNC)                             \
-    case humanoid_robot::PB::common::Variant::K##VARIANT_TYPE##Value:      \
-    {                                                                      \
-        std::cout << #VARIANT_TYPE << ": " << VARIANT_FUNC() << std::endl; \
-        break;                                                             \
-    }
-
-#define CASE_PRINT_ARRAY(VARIANT_TYPE, VARIANT_FUNC)                       \
-    case humanoid_robot::PB::common::Variant::K##VARIANT_TYPE##ArrayValue: \
-    {                                                                      \
-        std::cout << #VARIANT_TYPE " Array: ";                             \
-        auto &array = VARIANT_FUNC();                                      \
-        for (const auto &item : array)                                     \
-        {                                                                  \
-            std::cout << item << " ";                                      \
-        }                                                                  \
-        std::cout << std::endl;                                            \
-        break;                                                             \
-    }
-
-#define CASE_PRINT_DATE(VARIANT_TYPE, VARIANT_FUNC)                   \
-    case humanoid_robot::PB::common::Variant::K##VARIANT_TYPE##Value: \
-    {                                                                 \
-        auto &date = VARIANT_FUNC();                                  \
-        std::cout << #VARIANT_TYPE << ": "                            \
-                  << date.year() << "-"                               \
-                  << date.month() << "-"                              \
-                  << date.day() << std::endl;                         \
-        break;                                                        \
-    }
-
-#define CASE_PRINT_TIMESTAMP(VARIANT_TYPE, VARIANT_FUNC)              \
-    case humanoid_robot::PB::common::Variant::K##VARIANT_TYPE##Value: \
-    {                                                                 \
-        auto &timestamp = VARIANT_FUNC();                             \
-        std::cout << #VARIANT_TYPE << ": "                            \
-                  << timestamp.seconds() << "."                       \
-                  << timestamp.nanos() << std::endl;                  \
-        break;                                                        \
-    }
-
-#define CASE_PRINT_DICT(VARIANT_TYPE, VARIANT_FUNC)                    \
-    case humanoid_robot::PB::common::Variant::K##VARIANT_TYPE##Value:  \
-    {                                                                  \
-        auto map = VARIANT_FUNC();                                     \
-        std::cout << #VARIANT_TYPE << ": "                             \
-                  << map.keyvaluelist_size() << " items" << std::endl; \
-        for (const auto &item : map.keyvaluelist())                    \
-        {                                                              \
-            std::cout << "  " << item.first << ": ";                   \
-            ::humanoid_robot::utils::PB::print_variant(item.second);   \
-        }                                                              \
-        break;                                                         \
-    }
-
 namespace humanoid_robot::utils::PB
 {
-    // 用于打印Variant的不同类型
+    // 用于打印Variant的不同类型：先格式化到线程内复用的缓冲区，再一次性写出（不逐行 flush）
     void print_variant(const humanoid_robot::PB::common::Variant &var)
     {
-        auto caseVal = var.value_case();
-        std::cout << "Variant case: " << caseVal << std::endl;
-        switch (caseVal)
-        {
-            CASE_PRINT(Bool, var.boolvalue);
-            CASE_PRINT(Int8, var.int8value);
-            CASE_PRINT(Uint8, var.uint8value);
-            CASE_PRINT(Int16, var.int16value);
-            CASE_PRINT(Uint16, var.uint16value);
-            CASE_PRINT(Int32, var.int32value);
-            CASE_PRINT(Uint32, var.uint32value);
-            CASE_PRINT(Int64, var.int64value);
-            CASE_PRINT(Uint64, var.uint64value);
-            CASE_PRINT(Float, var.floatvalue);
-            CASE_PRINT(Double, var.doublevalue);
-            CASE_PRINT(Char, var.charvalue);
-            CASE_PRINT(Byte, var.bytevalue);
-            CASE_PRINT(String, var.stringvalue);
-            CASE_PRINT_DATE(Date, var.datevalue);
-            CASE_PRINT_TIMESTAMP(Timestamp, var.timestampvalue);
-            CASE_PRINT_DICT(Dict, var.dictvalue);
-            CASE_PRINT_ARRAY(Bool, var.boolarrayvalue().values);
-            CASE_PRINT_ARRAY(Int8, var.int8arrayvalue().values);
-            CASE_PRINT_ARRAY(Uint8, var.uint8arrayvalue().values);
-            CASE_PRINT_ARRAY(Int16, var.int16arrayvalue().values);
-            CASE_PRINT_ARRAY(Uint16, var.uint16arrayvalue().values);
-            CASE_PRINT_ARRAY(Int32, var.int32arrayvalue().values);
-            CASE_PRINT_ARRAY(Uint32, var.uint32arrayvalue().values);
-            CASE_PRINT_ARRAY(Int64, var.int64arrayvalue().values);
-            CASE_PRINT_ARRAY(Uint64, var.uint64arrayvalue().values);
-            CASE_PRINT_ARRAY(Float, var.floatarrayvalue().values);
-            CASE_PRINT_ARRAY(Double, var.doublearrayvalue().values);
-            CASE_PRINT_ARRAY(Char, var.chararrayvalue().values);
-            CASE_PRINT_ARRAY(Byte, var.bytearrayvalue().values);
-            CASE_PRINT_ARRAY(String, var.stringarrayvalue().values);
-        default:
-            std::cout << "Unknown Variant case" << std::endl;
-            break;
-        }
+        thread_local std::string line;
+        line.clear();
+        format_variant(var, &line);
+        line.push_back('\n');
+        std::cout.write(line.data(), static_cast<std::streamsize>(line.size()));
     }
 
     void print_keyvaluelist(const ::google::protobuf::Map<std::string, ::humanoid_robot::PB::common::Variant> &keyvaluelist)
     {
+        thread_local std::string lines;
+        lines.clear();
         for (const auto &pair : keyvaluelist)
         {
-            std::cout << pair.first << ": ";
-            // 显式转换类型，避免重载歧义
-            print_variant(pair.second);
+            lines.append(pair.first);
+            lines.append(": ");
+            format_variant(pair.second, &lines);
+            lines.push_back('\n');
         }
+        std::cout.write(lines.data(), static_cast<std::streamsize>(lines.size()));
     }
 
     void print_section(const std::string &section_name)
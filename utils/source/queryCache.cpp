@@ -0,0 +1,295 @@
+#include "queryCache.h"
+#include "variantHash.h"
+
+using namespace humanoid_robot::PB::common;
+using namespace humanoid_robot::PB::interfaces;
+
+namespace
+{
+    constexpr int kQueryMethodIndex = 4; // InterfaceService 中 Query 的方法序号（与生成代码一致）
+
+    void release_bytes(void *user_data)
+    {
+        delete static_cast<humanoid_robot::utils::PB::QueryCache::Bytes *>(user_data);
+    }
+
+    // 缓存字节零拷贝包成 ByteBuffer：slice 持有一份引用，gRPC 发送完毕后释放
+    grpc::ByteBuffer wrap_bytes(const humanoid_robot::utils::PB::QueryCache::Bytes &bytes)
+    {
+        auto *holder = new humanoid_robot::utils::PB::QueryCache::Bytes(bytes);
+        grpc::Slice slice(const_cast<char *>(bytes->data()), bytes->size(), &release_bytes, holder);
+        return grpc::ByteBuffer(&slice, 1);
+    }
+
+    uint64_t params_hash(const Dictionary &params, const std::unordered_set<std::string> &ignored)
+    {
+        if (ignored.empty())
+        {
+            return humanoid_robot::utils::PB::hash_dictionary(params);
+        }
+        uint64_t sum = 0;
+        std::size_t count = 0;
+        for (const auto &entry : params.keyvaluelist())
+        {
+            if (ignored.count(entry.first) != 0)
+            {
+                continue;
+            }
+            sum += humanoid_robot::utils::PB::dictionary_entry_hash(entry.first, humanoid_robot::utils::PB::hash_variant(entry.second));
+            ++count;
+        }
+        return humanoid_robot::utils::PB::finish_dictionary_hash(sum, count);
+    }
+
+    bool params_equal(const Dictionary &a, const Dictionary &b, const std::unordered_set<std::string> &ignored)
+    {
+        if (ignored.empty())
+        {
+            return humanoid_robot::utils::PB::dictionary_equal(a, b);
+        }
+        std::size_t count_a = 0;
+        for (const auto &entry : a.keyvaluelist())
+        {
+            if (ignored.count(entry.first) != 0)
+            {
+                continue;
+            }
+            auto it = b.keyvaluelist().find(entry.first);
+            if (it == b.keyvaluelist().end() || !humanoid_robot::utils::PB::variant_equal(entry.second, it->second))
+            {
+                return false;
+            }
+            ++count_a;
+        }
+        std::size_t count_b = 0;
+        for (const auto &entry : b.keyvaluelist())
+        {
+            count_b += ignored.count(entry.first) == 0 ? 1 : 0;
+        }
+        return count_a == count_b;
+    }
+
+    // input 是否包含 match 的全部 key 且值相等
+    bool contains_all(const Dictionary &input, const Dictionary &match)
+    {
+        for (const auto &entry : match.keyvaluelist())
+        {
+            auto it = input.keyvaluelist().find(entry.first);
+            if (it == input.keyvaluelist().end() || !humanoid_robot::utils::PB::variant_equal(entry.second, it->second))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    QueryCache::QueryCache(QueryCacheOptions options) : options_(std::move(options))
+    {
+    }
+
+    uint64_t QueryCache::key(const QueryRequest &request) const
+    {
+        const uint64_t parts[2] = {hash_dictionary(request.input()), params_hash(request.params(), options_.ignored_params)};
+        return hash_bytes(parts, sizeof(parts));
+    }
+
+    bool QueryCache::same_request(const QueryRequest &a, const QueryRequest &b) const
+    {
+        return dictionary_equal(a.input(), b.input()) && params_equal(a.params(), b.params(), options_.ignored_params);
+    }
+
+    QueryCache::Bytes QueryCache::find(const QueryRequest &request)
+    {
+        return find(request, key(request));
+    }
+
+    QueryCache::Bytes QueryCache::find(const QueryRequest &request, uint64_t key)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end() || !same_request(it->second->request, request))
+        {
+            ++stats_.misses;
+            return nullptr;
+        }
+        if (options_.ttl.count() > 0 && Clock::now() >= it->second->expires)
+        {
+            erase(it->second);
+            ++stats_.expired;
+            ++stats_.misses;
+            return nullptr;
+        }
+        lru_.splice(lru_.begin(), lru_, it->second);
+        ++stats_.hits;
+        return lru_.front().response;
+    }
+
+    QueryCache::Bytes QueryCache::store(const QueryRequest &request, const QueryResponse &response)
+    {
+        return store(request, key(request), response);
+    }
+
+    QueryCache::Bytes QueryCache::store(const QueryRequest &request, uint64_t key, const QueryResponse &response)
+    {
+        auto bytes = std::make_shared<const std::string>(response.SerializeAsString());
+        if ((options_.cacheable && !options_.cacheable(response)) || options_.max_entries == 0)
+        {
+            return bytes;
+        }
+
+        const Clock::time_point expires = Clock::now() + options_.ttl;
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end())
+        {
+            // 同一请求被并发计算，或哈希冲突：保留最新的
+            erase(it->second);
+        }
+        lru_.push_front(Entry{key, request, bytes, expires});
+        index_.emplace(key, lru_.begin());
+        while (lru_.size() > options_.max_entries)
+        {
+            erase(std::prev(lru_.end()));
+            ++stats_.evictions;
+        }
+        return bytes;
+    }
+
+    std::size_t QueryCache::invalidate(const Dictionary &match)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::size_t removed = 0;
+        for (auto it = lru_.begin(); it != lru_.end();)
+        {
+            auto next = std::next(it);
+            if (contains_all(it->request.input(), match))
+            {
+                erase(it);
+                ++removed;
+            }
+            it = next;
+        }
+        stats_.invalidations += removed;
+        return removed;
+    }
+
+    void QueryCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.invalidations += lru_.size();
+        index_.clear();
+        lru_.clear();
+    }
+
+    QueryCacheStats QueryCache::stats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        QueryCacheStats stats = stats_;
+        stats.entries = lru_.size();
+        return stats;
+    }
+
+    void QueryCache::erase(EntryList::iterator it)
+    {
+        index_.erase(it->key);
+        lru_.erase(it);
+    }
+
+    // ---------------------------------------------------------------- CachingInterfaceService
+
+    CachingInterfaceService::CachingInterfaceService(InterfaceService::Service *inner, QueryCacheOptions options)
+        : inner_(inner), cache_(std::move(options))
+    {
+        MarkMethodStreamed(kQueryMethodIndex,
+                           new grpc::internal::StreamedUnaryHandler<QueryRequest, grpc::ByteBuffer>(
+                               [this](grpc::ServerContext *context, grpc::ServerUnaryStreamer<QueryRequest, grpc::ByteBuffer> *stream)
+                               { return StreamedQuery(context, stream); }));
+    }
+
+    grpc::Status CachingInterfaceService::Send(grpc::ServerContext *context,
+                                               grpc::ServerReaderWriter<SendResponse, SendRequest> *stream)
+    {
+        return inner_->Send(context, stream);
+    }
+
+    grpc::Status CachingInterfaceService::Action(grpc::ServerContext *context, const ActionRequest *request,
+                                                 grpc::ServerWriter<ActionResponse> *writer)
+    {
+        return inner_->Action(context, request, writer);
+    }
+
+    grpc::Status CachingInterfaceService::Subscribe(grpc::ServerContext *context, const SubscribeRequest *request,
+                                                    SubscribeResponse *response)
+    {
+        grpc::Status status = inner_->Subscribe(context, request, response);
+        if (status.ok())
+        {
+            cache_.invalidate(request->input());
+        }
+        return status;
+    }
+
+    grpc::Status CachingInterfaceService::Unsubscribe(grpc::ServerContext *context, const UnsubscribeRequest *request,
+                                                      UnsubscribeResponse *response)
+    {
+        grpc::Status status = inner_->Unsubscribe(context, request, response);
+        if (status.ok())
+        {
+            cache_.invalidate(request->input());
+        }
+        return status;
+    }
+
+    grpc::Status CachingInterfaceService::StreamedQuery(grpc::ServerContext *context,
+                                                        grpc::ServerUnaryStreamer<QueryRequest, grpc::ByteBuffer> *stream)
+    {
+        QueryRequest request;
+        if (!stream->Read(&request))
+        {
+            return grpc::Status(grpc::StatusCode::INTERNAL, "failed to read QueryRequest");
+        }
+        const uint64_t key = cache_.key(request);
+        QueryCache::Bytes bytes = cache_.find(request, key);
+        if (!bytes)
+        {
+            QueryResponse response;
+            grpc::Status status = inner_->Query(context, &request, &response);
+            if (!status.ok())
+            {
+                return status;
+            }
+            // 已取消的调用不写入缓存，只序列化一次用于回复
+            bytes = context->IsCancelled() ? std::make_shared<const std::string>(response.SerializeAsString())
+                                           : cache_.store(request, key, response);
+        }
+        stream->Write(wrap_bytes(bytes));
+        return grpc::Status::OK;
+    }
+
+    grpc::Status CachingInterfaceService::Query(grpc::ServerContext *context, const QueryRequest *request,
+                                                QueryResponse *response)
+    {
+        const uint64_t key = cache_.key(*request);
+        QueryCache::Bytes bytes = cache_.find(*request, key);
+        if (bytes)
+        {
+            if (!response->ParseFromString(*bytes))
+            {
+                return grpc::Status(grpc::StatusCode::INTERNAL, "cached QueryResponse is corrupt");
+            }
+            return grpc::Status::OK;
+        }
+
+        // 内层收到调用方的 context：截止时间、取消与元数据都与直接调用一致
+        grpc::Status status = inner_->Query(context, request, response);
+        if (status.ok() && !context->IsCancelled())
+        {
+            cache_.store(*request, key, *response);
+        }
+        return status;
+    }
+
+} // namespace humanoid_robot::utils::PB
@@ -0,0 +1,564 @@
+#include "requestBatch.h"
+
+#include <cstring>
+#include <google/protobuf/io/coded_stream.h>
+#include "payloadChecksum.h"
+
+using namespace humanoid_robot::PB::communication;
+using ::google::protobuf::io::CodedInputStream;
+using ::google::protobuf::io::CodedOutputStream;
+
+namespace
+{
+    constexpr int32_t kBatchVersion = 1;
+
+    // RequestBatch / BatchedRequest 的线格式，字段号均小于 16，tag 为单字节
+    constexpr uint32_t kWireVarint = 0;
+    constexpr uint32_t kWireFixed64 = 1;
+    constexpr uint32_t kWireLengthDelimited = 2;
+    constexpr uint32_t kWireFixed32 = 5;
+
+    constexpr uint8_t tag(uint32_t field, uint32_t wire_type)
+    {
+        return static_cast<uint8_t>((field << 3) | wire_type);
+    }
+
+    // 估算单条请求在信封中的体积（负载 + 头部字段）
+    std::size_t batched_size(const UniversalRequest &request)
+    {
+        return request.payload().size() + 24;
+    }
+
+    // proto3 语义：值为 0 的标量字段不写出
+    std::size_t varint_field_size(uint64_t value)
+    {
+        return value == 0 ? 0 : 1 + CodedOutputStream::VarintSize64(value);
+    }
+
+    uint8_t *write_varint_field(uint8_t field, uint64_t value, uint8_t *p)
+    {
+        if (value == 0)
+        {
+            return p;
+        }
+        *p++ = field;
+        return CodedOutputStream::WriteVarint64ToArray(value, p);
+    }
+
+    uint64_t int32_wire(int32_t value) { return static_cast<uint64_t>(static_cast<int64_t>(value)); }
+    uint64_t sint32_wire(int32_t value) { return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31); }
+    uint64_t sint64_wire(int64_t value) { return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63); }
+    int32_t sint32_value(uint64_t wire)
+    {
+        const uint32_t u = static_cast<uint32_t>(wire);
+        return static_cast<int32_t>((u >> 1) ^ (0u - (u & 1)));
+    }
+    int64_t sint64_value(uint64_t wire) { return static_cast<int64_t>((wire >> 1) ^ (0ull - (wire & 1))); }
+
+    // BatchedRequest 的各字段（已编码为 varint 线值）
+    struct ItemHeader
+    {
+        uint64_t command;
+        uint64_t version;
+        uint64_t id_delta;
+        uint64_t ts_delta;
+        uint64_t checksum;
+        uint64_t payload_type;
+        uint64_t payload_codec;
+        bool write_size;          // payloadSize 与 payload 长度不同（压缩负载）时显式写出
+        uint64_t payload_size;
+        std::size_t accept_bytes; // acceptCodecs packed 后的长度
+        std::size_t trace_bytes;  // trace 序列化后的长度，未设置时为 0 且不写出
+        std::size_t body_size;    // 不含外层 tag 与长度
+    };
+
+    ItemHeader make_item_header(const UniversalRequest &request, int32_t prev_id, int64_t prev_ts)
+    {
+        ItemHeader h;
+        h.command = int32_wire(request.command());
+        h.version = int32_wire(request.version());
+        // requestId 可能回绕，按 32 位无符号差值编码
+        h.id_delta = sint32_wire(static_cast<int32_t>(static_cast<uint32_t>(request.requestid()) - static_cast<uint32_t>(prev_id)));
+        h.ts_delta = sint64_wire(static_cast<int64_t>(static_cast<uint64_t>(request.sendrequesttimestamp()) - static_cast<uint64_t>(prev_ts)));
+        h.checksum = int32_wire(request.checksum());
+        h.payload_type = int32_wire(request.payloadtype());
+        h.payload_codec = int32_wire(request.payloadcodec());
+        const std::size_t payload = request.payload().size();
+        h.write_size = request.payloadsize() != static_cast<int32_t>(payload);
+        h.payload_size = int32_wire(request.payloadsize());
+        h.accept_bytes = 0;
+        for (const int codec : request.acceptcodecs())
+        {
+            h.accept_bytes += CodedOutputStream::VarintSize64(int32_wire(codec));
+        }
+        // ByteSizeLong() 同时缓存大小，写出时用 SerializeWithCachedSizesToArray
+        h.trace_bytes = request.has_trace() ? request.trace().ByteSizeLong() : 0;
+        h.body_size = varint_field_size(h.command) + varint_field_size(h.version) +
+                      varint_field_size(h.id_delta) + varint_field_size(h.ts_delta) +
+                      varint_field_size(h.checksum) + varint_field_size(h.payload_type) +
+                      (payload == 0 ? 0 : 1 + CodedOutputStream::VarintSize64(payload) + payload) +
+                      (h.write_size ? 1 + CodedOutputStream::VarintSize64(h.payload_size) : 0) +
+                      varint_field_size(h.payload_codec) +
+                      (h.accept_bytes == 0 ? 0 : 1 + CodedOutputStream::VarintSize64(h.accept_bytes) + h.accept_bytes) +
+                      (request.has_trace() ? 1 + CodedOutputStream::VarintSize64(h.trace_bytes) + h.trace_bytes : 0);
+        return h;
+    }
+
+    bool skip_field(CodedInputStream *input, uint32_t wire_tag)
+    {
+        uint64_t value = 0;
+        uint32_t length = 0;
+        switch (wire_tag & 7)
+        {
+        case kWireVarint:
+            return input->ReadVarint64(&value);
+        case kWireFixed64:
+            return input->Skip(8);
+        case kWireLengthDelimited:
+            return input->ReadVarint32(&length) && input->Skip(static_cast<int>(length));
+        case kWireFixed32:
+            return input->Skip(4);
+        default:
+            return false;
+        }
+    }
+
+    // acceptCodecs：packed 与逐条两种编码都接受
+    bool read_packed_codecs(CodedInputStream *input, UniversalRequest *request)
+    {
+        uint32_t length = 0;
+        if (!input->ReadVarint32(&length) || static_cast<int>(length) > input->BytesUntilLimit())
+        {
+            return false;
+        }
+        const auto limit = input->PushLimit(static_cast<int>(length));
+        uint64_t value = 0;
+        while (input->BytesUntilLimit() > 0)
+        {
+            if (!input->ReadVarint64(&value))
+            {
+                return false;
+            }
+            request->add_acceptcodecs(static_cast<PayloadCodec>(static_cast<int32_t>(value)));
+        }
+        input->PopLimit(limit);
+        return true;
+    }
+
+    bool read_trace(CodedInputStream *input, UniversalRequest *request)
+    {
+        uint32_t length = 0;
+        if (!input->ReadVarint32(&length) || static_cast<int>(length) > input->BytesUntilLimit())
+        {
+            return false;
+        }
+        const auto limit = input->PushLimit(static_cast<int>(length));
+        if (!request->mutable_trace()->MergePartialFromCodedStream(input) || !input->ConsumedEntireMessage())
+        {
+            return false;
+        }
+        input->PopLimit(limit);
+        return true;
+    }
+
+    bool parse_item(CodedInputStream *input, UniversalRequest *request, uint32_t *id, int64_t *ts)
+    {
+        uint64_t value = 0;
+        uint32_t length = 0;
+        bool has_size = false;
+        for (uint32_t wire_tag = input->ReadTag(); wire_tag != 0; wire_tag = input->ReadTag())
+        {
+            switch (wire_tag)
+            {
+            case tag(1, kWireVarint):
+                if (!input->ReadVarint64(&value))
+                    return false;
+                request->set_command(static_cast<int32_t>(value));
+                break;
+            case tag(2, kWireVarint):
+                if (!input->ReadVarint64(&value))
+                    return false;
+                request->set_version(static_cast<int32_t>(value));
+                break;
+            case tag(3, kWireVarint):
+                if (!input->ReadVarint64(&value))
+                    return false;
+                *id += static_cast<uint32_t>(sint32_value(value));
+                break;
+            case tag(4, kWireVarint):
+                if (!input->ReadVarint64(&value))
+                    return false;
+                *ts = static_cast<int64_t>(static_cast<uint64_t>(*ts) + static_cast<uint64_t>(sint64_value(value)));
+                break;
+            case tag(5, kWireVarint):
+                if (!input->ReadVarint64(&value))
+                    return false;
+                request->set_checksum(static_cast<int32_t>(value));
+                break;
+            case tag(6, kWireLengthDelimited):
+                if (!input->ReadVarint32(&length) || !input->ReadString(request->mutable_payload(), static_cast<int>(length)))
+                    return false;
+                break;
+            case tag(7, kWireVarint):
+                if (!input->ReadVarint64(&value))
+                    return false;
+                request->set_payloadtype(static_cast<int32_t>(value));
+                break;
+            case tag(8, kWireVarint):
+                if (!input->ReadVarint64(&value))
+                    return false;
+                request->set_payloadsize(static_cast<int32_t>(value));
+                has_size = true;
+                break;
+            case tag(9, kWireVarint):
+                if (!input->ReadVarint64(&value))
+                    return false;
+                request->set_payloadcodec(static_cast<PayloadCodec>(static_cast<int32_t>(value)));
+                break;
+            case tag(10, kWireLengthDelimited):
+                if (!read_packed_codecs(input, request))
+                    return false;
+                break;
+            case tag(10, kWireVarint):
+                if (!input->ReadVarint64(&value))
+                    return false;
+                request->add_acceptcodecs(static_cast<PayloadCodec>(static_cast<int32_t>(value)));
+                break;
+            case tag(11, kWireLengthDelimited):
+                if (!read_trace(input, request))
+                    return false;
+                break;
+            default:
+                if (!skip_field(input, wire_tag))
+                    return false;
+                break;
+            }
+        }
+        request->set_requestid(static_cast<int32_t>(*id));
+        request->set_sendrequesttimestamp(*ts);
+        if (!has_size)
+        {
+            request->set_payloadsize(static_cast<int32_t>(request->payload().size()));
+        }
+        return input->ConsumedEntireMessage();
+    }
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    void pack_batch(const std::vector<UniversalRequest> &requests, UniversalRequest *envelope)
+    {
+        // 直接写出 RequestBatch 线格式：负载只拷贝一次，不构造中间消息
+        const int32_t base_id = requests.empty() ? 0 : requests.front().requestid();
+        const int64_t base_ts = requests.empty() ? 0 : requests.front().sendrequesttimestamp();
+
+        std::vector<ItemHeader> headers;
+        headers.reserve(requests.size());
+        std::size_t total = varint_field_size(int32_wire(base_id)) + varint_field_size(static_cast<uint64_t>(base_ts));
+        int32_t prev_id = base_id;
+        int64_t prev_ts = base_ts;
+        for (const UniversalRequest &request : requests)
+        {
+            headers.push_back(make_item_header(request, prev_id, prev_ts));
+            total += 1 + CodedOutputStream::VarintSize64(headers.back().body_size) + headers.back().body_size;
+            prev_id = request.requestid();
+            prev_ts = request.sendrequesttimestamp();
+        }
+
+        envelope->Clear();
+        std::string *frame = envelope->mutable_payload();
+        frame->resize(total);
+        uint8_t *p = reinterpret_cast<uint8_t *>(&(*frame)[0]);
+        p = write_varint_field(tag(1, kWireVarint), int32_wire(base_id), p);
+        p = write_varint_field(tag(2, kWireVarint), static_cast<uint64_t>(base_ts), p);
+        for (std::size_t i = 0; i < requests.size(); ++i)
+        {
+            const ItemHeader &h = headers[i];
+            const std::string &payload = requests[i].payload();
+            *p++ = tag(3, kWireLengthDelimited);
+            p = CodedOutputStream::WriteVarint64ToArray(h.body_size, p);
+            p = write_varint_field(tag(1, kWireVarint), h.command, p);
+            p = write_varint_field(tag(2, kWireVarint), h.version, p);
+            p = write_varint_field(tag(3, kWireVarint), h.id_delta, p);
+            p = write_varint_field(tag(4, kWireVarint), h.ts_delta, p);
+            p = write_varint_field(tag(5, kWireVarint), h.checksum, p);
+            if (!payload.empty())
+            {
+                *p++ = tag(6, kWireLengthDelimited);
+                p = CodedOutputStream::WriteVarint64ToArray(payload.size(), p);
+                std::memcpy(p, payload.data(), payload.size());
+                p += payload.size();
+            }
+            p = write_varint_field(tag(7, kWireVarint), h.payload_type, p);
+            if (h.write_size)
+            {
+                *p++ = tag(8, kWireVarint);
+                p = CodedOutputStream::WriteVarint64ToArray(h.payload_size, p);
+            }
+            p = write_varint_field(tag(9, kWireVarint), h.payload_codec, p);
+            if (h.accept_bytes != 0)
+            {
+                *p++ = tag(10, kWireLengthDelimited);
+                p = CodedOutputStream::WriteVarint64ToArray(h.accept_bytes, p);
+                for (const int codec : requests[i].acceptcodecs())
+                {
+                    p = CodedOutputStream::WriteVarint64ToArray(int32_wire(codec), p);
+                }
+            }
+            if (requests[i].has_trace())
+            {
+                *p++ = tag(11, kWireLengthDelimited);
+                p = CodedOutputStream::WriteVarint64ToArray(h.trace_bytes, p);
+                p = requests[i].trace().SerializeWithCachedSizesToArray(p);
+            }
+        }
+
+        envelope->set_version(kBatchVersion);
+        envelope->set_requestid(base_id);
+        envelope->set_sendrequesttimestamp(prev_ts);
+        envelope->set_payloadtype(RESERVED_PAYLOAD_REQUEST_BATCH);
+        envelope->set_payloadsize(static_cast<int32_t>(total));
+        seal_checksum(envelope);
+    }
+
+    bool unpack_batch(const UniversalRequest &envelope, std::vector<UniversalRequest> *out)
+    {
+        if (!is_batch_envelope(envelope) || envelope.version() != kBatchVersion || !verify_checksum(envelope))
+        {
+            return false;
+        }
+
+        const std::string &frame = envelope.payload();
+        CodedInputStream input(reinterpret_cast<const uint8_t *>(frame.data()), static_cast<int>(frame.size()));
+        const std::size_t first = out->size();
+        uint64_t value = 0;
+        uint32_t id = 0;
+        int64_t ts = 0;
+        bool ok = true;
+        for (uint32_t wire_tag = input.ReadTag(); ok && wire_tag != 0; wire_tag = input.ReadTag())
+        {
+            switch (wire_tag)
+            {
+            case tag(1, kWireVarint):
+                ok = input.ReadVarint64(&value);
+                id = static_cast<uint32_t>(value);
+                break;
+            case tag(2, kWireVarint):
+                ok = input.ReadVarint64(&value);
+                ts = static_cast<int64_t>(value);
+                break;
+            case tag(3, kWireLengthDelimited):
+            {
+                uint32_t length = 0;
+                // 条目长度不得超出帧的剩余字节，否则截断的条目会被当作较短的完整条目
+                ok = input.ReadVarint32(&length) &&
+                     length <= frame.size() - static_cast<std::size_t>(input.CurrentPosition());
+                if (ok)
+                {
+                    const auto limit = input.PushLimit(static_cast<int>(length));
+                    out->emplace_back();
+                    ok = parse_item(&input, &out->back(), &id, &ts);
+                    input.PopLimit(limit);
+                }
+                break;
+            }
+            default:
+                ok = skip_field(&input, wire_tag);
+                break;
+            }
+        }
+        // base 字段按协议位于所有条目之前；格式错误时回滚本次追加
+        if (!ok || !input.ConsumedEntireMessage())
+        {
+            out->resize(first);
+            return false;
+        }
+        return true;
+    }
+
+    RequestCoalescer::RequestCoalescer(const CoalescerOptions &options, Sink sink)
+        : options_(options), sink_(std::move(sink))
+    {
+        pending_.reserve(options_.max_count);
+        sending_.reserve(options_.max_count);
+    }
+
+    RequestCoalescer::~RequestCoalescer()
+    {
+        stop();
+    }
+
+    bool RequestCoalescer::add(UniversalRequest request)
+    {
+        const std::size_t size = batched_size(request);
+        if (size >= options_.max_bytes)
+        {
+            // 大请求合并没有收益：保持顺序，先发出已有请求
+            std::lock_guard<std::mutex> send_lock(send_mutex_);
+            bool ok = send_pending();
+            const bool sent = sink_(request);
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (sent)
+            {
+                ++frames_sent_;
+                ++requests_sent_;
+            }
+            return sent && ok;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pending_.empty())
+            {
+                oldest_ = std::chrono::steady_clock::now();
+                cv_.notify_one();
+            }
+            pending_.push_back(std::move(request));
+            pending_bytes_ += size;
+            if (pending_bytes_ < options_.max_bytes && pending_.size() < options_.max_count)
+            {
+                return true;
+            }
+        }
+        return flush();
+    }
+
+    bool RequestCoalescer::flush()
+    {
+        std::lock_guard<std::mutex> send_lock(send_mutex_);
+        return send_pending();
+    }
+
+    bool RequestCoalescer::poll(std::chrono::steady_clock::time_point now)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pending_.empty() || now - oldest_ < options_.max_latency)
+            {
+                return true;
+            }
+        }
+        return flush();
+    }
+
+    bool RequestCoalescer::send_pending()
+    {
+        // 持有 send_mutex_：只在交换待发队列时持有 mutex_，sink 在其外调用，
+        // 其他线程的 add() 不会被慢速写出阻塞
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pending_.empty())
+            {
+                return true;
+            }
+            sending_.swap(pending_);
+            pending_bytes_ = 0;
+        }
+
+        const std::size_t count = sending_.size();
+        bool ok = false;
+        if (count == 1)
+        {
+            ok = sink_(sending_.front());
+        }
+        else
+        {
+            pack_batch(sending_, &envelope_);
+            ok = sink_(envelope_);
+        }
+        sending_.clear();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (ok)
+        {
+            ++frames_sent_;
+            requests_sent_ += count;
+        }
+        return ok;
+    }
+
+    void RequestCoalescer::start()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_)
+        {
+            return;
+        }
+        running_ = true;
+        flusher_ = std::thread([this]
+                               {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (running_)
+            {
+                if (pending_.empty())
+                {
+                    cv_.wait(lock);
+                    continue;
+                }
+                const auto deadline = oldest_ + options_.max_latency;
+                if (std::chrono::steady_clock::now() >= deadline)
+                {
+                    // 锁顺序为 send_mutex_ → mutex_，发送前先释放 mutex_
+                    lock.unlock();
+                    flush();
+                    lock.lock();
+                }
+                else
+                {
+                    cv_.wait_until(lock, deadline);
+                }
+            } });
+    }
+
+    void RequestCoalescer::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_ = false;
+        }
+        cv_.notify_all();
+        if (flusher_.joinable())
+        {
+            flusher_.join();
+        }
+        flush();
+    }
+
+    std::size_t RequestCoalescer::pending_count() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pending_.size();
+    }
+
+    uint64_t RequestCoalescer::frames_sent() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return frames_sent_;
+    }
+
+    uint64_t RequestCoalescer::requests_sent() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return requests_sent_;
+    }
+
+    bool RequestDemultiplexer::dispatch(UniversalRequest &&request)
+    {
+        if (!is_batch_envelope(request))
+        {
+            handler_(std::move(request));
+            return true;
+        }
+        scratch_.clear();
+        if (!unpack_batch(request, &scratch_))
+        {
+            return false;
+        }
+        for (UniversalRequest &item : scratch_)
+        {
+            handler_(std::move(item));
+        }
+        scratch_.clear();
+        return true;
+    }
+} // namespace humanoid_robot::utils::PB
@@ -0,0 +1,485 @@
+#include "rowColumns.h"
+
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+using namespace humanoid_robot::PB::common;
+using google::protobuf::RepeatedPtrField;
+
+namespace
+{
+    // 字符串字典编码，键引用源消息中的字符串，转换期间保持有效
+    class StringDictionary
+    {
+    public:
+        StringDictionary(RepeatedPtrField<std::string> *dict, int expected) : dict_(dict)
+        {
+            index_.reserve(static_cast<std::size_t>(expected));
+        }
+
+        uint32_t encode(const std::string &value)
+        {
+            auto it = index_.find(value);
+            if (it != index_.end())
+            {
+                return it->second;
+            }
+            const uint32_t id = static_cast<uint32_t>(dict_->size());
+            dict_->Add()->assign(value);
+            index_.emplace(value, id);
+            return id;
+        }
+
+    private:
+        RepeatedPtrField<std::string> *dict_;
+        std::unordered_map<std::string_view, uint32_t> index_;
+    };
+
+    // 各行类型的字段差异：DivisionRow 无检测框，DetectionRow 无掩码
+    const BBox *row_bbox(const PerceptionRow &row) { return &row.bbox(); }
+    const BBox *row_bbox(const DetectionRow &row) { return &row.bbox(); }
+    const BBox *row_bbox(const DivisionRow &) { return nullptr; }
+
+    const RepeatedPtrField<Mask> *row_masks(const PerceptionRow &row) { return &row.masks(); }
+    const RepeatedPtrField<Mask> *row_masks(const DetectionRow &) { return nullptr; }
+    const RepeatedPtrField<Mask> *row_masks(const DivisionRow &row) { return &row.masks(); }
+
+    // 紧凑掩码（游程 / 轮廓），DetectionRow 没有
+    const MaskRle *row_mask_rle(const PerceptionRow &row) { return row.has_maskrle() ? &row.maskrle() : nullptr; }
+    const MaskRle *row_mask_rle(const DetectionRow &) { return nullptr; }
+    const MaskRle *row_mask_rle(const DivisionRow &row) { return row.has_maskrle() ? &row.maskrle() : nullptr; }
+
+    const MaskContour *row_mask_contour(const PerceptionRow &row) { return row.has_maskcontour() ? &row.maskcontour() : nullptr; }
+    const MaskContour *row_mask_contour(const DetectionRow &) { return nullptr; }
+    const MaskContour *row_mask_contour(const DivisionRow &row) { return row.has_maskcontour() ? &row.maskcontour() : nullptr; }
+
+    template <typename Row>
+    constexpr bool kRowHasBBox = !std::is_same<Row, DivisionRow>::value;
+
+    BBox *mutable_row_bbox(PerceptionRow *row) { return row->mutable_bbox(); }
+    BBox *mutable_row_bbox(DetectionRow *row) { return row->mutable_bbox(); }
+    BBox *mutable_row_bbox(DivisionRow *) { return nullptr; }
+
+    RepeatedPtrField<Mask> *mutable_row_masks(PerceptionRow *row) { return row->mutable_masks(); }
+    RepeatedPtrField<Mask> *mutable_row_masks(DetectionRow *) { return nullptr; }
+    RepeatedPtrField<Mask> *mutable_row_masks(DivisionRow *row) { return row->mutable_masks(); }
+
+    MaskRle *mutable_row_mask_rle(PerceptionRow *row) { return row->mutable_maskrle(); }
+    MaskRle *mutable_row_mask_rle(DetectionRow *) { return nullptr; }
+    MaskRle *mutable_row_mask_rle(DivisionRow *row) { return row->mutable_maskrle(); }
+
+    MaskContour *mutable_row_mask_contour(PerceptionRow *row) { return row->mutable_maskcontour(); }
+    MaskContour *mutable_row_mask_contour(DetectionRow *) { return nullptr; }
+    MaskContour *mutable_row_mask_contour(DivisionRow *row) { return row->mutable_maskcontour(); }
+
+    // 列中的空消息表示该行未设置
+    bool mask_present(const google::protobuf::MessageLite &mask)
+    {
+        return mask.ByteSizeLong() != 0;
+    }
+
+    template <typename Row>
+    void rows_to_columns(const RepeatedPtrField<Row> &rows, RowColumns *columns)
+    {
+        const int n = rows.size();
+        columns->Clear();
+        columns->set_count(static_cast<uint32_t>(n));
+        if (n == 0)
+        {
+            return;
+        }
+
+        constexpr bool has_bbox = kRowHasBBox<Row>;
+        if (has_bbox)
+        {
+            columns->mutable_x1()->Reserve(n);
+            columns->mutable_y1()->Reserve(n);
+            columns->mutable_x2()->Reserve(n);
+            columns->mutable_y2()->Reserve(n);
+        }
+        columns->mutable_conf()->Reserve(n);
+        columns->mutable_cls()->Reserve(n);
+        columns->mutable_trackid()->Reserve(n);
+
+        std::string *bits = columns->mutable_ismove();
+        bits->assign((static_cast<std::size_t>(n) + 7) / 8, '\0');
+
+        StringDictionary cls_dict(columns->mutable_clsdict(), 16);
+        StringDictionary track_dict(columns->mutable_trackiddict(), n);
+
+        bool any_mask = false;
+        bool any_rle = false;
+        bool any_contour = false;
+        std::size_t mask_points = 0;
+        for (const Row &row : rows)
+        {
+            const RepeatedPtrField<Mask> *masks = row_masks(row);
+            if (masks != nullptr && !masks->empty())
+            {
+                any_mask = true;
+                mask_points += static_cast<std::size_t>(masks->size());
+            }
+            any_rle = any_rle || row_mask_rle(row) != nullptr;
+            any_contour = any_contour || row_mask_contour(row) != nullptr;
+        }
+        if (any_rle)
+        {
+            columns->mutable_maskrle()->Reserve(n);
+        }
+        if (any_contour)
+        {
+            columns->mutable_maskcontour()->Reserve(n);
+        }
+        if (any_mask)
+        {
+            columns->mutable_maskxy()->Reserve(static_cast<int>(2 * mask_points));
+            columns->mutable_maskoffsets()->Reserve(n + 1);
+            columns->add_maskoffsets(0);
+        }
+
+        uint32_t offset = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            const Row &row = rows.Get(i);
+            if (has_bbox)
+            {
+                const BBox *bbox = row_bbox(row);
+                columns->add_x1(bbox->x1());
+                columns->add_y1(bbox->y1());
+                columns->add_x2(bbox->x2());
+                columns->add_y2(bbox->y2());
+            }
+            columns->add_conf(row.conf());
+            columns->add_cls(cls_dict.encode(row.cls()));
+            columns->add_trackid(track_dict.encode(row.trackid()));
+            if (row.ismove())
+            {
+                (*bits)[static_cast<std::size_t>(i) / 8] |= static_cast<char>(1u << (i % 8));
+            }
+            if (any_mask)
+            {
+                const RepeatedPtrField<Mask> *masks = row_masks(row);
+                if (masks != nullptr)
+                {
+                    for (const Mask &point : *masks)
+                    {
+                        columns->add_maskxy(point.x());
+                        columns->add_maskxy(point.y());
+                    }
+                    offset += static_cast<uint32_t>(masks->size());
+                }
+                columns->add_maskoffsets(offset);
+            }
+            if (any_rle)
+            {
+                const MaskRle *rle = row_mask_rle(row);
+                MaskRle *added = columns->add_maskrle();
+                if (rle != nullptr)
+                {
+                    *added = *rle;
+                }
+            }
+            if (any_contour)
+            {
+                const MaskContour *contour = row_mask_contour(row);
+                MaskContour *added = columns->add_maskcontour();
+                if (contour != nullptr)
+                {
+                    *added = *contour;
+                }
+            }
+        }
+    }
+
+    template <typename Row>
+    bool columns_to_rows(const RowColumns &columns, RepeatedPtrField<Row> *rows)
+    {
+        if (!humanoid_robot::utils::PB::columns_valid(columns, kRowHasBBox<Row>))
+        {
+            return false;
+        }
+        const int n = static_cast<int>(columns.count());
+        rows->Clear();
+        rows->Reserve(n);
+        const bool has_masks = columns.maskoffsets_size() != 0;
+        const bool has_rle = columns.maskrle_size() != 0;
+        const bool has_contour = columns.maskcontour_size() != 0;
+
+        for (int i = 0; i < n; ++i)
+        {
+            Row *row = rows->Add();
+            if (BBox *bbox = mutable_row_bbox(row))
+            {
+                bbox->set_x1(columns.x1(i));
+                bbox->set_y1(columns.y1(i));
+                bbox->set_x2(columns.x2(i));
+                bbox->set_y2(columns.y2(i));
+            }
+            row->set_conf(columns.conf(i));
+            row->set_cls(columns.clsdict(static_cast<int>(columns.cls(i))));
+            row->set_trackid(columns.trackiddict(static_cast<int>(columns.trackid(i))));
+            row->set_ismove(humanoid_robot::utils::PB::row_is_move(columns, static_cast<std::size_t>(i)));
+
+            RepeatedPtrField<Mask> *masks = mutable_row_masks(row);
+            if (has_masks && masks != nullptr)
+            {
+                const uint32_t begin = columns.maskoffsets(i);
+                const uint32_t end = columns.maskoffsets(i + 1);
+                masks->Reserve(static_cast<int>(end - begin));
+                for (uint32_t p = begin; p < end; ++p)
+                {
+                    Mask *point = masks->Add();
+                    point->set_x(columns.maskxy(static_cast<int>(2 * p)));
+                    point->set_y(columns.maskxy(static_cast<int>(2 * p + 1)));
+                }
+            }
+            if (has_rle && mask_present(columns.maskrle(i)))
+            {
+                if (MaskRle *rle = mutable_row_mask_rle(row))
+                {
+                    *rle = columns.maskrle(i);
+                }
+            }
+            if (has_contour && mask_present(columns.maskcontour(i)))
+            {
+                if (MaskContour *contour = mutable_row_mask_contour(row))
+                {
+                    *contour = columns.maskcontour(i);
+                }
+            }
+        }
+        return true;
+    }
+
+    bool dict_indices_valid(const google::protobuf::RepeatedField<uint32_t> &indices, int dict_size)
+    {
+        uint32_t max_index = 0;
+        for (uint32_t index : indices)
+        {
+            max_index = index > max_index ? index : max_index;
+        }
+        return indices.empty() || static_cast<int64_t>(max_index) < dict_size;
+    }
+
+    inline float box_iou(float ax1, float ay1, float ax2, float ay2,
+                         float bx1, float by1, float bx2, float by2)
+    {
+        const float ix1 = ax1 > bx1 ? ax1 : bx1;
+        const float iy1 = ay1 > by1 ? ay1 : by1;
+        const float ix2 = ax2 < bx2 ? ax2 : bx2;
+        const float iy2 = ay2 < by2 ? ay2 : by2;
+        const float iw = ix2 - ix1 > 0.0f ? ix2 - ix1 : 0.0f;
+        const float ih = iy2 - iy1 > 0.0f ? iy2 - iy1 : 0.0f;
+        const float inter = iw * ih;
+        const float uni = (ax2 - ax1) * (ay2 - ay1) + (bx2 - bx1) * (by2 - by1) - inter;
+        return uni > 0.0f ? inter / uni : 0.0f;
+    }
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    void to_columns(const RepeatedPtrField<PerceptionRow> &rows, RowColumns *columns)
+    {
+        rows_to_columns(rows, columns);
+    }
+
+    void to_columns(const RepeatedPtrField<DetectionRow> &rows, RowColumns *columns)
+    {
+        rows_to_columns(rows, columns);
+    }
+
+    void to_columns(const RepeatedPtrField<DivisionRow> &rows, RowColumns *columns)
+    {
+        rows_to_columns(rows, columns);
+    }
+
+    bool to_rows(const RowColumns &columns, RepeatedPtrField<PerceptionRow> *rows)
+    {
+        return columns_to_rows(columns, rows);
+    }
+
+    bool to_rows(const RowColumns &columns, RepeatedPtrField<DetectionRow> *rows)
+    {
+        return columns_to_rows(columns, rows);
+    }
+
+    bool to_rows(const RowColumns &columns, RepeatedPtrField<DivisionRow> *rows)
+    {
+        return columns_to_rows(columns, rows);
+    }
+
+    bool columns_valid(const RowColumns &columns, bool requires_bbox)
+    {
+        if (columns.count() > static_cast<uint32_t>(std::numeric_limits<int>::max()))
+        {
+            return false;
+        }
+        const int n = static_cast<int>(columns.count());
+
+        const bool has_bbox = columns.x1_size() != 0;
+        if (has_bbox || requires_bbox)
+        {
+            if (columns.x1_size() != n || columns.y1_size() != n || columns.x2_size() != n || columns.y2_size() != n)
+            {
+                return false;
+            }
+        }
+        else if (columns.y1_size() != 0 || columns.x2_size() != 0 || columns.y2_size() != 0)
+        {
+            return false;
+        }
+
+        if (columns.conf_size() != n || columns.cls_size() != n || columns.trackid_size() != n)
+        {
+            return false;
+        }
+        if (!columns.ismove().empty() && columns.ismove().size() != (static_cast<std::size_t>(n) + 7) / 8)
+        {
+            return false;
+        }
+        if (!dict_indices_valid(columns.cls(), columns.clsdict_size()) ||
+            !dict_indices_valid(columns.trackid(), columns.trackiddict_size()))
+        {
+            return false;
+        }
+
+        if ((columns.maskrle_size() != 0 && columns.maskrle_size() != n) ||
+            (columns.maskcontour_size() != 0 && columns.maskcontour_size() != n))
+        {
+            return false;
+        }
+
+        if (columns.maskoffsets_size() == 0)
+        {
+            return columns.maskxy_size() == 0;
+        }
+        if (columns.maskoffsets_size() != n + 1 || columns.maskoffsets(0) != 0)
+        {
+            return false;
+        }
+        for (int i = 0; i < n; ++i)
+        {
+            if (columns.maskoffsets(i + 1) < columns.maskoffsets(i))
+            {
+                return false;
+            }
+        }
+        return 2 * static_cast<int64_t>(columns.maskoffsets(n)) == columns.maskxy_size();
+    }
+
+    std::size_t select_by_confidence(const RowColumns &columns, float threshold, std::vector<uint32_t> *indices)
+    {
+        const std::size_t n = static_cast<std::size_t>(columns.conf_size());
+        const float *conf = columns.conf().data();
+        indices->resize(n);
+        uint32_t *out = indices->data();
+
+        // 无分支压缩：总是写入下标，按比较结果决定是否前移
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            out[kept] = static_cast<uint32_t>(i);
+            kept += conf[i] >= threshold ? 1 : 0;
+        }
+        indices->resize(kept);
+        return kept;
+    }
+
+    void iou_with_box(const RowColumns &columns, float x1, float y1, float x2, float y2, float *out)
+    {
+        const std::size_t n = static_cast<std::size_t>(columns.x1_size());
+        const float *ax1 = columns.x1().data();
+        const float *ay1 = columns.y1().data();
+        const float *ax2 = columns.x2().data();
+        const float *ay2 = columns.y2().data();
+
+        // 纯算术循环，编译器可自动向量化
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            out[i] = box_iou(ax1[i], ay1[i], ax2[i], ay2[i], x1, y1, x2, y2);
+        }
+    }
+
+    float row_iou(const RowColumns &columns, std::size_t a, std::size_t b)
+    {
+        const int ia = static_cast<int>(a);
+        const int ib = static_cast<int>(b);
+        return box_iou(columns.x1(ia), columns.y1(ia), columns.x2(ia), columns.y2(ia),
+                       columns.x1(ib), columns.y1(ib), columns.x2(ib), columns.y2(ib));
+    }
+
+    bool gather_rows(const RowColumns &columns, const std::vector<uint32_t> &indices, RowColumns *out)
+    {
+        if (!columns_valid(columns, false) ||
+            indices.size() > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+        {
+            return false;
+        }
+        for (uint32_t index : indices)
+        {
+            if (index >= columns.count())
+            {
+                return false;
+            }
+        }
+
+        const int n = static_cast<int>(indices.size());
+        const bool has_bbox = columns.x1_size() != 0;
+        const bool has_masks = columns.maskoffsets_size() != 0;
+        const bool has_rle = columns.maskrle_size() != 0;
+        const bool has_contour = columns.maskcontour_size() != 0;
+
+        out->Clear();
+        out->set_count(static_cast<uint32_t>(n));
+        *out->mutable_clsdict() = columns.clsdict();
+        *out->mutable_trackiddict() = columns.trackiddict();
+        std::string *bits = out->mutable_ismove();
+        bits->assign((static_cast<std::size_t>(n) + 7) / 8, '\0');
+        if (has_masks)
+        {
+            out->add_maskoffsets(0);
+        }
+
+        uint32_t offset = 0;
+        for (int k = 0; k < n; ++k)
+        {
+            const int i = static_cast<int>(indices[static_cast<std::size_t>(k)]);
+            if (has_bbox)
+            {
+                out->add_x1(columns.x1(i));
+                out->add_y1(columns.y1(i));
+                out->add_x2(columns.x2(i));
+                out->add_y2(columns.y2(i));
+            }
+            out->add_conf(columns.conf(i));
+            out->add_cls(columns.cls(i));
+            out->add_trackid(columns.trackid(i));
+            if (row_is_move(columns, static_cast<std::size_t>(i)))
+            {
+                (*bits)[static_cast<std::size_t>(k) / 8] |= static_cast<char>(1u << (k % 8));
+            }
+            if (has_masks)
+            {
+                const uint32_t begin = columns.maskoffsets(i);
+                const uint32_t end = columns.maskoffsets(i + 1);
+                for (uint32_t p = 2 * begin; p < 2 * end; ++p)
+                {
+                    out->add_maskxy(columns.maskxy(static_cast<int>(p)));
+                }
+                offset += end - begin;
+                out->add_maskoffsets(offset);
+            }
+            if (has_rle)
+            {
+                *out->add_maskrle() = columns.maskrle(i);
+            }
+            if (has_contour)
+            {
+                *out->add_maskcontour() = columns.maskcontour(i);
+            }
+        }
+        return true;
+    }
+} // namespace humanoid_robot::utils::PB
@@ -0,0 +1,456 @@
+#include "shmTopicRing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <thread>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace humanoid_robot::PB::communication;
+
+namespace
+{
+    constexpr uint64_t kMagic = 0x4348524943544F50ULL; // "CHRICTOP"
+    constexpr uint32_t kVersion = 2; // 2: 槽位附带 TopicMessage 其余字段
+    constexpr std::size_t kCacheLine = 64;
+    constexpr std::size_t kHeaderBytes = 2 * kCacheLine; // 段头：配置 + 独占缓存行的 write_index
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory ring requires lock-free 64-bit atomics");
+
+    std::size_t round_up(std::size_t value, std::size_t align)
+    {
+        return (value + align - 1) / align * align;
+    }
+
+    uint32_t next_pow2(uint32_t value)
+    {
+        uint32_t result = 1;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    uint64_t fnv1a(const std::string &text)
+    {
+        uint64_t hash = 1469598103934665603ULL;
+        for (unsigned char c : text)
+        {
+            hash ^= c;
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    bool has_meta(const TopicMessage &message)
+    {
+        return !message.topic_name().empty() || !message.publisher_id().empty() || message.name_id() != 0 ||
+               message.payload_codec() != PAYLOAD_CODEC_NONE || !message.codec_dictionary().empty() ||
+               message.has_trace();
+    }
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    struct ShmTopicRing::Header
+    {
+        std::atomic<uint64_t> magic;
+        uint32_t version;
+        uint32_t slot_count;
+        uint32_t slot_size;
+        uint32_t owner_pid; // 创建者进程，用于识别异常退出后残留的段
+        alignas(kCacheLine) std::atomic<uint64_t> write_index;
+    };
+
+    // 槽位头：stamp 为 2*index+1 表示正在写入，2*index+2 表示 index 号消息已写完。
+    // 数据区依次为 meta_length 字节的附加字段（序列化的 TopicMessage）和 length 字节的 payload
+    struct ShmTopicRing::SlotHeader
+    {
+        std::atomic<uint64_t> stamp;
+        uint64_t sequence;
+        uint64_t timestamp;
+        uint32_t length;
+        uint32_t meta_length;
+    };
+
+    ShmTopicRing::ShmTopicRing(std::string name, void *base, std::size_t mapped_size, bool owner,
+                               uint32_t slot_count, uint32_t slot_size)
+        : name_(std::move(name)), base_(base), mapped_size_(mapped_size), owner_(owner),
+          header_(static_cast<Header *>(base)), slot_count_(slot_count), slot_size_(slot_size)
+    {
+    }
+
+    bool ShmTopicRing::stale_segment(const std::string &name)
+    {
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+        {
+            // 段已被他人清理，或无权读取（不是本用户的段，不能清理）
+            return errno == ENOENT;
+        }
+        struct stat st;
+        void *base = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= kHeaderBytes)
+        {
+            base = mmap(nullptr, kHeaderBytes, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (base == MAP_FAILED)
+        {
+            // 尺寸不足可能是另一个 Publisher 正在创建，按存活处理
+            return false;
+        }
+        const Header *header = static_cast<const Header *>(base);
+        const bool stale = header->magic.load(std::memory_order_acquire) == kMagic && header->owner_pid != 0 &&
+                           kill(static_cast<pid_t>(header->owner_pid), 0) != 0 && errno == ESRCH;
+        munmap(base, kHeaderBytes);
+        return stale;
+    }
+
+    ShmTopicRing::~ShmTopicRing()
+    {
+        munmap(base_, mapped_size_);
+        if (owner_)
+        {
+            shm_unlink(name_.c_str());
+        }
+    }
+
+    std::unique_ptr<ShmTopicRing> ShmTopicRing::create(const std::string &topic_name, const Options &options)
+    {
+        static_assert(sizeof(Header) <= kHeaderBytes, "ring header exceeds reserved space");
+        static_assert(sizeof(SlotHeader) % 8 == 0, "slot header must keep payload 8-byte aligned");
+
+        const uint32_t slot_count = next_pow2(options.slot_count == 0 ? 1 : options.slot_count);
+        const uint32_t slot_size = static_cast<uint32_t>(round_up(
+            std::max<std::size_t>(options.slot_size, sizeof(SlotHeader) + 1), kCacheLine));
+        const std::size_t total = kHeaderBytes + static_cast<std::size_t>(slot_count) * slot_size;
+
+        const std::string name = shm_segment_name(topic_name);
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, static_cast<mode_t>(options.mode));
+        if (fd < 0 && errno == EEXIST && stale_segment(name))
+        {
+            // 上一次异常退出残留的段：创建者已不存在，清理后重建
+            shm_unlink(name.c_str());
+            fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, static_cast<mode_t>(options.mode));
+        }
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+        // shm_open 的权限受 umask 影响，显式设置
+        fchmod(fd, static_cast<mode_t>(options.mode));
+        if (ftruncate(fd, static_cast<off_t>(total)) != 0)
+        {
+            close(fd);
+            shm_unlink(name.c_str());
+            return nullptr;
+        }
+        void *base = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED)
+        {
+            shm_unlink(name.c_str());
+            return nullptr;
+        }
+
+        Header *header = new (base) Header();
+        header->version = kVersion;
+        header->slot_count = slot_count;
+        header->slot_size = slot_size;
+        header->owner_pid = static_cast<uint32_t>(getpid());
+        header->write_index.store(0, std::memory_order_relaxed);
+        for (uint32_t i = 0; i < slot_count; ++i)
+        {
+            char *p = static_cast<char *>(base) + kHeaderBytes + static_cast<std::size_t>(i) * slot_size;
+            new (p) SlotHeader{};
+        }
+        // magic 最后写入，open() 看到 magic 即说明头部已初始化完成
+        header->magic.store(kMagic, std::memory_order_release);
+
+        return std::unique_ptr<ShmTopicRing>(new ShmTopicRing(name, base, total, true, slot_count, slot_size));
+    }
+
+    std::unique_ptr<ShmTopicRing> ShmTopicRing::open(const std::string &topic_name)
+    {
+        const std::string name = shm_segment_name(topic_name);
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < kHeaderBytes)
+        {
+            close(fd);
+            return nullptr;
+        }
+        const std::size_t total = static_cast<std::size_t>(st.st_size);
+        void *base = mmap(nullptr, total, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED)
+        {
+            return nullptr;
+        }
+
+        const Header *header = static_cast<const Header *>(base);
+        const bool ready = header->magic.load(std::memory_order_acquire) == kMagic && header->version == kVersion;
+        // 只读取一次，之后使用本地副本
+        const uint32_t slot_count = ready ? header->slot_count : 0;
+        const uint32_t slot_size = ready ? header->slot_size : 0;
+        const bool valid = slot_count != 0 &&
+                           (slot_count & (slot_count - 1)) == 0 &&
+                           slot_size > sizeof(SlotHeader) &&
+                           slot_size % 8 == 0 &&
+                           kHeaderBytes + static_cast<std::size_t>(slot_count) * slot_size <= total;
+        if (!valid)
+        {
+            munmap(base, total);
+            return nullptr;
+        }
+
+        std::unique_ptr<ShmTopicRing> ring(new ShmTopicRing(name, base, total, false, slot_count, slot_size));
+        ring->read_index_ = header->write_index.load(std::memory_order_acquire);
+        return ring;
+    }
+
+    std::size_t ShmTopicRing::max_payload() const
+    {
+        return slot_size_ - sizeof(SlotHeader);
+    }
+
+    ShmTopicRing::SlotHeader *ShmTopicRing::slot(uint64_t index) const
+    {
+        const uint64_t pos = index & (slot_count_ - 1);
+        char *p = static_cast<char *>(base_) + kHeaderBytes + pos * slot_size_;
+        return reinterpret_cast<SlotHeader *>(p);
+    }
+
+    bool ShmTopicRing::publish(const TopicMessage &message)
+    {
+        meta_.clear();
+        if (has_meta(message))
+        {
+            // 只序列化附加字段，payload 不经过临时消息
+            TopicMessage meta;
+            meta.set_topic_name(message.topic_name());
+            meta.set_publisher_id(message.publisher_id());
+            meta.set_name_id(message.name_id());
+            meta.set_payload_codec(message.payload_codec());
+            meta.set_codec_dictionary(message.codec_dictionary());
+            if (message.has_trace())
+            {
+                *meta.mutable_trace() = message.trace();
+            }
+            meta.SerializeToString(&meta_);
+        }
+        return publish_slot(message.sequence(), message.timestamp(), meta_, message.payload().data(), message.payload().size());
+    }
+
+    bool ShmTopicRing::publish(uint64_t sequence, uint64_t timestamp, const void *payload, std::size_t size)
+    {
+        meta_.clear();
+        return publish_slot(sequence, timestamp, meta_, payload, size);
+    }
+
+    bool ShmTopicRing::publish_slot(uint64_t sequence, uint64_t timestamp, const std::string &meta,
+                                    const void *payload, std::size_t size)
+    {
+        if (!owner_ || size > max_payload() || meta.size() > max_payload() - size)
+        {
+            return false;
+        }
+        const uint64_t index = header_->write_index.load(std::memory_order_relaxed);
+        SlotHeader *s = slot(index);
+
+        s->stamp.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s->sequence = sequence;
+        s->timestamp = timestamp;
+        s->length = static_cast<uint32_t>(size);
+        s->meta_length = static_cast<uint32_t>(meta.size());
+        char *data = reinterpret_cast<char *>(s) + sizeof(SlotHeader);
+        if (!meta.empty())
+        {
+            std::memcpy(data, meta.data(), meta.size());
+        }
+        if (size != 0)
+        {
+            std::memcpy(data + meta.size(), payload, size);
+        }
+        s->stamp.store(2 * index + 2, std::memory_order_release);
+        header_->write_index.store(index + 1, std::memory_order_release);
+        return true;
+    }
+
+    ShmTopicRing::ReadStatus ShmTopicRing::read(TopicMessage *out, uint64_t *lost)
+    {
+        const uint64_t slot_count = slot_count_;
+        std::string meta;
+        for (;;)
+        {
+            const uint64_t write_index = header_->write_index.load(std::memory_order_acquire);
+            if (write_index < read_index_)
+            {
+                // Publisher 重建了共享内存段，从当前位置重新开始
+                read_index_ = write_index;
+            }
+            if (read_index_ == write_index)
+            {
+                return ReadStatus::kEmpty;
+            }
+            if (write_index - read_index_ > slot_count)
+            {
+                const uint64_t oldest = write_index - slot_count;
+                if (lost != nullptr)
+                {
+                    *lost += oldest - read_index_;
+                }
+                read_index_ = oldest;
+            }
+
+            const SlotHeader *s = slot(read_index_);
+            const uint64_t expected = 2 * read_index_ + 2;
+            const uint64_t before = s->stamp.load(std::memory_order_acquire);
+            if (before < expected)
+            {
+                // 写入尚未完成
+                return ReadStatus::kEmpty;
+            }
+            if (before == expected)
+            {
+                const uint32_t length = s->length;
+                const uint32_t meta_length = s->meta_length;
+                const uint64_t sequence = s->sequence;
+                const uint64_t timestamp = s->timestamp;
+                // 长度来自共享内存，先按本地缓存的槽位大小校验再拷贝
+                const bool fits = length <= max_payload() && meta_length <= max_payload() - length;
+                if (fits)
+                {
+                    const char *data = reinterpret_cast<const char *>(s) + sizeof(SlotHeader);
+                    meta.assign(data, meta_length);
+                    out->mutable_payload()->assign(data + meta_length, length);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (s->stamp.load(std::memory_order_relaxed) == expected && fits)
+                {
+                    // 附加字段在槽位稳定后再解析；先清掉上一条消息留下的字段（保留 payload 的缓冲区）
+                    std::string payload;
+                    out->mutable_payload()->swap(payload);
+                    const bool parsed = meta.empty() ? (out->Clear(), true) : out->ParseFromString(meta);
+                    out->mutable_payload()->swap(payload);
+                    if (parsed)
+                    {
+                        out->set_sequence(sequence);
+                        out->set_timestamp(timestamp);
+                        ++read_index_;
+                        return ReadStatus::kMessage;
+                    }
+                }
+            }
+            // 读取期间槽位被覆盖：计为丢失并继续
+            if (lost != nullptr)
+            {
+                ++*lost;
+            }
+            ++read_index_;
+        }
+    }
+
+    ShmTopicRing::ReadStatus ShmTopicRing::wait(TopicMessage *out, uint64_t *lost, std::chrono::microseconds timeout)
+    {
+        constexpr int kSpinRounds = 2000;
+        constexpr auto kYieldPhase = std::chrono::microseconds(200);
+        constexpr auto kSleepStep = std::chrono::microseconds(20);
+
+        for (int i = 0; i < kSpinRounds; ++i)
+        {
+            if (read(out, lost) == ReadStatus::kMessage)
+            {
+                return ReadStatus::kMessage;
+            }
+        }
+        const auto start = std::chrono::steady_clock::now();
+        for (;;)
+        {
+            if (read(out, lost) == ReadStatus::kMessage)
+            {
+                return ReadStatus::kMessage;
+            }
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            if (elapsed >= timeout)
+            {
+                return ReadStatus::kEmpty;
+            }
+            if (elapsed < kYieldPhase)
+            {
+                sched_yield();
+            }
+            else
+            {
+                std::this_thread::sleep_for(kSleepStep);
+            }
+        }
+    }
+
+    std::string shm_segment_name(const std::string &topic_name)
+    {
+        constexpr std::size_t kMaxReadable = 160;
+        std::string name = "/chric_topic_";
+        for (std::size_t i = 0; i < topic_name.size() && i < kMaxReadable; ++i)
+        {
+            const unsigned char c = static_cast<unsigned char>(topic_name[i]);
+            name.push_back(std::isalnum(c) ? static_cast<char>(c) : '_');
+        }
+        // 附加完整名称的哈希，避免 "a/b" 与 "a_b" 等清洗后同名
+        char suffix[24];
+        std::snprintf(suffix, sizeof(suffix), "_%016llx", static_cast<unsigned long long>(fnv1a(topic_name)));
+        name.append(suffix);
+        return name;
+    }
+
+    const std::string &local_host_id()
+    {
+        static const std::string id = []
+        {
+            char host[256] = {0};
+            gethostname(host, sizeof(host) - 1);
+            std::string boot_id;
+            std::ifstream in("/proc/sys/kernel/random/boot_id");
+            std::getline(in, boot_id);
+            return std::string(host) + "/" + boot_id;
+        }();
+        return id;
+    }
+
+    void prepare_local_subscribe(SubscribeRequest *request, bool ring_attached)
+    {
+        request->set_host_id(local_host_id());
+        request->set_accept_shm(ring_attached);
+    }
+
+    bool accepts_local_transport(const SubscribeRequest &request)
+    {
+        return request.accept_shm() && request.host_id() == local_host_id();
+    }
+
+    void make_shm_handshake(const std::string &topic_name, const std::string &publisher_id,
+                            const ShmTopicRing &ring, TopicMessage *out)
+    {
+        out->Clear();
+        out->set_topic_name(topic_name);
+        out->set_publisher_id(publisher_id);
+        out->set_shm_segment(ring.segment_name());
+    }
+} // namespace humanoid_robot::utils::PB
@@ -0,0 +1,570 @@
+#include "spanTracer.h"
+#include "latencyHistogram.h"
+#include "spscRing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <unistd.h>
+
+namespace
+{
+    std::atomic<uint64_t> g_next_tracer_id{1};
+
+    uint32_t fnv1a(const std::string &data)
+    {
+        uint32_t hash = 2166136261u;
+        for (const char c : data)
+        {
+            hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+        }
+        return hash;
+    }
+
+    uint32_t load_clock_id()
+    {
+        // 同一次开机内 CLOCK_MONOTONIC 在所有进程间一致，boot_id 正好标识这个范围
+        std::string identity;
+        std::ifstream boot_id("/proc/sys/kernel/random/boot_id");
+        if (!std::getline(boot_id, identity) || identity.empty())
+        {
+            char host[256] = {};
+            if (gethostname(host, sizeof(host) - 1) == 0)
+            {
+                identity = host;
+            }
+        }
+        const uint32_t id = fnv1a(identity);
+        return id == 0 ? 1 : id;
+    }
+
+    void append_number(std::string *out, uint64_t value, int width = 0)
+    {
+        char buffer[24];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        for (int n = static_cast<int>(result.ptr - buffer); n < width; ++n)
+        {
+            out->push_back('0');
+        }
+        out->append(buffer, static_cast<std::size_t>(result.ptr - buffer));
+    }
+
+    // 纳秒写成带 3 位小数的微秒
+    void append_micros(std::string *out, uint64_t ns)
+    {
+        append_number(out, ns / 1000);
+        out->push_back('.');
+        append_number(out, ns % 1000, 3);
+    }
+
+    void append_json_string(std::string *out, const char *text)
+    {
+        out->push_back('"');
+        for (const char *p = text; *p != '\0'; ++p)
+        {
+            const unsigned char c = static_cast<unsigned char>(*p);
+            if (c == '"' || c == '\\')
+            {
+                out->push_back('\\');
+                out->push_back(static_cast<char>(c));
+            }
+            else if (c < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out->append(escaped);
+            }
+            else
+            {
+                out->push_back(static_cast<char>(c));
+            }
+        }
+        out->push_back('"');
+    }
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    // 单生产者（所属线程）单消费者（drain 调用方，持有 tracer 的锁）环形队列
+    class SpanRing : public SpscRing<SpanRecord>
+    {
+    public:
+        SpanRing(std::size_t capacity, uint32_t thread) : SpscRing<SpanRecord>(capacity), thread_(thread) {}
+
+        // 仅由所属线程调用
+        bool push(const char *name, uint64_t trace_id, uint64_t start_ns, uint64_t duration_ns)
+        {
+            return SpscRing<SpanRecord>::push([&](SpanRecord &slot)
+                                              {
+                slot.name = name;
+                slot.trace_id = trace_id;
+                slot.start_ns = start_ns;
+                slot.duration_ns = duration_ns;
+                slot.thread = thread_; });
+        }
+
+        // 仅由持有 tracer 锁的一方调用
+        std::size_t consume(std::vector<SpanRecord> *out)
+        {
+            return SpscRing<SpanRecord>::consume([out](const SpanRecord &slot)
+                                                 { out->push_back(slot); });
+        }
+
+        uint64_t recorded() const { return enqueued(); }
+
+    private:
+        const uint32_t thread_;
+    };
+} // namespace humanoid_robot::utils::PB
+
+namespace
+{
+    using humanoid_robot::utils::PB::SpanRing;
+
+    // 每个线程持有自己在各个 tracer 中的队列；线程退出时标记为 detached，由 drain() 排空后回收
+    struct LocalRings
+    {
+        struct Entry
+        {
+            uint64_t tracer_id;
+            std::shared_ptr<SpanRing> ring;
+        };
+
+        std::vector<Entry> entries;
+
+        ~LocalRings()
+        {
+            for (const Entry &entry : entries)
+            {
+                entry.ring->detached.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    thread_local LocalRings t_local_rings;
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    using humanoid_robot::PB::common::TraceContext;
+    using humanoid_robot::PB::common::TraceHop;
+    using humanoid_robot::PB::common::TraceStage;
+
+    uint64_t trace_clock_ns()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+    }
+
+    uint32_t trace_clock_id()
+    {
+        static const uint32_t id = load_clock_id();
+        return id;
+    }
+
+    uint64_t new_trace_id()
+    {
+        thread_local std::mt19937_64 rng([]
+                                         {
+            std::random_device device;
+            return (static_cast<uint64_t>(device()) << 32) ^ device() ^ trace_clock_ns(); }());
+        uint64_t id = rng();
+        while (id == 0)
+        {
+            id = rng();
+        }
+        return id;
+    }
+
+    const char *trace_stage_name(TraceStage stage)
+    {
+        switch (stage)
+        {
+        case humanoid_robot::PB::common::TRACE_STAGE_CAPTURE:
+            return "capture";
+        case humanoid_robot::PB::common::TRACE_STAGE_TRANSPORT:
+            return "transport";
+        case humanoid_robot::PB::common::TRACE_STAGE_PERCEPTION:
+            return "perception";
+        case humanoid_robot::PB::common::TRACE_STAGE_DETECTION:
+            return "detection";
+        case humanoid_robot::PB::common::TRACE_STAGE_PLANNER:
+            return "planner";
+        case humanoid_robot::PB::common::TRACE_STAGE_CONTROL:
+            return "control";
+        default:
+            return "stage";
+        }
+    }
+
+    void start_trace(TraceContext *context)
+    {
+        if (context->trace_id() == 0)
+        {
+            context->set_trace_id(new_trace_id());
+        }
+    }
+
+    TraceHop *add_hop(TraceContext *context, TraceStage stage, uint64_t start_ns, uint64_t end_ns)
+    {
+        TraceHop *hop = context->add_hops();
+        hop->set_stage(stage);
+        hop->set_start_ns(start_ns);
+        hop->set_duration_ns(end_ns > start_ns ? end_ns - start_ns : 0);
+        hop->set_clock_id(trace_clock_id());
+        return hop;
+    }
+
+    std::vector<HopLatency> hop_latencies(const TraceContext &context)
+    {
+        std::vector<HopLatency> out;
+        out.reserve(static_cast<std::size_t>(context.hops_size()));
+        const TraceHop *previous = nullptr;
+        for (const TraceHop &hop : context.hops())
+        {
+            HopLatency latency;
+            latency.stage = hop.stage();
+            latency.duration_ns = hop.duration_ns();
+            if (previous != nullptr && previous->clock_id() == hop.clock_id())
+            {
+                // 同一时钟域内可能因阶段并行而重叠，此时间隔为负
+                latency.gap_ns = static_cast<int64_t>(hop.start_ns() - (previous->start_ns() + previous->duration_ns()));
+            }
+            out.push_back(latency);
+            previous = &hop;
+        }
+        return out;
+    }
+
+    int64_t end_to_end_ns(const TraceContext &context)
+    {
+        if (context.hops().empty())
+        {
+            return -1;
+        }
+        const TraceHop &first = context.hops(0);
+        uint64_t end = 0;
+        for (const TraceHop &hop : context.hops())
+        {
+            if (hop.clock_id() != first.clock_id())
+            {
+                return -1;
+            }
+            end = std::max(end, hop.start_ns() + hop.duration_ns());
+        }
+        return static_cast<int64_t>(end - first.start_ns());
+    }
+
+    // ------ SpanTracer
+
+    SpanTracer::SpanTracer(std::size_t ring_capacity)
+        : ring_capacity_(ring_capacity), id_(g_next_tracer_id.fetch_add(1, std::memory_order_relaxed))
+    {
+    }
+
+    SpanTracer::~SpanTracer()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &ring : rings_)
+        {
+            ring->closed.store(true, std::memory_order_release);
+        }
+    }
+
+    SpanRing *SpanTracer::register_local_ring()
+    {
+        // 本线程首次使用此 tracer：顺便清理已析构 tracer 的队列
+        auto &entries = t_local_rings.entries;
+        for (std::size_t i = 0; i < entries.size();)
+        {
+            if (entries[i].ring->closed.load(std::memory_order_acquire))
+            {
+                entries[i] = std::move(entries.back());
+                entries.pop_back();
+            }
+            else
+            {
+                ++i;
+            }
+        }
+        std::shared_ptr<SpanRing> ring;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ring = std::make_shared<SpanRing>(ring_capacity_, next_thread_++);
+            rings_.push_back(ring);
+        }
+        entries.push_back({id_, ring});
+        return ring.get();
+    }
+
+    SpanRing *SpanTracer::local_ring()
+    {
+        for (const auto &entry : t_local_rings.entries)
+        {
+            if (entry.tracer_id == id_)
+            {
+                return entry.ring.get();
+            }
+        }
+        return register_local_ring();
+    }
+
+    bool SpanTracer::record(const char *name, uint64_t trace_id, uint64_t start_ns, uint64_t end_ns)
+    {
+        return local_ring()->push(name, trace_id, start_ns, end_ns > start_ns ? end_ns - start_ns : 0);
+    }
+
+    std::size_t SpanTracer::record_hops(const TraceContext &context)
+    {
+        // 其他时钟域的时间戳无法放到本机时间轴上
+        const uint32_t clock_id = trace_clock_id();
+        SpanRing *ring = local_ring();
+        std::size_t count = 0;
+        for (const TraceHop &hop : context.hops())
+        {
+            if (hop.clock_id() == clock_id &&
+                ring->push(trace_stage_name(hop.stage()), context.trace_id(), hop.start_ns(), hop.duration_ns()))
+            {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    std::size_t SpanTracer::drain(std::vector<SpanRecord> *out)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < rings_.size();)
+        {
+            SpanRing &ring = *rings_[i];
+            // 先读 detached 再排空：之后不会再有新的 span
+            const bool detached = ring.detached.load(std::memory_order_acquire);
+            count += ring.consume(out);
+            if (detached)
+            {
+                retired_recorded_ += ring.recorded();
+                retired_dropped_ += ring.dropped();
+                rings_[i] = std::move(rings_.back());
+                rings_.pop_back();
+            }
+            else
+            {
+                ++i;
+            }
+        }
+        return count;
+    }
+
+    std::size_t SpanTracer::export_chrome_trace(std::string *out)
+    {
+        std::vector<SpanRecord> spans;
+        const std::size_t count = drain(&spans);
+        format_chrome_trace(spans, out);
+        return count;
+    }
+
+    bool SpanTracer::write_chrome_trace(const std::string &path)
+    {
+        std::string json;
+        export_chrome_trace(&json);
+        std::FILE *file = std::fopen(path.c_str(), "w");
+        if (file == nullptr)
+        {
+            return false;
+        }
+        const bool ok = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+        return std::fclose(file) == 0 && ok;
+    }
+
+    uint64_t SpanTracer::recorded() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t total = retired_recorded_;
+        for (const auto &ring : rings_)
+        {
+            total += ring->recorded();
+        }
+        return total;
+    }
+
+    uint64_t SpanTracer::dropped() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t total = retired_dropped_;
+        for (const auto &ring : rings_)
+        {
+            total += ring->dropped();
+        }
+        return total;
+    }
+
+    void format_chrome_trace(const std::vector<SpanRecord> &spans, std::string *out)
+    {
+        const uint64_t pid = static_cast<uint64_t>(getpid());
+        out->reserve(out->size() + 32 + spans.size() * 128);
+        out->append("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+        bool first = true;
+        for (const SpanRecord &span : spans)
+        {
+            out->append(first ? "\n" : ",\n");
+            first = false;
+            out->append("{\"name\":");
+            append_json_string(out, span.name != nullptr ? span.name : "span");
+            out->append(",\"ph\":\"X\",\"ts\":");
+            append_micros(out, span.start_ns);
+            out->append(",\"dur\":");
+            append_micros(out, span.duration_ns);
+            out->append(",\"pid\":");
+            append_number(out, pid);
+            out->append(",\"tid\":");
+            append_number(out, span.thread);
+            // 64 位 id 超出 JSON 数值精度，按 16 位十六进制字符串输出
+            char trace_id[17];
+            std::snprintf(trace_id, sizeof(trace_id), "%016llx", static_cast<unsigned long long>(span.trace_id));
+            out->append(",\"args\":{\"trace_id\":\"");
+            out->append(trace_id, 16);
+            out->append("\"}}");
+        }
+        out->append("\n]}\n");
+    }
+
+    // ------ HopScope
+
+    HopScope::HopScope(TraceContext *context, TraceStage stage, SpanTracer *tracer, uint64_t start_ns)
+        : context_(context), stage_(stage), tracer_(tracer), start_ns_(start_ns != 0 ? start_ns : trace_clock_ns())
+    {
+    }
+
+    HopScope::~HopScope()
+    {
+        const uint64_t end_ns = trace_clock_ns();
+        add_hop(context_, stage_, start_ns_, end_ns);
+        if (tracer_ != nullptr)
+        {
+            tracer_->record(trace_stage_name(stage_), context_->trace_id(), start_ns_, end_ns);
+        }
+    }
+
+    // ------ LatencyBreakdown
+
+    struct LatencyBreakdown::Entry
+    {
+        TraceStage stage;
+        LatencyHistogram duration;
+        LatencyHistogram gap; // 负间隔（阶段重叠）按 0 计
+    };
+
+    LatencyBreakdown::LatencyBreakdown() : total_(std::make_unique<LatencyHistogram>()) {}
+
+    LatencyBreakdown::~LatencyBreakdown() = default;
+
+    void LatencyBreakdown::add(const TraceContext &context)
+    {
+        const TraceHop *previous = nullptr;
+        for (const TraceHop &hop : context.hops())
+        {
+            Entry *entry = nullptr;
+            for (const auto &candidate : entries_)
+            {
+                if (candidate->stage == hop.stage())
+                {
+                    entry = candidate.get();
+                    break;
+                }
+            }
+            if (entry == nullptr)
+            {
+                entries_.push_back(std::make_unique<Entry>());
+                entry = entries_.back().get();
+                entry->stage = hop.stage();
+            }
+            entry->duration.record(hop.duration_ns());
+            if (previous != nullptr && previous->clock_id() == hop.clock_id())
+            {
+                const uint64_t previous_end = previous->start_ns() + previous->duration_ns();
+                entry->gap.record(hop.start_ns() > previous_end ? hop.start_ns() - previous_end : uint64_t(0));
+            }
+            previous = &hop;
+        }
+        const int64_t total = end_to_end_ns(context);
+        if (total >= 0)
+        {
+            total_->record(static_cast<uint64_t>(total));
+        }
+    }
+
+    std::vector<TraceStageLatency> LatencyBreakdown::stages() const
+    {
+        std::vector<TraceStageLatency> out;
+        out.reserve(entries_.size());
+        for (const auto &entry : entries_)
+        {
+            TraceStageLatency latency;
+            latency.stage = entry->stage;
+            latency.count = entry->duration.count();
+            latency.mean_ns = entry->duration.mean_ns();
+            latency.p50_ns = static_cast<uint64_t>(entry->duration.percentile(0.5).count());
+            latency.p99_ns = static_cast<uint64_t>(entry->duration.percentile(0.99).count());
+            latency.max_ns = entry->duration.max_ns();
+            latency.gap_count = entry->gap.count();
+            latency.gap_mean_ns = entry->gap.mean_ns();
+            latency.gap_p99_ns = static_cast<uint64_t>(entry->gap.percentile(0.99).count());
+            out.push_back(latency);
+        }
+        return out;
+    }
+
+    TraceStageLatency LatencyBreakdown::end_to_end() const
+    {
+        TraceStageLatency latency;
+        latency.count = total_->count();
+        latency.mean_ns = total_->mean_ns();
+        latency.p50_ns = static_cast<uint64_t>(total_->percentile(0.5).count());
+        latency.p99_ns = static_cast<uint64_t>(total_->percentile(0.99).count());
+        latency.max_ns = total_->max_ns();
+        return latency;
+    }
+
+    std::string LatencyBreakdown::report() const
+    {
+        std::string out;
+        char line[160];
+        std::snprintf(line, sizeof(line), "%-12s %10s %10s %10s %10s %10s %10s %10s\n",
+                      "stage", "count", "mean_us", "p50_us", "p99_us", "max_us", "gap_us", "gap_p99_us");
+        out.append(line);
+        auto row = [&](const char *name, const TraceStageLatency &latency, bool with_gap)
+        {
+            std::snprintf(line, sizeof(line), "%-12s %10llu %10.1f %10.1f %10.1f %10.1f ", name,
+                          static_cast<unsigned long long>(latency.count), latency.mean_ns / 1e3, latency.p50_ns / 1e3,
+                          latency.p99_ns / 1e3, latency.max_ns / 1e3);
+            out.append(line);
+            if (with_gap && latency.gap_count != 0)
+            {
+                std::snprintf(line, sizeof(line), "%10.1f %10.1f\n", latency.gap_mean_ns / 1e3, latency.gap_p99_ns / 1e3);
+            }
+            else
+            {
+                std::snprintf(line, sizeof(line), "%10s %10s\n", "-", "-");
+            }
+            out.append(line);
+        };
+        for (const TraceStageLatency &latency : stages())
+        {
+            row(trace_stage_name(latency.stage), latency, true);
+        }
+        row("end_to_end", end_to_end(), false);
+        return out;
+    }
+
+    void LatencyBreakdown::reset()
+    {
+        entries_.clear();
+        total_->clear();
+    }
+} // namespace humanoid_robot::utils::PB
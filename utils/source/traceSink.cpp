@@ -0,0 +1,445 @@
+#include "traceSink.h"
+#include "spscRing.h"
+
+#include <charconv>
+
+namespace
+{
+    constexpr std::size_t kWriteChunk = 64 * 1024;       // 后台线程累计到此大小才写一次
+    constexpr std::size_t kMaxRetainedWire = 64 * 1024; // 槽位保留的序列化缓冲区上限
+
+    std::atomic<uint64_t> g_next_sink_id{1};
+
+    void append_number(std::string *out, uint64_t value, int width)
+    {
+        char buffer[24];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        for (int n = static_cast<int>(result.ptr - buffer); n < width; ++n)
+        {
+            out->push_back('0');
+        }
+        out->append(buffer, static_cast<std::size_t>(result.ptr - buffer));
+    }
+
+    void append_timestamp(std::string *out, int64_t ns)
+    {
+        append_number(out, static_cast<uint64_t>(ns / 1000000000), 0);
+        out->push_back('.');
+        append_number(out, static_cast<uint64_t>(ns % 1000000000), 9);
+        out->push_back(' ');
+    }
+
+    int64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    struct TraceRecord
+    {
+        int64_t timestamp_ns = 0;
+        const char *tag = nullptr;
+        std::shared_ptr<const google::protobuf::Message> message; // trace() 的快照
+        const google::protobuf::Descriptor *descriptor = nullptr; // trace_copy() 的快照：类型 + 序列化数据
+        std::string wire;                                          // 随槽位复用，稳态不分配
+    };
+
+    // 单生产者（所属线程）单消费者（后台线程）环形队列
+    class TraceRing : public SpscRing<TraceRecord>
+    {
+    public:
+        explicit TraceRing(std::size_t capacity) : SpscRing<TraceRecord>(capacity) {}
+
+        // 仅由后台线程调用：逐条回调后释放快照引用，返回处理的条数
+        template <typename Fn>
+        std::size_t consume(Fn &&fn)
+        {
+            return SpscRing<TraceRecord>::consume([&fn](TraceRecord &record)
+                                                  {
+                fn(record);
+                record.message.reset();
+                if (record.wire.capacity() > kMaxRetainedWire)
+                {
+                    std::string().swap(record.wire);
+                } });
+        }
+
+        uint64_t reported_dropped = 0; // 后台线程已在输出中提示过的丢弃数
+    };
+} // namespace humanoid_robot::utils::PB
+
+namespace
+{
+    using humanoid_robot::utils::PB::TraceRing;
+
+    // 每个线程持有自己在各个 sink 中的队列；线程退出时标记为 detached，由后台线程排空后回收
+    struct LocalRings
+    {
+        struct Entry
+        {
+            uint64_t sink_id;
+            std::shared_ptr<TraceRing> ring;
+        };
+
+        std::vector<Entry> entries;
+
+        ~LocalRings()
+        {
+            for (const Entry &entry : entries)
+            {
+                entry.ring->detached.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    thread_local LocalRings t_local_rings;
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    TraceSink::TraceSink(TraceOptions options)
+        : options_(std::move(options)), id_(g_next_sink_id.fetch_add(1, std::memory_order_relaxed))
+    {
+    }
+
+    TraceSink::~TraceSink()
+    {
+        stop();
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &ring : rings_)
+        {
+            ring->closed.store(true, std::memory_order_release);
+        }
+        if (file_ != nullptr && file_ != stderr)
+        {
+            std::fclose(file_);
+        }
+    }
+
+    bool TraceSink::start()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_)
+        {
+            return true;
+        }
+        if (!options_.writer && file_ == nullptr)
+        {
+            file_ = options_.path.empty() ? stderr : std::fopen(options_.path.c_str(), "a");
+            if (file_ == nullptr)
+            {
+                return false;
+            }
+        }
+        running_ = true;
+        consumer_ = std::thread([this]
+                                { run(); });
+        return true;
+    }
+
+    void TraceSink::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_ = false;
+        }
+        cv_.notify_all();
+        if (consumer_.joinable())
+        {
+            consumer_.join();
+        }
+    }
+
+    TraceRing *TraceSink::register_local_ring()
+    {
+        // 本线程首次使用此 sink：顺便清理已析构 sink 的队列
+        auto &entries = t_local_rings.entries;
+        for (std::size_t i = 0; i < entries.size();)
+        {
+            if (entries[i].ring->closed.load(std::memory_order_acquire))
+            {
+                entries[i] = std::move(entries.back());
+                entries.pop_back();
+            }
+            else
+            {
+                ++i;
+            }
+        }
+        auto ring = std::make_shared<TraceRing>(options_.ring_capacity);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            rings_.push_back(ring);
+            ++rings_version_;
+        }
+        entries.push_back({id_, ring});
+        return ring.get();
+    }
+
+    TraceRing *TraceSink::local_ring()
+    {
+        // 热路径只取裸指针，避免每条记录一次引用计数原子操作
+        for (const auto &entry : t_local_rings.entries)
+        {
+            if (entry.sink_id == id_)
+            {
+                return entry.ring.get();
+            }
+        }
+        return register_local_ring();
+    }
+
+    bool TraceSink::trace(const char *tag, std::shared_ptr<const google::protobuf::Message> message)
+    {
+        TraceRing *ring = local_ring();
+        return ring->push([&](TraceRecord &record)
+                          {
+            record.timestamp_ns = now_ns();
+            record.tag = tag;
+            record.message = std::move(message);
+            record.descriptor = nullptr; });
+    }
+
+    bool TraceSink::trace_copy(const char *tag, const google::protobuf::Message &message)
+    {
+        // 序列化比 CopyFrom 便宜得多（不逐字段分配），解析与格式化都留给后台线程
+        return local_ring()->push([&](TraceRecord &record)
+                                  {
+            record.timestamp_ns = now_ns();
+            record.tag = tag;
+            record.descriptor = message.GetDescriptor();
+            message.SerializeToString(&record.wire); });
+    }
+
+    void TraceSink::flush()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!running_)
+        {
+            return;
+        }
+        const uint64_t target = ++flush_requested_;
+        FlushRequest request{target, {}};
+        for (const auto &ring : rings_)
+        {
+            if (!ring->empty())
+            {
+                request.marks.emplace_back(ring, ring->enqueued());
+            }
+        }
+        flush_requests_.push_back(std::move(request));
+        cv_.notify_all();
+        cv_.wait(lock, [&]
+                 { return flush_completed_ >= target || !running_; });
+    }
+
+    uint64_t TraceSink::enqueued() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t total = retired_enqueued_;
+        for (const auto &ring : rings_)
+        {
+            total += ring->enqueued();
+        }
+        return total;
+    }
+
+    uint64_t TraceSink::dropped() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t total = retired_dropped_;
+        for (const auto &ring : rings_)
+        {
+            total += ring->dropped();
+        }
+        return total;
+    }
+
+    uint64_t TraceSink::written() const
+    {
+        return written_.load(std::memory_order_relaxed);
+    }
+
+    void TraceSink::write(std::string *buffer)
+    {
+        if (buffer->empty())
+        {
+            return;
+        }
+        if (options_.writer)
+        {
+            options_.writer(*buffer);
+        }
+        else
+        {
+            std::fwrite(buffer->data(), 1, buffer->size(), file_);
+        }
+        buffer->clear();
+    }
+
+    const google::protobuf::Message *TraceSink::parse_snapshot(const TraceRecord &record)
+    {
+        if (record.descriptor == nullptr)
+        {
+            return nullptr;
+        }
+        google::protobuf::Message *message = nullptr;
+        for (const auto &entry : parse_cache_)
+        {
+            if (entry.first == record.descriptor)
+            {
+                message = entry.second.get();
+                break;
+            }
+        }
+        if (message == nullptr)
+        {
+            // 只支持生成类型；DynamicMessage 等没有生成原型的类型输出为 null
+            const auto *prototype =
+                google::protobuf::MessageFactory::generated_factory()->GetPrototype(record.descriptor);
+            if (prototype == nullptr)
+            {
+                return nullptr;
+            }
+            parse_cache_.emplace_back(record.descriptor, std::unique_ptr<google::protobuf::Message>(prototype->New()));
+            message = parse_cache_.back().second.get();
+        }
+        return message->ParseFromString(record.wire) ? message : nullptr;
+    }
+
+    bool TraceSink::drain(const std::vector<std::shared_ptr<TraceRing>> &rings, std::string *buffer)
+    {
+        bool progressed = false;
+        for (const auto &ring : rings)
+        {
+            const std::size_t count = ring->consume([&](const TraceRecord &record)
+                                                    {
+                append_timestamp(buffer, record.timestamp_ns);
+                buffer->append(record.tag != nullptr ? record.tag : "-");
+                buffer->push_back(' ');
+                if (record.message)
+                {
+                    format_message(*record.message, buffer, options_.format);
+                }
+                else if (const google::protobuf::Message *parsed = parse_snapshot(record))
+                {
+                    format_message(*parsed, buffer, options_.format);
+                }
+                else
+                {
+                    buffer->append("null");
+                }
+                buffer->push_back('\n');
+                if (buffer->size() >= kWriteChunk)
+                {
+                    write(buffer);
+                } });
+            written_.fetch_add(count, std::memory_order_relaxed);
+            progressed = progressed || count != 0;
+
+            const uint64_t dropped = ring->dropped();
+            if (dropped != ring->reported_dropped)
+            {
+                append_timestamp(buffer, now_ns());
+                buffer->append("trace dropped ");
+                append_number(buffer, dropped - ring->reported_dropped, 0);
+                buffer->append(" records\n");
+                ring->reported_dropped = dropped;
+            }
+        }
+        return progressed;
+    }
+
+    void TraceSink::run()
+    {
+        std::string buffer;
+        buffer.reserve(kWriteChunk + 4096);
+        std::vector<std::shared_ptr<TraceRing>> rings; // rings_ 的快照，仅在注册/回收后更新
+        uint64_t rings_version = ~0ull;
+        auto last_flush = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;)
+        {
+            // 回收生产者线程已退出且已排空的队列
+            for (std::size_t i = 0; i < rings_.size();)
+            {
+                const auto &ring = rings_[i];
+                if (ring->detached.load(std::memory_order_acquire) && ring->empty() &&
+                    ring->dropped() == ring->reported_dropped)
+                {
+                    retired_enqueued_ += ring->enqueued();
+                    retired_dropped_ += ring->dropped();
+                    rings_[i] = std::move(rings_.back());
+                    rings_.pop_back();
+                    ++rings_version_;
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+            if (rings_version != rings_version_)
+            {
+                rings = rings_;
+                rings_version = rings_version_;
+            }
+            const uint64_t requested = flush_requested_;
+            // 只有本轮开始前已登记的 flush 请求才能在本轮写出后完成
+            const std::size_t flush_checked = flush_requests_.size();
+            const bool stopping = !running_;
+            lock.unlock();
+
+            const bool progressed = drain(rings, &buffer);
+            const auto now = std::chrono::steady_clock::now();
+            if (!progressed || flush_checked != 0 || now - last_flush >= options_.flush_interval)
+            {
+                write(&buffer);
+                if (file_ != nullptr)
+                {
+                    std::fflush(file_);
+                }
+                last_flush = now;
+            }
+
+            lock.lock();
+            // 各队列已消费到请求时的写位置即完成，不要求队列为空
+            std::size_t done = 0;
+            while (done < flush_checked)
+            {
+                bool drained = true;
+                for (const auto &mark : flush_requests_[done].marks)
+                {
+                    drained = drained && mark.first->consumed() >= mark.second;
+                }
+                if (!drained)
+                {
+                    break;
+                }
+                ++done;
+            }
+            if (done != 0)
+            {
+                flush_completed_ = flush_requests_[done - 1].id;
+                flush_requests_.erase(flush_requests_.begin(), flush_requests_.begin() + static_cast<std::ptrdiff_t>(done));
+                cv_.notify_all();
+            }
+            if (progressed)
+            {
+                continue;
+            }
+            if (stopping)
+            {
+                break;
+            }
+            cv_.wait_for(lock, options_.poll_interval, [&]
+                         { return flush_requested_ != requested || !running_; });
+        }
+        // 停止后等待者已按 running_ 返回
+        flush_requests_.clear();
+        cv_.notify_all();
+    }
+} // namespace humanoid_robot::utils::PB
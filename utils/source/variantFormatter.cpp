@@ -0,0 +1,747 @@
+#include "variantFormatter.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include "packedArrayUtil.h"
+
+using namespace humanoid_robot::PB::common;
+using google::protobuf::FieldDescriptor;
+using google::protobuf::Message;
+using google::protobuf::Reflection;
+
+namespace
+{
+    using humanoid_robot::utils::PB::FormatOptions;
+    using humanoid_robot::utils::PB::FormatStyle;
+
+    // 追加到 std::string
+    class StringSink
+    {
+    public:
+        explicit StringSink(std::string *out) : out_(out) {}
+
+        void append(const char *data, std::size_t size) { out_->append(data, size); }
+        void append(char c) { out_->push_back(c); }
+        bool full() const { return false; }
+
+    private:
+        std::string *out_;
+    };
+
+    // 写入定长缓冲区，写满后丢弃后续输出
+    class FixedSink
+    {
+    public:
+        FixedSink(char *buffer, std::size_t capacity) : buffer_(buffer), capacity_(capacity) {}
+
+        void append(const char *data, std::size_t size)
+        {
+            const std::size_t room = capacity_ - size_;
+            const std::size_t n = size < room ? size : room;
+            std::memcpy(buffer_ + size_, data, n);
+            size_ += n;
+            truncated_ = truncated_ || n < size;
+        }
+
+        void append(char c) { append(&c, 1); }
+        bool full() const { return truncated_; }
+
+        std::size_t finish()
+        {
+            if (truncated_ && capacity_ >= 3)
+            {
+                std::memcpy(buffer_ + capacity_ - 3, "...", 3);
+            }
+            return size_;
+        }
+
+    private:
+        char *buffer_;
+        std::size_t capacity_;
+        std::size_t size_ = 0;
+        bool truncated_ = false;
+    };
+
+    template <typename Sink>
+    class Formatter
+    {
+    public:
+        Formatter(Sink &sink, const FormatOptions &options)
+            : sink_(sink), options_(options), json_(options.style == FormatStyle::kJson)
+        {
+        }
+
+        void variant(const Variant &v, int depth)
+        {
+            switch (v.value_case())
+            {
+            case Variant::kBoolValue:
+                boolean(v.boolvalue());
+                break;
+            case Variant::kInt8Value:
+                number(v.int8value());
+                break;
+            case Variant::kUint8Value:
+                number(v.uint8value());
+                break;
+            case Variant::kInt16Value:
+                number(v.int16value());
+                break;
+            case Variant::kUint16Value:
+                number(v.uint16value());
+                break;
+            case Variant::kInt32Value:
+                number(v.int32value());
+                break;
+            case Variant::kUint32Value:
+                number(v.uint32value());
+                break;
+            case Variant::kInt64Value:
+                number(v.int64value());
+                break;
+            case Variant::kUint64Value:
+                number(v.uint64value());
+                break;
+            case Variant::kFloatValue:
+                number(v.floatvalue());
+                break;
+            case Variant::kDoubleValue:
+                number(v.doublevalue());
+                break;
+            case Variant::kCharValue:
+            {
+                const char c = static_cast<char>(v.charvalue());
+                quoted(std::string_view(&c, 1));
+                break;
+            }
+            case Variant::kByteValue:
+                bytes(v.bytevalue());
+                break;
+            case Variant::kStringValue:
+                quoted(v.stringvalue());
+                break;
+            case Variant::kDateValue:
+                date(v.datevalue());
+                break;
+            case Variant::kTimestampValue:
+                timestamp(v.timestampvalue());
+                break;
+            case Variant::kDictValue:
+                dictionary(v.dictvalue(), depth + 1);
+                break;
+            case Variant::kImageValue:
+                message(v.imagevalue(), depth + 1);
+                break;
+            case Variant::kBboxValue:
+                message(v.bboxvalue(), depth + 1);
+                break;
+            case Variant::kMaskValue:
+                message(v.maskvalue(), depth + 1);
+                break;
+            case Variant::kPerceptionRowValue:
+                message(v.perceptionrowvalue(), depth + 1);
+                break;
+            case Variant::kDetectionRowValue:
+                message(v.detectionrowvalue(), depth + 1);
+                break;
+            case Variant::kDivisionRowValue:
+                message(v.divisionrowvalue(), depth + 1);
+                break;
+            case Variant::kBoolArrayValue:
+                array(v.boolarrayvalue().values(), [this](bool x)
+                      { boolean(x); });
+                break;
+            case Variant::kInt8ArrayValue:
+                numbers(v.int8arrayvalue().values());
+                break;
+            case Variant::kUint8ArrayValue:
+                numbers(v.uint8arrayvalue().values());
+                break;
+            case Variant::kInt16ArrayValue:
+                numbers(v.int16arrayvalue().values());
+                break;
+            case Variant::kUint16ArrayValue:
+                numbers(v.uint16arrayvalue().values());
+                break;
+            case Variant::kInt32ArrayValue:
+                numbers(v.int32arrayvalue().values());
+                break;
+            case Variant::kUint32ArrayValue:
+                numbers(v.uint32arrayvalue().values());
+                break;
+            case Variant::kInt64ArrayValue:
+                numbers(v.int64arrayvalue().values());
+                break;
+            case Variant::kUint64ArrayValue:
+                numbers(v.uint64arrayvalue().values());
+                break;
+            case Variant::kFloatArrayValue:
+                numbers(v.floatarrayvalue().values());
+                break;
+            case Variant::kDoubleArrayValue:
+                numbers(v.doublearrayvalue().values());
+                break;
+            case Variant::kCharArrayValue:
+                array(v.chararrayvalue().values(), [this](const std::string &x)
+                      { quoted(x); });
+                break;
+            case Variant::kByteArrayValue:
+                bytes(v.bytearrayvalue().values());
+                break;
+            case Variant::kStringArrayValue:
+                array(v.stringarrayvalue().values(), [this](const std::string &x)
+                      { quoted(x); });
+                break;
+            case Variant::kPackedInt8ArrayValue:
+                packed(v.packedint8arrayvalue());
+                break;
+            case Variant::kPackedUint8ArrayValue:
+                packed(v.packeduint8arrayvalue());
+                break;
+            case Variant::kPackedInt16ArrayValue:
+                packed(v.packedint16arrayvalue());
+                break;
+            case Variant::kPackedUint16ArrayValue:
+                packed(v.packeduint16arrayvalue());
+                break;
+            case Variant::VALUE_NOT_SET:
+            default:
+                raw("null");
+                break;
+            }
+        }
+
+        void dictionary(const Dictionary &dict, int depth)
+        {
+            const auto &map = dict.keyvaluelist();
+            if (depth > options_.max_depth)
+            {
+                collapsed(map.size());
+                return;
+            }
+            sink_.append('{');
+            std::size_t index = 0;
+            for (const auto &item : map)
+            {
+                if (index == options_.max_elements)
+                {
+                    separator(index);
+                    more_entries(map.size() - index);
+                    break;
+                }
+                separator(index++);
+                key(item.first);
+                variant(item.second, depth);
+                if (sink_.full())
+                {
+                    return;
+                }
+            }
+            sink_.append('}');
+        }
+
+        void message(const Message &m, int depth)
+        {
+            if (const auto *v = dynamic_cast<const Variant *>(&m))
+            {
+                variant(*v, depth - 1);
+                return;
+            }
+            if (const auto *d = dynamic_cast<const Dictionary *>(&m))
+            {
+                dictionary(*d, depth);
+                return;
+            }
+            const auto *descriptor = m.GetDescriptor();
+            const Reflection *reflection = m.GetReflection();
+            if (depth > options_.max_depth)
+            {
+                collapsed(static_cast<std::size_t>(descriptor->field_count()));
+                return;
+            }
+            sink_.append('{');
+            std::size_t written = 0;
+            for (int i = 0; i < descriptor->field_count(); ++i)
+            {
+                const FieldDescriptor *field = descriptor->field(i);
+                // proto3 标量字段的 HasField 表示非默认值；默认值字段不输出
+                if (field->is_repeated() ? reflection->FieldSize(m, field) == 0 : !reflection->HasField(m, field))
+                {
+                    continue;
+                }
+                separator(written++);
+                key(field->name());
+                if (field->is_map())
+                {
+                    map_field(m, field, depth);
+                }
+                else if (field->is_repeated())
+                {
+                    repeated_field(m, field, depth);
+                }
+                else
+                {
+                    singular_field(m, field, depth);
+                }
+                if (sink_.full())
+                {
+                    return;
+                }
+            }
+            sink_.append('}');
+        }
+
+    private:
+        void raw(std::string_view s) { sink_.append(s.data(), s.size()); }
+
+        void boolean(bool value) { raw(value ? std::string_view("true") : std::string_view("false")); }
+
+        template <typename T>
+        void number(T value)
+        {
+            char buffer[32];
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                if (!std::isfinite(value))
+                {
+                    // JSON 没有 NaN / Infinity，按 protobuf JSON 映射输出为字符串
+                    const std::string_view text = std::isnan(value) ? "NaN" : (value > 0 ? "Infinity" : "-Infinity");
+                    json_ ? quoted(text) : raw(text);
+                    return;
+                }
+            }
+            const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            sink_.append(buffer, static_cast<std::size_t>(result.ptr - buffer));
+        }
+
+        // 固定宽度、左侧补零的非负整数
+        void padded(int64_t value, int width)
+        {
+            char buffer[24];
+            const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            for (int n = static_cast<int>(result.ptr - buffer); n < width; ++n)
+            {
+                sink_.append('0');
+            }
+            sink_.append(buffer, static_cast<std::size_t>(result.ptr - buffer));
+        }
+
+        void date(const Date &d)
+        {
+            if (json_)
+            {
+                sink_.append('"');
+            }
+            padded(d.year(), 4);
+            sink_.append('-');
+            padded(d.month(), 2);
+            sink_.append('-');
+            padded(d.day(), 2);
+            if (json_)
+            {
+                sink_.append('"');
+            }
+        }
+
+        void timestamp(const Timestamp &t)
+        {
+            number(t.seconds());
+            sink_.append('.');
+            padded(t.nanos() < 0 ? 0 : t.nanos(), 9);
+        }
+
+        // 加引号并转义，超过 max_string 的部分以 ...(+N) 标记（不截断在 UTF-8 多字节序列中间）
+        void quoted(std::string_view s)
+        {
+            std::size_t limit = s.size();
+            if (limit > options_.max_string)
+            {
+                limit = options_.max_string;
+                while (limit > 0 && (static_cast<unsigned char>(s[limit]) & 0xC0) == 0x80)
+                {
+                    --limit;
+                }
+            }
+            sink_.append('"');
+            std::size_t run = 0;
+            for (std::size_t i = 0; i < limit; ++i)
+            {
+                const unsigned char c = static_cast<unsigned char>(s[i]);
+                if (c >= 0x20 && c != '"' && c != '\\')
+                {
+                    continue;
+                }
+                sink_.append(s.data() + run, i - run);
+                run = i + 1;
+                escape(c);
+            }
+            sink_.append(s.data() + run, limit - run);
+            if (limit < s.size())
+            {
+                truncated_marker(s.size() - limit);
+            }
+            sink_.append('"');
+        }
+
+        void escape(unsigned char c)
+        {
+            static const char kHex[] = "0123456789abcdef";
+            switch (c)
+            {
+            case '"':
+                raw("\\\"");
+                break;
+            case '\\':
+                raw("\\\\");
+                break;
+            case '\n':
+                raw("\\n");
+                break;
+            case '\r':
+                raw("\\r");
+                break;
+            case '\t':
+                raw("\\t");
+                break;
+            default:
+            {
+                const char u[] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xF]};
+                sink_.append(u, sizeof(u));
+                break;
+            }
+            }
+        }
+
+        // bytes 以十六进制字符串输出
+        void bytes(std::string_view b)
+        {
+            static const char kHex[] = "0123456789abcdef";
+            const std::size_t limit = b.size() < options_.max_string / 2 ? b.size() : options_.max_string / 2;
+            sink_.append('"');
+            char pair[2];
+            for (std::size_t i = 0; i < limit; ++i)
+            {
+                const unsigned char c = static_cast<unsigned char>(b[i]);
+                pair[0] = kHex[c >> 4];
+                pair[1] = kHex[c & 0xF];
+                sink_.append(pair, 2);
+            }
+            if (limit < b.size())
+            {
+                truncated_marker(b.size() - limit);
+            }
+            sink_.append('"');
+        }
+
+        void truncated_marker(std::size_t remaining)
+        {
+            raw("...(+");
+            number(remaining);
+            sink_.append(')');
+        }
+
+        void key(std::string_view k)
+        {
+            if (json_)
+            {
+                quoted(k);
+                sink_.append(':');
+            }
+            else
+            {
+                raw(k);
+                raw(": ");
+            }
+        }
+
+        void separator(std::size_t index)
+        {
+            if (index != 0)
+            {
+                json_ ? sink_.append(',') : raw(", ");
+            }
+        }
+
+        // 超出 max_elements 的数组元素
+        void more_elements(std::size_t remaining)
+        {
+            if (json_)
+            {
+                sink_.append('"');
+            }
+            truncated_marker(remaining);
+            if (json_)
+            {
+                sink_.append('"');
+            }
+        }
+
+        // 超出 max_elements 的字典条目
+        void more_entries(std::size_t remaining)
+        {
+            if (json_)
+            {
+                raw("\"...\":");
+                number(remaining);
+            }
+            else
+            {
+                truncated_marker(remaining);
+            }
+        }
+
+        // 超出 max_depth 的嵌套对象只输出条目数
+        void collapsed(std::size_t entries)
+        {
+            sink_.append('{');
+            more_entries(entries);
+            sink_.append('}');
+        }
+
+        template <typename Range, typename Fn>
+        void array(const Range &range, Fn &&each)
+        {
+            sink_.append('[');
+            const std::size_t size = static_cast<std::size_t>(range.size());
+            std::size_t index = 0;
+            for (const auto &item : range)
+            {
+                if (index == options_.max_elements)
+                {
+                    separator(index);
+                    more_elements(size - index);
+                    break;
+                }
+                separator(index++);
+                each(item);
+                if (sink_.full())
+                {
+                    return;
+                }
+            }
+            sink_.append(']');
+        }
+
+        template <typename Range>
+        void numbers(const Range &range)
+        {
+            array(range, [this](auto x)
+                  { number(x); });
+        }
+
+        template <typename Packed>
+        void packed(const Packed &p)
+        {
+            using T = humanoid_robot::utils::PB::packed_value_t<Packed>;
+            const std::size_t size = humanoid_robot::utils::PB::packed_size(p);
+            const std::size_t limit = size < options_.max_elements ? size : options_.max_elements;
+            const char *data = p.values().data();
+            sink_.append('[');
+            for (std::size_t i = 0; i < limit && !sink_.full(); ++i)
+            {
+                separator(i);
+                number(static_cast<int>(humanoid_robot::utils::PB::detail::load_le<T>(data + i * sizeof(T))));
+            }
+            if (limit < size)
+            {
+                separator(limit);
+                more_elements(size - limit);
+            }
+            sink_.append(']');
+        }
+
+        void enum_value(int number_value, const FieldDescriptor *field)
+        {
+            const auto *value = field->enum_type()->FindValueByNumber(number_value);
+            if (value == nullptr)
+            {
+                number(number_value);
+                return;
+            }
+            json_ ? quoted(value->name()) : raw(value->name());
+        }
+
+        void singular_field(const Message &m, const FieldDescriptor *field, int depth)
+        {
+            const Reflection *r = m.GetReflection();
+            switch (field->cpp_type())
+            {
+            case FieldDescriptor::CPPTYPE_BOOL:
+                boolean(r->GetBool(m, field));
+                break;
+            case FieldDescriptor::CPPTYPE_INT32:
+                number(r->GetInt32(m, field));
+                break;
+            case FieldDescriptor::CPPTYPE_UINT32:
+                number(r->GetUInt32(m, field));
+                break;
+            case FieldDescriptor::CPPTYPE_INT64:
+                number(r->GetInt64(m, field));
+                break;
+            case FieldDescriptor::CPPTYPE_UINT64:
+                number(r->GetUInt64(m, field));
+                break;
+            case FieldDescriptor::CPPTYPE_FLOAT:
+                number(r->GetFloat(m, field));
+                break;
+            case FieldDescriptor::CPPTYPE_DOUBLE:
+                number(r->GetDouble(m, field));
+                break;
+            case FieldDescriptor::CPPTYPE_ENUM:
+                enum_value(r->GetEnumValue(m, field), field);
+                break;
+            case FieldDescriptor::CPPTYPE_STRING:
+            {
+                std::string scratch; // 仅 Cord 字段会用到，普通 string/bytes 字段直接返回引用
+                const std::string &value = r->GetStringReference(m, field, &scratch);
+                field->type() == FieldDescriptor::TYPE_BYTES ? bytes(value) : quoted(value);
+                break;
+            }
+            case FieldDescriptor::CPPTYPE_MESSAGE:
+                message(r->GetMessage(m, field), depth + 1);
+                break;
+            }
+        }
+
+        void repeated_field(const Message &m, const FieldDescriptor *field, int depth)
+        {
+            const Reflection *r = m.GetReflection();
+            const std::size_t size = static_cast<std::size_t>(r->FieldSize(m, field));
+            const std::size_t limit = size < options_.max_elements ? size : options_.max_elements;
+            sink_.append('[');
+            for (std::size_t i = 0; i < limit && !sink_.full(); ++i)
+            {
+                const int index = static_cast<int>(i);
+                separator(i);
+                switch (field->cpp_type())
+                {
+                case FieldDescriptor::CPPTYPE_BOOL:
+                    boolean(r->GetRepeatedBool(m, field, index));
+                    break;
+                case FieldDescriptor::CPPTYPE_INT32:
+                    number(r->GetRepeatedInt32(m, field, index));
+                    break;
+                case FieldDescriptor::CPPTYPE_UINT32:
+                    number(r->GetRepeatedUInt32(m, field, index));
+                    break;
+                case FieldDescriptor::CPPTYPE_INT64:
+                    number(r->GetRepeatedInt64(m, field, index));
+                    break;
+                case FieldDescriptor::CPPTYPE_UINT64:
+                    number(r->GetRepeatedUInt64(m, field, index));
+                    break;
+                case FieldDescriptor::CPPTYPE_FLOAT:
+                    number(r->GetRepeatedFloat(m, field, index));
+                    break;
+                case FieldDescriptor::CPPTYPE_DOUBLE:
+                    number(r->GetRepeatedDouble(m, field, index));
+                    break;
+                case FieldDescriptor::CPPTYPE_ENUM:
+                    enum_value(r->GetRepeatedEnumValue(m, field, index), field);
+                    break;
+                case FieldDescriptor::CPPTYPE_STRING:
+                {
+                    std::string scratch;
+                    const std::string &value = r->GetRepeatedStringReference(m, field, index, &scratch);
+                    field->type() == FieldDescriptor::TYPE_BYTES ? bytes(value) : quoted(value);
+                    break;
+                }
+                case FieldDescriptor::CPPTYPE_MESSAGE:
+                    message(r->GetRepeatedMessage(m, field, index), depth + 1);
+                    break;
+                }
+            }
+            if (limit < size)
+            {
+                separator(limit);
+                more_elements(size - limit);
+            }
+            sink_.append(']');
+        }
+
+        // map 字段（Dictionary 以外）输出为对象，键统一按字符串处理
+        void map_field(const Message &m, const FieldDescriptor *field, int depth)
+        {
+            const Reflection *r = m.GetReflection();
+            const std::size_t size = static_cast<std::size_t>(r->FieldSize(m, field));
+            const FieldDescriptor *key_field = field->message_type()->map_key();
+            const FieldDescriptor *value_field = field->message_type()->map_value();
+            if (depth + 1 > options_.max_depth)
+            {
+                collapsed(size);
+                return;
+            }
+            sink_.append('{');
+            for (std::size_t i = 0; i < size && !sink_.full(); ++i)
+            {
+                if (i == options_.max_elements)
+                {
+                    separator(i);
+                    more_entries(size - i);
+                    break;
+                }
+                const Message &entry = r->GetRepeatedMessage(m, field, static_cast<int>(i));
+                separator(i);
+                if (key_field->cpp_type() == FieldDescriptor::CPPTYPE_STRING)
+                {
+                    std::string scratch;
+                    key(entry.GetReflection()->GetStringReference(entry, key_field, &scratch));
+                }
+                else
+                {
+                    if (json_)
+                    {
+                        sink_.append('"');
+                    }
+                    singular_field(entry, key_field, depth + 1);
+                    json_ ? raw("\":") : raw(": ");
+                }
+                singular_field(entry, value_field, depth + 1);
+            }
+            sink_.append('}');
+        }
+
+        Sink &sink_;
+        const FormatOptions &options_;
+        const bool json_;
+    };
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    void format_variant(const Variant &variant, std::string *out, const FormatOptions &options)
+    {
+        StringSink sink(out);
+        Formatter<StringSink>(sink, options).variant(variant, 0);
+    }
+
+    void format_dictionary(const Dictionary &dictionary, std::string *out, const FormatOptions &options)
+    {
+        StringSink sink(out);
+        Formatter<StringSink>(sink, options).dictionary(dictionary, 1);
+    }
+
+    void format_message(const google::protobuf::Message &message, std::string *out, const FormatOptions &options)
+    {
+        StringSink sink(out);
+        Formatter<StringSink>(sink, options).message(message, 1);
+    }
+
+    std::size_t format_variant(const Variant &variant, char *buffer, std::size_t capacity, const FormatOptions &options)
+    {
+        FixedSink sink(buffer, capacity);
+        Formatter<FixedSink>(sink, options).variant(variant, 0);
+        return sink.finish();
+    }
+
+    std::size_t format_message(const google::protobuf::Message &message, char *buffer, std::size_t capacity,
+                               const FormatOptions &options)
+    {
+        FixedSink sink(buffer, capacity);
+        Formatter<FixedSink>(sink, options).message(message, 1);
+        return sink.finish();
+    }
+} // namespace humanoid_robot::utils::PB
@@ -0,0 +1,692 @@
+#include "variantHash.h"
+
+#include <cstring>
+
+using namespace humanoid_robot::PB::common;
+
+namespace
+{
+    constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+    constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+    inline uint64_t rotl(uint64_t x, int r)
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    inline uint64_t load64(const uint8_t *p)
+    {
+        uint64_t v;
+        std::memcpy(&v, p, sizeof(v)); // 小端主机
+        return v;
+    }
+
+    inline uint32_t load32(const uint8_t *p)
+    {
+        uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline uint64_t round64(uint64_t acc, uint64_t input)
+    {
+        acc += input * kPrime2;
+        acc = rotl(acc, 31);
+        return acc * kPrime1;
+    }
+
+    inline uint64_t merge_round(uint64_t acc, uint64_t value)
+    {
+        acc ^= round64(0, value);
+        return acc * kPrime1 + kPrime4;
+    }
+
+    inline uint64_t avalanche(uint64_t h)
+    {
+        h ^= h >> 33;
+        h *= kPrime2;
+        h ^= h >> 29;
+        h *= kPrime3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    template <typename T>
+    uint64_t bits(T value)
+    {
+        static_assert(sizeof(T) <= sizeof(uint64_t), "scalar too wide");
+        uint64_t out = 0;
+        std::memcpy(&out, &value, sizeof(T));
+        return out;
+    }
+
+    // 顺序相关的组合器：依次混入各字段
+    struct Hasher
+    {
+        uint64_t h;
+
+        explicit Hasher(uint64_t seed) : h(seed + kPrime5) {}
+
+        void add(uint64_t value) { h = rotl(h ^ round64(0, value), 27) * kPrime1 + kPrime4; }
+        void add_bytes(const std::string &value)
+        {
+            add(humanoid_robot::utils::PB::hash_bytes(value.data(), value.size(), value.size()));
+        }
+        template <typename T>
+        void add_array(const google::protobuf::RepeatedField<T> &values)
+        {
+            add(humanoid_robot::utils::PB::hash_bytes(values.data(), static_cast<std::size_t>(values.size()) * sizeof(T),
+                                                      static_cast<uint64_t>(values.size())));
+        }
+        void add_strings(const google::protobuf::RepeatedPtrField<std::string> &values)
+        {
+            add(static_cast<uint64_t>(values.size()));
+            for (const auto &value : values)
+            {
+                add_bytes(value);
+            }
+        }
+        uint64_t finish() const { return avalanche(h); }
+    };
+
+    template <typename T>
+    bool array_equal(const google::protobuf::RepeatedField<T> &a, const google::protobuf::RepeatedField<T> &b)
+    {
+        return a.size() == b.size() &&
+               (a.size() == 0 || std::memcmp(a.data(), b.data(), static_cast<std::size_t>(a.size()) * sizeof(T)) == 0);
+    }
+
+    bool strings_equal(const google::protobuf::RepeatedPtrField<std::string> &a,
+                       const google::protobuf::RepeatedPtrField<std::string> &b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (int i = 0; i < a.size(); ++i)
+        {
+            if (a.Get(i) != b.Get(i))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // ---------------------------------------------------------------- 感知相关消息
+
+    void add_bbox(Hasher *hasher, const BBox &box)
+    {
+        hasher->add(bits(box.x1()) | (bits(box.y1()) << 32));
+        hasher->add(bits(box.x2()) | (bits(box.y2()) << 32));
+    }
+
+    bool bbox_equal(const BBox &a, const BBox &b)
+    {
+        return bits(a.x1()) == bits(b.x1()) && bits(a.y1()) == bits(b.y1()) &&
+               bits(a.x2()) == bits(b.x2()) && bits(a.y2()) == bits(b.y2());
+    }
+
+    void add_masks(Hasher *hasher, const google::protobuf::RepeatedPtrField<Mask> &masks)
+    {
+        hasher->add(static_cast<uint64_t>(masks.size()));
+        for (const auto &mask : masks)
+        {
+            hasher->add(bits(mask.x()) | (bits(mask.y()) << 32));
+        }
+    }
+
+    bool masks_equal(const google::protobuf::RepeatedPtrField<Mask> &a, const google::protobuf::RepeatedPtrField<Mask> &b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (int i = 0; i < a.size(); ++i)
+        {
+            if (a.Get(i).x() != b.Get(i).x() || a.Get(i).y() != b.Get(i).y())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void add_mask_rle(Hasher *hasher, const MaskRle &rle)
+    {
+        hasher->add(rle.width() | (static_cast<uint64_t>(rle.height()) << 32));
+        hasher->add(bits(rle.originx()) | (bits(rle.originy()) << 32));
+        hasher->add_array(rle.counts());
+    }
+
+    bool mask_rle_equal(const MaskRle &a, const MaskRle &b)
+    {
+        return a.width() == b.width() && a.height() == b.height() && a.originx() == b.originx() &&
+               a.originy() == b.originy() && array_equal(a.counts(), b.counts());
+    }
+
+    // Image.trace：未设置与空的 TraceContext 序列化结果不同，分开计
+    void add_trace(Hasher *hasher, const Image &image)
+    {
+        if (!image.has_trace())
+        {
+            hasher->add(0);
+            return;
+        }
+        const TraceContext &trace = image.trace();
+        hasher->add(1 + static_cast<uint64_t>(trace.hops_size()));
+        hasher->add(trace.trace_id());
+        for (const TraceHop &hop : trace.hops())
+        {
+            hasher->add(bits(static_cast<int32_t>(hop.stage())) | (static_cast<uint64_t>(hop.clock_id()) << 32));
+            hasher->add(hop.start_ns());
+            hasher->add(hop.duration_ns());
+        }
+    }
+
+    bool trace_equal(const Image &a, const Image &b)
+    {
+        if (a.has_trace() != b.has_trace())
+        {
+            return false;
+        }
+        if (!a.has_trace())
+        {
+            return true;
+        }
+        const TraceContext &x = a.trace();
+        const TraceContext &y = b.trace();
+        if (x.trace_id() != y.trace_id() || x.hops_size() != y.hops_size())
+        {
+            return false;
+        }
+        for (int i = 0; i < x.hops_size(); ++i)
+        {
+            const TraceHop &p = x.hops(i);
+            const TraceHop &q = y.hops(i);
+            if (p.stage() != q.stage() || p.start_ns() != q.start_ns() || p.duration_ns() != q.duration_ns() ||
+                p.clock_id() != q.clock_id())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 三种感知行共有的字段
+    template <typename Row>
+    void add_row_common(Hasher *hasher, const Row &row)
+    {
+        hasher->add_bytes(row.trackid());
+        hasher->add_bytes(row.cls());
+        hasher->add(bits(row.conf()) | (static_cast<uint64_t>(row.ismove()) << 32));
+    }
+
+    template <typename Row>
+    bool row_common_equal(const Row &a, const Row &b)
+    {
+        return bits(a.conf()) == bits(b.conf()) && a.ismove() == b.ismove() && a.trackid() == b.trackid() && a.cls() == b.cls();
+    }
+
+    // 带掩码的行（PerceptionRow / DivisionRow）
+    template <typename Row>
+    void add_row_masks(Hasher *hasher, const Row &row)
+    {
+        add_masks(hasher, row.masks());
+        hasher->add(row.has_maskrle() | (static_cast<uint64_t>(row.has_maskcontour()) << 1));
+        if (row.has_maskrle())
+        {
+            add_mask_rle(hasher, row.maskrle());
+        }
+        if (row.has_maskcontour())
+        {
+            hasher->add_array(row.maskcontour().deltas());
+        }
+    }
+
+    template <typename Row>
+    bool row_masks_equal(const Row &a, const Row &b)
+    {
+        return a.has_maskrle() == b.has_maskrle() && a.has_maskcontour() == b.has_maskcontour() &&
+               masks_equal(a.masks(), b.masks()) &&
+               (!a.has_maskrle() || mask_rle_equal(a.maskrle(), b.maskrle())) &&
+               (!a.has_maskcontour() || array_equal(a.maskcontour().deltas(), b.maskcontour().deltas()));
+    }
+
+    template <typename Row>
+    void add_row_bbox(Hasher *hasher, const Row &row)
+    {
+        hasher->add(row.has_bbox());
+        if (row.has_bbox())
+        {
+            add_bbox(hasher, row.bbox());
+        }
+    }
+
+    template <typename Row>
+    bool row_bbox_equal(const Row &a, const Row &b)
+    {
+        return a.has_bbox() == b.has_bbox() && (!a.has_bbox() || bbox_equal(a.bbox(), b.bbox()));
+    }
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    uint64_t hash_bytes(const void *data, std::size_t size, uint64_t seed)
+    {
+        const uint8_t *p = static_cast<const uint8_t *>(data);
+        const uint8_t *const end = p + size;
+        uint64_t h;
+
+        if (size >= 32)
+        {
+            // 4 路独立累加，互不依赖，便于流水线与向量化
+            uint64_t v1 = seed + kPrime1 + kPrime2;
+            uint64_t v2 = seed + kPrime2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - kPrime1;
+            const uint8_t *const limit = end - 32;
+            do
+            {
+                v1 = round64(v1, load64(p));
+                v2 = round64(v2, load64(p + 8));
+                v3 = round64(v3, load64(p + 16));
+                v4 = round64(v4, load64(p + 24));
+                p += 32;
+            } while (p <= limit);
+
+            h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+            h = merge_round(h, v1);
+            h = merge_round(h, v2);
+            h = merge_round(h, v3);
+            h = merge_round(h, v4);
+        }
+        else
+        {
+            h = seed + kPrime5;
+        }
+
+        h += static_cast<uint64_t>(size);
+        for (; p + 8 <= end; p += 8)
+        {
+            h ^= round64(0, load64(p));
+            h = rotl(h, 27) * kPrime1 + kPrime4;
+        }
+        if (p + 4 <= end)
+        {
+            h ^= static_cast<uint64_t>(load32(p)) * kPrime1;
+            h = rotl(h, 23) * kPrime2 + kPrime3;
+            p += 4;
+        }
+        for (; p < end; ++p)
+        {
+            h ^= static_cast<uint64_t>(*p) * kPrime5;
+            h = rotl(h, 11) * kPrime1;
+        }
+        return avalanche(h);
+    }
+
+    uint64_t hash_variant(const Variant &value)
+    {
+        Hasher hasher(static_cast<uint64_t>(value.value_case()));
+        switch (value.value_case())
+        {
+        case Variant::VALUE_NOT_SET:
+            break;
+        case Variant::kBoolValue:
+            hasher.add(value.boolvalue());
+            break;
+        case Variant::kInt8Value:
+            hasher.add(bits(value.int8value()));
+            break;
+        case Variant::kUint8Value:
+            hasher.add(value.uint8value());
+            break;
+        case Variant::kInt16Value:
+            hasher.add(bits(value.int16value()));
+            break;
+        case Variant::kUint16Value:
+            hasher.add(value.uint16value());
+            break;
+        case Variant::kInt32Value:
+            hasher.add(bits(value.int32value()));
+            break;
+        case Variant::kUint32Value:
+            hasher.add(value.uint32value());
+            break;
+        case Variant::kInt64Value:
+            hasher.add(bits(value.int64value()));
+            break;
+        case Variant::kUint64Value:
+            hasher.add(value.uint64value());
+            break;
+        case Variant::kFloatValue:
+            hasher.add(bits(value.floatvalue()));
+            break;
+        case Variant::kDoubleValue:
+            hasher.add(bits(value.doublevalue()));
+            break;
+        case Variant::kCharValue:
+            hasher.add(value.charvalue());
+            break;
+        case Variant::kByteValue:
+            hasher.add_bytes(value.bytevalue());
+            break;
+        case Variant::kStringValue:
+            hasher.add_bytes(value.stringvalue());
+            break;
+        case Variant::kDateValue:
+            hasher.add(bits(value.datevalue().year()) | (bits(value.datevalue().month()) << 32));
+            hasher.add(bits(value.datevalue().day()));
+            break;
+        case Variant::kTimestampValue:
+            hasher.add(bits(value.timestampvalue().seconds()));
+            hasher.add(bits(value.timestampvalue().nanos()));
+            break;
+        case Variant::kDictValue:
+            hasher.add(hash_dictionary(value.dictvalue()));
+            break;
+        case Variant::kImageValue:
+            hasher.add_bytes(value.imagevalue().timestamp());
+            hasher.add_bytes(value.imagevalue().img());
+            hasher.add(value.imagevalue().requiresmasks());
+            add_trace(&hasher, value.imagevalue());
+            break;
+        case Variant::kBboxValue:
+            add_bbox(&hasher, value.bboxvalue());
+            break;
+        case Variant::kMaskValue:
+            hasher.add(bits(value.maskvalue().x()) | (bits(value.maskvalue().y()) << 32));
+            break;
+        case Variant::kPerceptionRowValue:
+            add_row_bbox(&hasher, value.perceptionrowvalue());
+            add_row_common(&hasher, value.perceptionrowvalue());
+            add_row_masks(&hasher, value.perceptionrowvalue());
+            break;
+        case Variant::kDetectionRowValue:
+            add_row_bbox(&hasher, value.detectionrowvalue());
+            add_row_common(&hasher, value.detectionrowvalue());
+            break;
+        case Variant::kDivisionRowValue:
+            add_row_common(&hasher, value.divisionrowvalue());
+            add_row_masks(&hasher, value.divisionrowvalue());
+            break;
+        case Variant::kBoolArrayValue:
+            hasher.add_array(value.boolarrayvalue().values());
+            break;
+        case Variant::kInt8ArrayValue:
+            hasher.add_array(value.int8arrayvalue().values());
+            break;
+        case Variant::kUint8ArrayValue:
+            hasher.add_array(value.uint8arrayvalue().values());
+            break;
+        case Variant::kInt16ArrayValue:
+            hasher.add_array(value.int16arrayvalue().values());
+            break;
+        case Variant::kUint16ArrayValue:
+            hasher.add_array(value.uint16arrayvalue().values());
+            break;
+        case Variant::kInt32ArrayValue:
+            hasher.add_array(value.int32arrayvalue().values());
+            break;
+        case Variant::kUint32ArrayValue:
+            hasher.add_array(value.uint32arrayvalue().values());
+            break;
+        case Variant::kInt64ArrayValue:
+            hasher.add_array(value.int64arrayvalue().values());
+            break;
+        case Variant::kUint64ArrayValue:
+            hasher.add_array(value.uint64arrayvalue().values());
+            break;
+        case Variant::kFloatArrayValue:
+            hasher.add_array(value.floatarrayvalue().values());
+            break;
+        case Variant::kDoubleArrayValue:
+            hasher.add_array(value.doublearrayvalue().values());
+            break;
+        case Variant::kCharArrayValue:
+            hasher.add_strings(value.chararrayvalue().values());
+            break;
+        case Variant::kByteArrayValue:
+            hasher.add_bytes(value.bytearrayvalue().values());
+            break;
+        case Variant::kStringArrayValue:
+            hasher.add_strings(value.stringarrayvalue().values());
+            break;
+        case Variant::kPackedInt8ArrayValue:
+            hasher.add_bytes(value.packedint8arrayvalue().values());
+            break;
+        case Variant::kPackedUint8ArrayValue:
+            hasher.add_bytes(value.packeduint8arrayvalue().values());
+            break;
+        case Variant::kPackedInt16ArrayValue:
+            hasher.add_bytes(value.packedint16arrayvalue().values());
+            break;
+        case Variant::kPackedUint16ArrayValue:
+            hasher.add_bytes(value.packeduint16arrayvalue().values());
+            break;
+        }
+        return hasher.finish();
+    }
+
+    uint64_t dictionary_entry_hash(std::string_view key, uint64_t value_hash)
+    {
+        // 条目内 key 与值顺序相关；条目之间求和，与迭代顺序无关
+        return avalanche(hash_bytes(key.data(), key.size(), kPrime3) ^ rotl(value_hash, 29));
+    }
+
+    uint64_t finish_dictionary_hash(uint64_t entry_sum, std::size_t entry_count)
+    {
+        return avalanche(entry_sum + static_cast<uint64_t>(entry_count) * kPrime5);
+    }
+
+    uint64_t hash_dictionary(const Dictionary &dict)
+    {
+        uint64_t sum = 0;
+        for (const auto &entry : dict.keyvaluelist())
+        {
+            sum += dictionary_entry_hash(entry.first, hash_variant(entry.second));
+        }
+        return finish_dictionary_hash(sum, static_cast<std::size_t>(dict.keyvaluelist().size()));
+    }
+
+    bool variant_equal(const Variant &a, const Variant &b)
+    {
+        if (&a == &b)
+        {
+            return true;
+        }
+        if (a.value_case() != b.value_case())
+        {
+            return false;
+        }
+        switch (a.value_case())
+        {
+        case Variant::VALUE_NOT_SET:
+            return true;
+        case Variant::kBoolValue:
+            return a.boolvalue() == b.boolvalue();
+        case Variant::kInt8Value:
+            return a.int8value() == b.int8value();
+        case Variant::kUint8Value:
+            return a.uint8value() == b.uint8value();
+        case Variant::kInt16Value:
+            return a.int16value() == b.int16value();
+        case Variant::kUint16Value:
+            return a.uint16value() == b.uint16value();
+        case Variant::kInt32Value:
+            return a.int32value() == b.int32value();
+        case Variant::kUint32Value:
+            return a.uint32value() == b.uint32value();
+        case Variant::kInt64Value:
+            return a.int64value() == b.int64value();
+        case Variant::kUint64Value:
+            return a.uint64value() == b.uint64value();
+        case Variant::kFloatValue:
+            return bits(a.floatvalue()) == bits(b.floatvalue());
+        case Variant::kDoubleValue:
+            return bits(a.doublevalue()) == bits(b.doublevalue());
+        case Variant::kCharValue:
+            return a.charvalue() == b.charvalue();
+        case Variant::kByteValue:
+            return a.bytevalue() == b.bytevalue();
+        case Variant::kStringValue:
+            return a.stringvalue() == b.stringvalue();
+        case Variant::kDateValue:
+            return a.datevalue().year() == b.datevalue().year() && a.datevalue().month() == b.datevalue().month() &&
+                   a.datevalue().day() == b.datevalue().day();
+        case Variant::kTimestampValue:
+            return a.timestampvalue().seconds() == b.timestampvalue().seconds() &&
+                   a.timestampvalue().nanos() == b.timestampvalue().nanos();
+        case Variant::kDictValue:
+            return dictionary_equal(a.dictvalue(), b.dictvalue());
+        case Variant::kImageValue:
+            return a.imagevalue().requiresmasks() == b.imagevalue().requiresmasks() &&
+                   a.imagevalue().img().size() == b.imagevalue().img().size() &&
+                   a.imagevalue().timestamp() == b.imagevalue().timestamp() && a.imagevalue().img() == b.imagevalue().img() &&
+                   trace_equal(a.imagevalue(), b.imagevalue());
+        case Variant::kBboxValue:
+            return bbox_equal(a.bboxvalue(), b.bboxvalue());
+        case Variant::kMaskValue:
+            return a.maskvalue().x() == b.maskvalue().x() && a.maskvalue().y() == b.maskvalue().y();
+        case Variant::kPerceptionRowValue:
+            return row_common_equal(a.perceptionrowvalue(), b.perceptionrowvalue()) &&
+                   row_bbox_equal(a.perceptionrowvalue(), b.perceptionrowvalue()) &&
+                   row_masks_equal(a.perceptionrowvalue(), b.perceptionrowvalue());
+        case Variant::kDetectionRowValue:
+            return row_common_equal(a.detectionrowvalue(), b.detectionrowvalue()) &&
+                   row_bbox_equal(a.detectionrowvalue(), b.detectionrowvalue());
+        case Variant::kDivisionRowValue:
+            return row_common_equal(a.divisionrowvalue(), b.divisionrowvalue()) &&
+                   row_masks_equal(a.divisionrowvalue(), b.divisionrowvalue());
+        case Variant::kBoolArrayValue:
+            return array_equal(a.boolarrayvalue().values(), b.boolarrayvalue().values());
+        case Variant::kInt8ArrayValue:
+            return array_equal(a.int8arrayvalue().values(), b.int8arrayvalue().values());
+        case Variant::kUint8ArrayValue:
+            return array_equal(a.uint8arrayvalue().values(), b.uint8arrayvalue().values());
+        case Variant::kInt16ArrayValue:
+            return array_equal(a.int16arrayvalue().values(), b.int16arrayvalue().values());
+        case Variant::kUint16ArrayValue:
+            return array_equal(a.uint16arrayvalue().values(), b.uint16arrayvalue().values());
+        case Variant::kInt32ArrayValue:
+            return array_equal(a.int32arrayvalue().values(), b.int32arrayvalue().values());
+        case Variant::kUint32ArrayValue:
+            return array_equal(a.uint32arrayvalue().values(), b.uint32arrayvalue().values());
+        case Variant::kInt64ArrayValue:
+            return array_equal(a.int64arrayvalue().values(), b.int64arrayvalue().values());
+        case Variant::kUint64ArrayValue:
+            return array_equal(a.uint64arrayvalue().values(), b.uint64arrayvalue().values());
+        case Variant::kFloatArrayValue:
+            return array_equal(a.floatarrayvalue().values(), b.floatarrayvalue().values());
+        case Variant::kDoubleArrayValue:
+            return array_equal(a.doublearrayvalue().values(), b.doublearrayvalue().values());
+        case Variant::kCharArrayValue:
+            return strings_equal(a.chararrayvalue().values(), b.chararrayvalue().values());
+        case Variant::kByteArrayValue:
+            return a.bytearrayvalue().values() == b.bytearrayvalue().values();
+        case Variant::kStringArrayValue:
+            return strings_equal(a.stringarrayvalue().values(), b.stringarrayvalue().values());
+        case Variant::kPackedInt8ArrayValue:
+            return a.packedint8arrayvalue().values() == b.packedint8arrayvalue().values();
+        case Variant::kPackedUint8ArrayValue:
+            return a.packeduint8arrayvalue().values() == b.packeduint8arrayvalue().values();
+        case Variant::kPackedInt16ArrayValue:
+            return a.packedint16arrayvalue().values() == b.packedint16arrayvalue().values();
+        case Variant::kPackedUint16ArrayValue:
+            return a.packeduint16arrayvalue().values() == b.packeduint16arrayvalue().values();
+        }
+        return false;
+    }
+
+    bool dictionary_equal(const Dictionary &a, const Dictionary &b)
+    {
+        if (&a == &b)
+        {
+            return true;
+        }
+        const auto &map_a = a.keyvaluelist();
+        const auto &map_b = b.keyvaluelist();
+        if (map_a.size() != map_b.size())
+        {
+            return false;
+        }
+        for (const auto &entry : map_a)
+        {
+            auto it = map_b.find(entry.first);
+            if (it == map_b.end() || !variant_equal(entry.second, it->second))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // ---------------------------------------------------------------- DictionaryHash
+
+    void DictionaryHash::reset(const Dictionary &dict)
+    {
+        clear();
+        entries_.reserve(static_cast<std::size_t>(dict.keyvaluelist().size()));
+        for (const auto &entry : dict.keyvaluelist())
+        {
+            const uint64_t value_hash = hash_variant(entry.second);
+            entries_.emplace(entry.first, value_hash);
+            sum_ += dictionary_entry_hash(entry.first, value_hash);
+        }
+    }
+
+    void DictionaryHash::clear()
+    {
+        entries_.clear();
+        sum_ = 0;
+    }
+
+    bool DictionaryHash::set(const std::string &key, const Variant &value)
+    {
+        const uint64_t value_hash = hash_variant(value);
+        auto it = entries_.find(key);
+        if (it != entries_.end())
+        {
+            if (it->second == value_hash)
+            {
+                return false;
+            }
+            sum_ -= dictionary_entry_hash(key, it->second);
+            it->second = value_hash;
+        }
+        else
+        {
+            entries_.emplace(key, value_hash);
+        }
+        sum_ += dictionary_entry_hash(key, value_hash);
+        return true;
+    }
+
+    bool DictionaryHash::remove(const std::string &key)
+    {
+        auto it = entries_.find(key);
+        if (it == entries_.end())
+        {
+            return false;
+        }
+        sum_ -= dictionary_entry_hash(key, it->second);
+        entries_.erase(it);
+        return true;
+    }
+
+    bool DictionaryHash::find(const std::string &key, uint64_t *value_hash) const
+    {
+        auto it = entries_.find(key);
+        if (it == entries_.end())
+        {
+            return false;
+        }
+        *value_hash = it->second;
+        return true;
+    }
+
+} // namespace humanoid_robot::utils::PB
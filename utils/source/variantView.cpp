@@ -0,0 +1,819 @@
+#include "variantView.h"
+
+#include <cstring>
+#include <limits>
+
+using namespace humanoid_robot::PB::common;
+
+namespace
+{
+    constexpr uint32_t kWireVarint = 0;
+    constexpr uint32_t kWireFixed64 = 1;
+    constexpr uint32_t kWireLengthDelimited = 2;
+    constexpr uint32_t kWireFixed32 = 5;
+
+    constexpr int kMaxDepth = 100; // 与 protobuf 默认递归上限一致
+
+    // 线格式游标：所有读取都做边界检查，失败时不移动
+    struct WireCursor
+    {
+        const uint8_t *p;
+        const uint8_t *end;
+
+        explicit WireCursor(std::string_view bytes)
+            : p(reinterpret_cast<const uint8_t *>(bytes.data())), end(p + bytes.size()) {}
+
+        bool done() const { return p >= end; }
+
+        bool varint(uint64_t *out)
+        {
+            uint64_t value = 0;
+            const uint8_t *q = p;
+            for (int shift = 0; shift < 64 && q < end; shift += 7)
+            {
+                const uint8_t byte = *q++;
+                value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    p = q;
+                    *out = value;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool fixed(std::size_t width, uint64_t *out)
+        {
+            if (static_cast<std::size_t>(end - p) < width)
+            {
+                return false;
+            }
+            uint64_t value = 0;
+            std::memcpy(&value, p, width); // 小端主机
+            p += width;
+            *out = value;
+            return true;
+        }
+
+        bool bytes(std::string_view *out)
+        {
+            uint64_t size = 0;
+            const uint8_t *start = p;
+            if (!varint(&size) || size > static_cast<uint64_t>(end - p))
+            {
+                p = start;
+                return false;
+            }
+            *out = std::string_view(reinterpret_cast<const char *>(p), static_cast<std::size_t>(size));
+            p += size;
+            return true;
+        }
+
+        bool tag(uint32_t *field, uint32_t *wire_type)
+        {
+            uint64_t value = 0;
+            if (!varint(&value) || value > std::numeric_limits<uint32_t>::max() || (value >> 3) == 0)
+            {
+                return false;
+            }
+            *field = static_cast<uint32_t>(value >> 3);
+            *wire_type = static_cast<uint32_t>(value & 7);
+            return true;
+        }
+
+        // 读取字段值：varint/fixed 放入 scalar，长度限定放入 span
+        bool value(uint32_t wire_type, uint64_t *scalar, std::string_view *span)
+        {
+            switch (wire_type)
+            {
+            case kWireVarint:
+                return varint(scalar);
+            case kWireFixed64:
+                return fixed(8, scalar);
+            case kWireLengthDelimited:
+                return bytes(span);
+            case kWireFixed32:
+                return fixed(4, scalar);
+            default: // group 已废弃，proto3 消息中不会出现
+                return false;
+            }
+        }
+    };
+
+    // Variant oneof 字段的线类型
+    uint32_t variant_wire_type(uint32_t field)
+    {
+        switch (field)
+        {
+        case Variant::kBoolValue:
+        case Variant::kInt8Value:
+        case Variant::kUint8Value:
+        case Variant::kInt16Value:
+        case Variant::kUint16Value:
+        case Variant::kInt32Value:
+        case Variant::kUint32Value:
+        case Variant::kInt64Value:
+        case Variant::kUint64Value:
+        case Variant::kCharValue:
+            return kWireVarint;
+        case Variant::kFloatValue:
+            return kWireFixed32;
+        case Variant::kDoubleValue:
+            return kWireFixed64;
+        default:
+            return kWireLengthDelimited;
+        }
+    }
+
+    bool is_variant_field(uint32_t field)
+    {
+        return (field >= Variant::kBoolValue && field <= Variant::kDivisionRowValue) ||
+               (field >= Variant::kBoolArrayValue && field <= Variant::kStringArrayValue) ||
+               (field >= Variant::kPackedInt8ArrayValue && field <= Variant::kPackedUint16ArrayValue);
+    }
+
+    bool is_array_case(Variant::ValueCase value_case)
+    {
+        return (value_case >= Variant::kBoolArrayValue && value_case <= Variant::kStringArrayValue) ||
+               (value_case >= Variant::kPackedInt8ArrayValue && value_case <= Variant::kPackedUint16ArrayValue);
+    }
+
+    bool is_packed_case(Variant::ValueCase value_case)
+    {
+        return value_case >= Variant::kPackedInt8ArrayValue && value_case <= Variant::kPackedUint16ArrayValue;
+    }
+
+    // 数组元素（repeated 字段 1）的线类型；字符串数组与 bytes 字段为长度限定
+    uint32_t element_wire_type(Variant::ValueCase value_case)
+    {
+        switch (value_case)
+        {
+        case Variant::kFloatArrayValue:
+            return kWireFixed32;
+        case Variant::kDoubleArrayValue:
+            return kWireFixed64;
+        case Variant::kCharArrayValue:
+        case Variant::kStringArrayValue:
+        case Variant::kByteArrayValue:
+            return kWireLengthDelimited;
+        default:
+            return kWireVarint;
+        }
+    }
+
+    // 按元素类型把 varint 原始值还原为整数
+    int64_t integer_value(Variant::ValueCase value_case, uint64_t raw)
+    {
+        switch (value_case)
+        {
+        case Variant::kBoolValue:
+        case Variant::kBoolArrayValue:
+            return raw != 0 ? 1 : 0;
+        case Variant::kInt8Value:
+        case Variant::kInt16Value:
+        case Variant::kInt32Value:
+        case Variant::kInt8ArrayValue:
+        case Variant::kInt16ArrayValue:
+        case Variant::kInt32ArrayValue:
+            return static_cast<int32_t>(static_cast<uint32_t>(raw));
+        case Variant::kUint8Value:
+        case Variant::kUint16Value:
+        case Variant::kUint32Value:
+        case Variant::kCharValue:
+        case Variant::kUint8ArrayValue:
+        case Variant::kUint16ArrayValue:
+        case Variant::kUint32ArrayValue:
+            return static_cast<uint32_t>(raw);
+        default:
+            return static_cast<int64_t>(raw);
+        }
+    }
+
+    bool is_signed_integer_case(Variant::ValueCase value_case)
+    {
+        return value_case == Variant::kInt8Value || value_case == Variant::kInt16Value ||
+               value_case == Variant::kInt32Value || value_case == Variant::kInt64Value;
+    }
+
+    bool is_unsigned_integer_case(Variant::ValueCase value_case)
+    {
+        return value_case == Variant::kUint8Value || value_case == Variant::kUint16Value ||
+               value_case == Variant::kUint32Value || value_case == Variant::kUint64Value ||
+               value_case == Variant::kCharValue;
+    }
+
+    // 解析单个 map 条目（key = 1, value = 2）
+    bool parse_entry(std::string_view entry, std::string_view *key, std::string_view *value)
+    {
+        *key = std::string_view();
+        *value = std::string_view();
+        WireCursor cursor(entry);
+        while (!cursor.done())
+        {
+            uint32_t field = 0;
+            uint32_t wire_type = 0;
+            uint64_t scalar = 0;
+            std::string_view span;
+            if (!cursor.tag(&field, &wire_type) || !cursor.value(wire_type, &scalar, &span))
+            {
+                return false;
+            }
+            if (wire_type == kWireLengthDelimited)
+            {
+                if (field == 1)
+                {
+                    *key = span;
+                }
+                else if (field == 2)
+                {
+                    *value = span;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool validate_dictionary(std::string_view bytes, int depth);
+
+    bool validate_variant(const humanoid_robot::utils::PB::VariantView &view, int depth)
+    {
+        using namespace humanoid_robot::utils::PB;
+        if (!view.valid())
+        {
+            return false;
+        }
+        DictionaryView dict;
+        if (view.as_dictionary(&dict))
+        {
+            return validate_dictionary(dict.bytes(), depth + 1);
+        }
+        ArrayView array;
+        return !view.as_array(&array) || array.validate();
+    }
+
+    bool validate_dictionary(std::string_view bytes, int depth)
+    {
+        using namespace humanoid_robot::utils::PB;
+        if (depth > kMaxDepth)
+        {
+            return false;
+        }
+        bool nested_ok = true;
+        const bool ok = DictionaryView(bytes).for_each([&](std::string_view, const VariantView &value)
+                                                       { return nested_ok = validate_variant(value, depth); });
+        return ok && nested_ok;
+    }
+} // namespace
+
+namespace humanoid_robot::utils::PB
+{
+    // ---------------------------------------------------------------- VariantView
+
+    VariantView::VariantView(std::string_view bytes) : data_(bytes)
+    {
+        WireCursor cursor(bytes);
+        while (!cursor.done())
+        {
+            uint32_t field = 0;
+            uint32_t wire_type = 0;
+            uint64_t scalar = 0;
+            std::string_view span;
+            if (!cursor.tag(&field, &wire_type) || !cursor.value(wire_type, &scalar, &span))
+            {
+                valid_ = false;
+                case_ = Variant::VALUE_NOT_SET;
+                return;
+            }
+            // 线类型与声明不符的字段按未知字段处理（与生成代码一致）
+            if (is_variant_field(field) && wire_type == variant_wire_type(field))
+            {
+                case_ = static_cast<ValueCase>(field);
+                scalar_ = scalar;
+                span_ = span;
+            }
+        }
+    }
+
+    bool VariantView::as_bool(bool *out) const
+    {
+        if (case_ != Variant::kBoolValue)
+        {
+            return false;
+        }
+        *out = scalar_ != 0;
+        return true;
+    }
+
+    bool VariantView::as_int64(int64_t *out) const
+    {
+        if (is_signed_integer_case(case_) ||
+            (is_unsigned_integer_case(case_) &&
+             (case_ != Variant::kUint64Value || scalar_ <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))))
+        {
+            *out = integer_value(case_, scalar_);
+            return true;
+        }
+        return false;
+    }
+
+    bool VariantView::as_uint64(uint64_t *out) const
+    {
+        if (case_ == Variant::kUint64Value)
+        {
+            *out = scalar_;
+            return true;
+        }
+        if (is_signed_integer_case(case_) || is_unsigned_integer_case(case_))
+        {
+            const int64_t value = integer_value(case_, scalar_);
+            if (value < 0)
+            {
+                return false;
+            }
+            *out = static_cast<uint64_t>(value);
+            return true;
+        }
+        return false;
+    }
+
+    bool VariantView::as_double(double *out) const
+    {
+        if (case_ == Variant::kFloatValue)
+        {
+            float value;
+            const uint32_t bits = static_cast<uint32_t>(scalar_);
+            std::memcpy(&value, &bits, sizeof(value));
+            *out = value;
+            return true;
+        }
+        if (case_ == Variant::kDoubleValue)
+        {
+            std::memcpy(out, &scalar_, sizeof(double));
+            return true;
+        }
+        if (case_ == Variant::kUint64Value)
+        {
+            *out = static_cast<double>(scalar_);
+            return true;
+        }
+        int64_t value = 0;
+        if (as_int64(&value))
+        {
+            *out = static_cast<double>(value);
+            return true;
+        }
+        return false;
+    }
+
+    bool VariantView::as_string(std::string_view *out) const
+    {
+        if (case_ != Variant::kStringValue && case_ != Variant::kByteValue)
+        {
+            return false;
+        }
+        *out = span_;
+        return true;
+    }
+
+    bool VariantView::as_dictionary(DictionaryView *out) const
+    {
+        if (case_ != Variant::kDictValue)
+        {
+            return false;
+        }
+        *out = DictionaryView(span_);
+        return true;
+    }
+
+    bool VariantView::as_array(ArrayView *out) const
+    {
+        if (!is_array_case(case_))
+        {
+            return false;
+        }
+        *out = ArrayView(case_, span_);
+        return true;
+    }
+
+    bool VariantView::as_message(std::string_view *out) const
+    {
+        if ((case_ >= Variant::kDateValue && case_ <= Variant::kDivisionRowValue && case_ != Variant::kDictValue))
+        {
+            *out = span_;
+            return true;
+        }
+        return false;
+    }
+
+    bool VariantView::materialize(Variant *out) const
+    {
+        return out->ParseFromArray(data_.data(), static_cast<int>(data_.size()));
+    }
+
+    // ---------------------------------------------------------------- DictionaryView
+
+    int DictionaryView::next_entry(std::size_t *pos, std::string_view *key, VariantView *value) const
+    {
+        WireCursor cursor(data_.substr(*pos));
+        while (!cursor.done())
+        {
+            uint32_t field = 0;
+            uint32_t wire_type = 0;
+            uint64_t scalar = 0;
+            std::string_view span;
+            if (!cursor.tag(&field, &wire_type) || !cursor.value(wire_type, &scalar, &span))
+            {
+                return -1;
+            }
+            if (field != 1 || wire_type != kWireLengthDelimited)
+            {
+                continue;
+            }
+            std::string_view value_bytes;
+            if (!parse_entry(span, key, &value_bytes))
+            {
+                return -1;
+            }
+            *value = VariantView(value_bytes);
+            *pos = static_cast<std::size_t>(reinterpret_cast<const char *>(cursor.p) - data_.data());
+            return value->valid() ? 1 : -1;
+        }
+        *pos = data_.size();
+        return 0;
+    }
+
+    bool DictionaryView::find(std::string_view key, VariantView *out) const
+    {
+        // 只为匹配的条目构造 VariantView；继续扫描以取最后一个重复 key
+        std::string_view found;
+        bool matched = false;
+        WireCursor cursor(data_);
+        while (!cursor.done())
+        {
+            uint32_t field = 0;
+            uint32_t wire_type = 0;
+            uint64_t scalar = 0;
+            std::string_view span;
+            if (!cursor.tag(&field, &wire_type) || !cursor.value(wire_type, &scalar, &span))
+            {
+                return false;
+            }
+            if (field != 1 || wire_type != kWireLengthDelimited)
+            {
+                continue;
+            }
+            std::string_view entry_key;
+            std::string_view entry_value;
+            if (!parse_entry(span, &entry_key, &entry_value))
+            {
+                return false;
+            }
+            if (entry_key == key)
+            {
+                found = entry_value;
+                matched = true;
+            }
+        }
+        if (!matched)
+        {
+            return false;
+        }
+        VariantView view(found);
+        if (!view.valid())
+        {
+            return false;
+        }
+        *out = view;
+        return true;
+    }
+
+    bool DictionaryView::contains(std::string_view key) const
+    {
+        VariantView value;
+        return find(key, &value);
+    }
+
+    std::size_t DictionaryView::size() const
+    {
+        std::size_t count = 0;
+        const bool ok = for_each([&](std::string_view, const VariantView &)
+                                 { ++count; return true; });
+        return ok ? count : 0;
+    }
+
+    bool DictionaryView::validate() const
+    {
+        return validate_dictionary(data_, 0);
+    }
+
+    bool DictionaryView::materialize(Dictionary *out) const
+    {
+        return out->ParseFromArray(data_.data(), static_cast<int>(data_.size()));
+    }
+
+    // ---------------------------------------------------------------- ArrayView
+
+    ArrayView::ArrayView(ValueCase value_case, std::string_view bytes) : case_(value_case), data_(bytes)
+    {
+        rewind();
+    }
+
+    void ArrayView::rewind()
+    {
+        pos_ = 0;
+        chunk_ = std::string_view();
+        failed_ = false;
+        if (is_packed_case(case_))
+        {
+            // packed 数组是单个 bytes 字段，直接按定宽元素遍历
+            chunk_ = bytes();
+            pos_ = data_.size();
+        }
+    }
+
+    std::string_view ArrayView::bytes() const
+    {
+        const bool whole_bytes = case_ == Variant::kByteArrayValue || is_packed_case(case_);
+        const bool fixed = case_ == Variant::kFloatArrayValue || case_ == Variant::kDoubleArrayValue;
+        if (!whole_bytes && !fixed)
+        {
+            return std::string_view();
+        }
+        std::string_view result;
+        int chunks = 0;
+        WireCursor cursor(data_);
+        while (!cursor.done())
+        {
+            uint32_t field = 0;
+            uint32_t wire_type = 0;
+            uint64_t scalar = 0;
+            std::string_view span;
+            if (!cursor.tag(&field, &wire_type) || !cursor.value(wire_type, &scalar, &span))
+            {
+                return std::string_view();
+            }
+            if (field != 1)
+            {
+                continue;
+            }
+            if (wire_type != kWireLengthDelimited)
+            {
+                if (fixed)
+                {
+                    return std::string_view(); // 非 packed 编码，元素不连续
+                }
+                continue;
+            }
+            result = span;
+            ++chunks;
+        }
+        if (fixed)
+        {
+            const std::size_t width = case_ == Variant::kFloatArrayValue ? 4 : 8;
+            if (chunks > 1 || result.size() % width != 0)
+            {
+                return std::string_view();
+            }
+        }
+        return result;
+    }
+
+    bool ArrayView::next_scalar(uint64_t *raw)
+    {
+        const uint32_t wire_type = element_wire_type(case_);
+        while (!failed_)
+        {
+            if (!chunk_.empty())
+            {
+                WireCursor cursor(chunk_);
+                bool ok = false;
+                if (is_packed_case(case_))
+                {
+                    const std::size_t width = (case_ == Variant::kPackedInt16ArrayValue ||
+                                               case_ == Variant::kPackedUint16ArrayValue)
+                                                  ? 2
+                                                  : 1;
+                    ok = cursor.fixed(width, raw);
+                    if (ok)
+                    {
+                        // 有符号元素按宽度符号扩展
+                        if (case_ == Variant::kPackedInt8ArrayValue)
+                        {
+                            *raw = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int8_t>(*raw)));
+                        }
+                        else if (case_ == Variant::kPackedInt16ArrayValue)
+                        {
+                            *raw = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int16_t>(*raw)));
+                        }
+                    }
+                }
+                else if (wire_type == kWireVarint)
+                {
+                    ok = cursor.varint(raw);
+                }
+                else
+                {
+                    ok = cursor.fixed(wire_type == kWireFixed32 ? 4 : 8, raw);
+                }
+                if (!ok)
+                {
+                    failed_ = true;
+                    return false;
+                }
+                chunk_.remove_prefix(static_cast<std::size_t>(reinterpret_cast<const char *>(cursor.p) - chunk_.data()));
+                return true;
+            }
+            if (pos_ >= data_.size())
+            {
+                return false;
+            }
+
+            WireCursor cursor(data_.substr(pos_));
+            uint32_t field = 0;
+            uint32_t field_wire = 0;
+            uint64_t scalar = 0;
+            std::string_view span;
+            if (!cursor.tag(&field, &field_wire) || !cursor.value(field_wire, &scalar, &span))
+            {
+                failed_ = true;
+                return false;
+            }
+            pos_ = static_cast<std::size_t>(reinterpret_cast<const char *>(cursor.p) - data_.data());
+            if (field != 1)
+            {
+                continue;
+            }
+            if (field_wire == kWireLengthDelimited)
+            {
+                chunk_ = span; // packed 编码块
+            }
+            else if (field_wire == wire_type)
+            {
+                *raw = scalar;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ArrayView::next(int64_t *out)
+    {
+        if (element_wire_type(case_) != kWireVarint && !is_packed_case(case_))
+        {
+            return false;
+        }
+        uint64_t raw = 0;
+        if (!next_scalar(&raw))
+        {
+            return false;
+        }
+        *out = is_packed_case(case_) ? static_cast<int64_t>(raw) : integer_value(case_, raw);
+        return true;
+    }
+
+    bool ArrayView::next(double *out)
+    {
+        uint64_t raw = 0;
+        if (case_ == Variant::kFloatArrayValue)
+        {
+            if (!next_scalar(&raw))
+            {
+                return false;
+            }
+            float value;
+            const uint32_t bits = static_cast<uint32_t>(raw);
+            std::memcpy(&value, &bits, sizeof(value));
+            *out = value;
+            return true;
+        }
+        if (case_ == Variant::kDoubleArrayValue)
+        {
+            if (!next_scalar(&raw))
+            {
+                return false;
+            }
+            std::memcpy(out, &raw, sizeof(double));
+            return true;
+        }
+        return false;
+    }
+
+    bool ArrayView::next(std::string_view *out)
+    {
+        if (case_ != Variant::kCharArrayValue && case_ != Variant::kStringArrayValue)
+        {
+            return false;
+        }
+        while (!failed_ && pos_ < data_.size())
+        {
+            WireCursor cursor(data_.substr(pos_));
+            uint32_t field = 0;
+            uint32_t wire_type = 0;
+            uint64_t scalar = 0;
+            std::string_view span;
+            if (!cursor.tag(&field, &wire_type) || !cursor.value(wire_type, &scalar, &span))
+            {
+                failed_ = true;
+                return false;
+            }
+            pos_ = static_cast<std::size_t>(reinterpret_cast<const char *>(cursor.p) - data_.data());
+            if (field == 1 && wire_type == kWireLengthDelimited)
+            {
+                *out = span;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ArrayView::validate() const
+    {
+        if (case_ == Variant::kByteArrayValue || is_packed_case(case_))
+        {
+            // bytes 字段：字段结构正确即可，packed 元素宽度不整除时与生成代码一样不报错
+            WireCursor cursor(data_);
+            while (!cursor.done())
+            {
+                uint32_t field = 0;
+                uint32_t wire_type = 0;
+                uint64_t scalar = 0;
+                std::string_view span;
+                if (!cursor.tag(&field, &wire_type) || !cursor.value(wire_type, &scalar, &span))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        ArrayView copy(case_, data_);
+        std::string_view element;
+        uint64_t raw = 0;
+        while (case_ == Variant::kCharArrayValue || case_ == Variant::kStringArrayValue ? copy.next(&element)
+                                                                                         : copy.next_scalar(&raw))
+        {
+        }
+        return !copy.failed_;
+    }
+
+    std::size_t ArrayView::size() const
+    {
+        if (case_ == Variant::kByteArrayValue)
+        {
+            return bytes().size();
+        }
+        if (is_packed_case(case_))
+        {
+            const std::size_t width = (case_ == Variant::kPackedInt16ArrayValue ||
+                                       case_ == Variant::kPackedUint16ArrayValue)
+                                          ? 2
+                                          : 1;
+            return bytes().size() / width;
+        }
+        ArrayView copy(case_, data_);
+        std::size_t count = 0;
+        if (case_ == Variant::kCharArrayValue || case_ == Variant::kStringArrayValue)
+        {
+            std::string_view element;
+            while (copy.next(&element))
+            {
+                ++count;
+            }
+        }
+        else
+        {
+            uint64_t raw = 0;
+            while (copy.next_scalar(&raw))
+            {
+                ++count;
+            }
+        }
+        return copy.failed_ ? 0 : count;
+    }
+
+    // ---------------------------------------------------------------- helpers
+
+    bool find_message_field(std::string_view message, uint32_t field_number, std::string_view *out)
+    {
+        bool found = false;
+        WireCursor cursor(message);
+        while (!cursor.done())
+        {
+            uint32_t field = 0;
+            uint32_t wire_type = 0;
+            uint64_t scalar = 0;
+            std::string_view span;
+            if (!cursor.tag(&field, &wire_type) || !cursor.value(wire_type, &scalar, &span))
+            {
+                return false;
+            }
+            if (field == field_number && wire_type == kWireLengthDelimited)
+            {
+                *out = span;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+} // namespace humanoid_robot::utils::PB